@@ -15,7 +15,7 @@ AABB::~AABB()
 {
 }
 
-bool AABB::Hit(const Ray & ray, const Types::F32 t0, const Types::F32 t1, HitRecord * pHitRec)
+bool AABB::Hit(const Ray & ray, const Types::F32 t0, const Types::F32 t1, HitRecord * pHitRec) const
 {
     Types::F32 tmin = Types::Constant::MIN_F32;
     Types::F32 tmax = Types::Constant::MAX_F32;
@@ -61,4 +61,42 @@ bool AABB::Hit(const Ray & ray, const Types::F32 t0, const Types::F32 t1, HitRec
     return true;
 }
 
+bool AABB::Hit(const PrecomputedRay & ray, const Types::F32 t0, const Types::F32 t1) const
+{
+    const vector3 * bounds[2] = { &m_minPoint, &m_maxPoint };
+
+    Types::F32 tNear = t0;
+    Types::F32 tFar  = t1;
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        const Types::F32 p = ray.m_origin.m_arr[i];
+        const Types::F32 recipocalF = ray.m_inverseDirection.m_arr[i];
+
+        const Types::F32 tEnter = (bounds[    ray.m_sign[i]]->m_arr[i] - p) * recipocalF;
+        const Types::F32 tExit  = (bounds[1 - ray.m_sign[i]]->m_arr[i] - p) * recipocalF;
+
+        // written in this way (not std::max/min) to be compiled into min/max instructions,
+        // and when the ray lies exactly on the slab plane, (0 * infinity) is NaN, the compare is false, the old value is kept.
+        tNear = tEnter > tNear ? tEnter : tNear;
+        tFar  = tExit  < tFar  ? tExit  : tFar;
+    }
+
+    return tNear <= tFar;
+}
+
+void AABB::Expand(const AABB & box)
+{
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        m_minPoint.m_arr[i] = std::min(m_minPoint.m_arr[i], box.m_minPoint.m_arr[i]);
+        m_maxPoint.m_arr[i] = std::max(m_maxPoint.m_arr[i], box.m_maxPoint.m_arr[i]);
+    }
+}
+
+vector3 AABB::Center() const
+{
+    return (m_minPoint + m_maxPoint) * 0.5f;
+}
+
 } // namespace CommonClass
@@ -38,7 +38,27 @@ public:
         In the distance interval, if ray dosen't hit the box,
         it should never hit the inside object.
     */
-    bool Hit(const Ray& ray, const Types::F32 t0, const Types::F32 t1, HitRecord * pHitRec);
+    bool Hit(const Ray& ray, const Types::F32 t0, const Types::F32 t1, HitRecord * pHitRec) const;
+
+    /*!
+        \brief whether the ray hit the box with interval [t0, t1], the branchless slab test.
+        \param ray the ray with cached inverse direction and signs
+        \param t0 min intersect dist
+        \param t1 max intersect dist
+        prefer this one when one ray is tested with many boxes, it has no division and no branch in the loop.
+    */
+    bool Hit(const PrecomputedRay& ray, const Types::F32 t0, const Types::F32 t1) const;
+
+    /*!
+        \brief grow the box to contain another box.
+        \param box the box to be contained.
+    */
+    void Expand(const AABB& box);
+
+    /*!
+        \brief get the center of the box.
+    */
+    vector3 Center() const;
 };
 
 } // namespace CommonClass
@@ -0,0 +1,83 @@
+#include "AccumulationFilm.h"
+#include <assert.h>
+#include <algorithm>
+
+namespace CommonClass
+{
+
+AccumulationFilm::AccumulationFilm(const Types::U32 width, const Types::U32 height)
+    :m_width(width), m_height(height)
+{
+    assert(width > 0 && height > 0);
+    Clear();
+}
+
+AccumulationFilm::~AccumulationFilm()
+{
+    // empty
+}
+
+void AccumulationFilm::Clear()
+{
+    m_sum.assign(m_width * m_height, vector3::ZERO);
+    m_count.assign(m_width * m_height, 0);
+    m_preview.assign(m_width * m_height, vector3::ZERO);
+    m_hasPreview.assign(m_width * m_height, 0);
+}
+
+void AccumulationFilm::AddSample(const Types::U32 x, const Types::U32 y, const vector3& color)
+{
+    assert(x < m_width && y < m_height);
+    const Types::U32 index = y * m_width + x;
+    m_sum[index] = m_sum[index] + color;
+    ++m_count[index];
+}
+
+void AccumulationFilm::SetPreviewBlock(const Types::U32 left, const Types::U32 bottom, const Types::U32 size, const vector3& color)
+{
+    const Types::U32 right = std::min(left + size, m_width);
+    const Types::U32 top   = std::min(bottom + size, m_height);
+    for (Types::U32 y = bottom; y < top; ++y)
+    {
+        for (Types::U32 x = left; x < right; ++x)
+        {
+            m_preview[y * m_width + x]      = color;
+            m_hasPreview[y * m_width + x]   = 1;
+        }
+    }
+}
+
+Types::U32 AccumulationFilm::GetSampleCount(const Types::U32 x, const Types::U32 y) const
+{
+    assert(x < m_width && y < m_height);
+    return m_count[y * m_width + x];
+}
+
+vector3 AccumulationFilm::Resolve(const Types::U32 x, const Types::U32 y) const
+{
+    assert(x < m_width && y < m_height);
+    const Types::U32 index = y * m_width + x;
+    if (m_count[index] > 0)
+    {
+        return m_sum[index] / static_cast<Types::F32>(m_count[index]);
+    }
+    else if (m_hasPreview[index])
+    {
+        return m_preview[index];
+    }
+    return vector3::BLACK;
+}
+
+void AccumulationFilm::ResolveTo(Image * pImage) const
+{
+    assert(pImage != nullptr && pImage->GetWidth() == m_width && pImage->GetHeight() == m_height);
+    for (Types::U32 y = 0; y < m_height; ++y)
+    {
+        for (Types::U32 x = 0; x < m_width; ++x)
+        {
+            pImage->SetPixel(x, y, Resolve(x, y));
+        }
+    }
+}
+
+} // namespace CommonClass
@@ -0,0 +1,93 @@
+#pragma once
+#include <vector>
+#include "vector3.h"
+#include "Image.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief AccumulationFilm store the sum of the float samples and the sample count of each pixel,
+    so the rendering can be done in many passes, and the image can be resolved at any time.
+    besides the full resolution samples, it also keep a preview color for each pixel,
+    which is filled by the reduced resolution passes, and used only when the pixel has no full resolution sample.
+*/
+class AccumulationFilm
+{
+protected:
+    /*!
+        \brief the sum of the samples of each pixel.
+    */
+    std::vector<vector3> m_sum;
+
+    /*!
+        \brief the number of the samples of each pixel.
+    */
+    std::vector<Types::U32> m_count;
+
+    /*!
+        \brief the color from the reduced resolution pass.
+    */
+    std::vector<vector3> m_preview;
+
+    /*!
+        \brief whether the preview color has been setted,
+        not std::vector<bool>, because different rows may be written by different threads.
+    */
+    std::vector<Types::U8> m_hasPreview;
+
+    Types::U32 m_width, m_height;
+
+public:
+    /*!
+        \brief create an empty accumulation film.
+        \param width width of the film
+        \param height height of the film
+    */
+    AccumulationFilm(const Types::U32 width, const Types::U32 height);
+    AccumulationFilm(const AccumulationFilm&) = delete;
+    AccumulationFilm& operator=(const AccumulationFilm&) = delete;
+    ~AccumulationFilm();
+
+    /*!
+        \brief remove all the samples.
+    */
+    void Clear();
+
+    /*!
+        \brief add one full resolution sample to the pixel.
+        \param x column of the pixel, from left to right
+        \param y row of the pixel, from bottom to top
+        \param color the sample color
+    */
+    void AddSample(const Types::U32 x, const Types::U32 y, const vector3& color);
+
+    /*!
+        \brief set the preview color for a block of pixels, the block will be clipped by the film border.
+        \param left/bottom the left bottom pixel of the block
+        \param size the side length of the block
+        \param color the preview color
+    */
+    void SetPreviewBlock(const Types::U32 left, const Types::U32 bottom, const Types::U32 size, const vector3& color);
+
+    /*!
+        \brief get the number of full resolution samples of the pixel.
+    */
+    Types::U32 GetSampleCount(const Types::U32 x, const Types::U32 y) const;
+
+    /*!
+        \brief get the best color for the pixel, the mean of the samples, or the preview color, or black.
+    */
+    vector3 Resolve(const Types::U32 x, const Types::U32 y) const;
+
+    /*!
+        \brief write the best color of all pixels into the image.
+        \param pImage the image whose size should be same as the film.
+    */
+    void ResolveTo(Image * pImage) const;
+
+    Types::U32 GetWidth() const { return m_width; }
+    Types::U32 GetHeight() const { return m_height; }
+};
+
+} // namespace CommonClass
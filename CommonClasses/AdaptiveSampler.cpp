@@ -0,0 +1,182 @@
+#include "AdaptiveSampler.h"
+#include <assert.h>
+#include <atomic>
+#include <cmath>
+#include "Utils/ParallelTool.h"
+
+namespace CommonClass
+{
+
+AdaptiveSampler::AdaptiveSampler()
+{
+    // empty
+}
+
+AdaptiveSampler::~AdaptiveSampler()
+{
+    // empty
+}
+
+void AdaptiveSampler::Render(Camera& camera, const RadianceFunction& radiance)
+{
+    if (camera.m_film.get() == nullptr)
+    {
+        throw std::exception("adaptive sampling failed: film is not setted");
+    }
+
+    assert(m_initialSide > 0 && m_maxSamples >= m_initialSide * m_initialSide);
+
+    m_width  = camera.m_film->GetWidth();
+    m_height = camera.m_film->GetHeight();
+    m_statistics.assign(m_width * m_height, PixelStatistic());
+
+    const Types::U32 samplesPerRound = m_initialSide * m_initialSide;
+
+    // first round, all the pixels take the initial samples.
+    ParallelTool::ParallelFor(0, m_height, [&](const unsigned int y)
+    {
+        for (Types::U32 x = 0; x < m_width; ++x)
+        {
+            SampleRound(camera, radiance, x, y);
+        }
+    }, 1, m_numThreads);
+
+    MarkEdges();
+
+    // refine rounds, only the pixels that need more samples.
+    for (Types::U32 round = 1; (round + 1) * samplesPerRound <= m_maxSamples; ++round)
+    {
+        std::atomic<Types::U32> numRefined(0);
+
+        ParallelTool::ParallelFor(0, m_height, [&](const unsigned int y)
+        {
+            for (Types::U32 x = 0; x < m_width; ++x)
+            {
+                if (NeedRefine(m_statistics[y * m_width + x]))
+                {
+                    SampleRound(camera, radiance, x, y);
+                    ++numRefined;
+                }
+            }
+        }, 1, m_numThreads);
+
+        if (numRefined == 0)
+        {
+            break;
+        }
+    }
+
+    for (Types::U32 y = 0; y < m_height; ++y)
+    {
+        for (Types::U32 x = 0; x < m_width; ++x)
+        {
+            const PixelStatistic& stat = m_statistics[y * m_width + x];
+            camera.IncomeLight(x, y, stat.m_sum / static_cast<Types::F32>(stat.m_count));
+        }
+    }
+}
+
+Types::U32 AdaptiveSampler::GetTotalSampleCount() const
+{
+    Types::U32 total = 0;
+    for (const auto& stat : m_statistics)
+    {
+        total += stat.m_count;
+    }
+    return total;
+}
+
+Types::U32 AdaptiveSampler::GetSampleCount(const Types::U32 x, const Types::U32 y) const
+{
+    assert(x < m_width && y < m_height);
+    return m_statistics[y * m_width + x].m_count;
+}
+
+void AdaptiveSampler::SampleRound(Camera& camera, const RadianceFunction& radiance, const Types::U32 x, const Types::U32 y)
+{
+    PixelStatistic& stat = m_statistics[y * m_width + x];
+    const Types::F32 recipoSide = 1.0f / m_initialSide;
+    const Types::U32 pixel = y * m_width + x;
+
+    // jittered stratified samples inside the pixel, the jitter is keyed by the pixel and the sample index,
+    // so the result is same no matter how many threads and which round.
+    for (Types::U32 p = 0; p < m_initialSide; ++p)
+    {
+        for (Types::U32 q = 0; q < m_initialSide; ++q)
+        {
+            const Types::F32 sampleX = x + (p + m_random.Uniform(pixel, stat.m_count, 0)) * recipoSide;
+            const Types::F32 sampleY = y + (q + m_random.Uniform(pixel, stat.m_count, 1)) * recipoSide;
+
+            const vector3 color = radiance(camera.GetRay(sampleX, sampleY));
+            const Types::F32 lum = Luminance(color);
+
+            stat.m_sum      = stat.m_sum + color;
+            stat.m_sumLum   += lum;
+            stat.m_sumLumSq += lum * lum;
+            ++stat.m_count;
+        }
+    }
+}
+
+bool AdaptiveSampler::NeedRefine(const PixelStatistic& stat) const
+{
+    if (stat.m_count + m_initialSide * m_initialSide > m_maxSamples)
+    {
+        // out of budget.
+        return false;
+    }
+
+    if (stat.m_isEdge)
+    {
+        return true;
+    }
+
+    const Types::F32 recipoCount = 1.0f / stat.m_count;
+    const Types::F32 mean = stat.m_sumLum * recipoCount;
+    const Types::F32 variance = std::max(0.0f, stat.m_sumLumSq * recipoCount - mean * mean);
+
+    // standard error of the mean.
+    return std::sqrt(variance * recipoCount) > m_varianceThreshold;
+}
+
+void AdaptiveSampler::MarkEdges()
+{
+    for (Types::U32 y = 0; y < m_height; ++y)
+    {
+        for (Types::U32 x = 0; x < m_width; ++x)
+        {
+            PixelStatistic& stat = m_statistics[y * m_width + x];
+            const Types::F32 lum = MeanLuminance(stat);
+
+            // only check the right and top neighbour, and mark both sides.
+            if (x + 1 < m_width)
+            {
+                PixelStatistic& right = m_statistics[y * m_width + x + 1];
+                if (std::abs(MeanLuminance(right) - lum) > m_contrastThreshold)
+                {
+                    stat.m_isEdge = right.m_isEdge = true;
+                }
+            }
+            if (y + 1 < m_height)
+            {
+                PixelStatistic& top = m_statistics[(y + 1) * m_width + x];
+                if (std::abs(MeanLuminance(top) - lum) > m_contrastThreshold)
+                {
+                    stat.m_isEdge = top.m_isEdge = true;
+                }
+            }
+        }
+    }
+}
+
+Types::F32 AdaptiveSampler::MeanLuminance(const PixelStatistic& stat)
+{
+    return stat.m_count > 0 ? stat.m_sumLum / stat.m_count : 0.0f;
+}
+
+Types::F32 AdaptiveSampler::Luminance(const vector3& color)
+{
+    return 0.2126f * color.m_x + 0.7152f * color.m_y + 0.0722f * color.m_z;
+}
+
+} // namespace CommonClass
@@ -0,0 +1,127 @@
+#pragma once
+#include <vector>
+#include <functional>
+#include "Camera.h"
+#include "Utils/CounterRandom.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief AdaptiveSampler supersample the film of a camera, but only spend samples where they are needed.
+    every pixel first take m_initialSide x m_initialSide jittered samples,
+    then the pixels whose estimated variance or contrast to the neighbour pixels exceed the threshold
+    take another m_initialSide x m_initialSide samples, round by round, until they converge or reach m_maxSamples.
+    Flat pixels (such as the background) only cost the initial samples.
+*/
+class AdaptiveSampler
+{
+public:
+    /*!
+        \brief the radiance function, return the color of the ray, e.g. Scene::RayColor.
+    */
+    using RadianceFunction = std::function<vector3(const Ray&)>;
+
+    /*!
+        \brief the side length of the stratified grid in one sampling round, m_initialSide^2 samples per round.
+    */
+    Types::U32 m_initialSide = 2;
+
+    /*!
+        \brief the max samples of one pixel, same as a fixed 4x4 grid by default.
+    */
+    Types::U32 m_maxSamples = 16;
+
+    /*!
+        \brief if the standard error of the pixel luminance is greater than this value, take more samples.
+    */
+    Types::F32 m_varianceThreshold = 0.01f;
+
+    /*!
+        \brief if the luminance difference between the pixel and any of the four neighbours is greater than this value,
+        the pixel is treated as an edge and will be refined to m_maxSamples.
+    */
+    Types::F32 m_contrastThreshold = 0.1f;
+
+    /*!
+        \brief how many threads to sample rows, zero for all the hardware threads.
+    */
+    Types::U32 m_numThreads = 0;
+
+protected:
+    /*!
+        \brief accumulated samples of one pixel.
+    */
+    struct PixelStatistic
+    {
+        vector3     m_sum;
+        Types::F32  m_sumLum    = 0.0f;
+        Types::F32  m_sumLumSq  = 0.0f;
+        Types::U32  m_count     = 0;
+        bool        m_isEdge    = false;
+    };
+
+    /*!
+        \brief the statistic of all the pixels in the last rendering.
+    */
+    std::vector<PixelStatistic> m_statistics;
+
+    Types::U32 m_width  = 0;
+    Types::U32 m_height = 0;
+
+    /*!
+        \brief the jitter of the samples, a pure function of (pixel, sample, dimension).
+    */
+    RandomTool::CounterRandom m_random;
+
+public:
+    AdaptiveSampler();
+    ~AdaptiveSampler();
+
+    /*!
+        \brief render the film of the camera.
+        \param camera the camera to generate rays, the film of the camera MUST be setted.
+        \param radiance the function to evaluate the color of one ray, it will be called on multiple threads.
+    */
+    void Render(Camera& camera, const RadianceFunction& radiance);
+
+    /*!
+        \brief get the total number of samples taken in the last rendering.
+    */
+    Types::U32 GetTotalSampleCount() const;
+
+    /*!
+        \brief get the number of samples of one pixel in the last rendering.
+        \param x horizontal index from left to right
+        \param y vertical index from bottom to top
+    */
+    Types::U32 GetSampleCount(const Types::U32 x, const Types::U32 y) const;
+
+protected:
+    /*!
+        \brief take one round (m_initialSide x m_initialSide jittered samples) for one pixel.
+    */
+    void SampleRound(Camera& camera, const RadianceFunction& radiance, const Types::U32 x, const Types::U32 y);
+
+    /*!
+        \brief whether the pixel need more samples.
+    */
+    bool NeedRefine(const PixelStatistic& stat) const;
+
+    /*!
+        \brief mark the pixels that have high contrast with the neighbours.
+    */
+    void MarkEdges();
+
+    /*!
+        \brief the mean luminance of the pixel.
+    */
+    static Types::F32 MeanLuminance(const PixelStatistic& stat);
+
+    /*!
+        \brief luminance of a linear rgb color.
+    */
+    static Types::F32 Luminance(const vector3& color);
+};
+
+} // namespace CommonClass
@@ -0,0 +1,172 @@
+#include "AsyncImageWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+namespace CommonClass
+{
+
+AsyncImageWriter::AsyncImageWriter(const Types::U32 maxPendingImages /*= 2*/)
+    :m_maxPendingImages(std::max(maxPendingImages, 1u)),
+    m_thread(&AsyncImageWriter::WriterLoop, this)
+{
+    // empty
+}
+
+AsyncImageWriter::~AsyncImageWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_jobAdded.notify_all();
+    m_thread.join();
+}
+
+void AsyncImageWriter::Submit(const Image& img, const std::wstring& filePath)
+{
+    Job job;
+    job.m_image = Snapshot(img);
+    job.m_widePath = filePath;
+    Enqueue(std::move(job));
+}
+
+void AsyncImageWriter::Submit(const Image& img, const std::string& filePath)
+{
+    Job job;
+    job.m_image = Snapshot(img);
+    job.m_path = filePath;
+    Enqueue(std::move(job));
+}
+
+void AsyncImageWriter::Submit(Image&& img, const std::wstring& filePath)
+{
+    Job job;
+    job.m_image.reset(new Image(std::move(img)));
+    job.m_widePath = filePath;
+    Enqueue(std::move(job));
+}
+
+void AsyncImageWriter::Submit(Image&& img, const std::string& filePath)
+{
+    Job job;
+    job.m_image.reset(new Image(std::move(img)));
+    job.m_path = filePath;
+    Enqueue(std::move(job));
+}
+
+bool AsyncImageWriter::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobDone.wait(lock, [this]() { return m_jobs.empty() && ! m_isWriting; });
+    const bool isAllWritten = m_numFailedSinceFlush == 0;
+    m_numFailedSinceFlush = 0;
+    return isAllWritten;
+}
+
+Types::U32 AsyncImageWriter::GetNumPending() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<Types::U32>(m_jobs.size()) + (m_isWriting ? 1 : 0);
+}
+
+AsyncImageWriter::Statistic AsyncImageWriter::GetStatistic() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistic;
+}
+
+std::unique_ptr<Image> AsyncImageWriter::Snapshot(const Image& img)
+{
+    if ( ! img.IsValid())
+    {
+        throw std::exception("cannot write an empty image");
+    }
+    if (img.GetStorageFormat() == Image::BYTE_STORAGE)
+    {
+        std::unique_ptr<Image> snapshot(new Image(img.GetWidth(), img.GetHeight(), RGBA::BLACK, Image::BYTE_STORAGE));
+        for (Types::U32 y = 0; y < img.GetHeight(); ++y)
+        {
+            for (Types::U32 x = 0; x < img.GetWidth(); ++x)
+            {
+                snapshot->SetPixel(x, y, img.GetPixel(x, y));
+            }
+        }
+        return snapshot;
+    }
+
+    std::unique_ptr<Image> snapshot(new Image(img.GetWidth(), img.GetHeight()));
+    for (Types::U32 y = 0; y < img.GetHeight(); ++y)
+    {
+        const vector4* srcRow = img.GetFloatRow(y);
+        std::copy(srcRow, srcRow + img.GetWidth(), snapshot->GetFloatRow(y));
+    }
+    return snapshot;
+}
+
+void AsyncImageWriter::Enqueue(Job&& job)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobDone.wait(lock, [this]() { return m_jobs.size() < m_maxPendingImages; });
+    m_statistic.m_blockedMs += std::chrono::duration<Types::F32, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    m_jobs.push_back(std::move(job));
+    lock.unlock();
+    m_jobAdded.notify_one();
+}
+
+void AsyncImageWriter::WriterLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_jobAdded.wait(lock, [this]() { return ! m_jobs.empty() || m_isStopping; });
+        if (m_jobs.empty())
+        {
+            // stopping and all the images are written.
+            return;
+        }
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_isWriting = true;
+        lock.unlock();
+        // a slot of the queue is free.
+        m_jobDone.notify_all();
+
+        const auto startTime = std::chrono::steady_clock::now();
+        bool isWritten = true;
+        try
+        {
+            if (job.m_path.empty())
+            {
+                job.m_image->SaveTo(job.m_widePath);
+            }
+            else
+            {
+                job.m_image->SaveTo(job.m_path);
+            }
+        }
+        catch (const std::exception&)
+        {
+            isWritten = false;
+        }
+        job.m_image.reset();
+        const Types::F32 writeMs = std::chrono::duration<Types::F32, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+        lock.lock();
+        m_isWriting = false;
+        m_statistic.m_writeMs += writeMs;
+        if (isWritten)
+        {
+            ++m_statistic.m_numWritten;
+        }
+        else
+        {
+            ++m_statistic.m_numFailed;
+            ++m_numFailedSinceFlush;
+        }
+        m_jobDone.notify_all();
+    }
+}
+
+}// namespace CommonClass
@@ -0,0 +1,133 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Image.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief AsyncImageWriter save the images to the files on a background thread,
+    so the caller can render the next frame while the previous frame is converted to bytes, compressed and written.
+    Submit() take a snapshot of the image, then the caller is free to modify the image.
+    The queue is bounded, Submit() block while the queue is full (back-pressure), so a fast renderer cannot run out of memory.
+    The files are written in the submitting order, Flush() wait until all the submitted images are written.
+*/
+class AsyncImageWriter
+{
+public:
+    struct Statistic
+    {
+        /*!
+            \brief how many images are written successfully.
+        */
+        Types::U32 m_numWritten = 0;
+
+        /*!
+            \brief how many images are failed to write, e.g. the file cannot be opened.
+        */
+        Types::U32 m_numFailed = 0;
+
+        /*!
+            \brief the time of the background thread to convert, compress and write the images, in milliseconds.
+        */
+        Types::F32 m_writeMs = 0.0f;
+
+        /*!
+            \brief the time of Submit() blocked by the full queue, in milliseconds.
+        */
+        Types::F32 m_blockedMs = 0.0f;
+    };
+
+protected:
+    /*!
+        \brief one of the file paths is empty.
+    */
+    struct Job
+    {
+        std::unique_ptr<Image> m_image;
+        std::wstring m_widePath;
+        std::string m_path;
+    };
+
+    Types::U32 m_maxPendingImages;
+
+    std::deque<Job> m_jobs;
+    bool m_isWriting = false;
+    bool m_isStopping = false;
+
+    /*!
+        \brief the failed writes since the last Flush().
+    */
+    Types::U32 m_numFailedSinceFlush = 0;
+
+    Statistic m_statistic;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_jobAdded;
+    std::condition_variable m_jobDone;
+
+    /*!
+        \brief the background thread, it is the last member so it starts after the others are constructed.
+    */
+    std::thread m_thread;
+
+public:
+    /*!
+        \param maxPendingImages how many images can wait in the queue (not include the one being written), at least one.
+    */
+    explicit AsyncImageWriter(const Types::U32 maxPendingImages = 2);
+    AsyncImageWriter(const AsyncImageWriter&) = delete;
+    AsyncImageWriter& operator=(const AsyncImageWriter&) = delete;
+
+    /*!
+        \brief write all the submitted images, then stop the background thread.
+    */
+    ~AsyncImageWriter();
+
+    /*!
+        \brief copy the float pixels of the image, and queue it to save to the file like Image::SaveTo,
+        block if the queue is full.
+    */
+    void Submit(const Image& img, const std::wstring& filePath);
+    void Submit(const Image& img, const std::string& filePath);
+
+    /*!
+        \brief queue the image without copy, the image is moved into the writer.
+    */
+    void Submit(Image&& img, const std::wstring& filePath);
+    void Submit(Image&& img, const std::string& filePath);
+
+    /*!
+        \brief wait until all the submitted images are written.
+        \return false if any image is failed to write since the last Flush().
+    */
+    bool Flush();
+
+    /*!
+        \brief how many images are submitted but not written.
+    */
+    Types::U32 GetNumPending() const;
+
+    Statistic GetStatistic() const;
+
+protected:
+    /*!
+        \brief copy the float pixels, the byte pixels are converted by the background thread.
+        the image with BYTE_STORAGE is copied pixel by pixel.
+    */
+    static std::unique_ptr<Image> Snapshot(const Image& img);
+
+    /*!
+        \brief wait until the queue is not full, and queue the job.
+    */
+    void Enqueue(Job&& job);
+
+    void WriterLoop();
+};
+
+}// namespace CommonClass
@@ -0,0 +1,150 @@
+#include "BVH.h"
+#include <assert.h>
+#include <algorithm>
+#include <numeric>
+
+namespace CommonClass
+{
+
+BVH::BVH(std::vector<std::shared_ptr<Surface>> surfaces, const Types::U32 maxLeafSize)
+    :m_surfaces(std::move(surfaces)), m_maxLeafSize(std::max(maxLeafSize, 1u))
+{
+    if (m_surfaces.empty())
+    {
+        throw std::exception("build BVH failed: no surface");
+    }
+
+    std::vector<AABB> boxes;
+    boxes.reserve(m_surfaces.size());
+    for (auto & surf : m_surfaces)
+    {
+        boxes.push_back(surf->BoundingBox());
+    }
+
+    // a binary tree with N leaves has at most 2N - 1 nodes.
+    m_nodes.reserve(2 * m_surfaces.size());
+    Build(boxes, 0, static_cast<Types::U32>(m_surfaces.size()));
+}
+
+BVH::~BVH()
+{
+    // empty
+}
+
+bool BVH::Hit(const Ray & ray, const Types::F32 t0, const Types::F32 t1, HitRecord * pHitRec) const
+{
+    assert(pHitRec != nullptr && "argument nullptr error");
+
+    Types::F32 t = t1;
+    bool isHit = false;
+
+    // the inverse direction is computed once for all the nodes.
+    const PrecomputedRay precomputedRay(ray);
+    HitRecord surfHitRec;
+
+    // the tree depth is about log2(N), 64 is enough.
+    Types::U32 stack[64];
+    Types::U32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const Node& node = m_nodes[stack[--stackSize]];
+
+        // see Scene::Hit for why the bounding box test start from 0.0f.
+        if ( ! node.m_box.Hit(precomputedRay, 0.0f, t))
+        {
+            continue;
+        }
+
+        if (node.m_count > 0)
+        {
+            for (Types::U32 i = node.m_start; i < node.m_start + node.m_count; ++i)
+            {
+                if (m_surfaces[i]->Hit(ray, t0, t, &surfHitRec) && surfHitRec.m_hitT < t)
+                {
+                    isHit = true;
+                    t = surfHitRec.m_hitT;
+                    *pHitRec = surfHitRec;
+                }
+            }
+        }
+        else
+        {
+            assert(stackSize + 2 <= 64 && "BVH is too deep");
+            stack[stackSize++] = node.m_rightChild;
+            stack[stackSize++] = static_cast<Types::U32>(&node - m_nodes.data()) + 1;
+        }
+    }
+
+    return isHit;
+}
+
+AABB BVH::BoundingBox() const
+{
+    return m_nodes[0].m_box;
+}
+
+Types::U32 BVH::GetNodeCount() const
+{
+    return static_cast<Types::U32>(m_nodes.size());
+}
+
+Types::U32 BVH::Build(std::vector<AABB>& boxes, const Types::U32 start, const Types::U32 end)
+{
+    const Types::U32 nodeIndex = static_cast<Types::U32>(m_nodes.size());
+    m_nodes.push_back(Node());
+
+    AABB nodeBox = boxes[start];
+    AABB centerBox(boxes[start].Center(), boxes[start].Center());
+    for (Types::U32 i = start + 1; i < end; ++i)
+    {
+        nodeBox.Expand(boxes[i]);
+        const vector3 center = boxes[i].Center();
+        centerBox.Expand(AABB(center, center));
+    }
+    m_nodes[nodeIndex].m_box = nodeBox;
+
+    const Types::U32 count = end - start;
+    if (count <= m_maxLeafSize)
+    {
+        m_nodes[nodeIndex].m_start = start;
+        m_nodes[nodeIndex].m_count = count;
+        return nodeIndex;
+    }
+
+    // split along the longest axis of the centers.
+    const vector3 extent = centerBox.m_maxPoint - centerBox.m_minPoint;
+    unsigned int axis = 0;
+    if (extent.m_y > extent.m_arr[axis]) axis = 1;
+    if (extent.m_z > extent.m_arr[axis]) axis = 2;
+
+    // sort the surfaces and the boxes together by an index array.
+    std::vector<Types::U32> order(count);
+    std::iota(order.begin(), order.end(), start);
+    const Types::U32 mid = count / 2;
+    std::nth_element(order.begin(), order.begin() + mid, order.end(), [&boxes, axis](const Types::U32 a, const Types::U32 b)
+    {
+        return boxes[a].Center().m_arr[axis] < boxes[b].Center().m_arr[axis];
+    });
+
+    std::vector<std::shared_ptr<Surface>> sortedSurfaces;
+    std::vector<AABB> sortedBoxes;
+    sortedSurfaces.reserve(count);
+    sortedBoxes.reserve(count);
+    for (const Types::U32 index : order)
+    {
+        sortedSurfaces.push_back(m_surfaces[index]);
+        sortedBoxes.push_back(boxes[index]);
+    }
+    std::move(sortedSurfaces.begin(), sortedSurfaces.end(), m_surfaces.begin() + start);
+    std::copy(sortedBoxes.begin(), sortedBoxes.end(), boxes.begin() + start);
+
+    // the left child is always the next node.
+    Build(boxes, start, start + mid);
+    m_nodes[nodeIndex].m_rightChild = Build(boxes, start + mid, end);
+
+    return nodeIndex;
+}
+
+} // namespace CommonClass
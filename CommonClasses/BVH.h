@@ -0,0 +1,88 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include "Surface.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief BVH (bounding volume hierarchy) is a binary tree of AABBs over a set of surfaces,
+    a ray only test the surfaces whose boxes on the path from the root to the leaf are hit.
+    BVH itself is a Surface, so it can be used in two level:
+        1. bottom level, build over the primitives (triangles/spheres...) of one object,
+           and shared by many Instance.
+        2. top level, build over the Instances, so only the instances whose bounds are hit will be tested.
+*/
+class BVH
+    : public Surface
+{
+protected:
+    /*!
+        \brief one node in the tree, the left child is always the next node,
+        the right child is m_rightChild, leaf nodes have m_count > 0.
+    */
+    struct Node
+    {
+        AABB        m_box = AABB(vector3(), vector3());
+        Types::U32  m_start = 0;
+        Types::U32  m_count = 0;
+        Types::U32  m_rightChild = 0;
+    };
+
+    /*!
+        \brief the surfaces in the tree, reordered so each leaf owns a continuous range.
+    */
+    std::vector<std::shared_ptr<Surface>> m_surfaces;
+
+    /*!
+        \brief all the nodes, m_nodes[0] is the root.
+    */
+    std::vector<Node> m_nodes;
+
+    /*!
+        \brief the max surfaces in one leaf.
+    */
+    Types::U32 m_maxLeafSize;
+
+public:
+    /*!
+        \brief build the tree over the surfaces.
+        \param surfaces the surfaces to be contained, MUST not be empty.
+        \param maxLeafSize the max surfaces in one leaf.
+        the tree is built by splitting the surfaces at the median of the box centers along the longest axis.
+    */
+    BVH(std::vector<std::shared_ptr<Surface>> surfaces, const Types::U32 maxLeafSize = 2);
+    BVH(const BVH&) = delete;
+    BVH& operator=(const BVH&) = delete;
+    ~BVH();
+
+    /*!
+        \brief find the closest hit of all the surfaces in the tree.
+        \param ray hit ray
+        \param t0 min T value
+        \param t1 max T value
+        \param pHitRec return the hit detail of the closest surface.
+    */
+    virtual bool Hit(const Ray& ray, const Types::F32 t0, const Types::F32 t1, HitRecord* pHitRec) const override;
+
+    /*!
+        \brief the box of the root node.
+    */
+    virtual AABB BoundingBox() const override;
+
+    /*!
+        \brief get how many nodes in the tree.
+    */
+    Types::U32 GetNodeCount() const;
+
+protected:
+    /*!
+        \brief build the subtree for surfaces in [start, end), append the nodes into m_nodes.
+        \param boxes the bounding boxes of m_surfaces, reordered together with m_surfaces.
+        \return the index of the subtree root.
+    */
+    Types::U32 Build(std::vector<AABB>& boxes, const Types::U32 start, const Types::U32 end);
+};
+
+} // namespace CommonClass
@@ -0,0 +1,172 @@
+#include "CascadedShadowMap.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include "Utils/ParallelTool.h"
+
+namespace CommonClass
+{
+
+CascadedShadowMap::CascadedShadowMap(const Types::U32 numCascades /*= MAX_CASCADES*/, const Types::U32 resolution /*= 1024*/)
+    :m_cascades(numCascades == 0 ? 1 : (numCascades < MAX_CASCADES ? numCascades : MAX_CASCADES)),
+    m_resolution(resolution)
+{
+    if (m_resolution < 8)
+    {
+        throw std::exception("the resolution of the shadow map is too small.");
+    }
+
+    Viewport viewport;
+    viewport.left   = 0.0f;
+    viewport.right  = static_cast<Types::F32>(m_resolution - 1);
+    viewport.bottom = 0.0f;
+    viewport.top    = static_cast<Types::F32>(m_resolution - 1);
+
+    for (auto& cascade : m_cascades)
+    {
+        cascade.m_shadowMap = std::make_shared<DepthBuffer>(m_resolution, m_resolution);
+        cascade.m_shadowMap->SetAll(1.0f);
+
+        auto pso = std::make_shared<PiplineStateObject>();
+        pso->m_primitiveType    = PrimitiveType::TRIANGLE_LIST;
+        pso->m_fillMode         = FillMode::SOLIDE;
+        // the open meshes cast shadows from both sides.
+        pso->m_cullFace         = CullFace::NONE;
+        pso->m_isDepthOnly      = true;
+        pso->SetViewport(viewport);
+
+        auto pipline = std::make_unique<Pipline>();
+        pipline->SetPSO(pso);
+        pipline->SetDepthTarget(cascade.m_shadowMap);
+        m_piplines.push_back(std::move(pipline));
+    }
+}
+
+CascadedShadowMap::~CascadedShadowMap()
+{
+    // empty
+}
+
+void CascadedShadowMap::Update(
+    const CameraFrame&  camera,
+    const Types::F32    fovAngleY,
+    const Types::F32    aspectRatio,
+    const Types::F32    near,
+    const Types::F32    far,
+    const vector3&      lightDirection)
+{
+    using Types::F32;
+
+    if ( ! (0.0f < near && near < far))
+    {
+        throw std::exception("the camera range of the cascaded shadow map is invalid.");
+    }
+
+    const Types::U32 numCascades = GetNumCascades();
+    const Transform toWorld = camera.LocalToWorld();
+
+    // the half diagonal of the slice at the distance d is d * diagonalRatio.
+    const F32 tanHalfFov = std::tan(fovAngleY * 0.5f);
+    const F32 diagonalRatio = tanHalfFov * std::sqrt(1.0f + aspectRatio * aspectRatio);
+
+    // the orientation of the light camera is fixed, its origin is the world origin and it looks along the light.
+    const vector3 direction = Normalize(lightDirection);
+    const vector3 lookUp = std::abs(direction.m_y) > 0.99f ? vector3::AXIS_X : vector3::AXIS_Y;
+    const Transform toLightRotation = CameraFrame(vector3::ZERO, direction, lookUp).WorldToLocal();
+
+    for (Types::U32 i = 0; i < numCascades; ++i)
+    {
+        Cascade& cascade = m_cascades[i];
+
+        // practical split scheme.
+        auto splitAt = [&](const Types::U32 index)->F32
+        {
+            const F32 ratio = static_cast<F32>(index) / numCascades;
+            const F32 logSplit = near * std::pow(far / near, ratio);
+            const F32 uniformSplit = near + (far - near) * ratio;
+            return m_splitLambda * logSplit + (1.0f - m_splitLambda) * uniformSplit;
+        };
+        cascade.m_splitNear = i == 0 ? near : splitAt(i);
+        cascade.m_splitFar  = i + 1 == numCascades ? far : splitAt(i + 1);
+
+        // the bounding sphere of the slice, its center is on the view axis and equidistant to the near and the far corners,
+        // it only depends on the split distances, so it's the same size when the camera rotates.
+        const F32 dn = cascade.m_splitNear, df = cascade.m_splitFar;
+        const F32 squareRatio = diagonalRatio * diagonalRatio;
+        const F32 centerDistance = std::min(0.5f * (dn + df) * (1.0f + squareRatio), df);
+        const F32 farHalfDiagonal = df * diagonalRatio;
+        const F32 radius = std::sqrt((df - centerDistance) * (df - centerDistance) + farHalfDiagonal * farHalfDiagonal);
+        const vector4 centerW = toWorld * vector4(0.0f, 0.0f, -centerDistance, 1.0f);
+
+        // reserve one texel at each side, so the snapped square still contains the sphere.
+        const F32 texelWorldSize = 2.0f * radius / (m_resolution - 2);
+        const F32 halfExtent = 0.5f * texelWorldSize * m_resolution;
+
+        // move the light camera by whole texels, the static casters are rasterized to the same texels in every frame.
+        const vector4 centerL = toLightRotation * centerW;
+        const F32 snappedX = std::round(centerL.m_x / texelWorldSize) * texelWorldSize;
+        const F32 snappedY = std::round(centerL.m_y / texelWorldSize) * texelWorldSize;
+        const F32 eyeDistance = radius + m_casterDistance;
+        cascade.m_toLight = Transform::Translation(-snappedX, -snappedY, -centerL.m_z - eyeDistance) * toLightRotation;
+
+        cascade.m_depthRange = eyeDistance + radius;
+        cascade.m_project = Transform::OrthographicTransOG(-halfExtent, halfExtent, -halfExtent, halfExtent, 0.0f, -cascade.m_depthRange);
+        cascade.m_toShadowMap = cascade.m_project * cascade.m_toLight;
+        cascade.m_texelWorldSize = texelWorldSize;
+    }
+}
+
+void CascadedShadowMap::Render(const DrawCascadeFunc& drawCascade, const Types::U32 numThreads /*= 0*/)
+{
+    ParallelTool::ParallelFor(0, GetNumCascades(), [&](const unsigned int i)
+    {
+        Cascade& cascade = m_cascades[i];
+        cascade.m_shadowMap->SetAll(1.0f);
+        drawCascade(*m_piplines[i], cascade);
+        // the samplers read the rows directly.
+        cascade.m_shadowMap->ResolveClearedTiles();
+    }, 1, numThreads);
+}
+
+Types::U32 CascadedShadowMap::SelectCascade(const Types::F32 viewDepth) const
+{
+    Types::U32 index = 0;
+    while (index < GetNumCascades() && viewDepth > m_cascades[index].m_splitFar)
+    {
+        ++index;
+    }
+    return index;
+}
+
+Types::F32 CascadedShadowMap::SampleShadow(const vector3& posW, const vector3& normalW, const Types::F32 viewDepth) const
+{
+    const Types::U32 index = SelectCascade(viewDepth);
+    if (index >= GetNumCascades())
+    {
+        return 1.0f;
+    }
+    const Cascade& cascade = m_cascades[index];
+
+    // push the receiver out of the surface, the offset grows with the texel size of the cascade.
+    vector3 receiver = posW;
+    const Types::F32 normalLength = Length(normalW);
+    if (normalLength > 0.0f)
+    {
+        receiver = receiver + normalW * (m_normalOffset * cascade.m_texelWorldSize / normalLength);
+    }
+
+    // orthographic projection, w is one.
+    const vector4 inShadowMap = cascade.m_toShadowMap * receiver.Tovector4(1.0f);
+    return cascade.m_shadowMap->SampleComparePCF(
+        0.5f + 0.5f * inShadowMap.m_x,
+        0.5f + 0.5f * inShadowMap.m_y,
+        inShadowMap.m_z - m_depthBias / cascade.m_depthRange,
+        m_pcfRadius);
+}
+
+void CascadedShadowMap::SetPCFRadius(const Types::U32 radius)
+{
+    m_pcfRadius = radius < DepthBuffer::PCF_MAX_RADIUS ? radius : DepthBuffer::PCF_MAX_RADIUS;
+}
+
+}// namespace CommonClass
@@ -0,0 +1,151 @@
+#pragma once
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "CameraFrame.h"
+#include "DepthBuffer.h"
+#include "Pipline.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief CascadedShadowMap cover the view frustum of a camera with several orthographic shadow maps of a directional light,
+    the near slices of the frustum get the small cascades with the dense texels, the far slices get the large ones.
+    The split distances mix the logarithmic and the uniform splits (the practical split scheme).
+    Each cascade bound the bounding sphere of its frustum slice, and the light camera moves by whole texels,
+    so the shadow edges don't shimmer when the camera moves or rotates.
+    The cascades are rendered on multiple threads by the depth only pipelines (see PiplineStateObject::m_isDepthOnly),
+    and sampled by DepthBuffer::SampleComparePCF().
+*/
+class CascadedShadowMap
+{
+public:
+    static const Types::U32 MAX_CASCADES = 4;
+
+    /*!
+        \brief one shadow map and the light camera of a frustum slice.
+    */
+    struct Cascade
+    {
+    public:
+        /*!
+            \brief the view depth range of the slice in the camera space, positive distances in front of the camera.
+        */
+        Types::F32 m_splitNear = 0.0f, m_splitFar = 0.0f;
+
+        /*!
+            \brief world to the light camera, and the orthographic projection, the ndc z is 0 at the light camera.
+        */
+        Transform m_toLight;
+        Transform m_project;
+
+        /*!
+            \brief m_project * m_toLight.
+        */
+        Transform m_toShadowMap;
+
+        /*!
+            \brief the world size of one texel, and the world depth of the ndc z range [0, 1].
+        */
+        Types::F32 m_texelWorldSize = 0.0f;
+        Types::F32 m_depthRange = 0.0f;
+
+        /*!
+            \brief the ndc z of the closest casters, 1 where nothing is drawn.
+        */
+        std::shared_ptr<DepthBuffer> m_shadowMap;
+    };
+
+    /*!
+        \brief draw the casters into one cascade, the pipline has the depth target and a depth only PSO with the viewport of the shadow map,
+        the function set the vertex shader (transform by cascade.m_toShadowMap) and the vertex layout, then call DrawInstance().
+        the function is called on multiple threads for different cascades, so it must not share the writable states between the calls.
+    */
+    using DrawCascadeFunc = std::function<void(Pipline& pipline, const Cascade& cascade)>;
+
+protected:
+    std::vector<Cascade> m_cascades;
+    std::vector<std::unique_ptr<Pipline>> m_piplines;
+    Types::U32 m_resolution;
+
+    /*!
+        \brief 0 for the uniform splits, 1 for the logarithmic splits.
+    */
+    Types::F32 m_splitLambda = 0.75f;
+
+    /*!
+        \brief how far the casters behind the slice (toward the light) are still drawn, in the world unit.
+    */
+    Types::F32 m_casterDistance = 20.0f;
+
+    /*!
+        \brief the depth bias in the world unit, and the offset along the normal in texels, both avoid the self shadowing.
+    */
+    Types::F32 m_depthBias = 0.02f;
+    Types::F32 m_normalOffset = 1.5f;
+
+    /*!
+        \brief the kernel radius of DepthBuffer::SampleComparePCF().
+    */
+    Types::U32 m_pcfRadius = 1;
+
+public:
+    /*!
+        \param numCascades in [1, MAX_CASCADES].
+        \param resolution the width and the height of each shadow map.
+    */
+    explicit CascadedShadowMap(const Types::U32 numCascades = MAX_CASCADES, const Types::U32 resolution = 1024);
+    ~CascadedShadowMap();
+
+    /*!
+        \brief fit the cascades to the view frustum.
+        \param camera the camera looks along -w of the frame, the same as ConstantBufferForCamera.
+        \param fovAngleY, aspectRatio, near, far the same as Transform::PerspectiveFOV().
+        \param lightDirection the direction the light travels.
+    */
+    void Update(
+        const CameraFrame&  camera,
+        const Types::F32    fovAngleY,
+        const Types::F32    aspectRatio,
+        const Types::F32    near,
+        const Types::F32    far,
+        const vector3&      lightDirection);
+
+    /*!
+        \brief clear and draw all the cascades, one cascade on each thread.
+        \param numThreads zero for all the hardware threads.
+    */
+    void Render(const DrawCascadeFunc& drawCascade, const Types::U32 numThreads = 0);
+
+    /*!
+        \brief the index of the cascade which contains the view depth, GetNumCascades() if it's beyond the last one.
+    */
+    Types::U32 SelectCascade(const Types::F32 viewDepth) const;
+
+    /*!
+        \brief the lit ratio of a world position, filtered by PCF.
+        \param posW the world position of the receiver
+        \param normalW the world normal of the receiver, which need not be normalized.
+        \param viewDepth the distance in front of the camera, to select the cascade.
+        \return 1 for lit, 0 for fully in shadow, out of the cascades is lit.
+    */
+    Types::F32 SampleShadow(const vector3& posW, const vector3& normalW, const Types::F32 viewDepth) const;
+
+    void SetSplitLambda(const Types::F32 lambda) { m_splitLambda = lambda; }
+    void SetCasterDistance(const Types::F32 distance) { m_casterDistance = distance; }
+    void SetDepthBias(const Types::F32 bias) { m_depthBias = bias; }
+    void SetNormalOffset(const Types::F32 texels) { m_normalOffset = texels; }
+
+    /*!
+        \brief set the PCF kernel radius, in [0, DepthBuffer::PCF_MAX_RADIUS].
+    */
+    void SetPCFRadius(const Types::U32 radius);
+
+    Types::U32 GetNumCascades() const { return static_cast<Types::U32>(m_cascades.size()); }
+    const Cascade& GetCascade(const Types::U32 index) const { return m_cascades[index]; }
+    Types::U32 GetResolution() const { return m_resolution; }
+};
+
+}// namespace CommonClass
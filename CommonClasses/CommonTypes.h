@@ -2,11 +2,18 @@
 #include <limits>
 #include <type_traits>
 
+/*!
+    \brief whether to use SSE in the header-inline math of vector4 and Transform,
+    comment this line to get the plain scalar code.
+*/
+#define USING_SSE_MATH
+
 namespace Types
 {
 
 using F32 = float;
 using I32 = int;
+using I64 = long long;
 using U32 = unsigned int;
 using U8  = unsigned char;
 using I32 = int;
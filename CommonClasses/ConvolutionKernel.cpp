@@ -0,0 +1,482 @@
+#include "ConvolutionKernel.h"
+#include <cmath>
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <mutex>
+#include "FFT.h"
+#include "Utils/ParallelTool.h"
+
+namespace
+{
+
+using CommonClass::vector4;
+using Types::F32;
+using Types::U32;
+
+/*!
+    \brief sum of weights[j * width + i] * pixels[j * rowStride + i * columnStride], all the four channels.
+*/
+inline vector4 WeightedSum(const vector4* pixels, const U32 columnStride, const U32 rowStride, const F32* weights, const U32 width, const U32 height)
+{
+#ifdef USING_SSE_MATH
+    __m128 acc = _mm_setzero_ps();
+    for (U32 j = 0; j < height; ++j)
+    {
+        const vector4* row = pixels + j * rowStride;
+        const F32* rowWeights = weights + j * width;
+        for (U32 i = 0; i < width; ++i)
+        {
+            acc = _mm_add_ps(acc, _mm_mul_ps(CommonClass::LoadSSE(row[i * columnStride]), _mm_set1_ps(rowWeights[i])));
+        }
+    }
+    return CommonClass::StoreSSE(acc);
+#else
+    vector4 acc(0.0f, 0.0f, 0.0f, 0.0f);
+    for (U32 j = 0; j < height; ++j)
+    {
+        const vector4* row = pixels + j * rowStride;
+        const F32* rowWeights = weights + j * width;
+        for (U32 i = 0; i < width; ++i)
+        {
+            for (U32 c = 0; c < 4; ++c)
+            {
+                acc.m_arr[c] += row[i * columnStride].m_arr[c] * rowWeights[i];
+            }
+        }
+    }
+    return acc;
+#endif
+}
+
+/*!
+    \brief the output size of one axis, same as Filter::ConvolutionSize.
+*/
+U32 OutputSize(const U32 imgSize, const U32 kernelSize, const U32 step, const U32 padding)
+{
+    if (imgSize + 2 * padding < kernelSize || step == 0)
+    {
+        throw std::exception("the kernel is larger than the padded image");
+    }
+    return (imgSize + 2 * padding - kernelSize) / step + 1;
+}
+
+/*!
+    \brief the cost of one FFT butterfly relative to one SSE multiply-add of the direct convolution,
+    measured by the ConvolutionKernel case, see ConvolutionKernel::ChoosePath.
+*/
+const double FFT_BUTTERFLY_COST = 3.5;
+
+/*!
+    \brief the largest FFT size to try unless the kernel is larger, each thread hold two tile buffers of size * size complex numbers.
+*/
+const U32 MAX_FFT_SIZE = 1024;
+
+}
+
+namespace CommonClass
+{
+
+struct ConvolutionKernel::SpectrumCache
+{
+    struct Spectrum
+    {
+        FFT fft;
+
+        /*!
+            \brief the conjugate of the kernel spectrum, multiply it to the image spectrum is the correlation with the kernel.
+        */
+        std::vector<FFT::Complex> conjugateKernel;
+
+        explicit Spectrum(const Types::U32 size)
+            :fft(size)
+        {
+            // empty
+        }
+    };
+
+    std::mutex mutex;
+    std::map<Types::U32, std::shared_ptr<const Spectrum>> spectrums;
+};
+
+ConvolutionKernel::ConvolutionKernel(const Types::U32 width, const Types::U32 height, const std::vector<Types::F32>& weights, const Types::U32 step /*= 1*/, const Types::U32 padding /*= 0*/)
+    :m_step(step), m_width(width), m_height(height), m_padding(padding), m_weights(weights),
+    m_spectrumCache(std::make_shared<SpectrumCache>())
+{
+    if (m_weights.size() != m_width * m_height || m_weights.empty())
+    {
+        throw std::exception("the number of weights is not width * height");
+    }
+    Factorize();
+}
+
+ConvolutionKernel::ConvolutionKernel(const std::vector<Types::F32>& horizontal, const std::vector<Types::F32>& vertical, const Types::U32 step /*= 1*/, const Types::U32 padding /*= 0*/)
+    :m_step(step),
+    m_width(static_cast<Types::U32>(horizontal.size())),
+    m_height(static_cast<Types::U32>(vertical.size())),
+    m_padding(padding),
+    m_horizontal(horizontal),
+    m_vertical(vertical),
+    m_spectrumCache(std::make_shared<SpectrumCache>())
+{
+    if (m_horizontal.empty() || m_vertical.empty())
+    {
+        throw std::exception("the 1D kernels cannot be empty");
+    }
+    ExpandWeights();
+}
+
+ConvolutionKernel::~ConvolutionKernel()
+{
+    // empty
+}
+
+ConvolutionKernel ConvolutionKernel::Box(const Types::U32 step, const Types::U32 width, const Types::U32 height, const Types::U32 padding)
+{
+    return ConvolutionKernel(
+        std::vector<Types::F32>(width,  1.0f / width),
+        std::vector<Types::F32>(height, 1.0f / height),
+        step, padding);
+}
+
+ConvolutionKernel ConvolutionKernel::Gaussian(const Types::U32 radius, const Types::F32 sigma)
+{
+    std::vector<Types::F32> weights(2 * radius + 1);
+    Types::F32 sum = 0.0f;
+    for (Types::U32 i = 0; i < weights.size(); ++i)
+    {
+        const Types::F32 d = static_cast<Types::F32>(i) - radius;
+        weights[i] = std::exp(-d * d / (2.0f * sigma * sigma));
+        sum += weights[i];
+    }
+    for (auto& w : weights)
+    {
+        w /= sum;
+    }
+    return ConvolutionKernel(weights, weights, 1, radius);
+}
+
+Image ConvolutionKernel::Convolve(const Image& img) const
+{
+    using namespace Types;
+    const U32 imgWidth  = img.GetWidth();
+    const U32 imgHeight = img.GetHeight();
+    const U32 outWidth  = OutputSize(imgWidth,  m_width,  m_step, m_padding);
+    const U32 outHeight = OutputSize(imgHeight, m_height, m_step, m_padding);
+
+    // only the pixels touched by the kernel are padded, the padding pixels are zero.
+    const U32 padWidth  = (outWidth  - 1) * m_step + m_width;
+    const U32 padHeight = (outHeight - 1) * m_step + m_height;
+    std::vector<vector4> padded(padWidth * padHeight, vector4(0.0f, 0.0f, 0.0f, 0.0f));
+    ParallelTool::ParallelFor(0, padHeight, [&](const unsigned int py)
+    {
+        const I32 srcY = static_cast<I32>(py) - static_cast<I32>(m_padding);
+        if (srcY < 0 || srcY >= static_cast<I32>(imgHeight))
+        {
+            return;
+        }
+        const U32 beginX = m_padding;
+        const U32 endX = std::min(padWidth, imgWidth + m_padding);
+        for (U32 px = beginX; px < endX; ++px)
+        {
+            padded[py * padWidth + px] = img.GetPixel(px - m_padding, srcY);
+        }
+    }, 16, m_numThreads);
+
+    Image result(outWidth, outHeight, RGBA::BLACK);
+    switch (ChoosePath(imgWidth, imgHeight))
+    {
+    case SEPARABLE_PATH:
+        ConvolveSeparable(padded, padWidth, padHeight, result);
+        break;
+    case FFT_PATH:
+        ConvolveFFT(padded, padWidth, padHeight, result);
+        break;
+    default:
+        ConvolveDirect(padded, padWidth, result);
+        break;
+    }
+    return result;
+}
+
+bool ConvolutionKernel::IsSeparable() const
+{
+    return ! m_horizontal.empty();
+}
+
+ConvolutionKernel::ConvolutionPath ConvolutionKernel::ChoosePath(const Types::U32 imgWidth, const Types::U32 imgHeight) const
+{
+    using namespace Types;
+    if (m_path == SEPARABLE_PATH)
+    {
+        return IsSeparable() ? SEPARABLE_PATH : DIRECT_PATH;
+    }
+    if (m_path != AUTO_PATH)
+    {
+        return m_path;
+    }
+
+    const U32 outWidth  = OutputSize(imgWidth,  m_width,  m_step, m_padding);
+    const U32 outHeight = OutputSize(imgHeight, m_height, m_step, m_padding);
+    const U32 padWidth  = (outWidth  - 1) * m_step + m_width;
+    const U32 padHeight = (outHeight - 1) * m_step + m_height;
+
+    // the multiply-add count of each path.
+    const double directCost = static_cast<double>(outWidth) * outHeight * m_width * m_height;
+    double bestCost = directCost;
+    ConvolutionPath bestPath = DIRECT_PATH;
+    if (IsSeparable())
+    {
+        const double separableCost = static_cast<double>(outWidth) * (padHeight * m_width + outHeight * m_height);
+        if (separableCost < bestCost)
+        {
+            bestCost = separableCost;
+            bestPath = SEPARABLE_PATH;
+        }
+    }
+    double fftCost = 0.0;
+    ChooseFFTSize(padWidth, padHeight, fftCost);
+    if (fftCost * FFT_BUTTERFLY_COST < bestCost)
+    {
+        bestPath = FFT_PATH;
+    }
+    return bestPath;
+}
+
+Types::U32 ConvolutionKernel::ChooseFFTSize(const Types::U32 padWidth, const Types::U32 padHeight, double& outCost) const
+{
+    using namespace Types;
+    const U32 fullWidth  = padWidth  - m_width  + 1;
+    const U32 fullHeight = padHeight - m_height + 1;
+
+    // larger tile has more valid pixels for each transformed pixel, but the cost of each transformed pixel grow by log(size),
+    // and the tiles larger than the image are wasted.
+    U32 bestSize = 0;
+    outCost = 0.0;
+    const U32 minSize = FFT::NextPowerOfTwo(std::max(m_width, m_height) + 1);
+    const U32 maxSize = std::max(MAX_FFT_SIZE, minSize);
+    for (U32 size = minSize; size <= maxSize; size *= 2)
+    {
+        U32 log2Size = 0;
+        while ((1u << log2Size) < size)
+        {
+            ++log2Size;
+        }
+        const U32 tileWidth  = size - m_width  + 1;
+        const U32 tileHeight = size - m_height + 1;
+        const double numTiles = static_cast<double>((fullWidth + tileWidth - 1) / tileWidth) * ((fullHeight + tileHeight - 1) / tileHeight);
+        // two complex buffers for the four channels, forward and inverse, size * log2(size) butterflies for each 2D transform.
+        const double cost = numTiles * 4.0 * size * size * log2Size;
+        if (bestSize == 0 || cost < outCost)
+        {
+            bestSize = size;
+            outCost = cost;
+        }
+        if (tileWidth >= fullWidth && tileHeight >= fullHeight)
+        {
+            break;
+        }
+    }
+    return bestSize;
+}
+
+void ConvolutionKernel::ConvolveDirect(const std::vector<vector4>& padded, const Types::U32 padWidth, Image& result) const
+{
+    using namespace Types;
+    const U32 outWidth = result.GetWidth();
+    ParallelTool::ParallelFor(0, result.GetHeight(), [&](const unsigned int y)
+    {
+        for (U32 x = 0; x < outWidth; ++x)
+        {
+            const vector4* window = &padded[y * m_step * padWidth + x * m_step];
+            const vector4 sum = WeightedSum(window, 1, padWidth, m_weights.data(), m_width, m_height);
+            result.SetPixel(x, y, sum);
+        }
+    }, 4, m_numThreads);
+}
+
+void ConvolutionKernel::ConvolveSeparable(const std::vector<vector4>& padded, const Types::U32 padWidth, const Types::U32 padHeight, Image& result) const
+{
+    using namespace Types;
+    const U32 outWidth  = result.GetWidth();
+    const U32 outHeight = result.GetHeight();
+
+    // horizontal pass, all the padded rows, only the output columns.
+    std::vector<vector4> horizontalPass(padHeight * outWidth);
+    ParallelTool::ParallelFor(0, padHeight, [&](const unsigned int py)
+    {
+        const vector4* srcRow = &padded[py * padWidth];
+        vector4* dstRow = &horizontalPass[py * outWidth];
+        for (U32 x = 0; x < outWidth; ++x)
+        {
+            dstRow[x] = WeightedSum(srcRow + x * m_step, 1, 0, m_horizontal.data(), m_width, 1);
+        }
+    }, 8, m_numThreads);
+
+    // vertical pass.
+    ParallelTool::ParallelFor(0, outHeight, [&](const unsigned int y)
+    {
+        const vector4* srcColumnsHead = &horizontalPass[y * m_step * outWidth];
+        for (U32 x = 0; x < outWidth; ++x)
+        {
+            result.SetPixel(x, y, WeightedSum(srcColumnsHead + x, outWidth, 0, m_vertical.data(), m_height, 1));
+        }
+    }, 8, m_numThreads);
+}
+
+void ConvolutionKernel::ConvolveFFT(const std::vector<vector4>& padded, const Types::U32 padWidth, const Types::U32 padHeight, Image& result) const
+{
+    using namespace Types;
+    using Complex = FFT::Complex;
+    double cost = 0.0;
+    const U32 size = ChooseFFTSize(padWidth, padHeight, cost);
+
+    // get the kernel spectrum of the size, or compute it.
+    std::shared_ptr<const SpectrumCache::Spectrum> spectrum;
+    {
+        std::lock_guard<std::mutex> lock(m_spectrumCache->mutex);
+        auto& cached = m_spectrumCache->spectrums[size];
+        if ( ! cached)
+        {
+            auto newSpectrum = std::make_shared<SpectrumCache::Spectrum>(size);
+            std::vector<Complex>& kernel = newSpectrum->conjugateKernel;
+            kernel.assign(size * size, Complex(0.0f, 0.0f));
+            for (U32 j = 0; j < m_height; ++j)
+            {
+                for (U32 i = 0; i < m_width; ++i)
+                {
+                    kernel[j * size + i] = Complex(m_weights[j * m_width + i], 0.0f);
+                }
+            }
+            newSpectrum->fft.Forward2D(kernel.data());
+            for (auto& k : kernel)
+            {
+                k = std::conj(k);
+            }
+            cached = newSpectrum;
+        }
+        spectrum = cached;
+    }
+
+    // overlap-save: the circular correlation of a size * size tile is correct for the first (size - kernel size + 1) pixels of each axis,
+    // so each tile write its own output pixels, and the tiles need no lock.
+    const U32 fullWidth  = padWidth  - m_width  + 1;
+    const U32 fullHeight = padHeight - m_height + 1;
+    const U32 tileWidth  = size - m_width  + 1;
+    const U32 tileHeight = size - m_height + 1;
+    const U32 numTilesX = (fullWidth  + tileWidth  - 1) / tileWidth;
+    const U32 numTilesY = (fullHeight + tileHeight - 1) / tileHeight;
+    const Complex* conjugateKernel = spectrum->conjugateKernel.data();
+    ParallelTool::ParallelFor(0, numTilesX * numTilesY, [&](const unsigned int tileIndex)
+    {
+        const U32 originX = (tileIndex % numTilesX) * tileWidth;
+        const U32 originY = (tileIndex / numTilesX) * tileHeight;
+
+        // the real kernel convolve the real and imaginary parts separately, so (r + g * i) and (b + a * i) need only two transforms.
+        std::vector<Complex> redGreen(size * size, Complex(0.0f, 0.0f)), blueAlpha(size * size, Complex(0.0f, 0.0f));
+        const U32 copyWidth  = std::min(size, padWidth  - originX);
+        const U32 copyHeight = std::min(size, padHeight - originY);
+        for (U32 j = 0; j < copyHeight; ++j)
+        {
+            const vector4* srcRow = &padded[(originY + j) * padWidth + originX];
+            for (U32 i = 0; i < copyWidth; ++i)
+            {
+                redGreen [j * size + i] = Complex(srcRow[i].m_x, srcRow[i].m_y);
+                blueAlpha[j * size + i] = Complex(srcRow[i].m_z, srcRow[i].m_w);
+            }
+        }
+
+        for (auto* buffer : { &redGreen, &blueAlpha })
+        {
+            Complex* data = buffer->data();
+            spectrum->fft.Forward2D(data);
+            for (U32 k = 0; k < size * size; ++k)
+            {
+                const F32 ar = data[k].real(), ai = data[k].imag();
+                const F32 br = conjugateKernel[k].real(), bi = conjugateKernel[k].imag();
+                data[k] = Complex(ar * br - ai * bi, ar * bi + ai * br);
+            }
+            spectrum->fft.Inverse2D(data);
+        }
+
+        // only the output pixels on the step grid are kept.
+        const U32 endX = std::min(tileWidth,  fullWidth  - originX);
+        const U32 endY = std::min(tileHeight, fullHeight - originY);
+        for (U32 j = 0; j < endY; ++j)
+        {
+            const U32 fullY = originY + j;
+            if (fullY % m_step != 0)
+            {
+                continue;
+            }
+            for (U32 i = 0; i < endX; ++i)
+            {
+                const U32 fullX = originX + i;
+                if (fullX % m_step != 0)
+                {
+                    continue;
+                }
+                const Complex& rg = redGreen [j * size + i];
+                const Complex& ba = blueAlpha[j * size + i];
+                result.SetPixel(fullX / m_step, fullY / m_step, vector4(rg.real(), rg.imag(), ba.real(), ba.imag()));
+            }
+        }
+    }, 1, m_numThreads);
+}
+
+void ConvolutionKernel::Factorize()
+{
+    m_horizontal.clear();
+    m_vertical.clear();
+
+    // the largest weight as the pivot, then weight(i, j) should be weight(i, pivotJ) * weight(pivotI, j) / pivot.
+    const auto pivotIter = std::max_element(m_weights.begin(), m_weights.end(),
+        [](const Types::F32 a, const Types::F32 b) { return std::abs(a) < std::abs(b); });
+    const Types::F32 pivot = *pivotIter;
+    if (pivot == 0.0f)
+    {
+        return;
+    }
+    const Types::U32 pivotIndex = static_cast<Types::U32>(pivotIter - m_weights.begin());
+    const Types::U32 pivotI = pivotIndex % m_width;
+    const Types::U32 pivotJ = pivotIndex / m_width;
+
+    std::vector<Types::F32> horizontal(m_width), vertical(m_height);
+    for (Types::U32 i = 0; i < m_width; ++i)
+    {
+        horizontal[i] = m_weights[pivotJ * m_width + i] / pivot;
+    }
+    for (Types::U32 j = 0; j < m_height; ++j)
+    {
+        vertical[j] = m_weights[j * m_width + pivotI];
+    }
+
+    const Types::F32 tolerance = std::abs(pivot) * 1e-6f;
+    for (Types::U32 j = 0; j < m_height; ++j)
+    {
+        for (Types::U32 i = 0; i < m_width; ++i)
+        {
+            if (std::abs(horizontal[i] * vertical[j] - m_weights[j * m_width + i]) > tolerance)
+            {
+                return;
+            }
+        }
+    }
+
+    m_horizontal = std::move(horizontal);
+    m_vertical = std::move(vertical);
+}
+
+void ConvolutionKernel::ExpandWeights()
+{
+    m_weights.resize(m_width * m_height);
+    for (Types::U32 j = 0; j < m_height; ++j)
+    {
+        for (Types::U32 i = 0; i < m_width; ++i)
+        {
+            m_weights[j * m_width + i] = m_horizontal[i] * m_vertical[j];
+        }
+    }
+}
+
+}// namespace CommonClass
@@ -0,0 +1,166 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include "Image.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief ConvolutionKernel convolve a image with a weighted kernel, it has the same step/size/padding rule as the Filter,
+    the output pixel (x, y) = sum of weight(i, j) * pixel(x * step - padding + i, y * step - padding + j),
+    the pixels out of the image are zero.
+    Instead of the per pixel virtual calls of the Filter, the image is copied into a zero padded float buffer once,
+    so the inner loops have no boundary branch, and the rows are convolved on multiple threads.
+    If the weights is the outer product of a vertical and a horizontal vector (e.g. box and gaussian),
+    the image is convolved by two 1D passes, which cost (width + height) instead of (width * height) taps for each pixel.
+    The large non-separable kernels are convolved in the frequency domain, see FFT_PATH.
+    All the four channels (include alpha) are convolved, one SSE instruction for the four channels with USING_SSE_MATH.
+*/
+class ConvolutionKernel
+{
+public:
+    /*!
+        \brief the ways to convolve the image, all of them have the same result (except the float rounding).
+    */
+    enum ConvolutionPath
+    {
+        /*!
+            \brief choose the cheapest path by the kernel size and the image size, see ChoosePath.
+        */
+        AUTO_PATH,
+
+        /*!
+            \brief width * height taps for each output pixel.
+        */
+        DIRECT_PATH,
+
+        /*!
+            \brief a horizontal and a vertical 1D pass, fall back to DIRECT_PATH if the kernel is not separable.
+        */
+        SEPARABLE_PATH,
+
+        /*!
+            \brief overlap-save tiles of the padded image are transformed by 2D FFT, multiplied by the cached kernel spectrum
+            and transformed back, the cost of each pixel is O(log(tile size)) no matter how large the kernel is.
+            The tiles are convolved on multiple threads, the four channels are packed into two complex FFTs.
+        */
+        FFT_PATH
+    };
+
+    /*!
+        \brief how many threads to convolve rows, zero for all the hardware threads.
+    */
+    Types::U32 m_numThreads = 0;
+
+    /*!
+        \brief the path to convolve the image, AUTO_PATH by default.
+    */
+    ConvolutionPath m_path = AUTO_PATH;
+
+protected:
+    Types::U32 m_step       = 1;
+    Types::U32 m_width      = 3;
+    Types::U32 m_height     = 3;
+    Types::U32 m_padding    = 0;
+
+    /*!
+        \brief the weights of the kernel, m_weights[j * m_width + i] is the weight of the tap (i, j) from the bottom left.
+    */
+    std::vector<Types::F32> m_weights;
+
+    /*!
+        \brief weight(i, j) = m_horizontal[i] * m_vertical[j], both are empty if the kernel is not separable.
+    */
+    std::vector<Types::F32> m_horizontal;
+    std::vector<Types::F32> m_vertical;
+
+    /*!
+        \brief the kernel spectrums of each FFT size, they are computed by the first FFT convolution of that size,
+        the copies of the kernel share the cache because the weights never change.
+    */
+    struct SpectrumCache;
+    std::shared_ptr<SpectrumCache> m_spectrumCache;
+
+public:
+    /*!
+        \brief create a kernel from the 2D weights, the kernel is factorized if it is separable.
+        \param weights width * height weights, row by row from the bottom, throw if the size is not match.
+    */
+    ConvolutionKernel(
+        const Types::U32 width,
+        const Types::U32 height,
+        const std::vector<Types::F32>& weights,
+        const Types::U32 step = 1,
+        const Types::U32 padding = 0);
+
+    /*!
+        \brief create a separable kernel, weight(i, j) = horizontal[i] * vertical[j].
+    */
+    ConvolutionKernel(
+        const std::vector<Types::F32>& horizontal,
+        const std::vector<Types::F32>& vertical,
+        const Types::U32 step = 1,
+        const Types::U32 padding = 0);
+
+    ~ConvolutionKernel();
+
+    /*!
+        \brief the average of width * height pixels, same as Filter(step, width, height, padding).
+    */
+    static ConvolutionKernel Box(const Types::U32 step, const Types::U32 width, const Types::U32 height, const Types::U32 padding);
+
+    /*!
+        \brief the normalized gaussian kernel of (2 * radius + 1)^2 taps, the padding is the radius so the output has the same size as the input.
+    */
+    static ConvolutionKernel Gaussian(const Types::U32 radius, const Types::F32 sigma);
+
+    /*!
+        \brief convolve the image and return a new image, the channels are clamped to [0, 1] like Image::SetPixel.
+        throw if the kernel is larger than the padded image.
+    */
+    Image Convolve(const Image& img) const;
+
+    /*!
+        \brief whether the kernel is the outer product of two 1D kernels.
+    */
+    bool IsSeparable() const;
+
+    /*!
+        \brief the path used to convolve a imgWidth * imgHeight image, it is m_path unless m_path is AUTO_PATH or
+        SEPARABLE_PATH of a non-separable kernel.
+        AUTO_PATH estimate the multiply-add count of each path and choose the cheapest one,
+        e.g. the FFT is faster than the direct convolution for the non-separable kernels larger than about 13 * 13 on a 320 * 240 image.
+    */
+    ConvolutionPath ChoosePath(const Types::U32 imgWidth, const Types::U32 imgHeight) const;
+
+    Types::U32 GetWidth() const { return m_width; }
+    Types::U32 GetHeight() const { return m_height; }
+
+protected:
+    /*!
+        \brief the FFT size with the least cost to convolve the padded image of padWidth * padHeight,
+        the cost (multiply-add count of the transforms) is returned by outCost.
+    */
+    Types::U32 ChooseFFTSize(const Types::U32 padWidth, const Types::U32 padHeight, double& outCost) const;
+
+    /*!
+        \brief the three paths, write the output pixels to the result.
+        \param padded the zero padded image of padWidth * padHeight pixels.
+    */
+    void ConvolveDirect(const std::vector<vector4>& padded, const Types::U32 padWidth, Image& result) const;
+    void ConvolveSeparable(const std::vector<vector4>& padded, const Types::U32 padWidth, const Types::U32 padHeight, Image& result) const;
+    void ConvolveFFT(const std::vector<vector4>& padded, const Types::U32 padWidth, const Types::U32 padHeight, Image& result) const;
+
+    /*!
+        \brief try to decompose m_weights to m_horizontal and m_vertical.
+    */
+    void Factorize();
+
+    /*!
+        \brief the 2D weights of the separable kernel.
+    */
+    void ExpandWeights();
+};
+
+}// namespace CommonClass
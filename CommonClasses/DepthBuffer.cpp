@@ -1,5 +1,10 @@
 #include "DepthBuffer.h"
+#include <algorithm>
+#include <cmath>
 #include "assert.h"
+#ifdef USING_SSE_MATH
+#include <xmmintrin.h>
+#endif
 
 namespace CommonClass
 {
@@ -9,6 +14,7 @@ DepthBuffer::DepthBuffer(const Types::U32 width, const Types::U32 height)
 {
     assert(m_width * m_height != 0);
     m_pBuffer = new Types::F32[m_width * m_height];
+    m_clearTiles.Init(m_width, m_height);
     SetAll(0.0f);
 }
 
@@ -16,6 +22,8 @@ DepthBuffer::DepthBuffer(DepthBuffer && moveObj)
 {
     this->m_height = moveObj.m_height;
     this->m_width = moveObj.m_width;
+    this->m_clearTiles = std::move(moveObj.m_clearTiles);
+    this->m_clearValue = moveObj.m_clearValue;
 
     assert(moveObj.m_pBuffer);
     this->m_pBuffer = moveObj.m_pBuffer;
@@ -34,21 +42,138 @@ DepthBuffer::~DepthBuffer()
 const Types::F32 DepthBuffer::ValueAt(const Types::U32 x, const Types::U32 y) const
 {
     assert(x < m_width && y < m_height);
+    if (m_clearTiles.IsPending(x, y))
+    {
+        return m_clearValue;
+    }
     return m_pBuffer[x + m_width * y];
 }
 
+void DepthBuffer::ResolveClearedTiles()
+{
+    m_clearTiles.ResolveAll([this](const Types::U32 left, const Types::U32 bottom, const Types::U32 right, const Types::U32 top)
+    {
+        for (Types::U32 row = bottom; row < top; ++row)
+        {
+            std::fill(m_pBuffer + row * m_width + left, m_pBuffer + row * m_width + right, m_clearValue);
+        }
+    });
+}
+
 Types::F32 & DepthBuffer::Value(const Types::U32 x, const Types::U32 y)
 {
     assert(x < m_width && y < m_height);
+    m_clearTiles.Resolve(x, y, [this](const Types::U32 left, const Types::U32 bottom, const Types::U32 right, const Types::U32 top)
+    {
+        for (Types::U32 row = bottom; row < top; ++row)
+        {
+            std::fill(m_pBuffer + row * m_width + left, m_pBuffer + row * m_width + right, m_clearValue);
+        }
+    });
     return m_pBuffer[x + m_width * y];
 }
 
 void DepthBuffer::SetAll(const Types::F32 val)
 {
-    for (Types::U32 i = 0; i < m_width * m_height; ++i)
+    // the tiles are filled later, only if they are used.
+    m_clearValue = val;
+    m_clearTiles.MarkAll();
+}
+
+Types::F32 DepthBuffer::SampleCompare(const Types::F32 u, const Types::F32 v, const Types::F32 compareValue) const
+{
+    if ( ! (0.0f <= u && u <= 1.0f && 0.0f <= v && v <= 1.0f))
+    {
+        return 1.0f;
+    }
+    // the pixel (x, y) cover [x, x + 1) / width, u = 1 is in the last pixel.
+    const Types::U32 x = std::min(static_cast<Types::U32>(u * m_width),  m_width - 1);
+    const Types::U32 y = std::min(static_cast<Types::U32>(v * m_height), m_height - 1);
+    return compareValue <= ValueAt(x, y) ? 1.0f : 0.0f;
+}
+
+Types::F32 DepthBuffer::SampleComparePCF(const Types::F32 u, const Types::F32 v, const Types::F32 compareValue, const Types::U32 kernelRadius) const
+{
+    using Types::I32;
+    using Types::F32;
+    assert(kernelRadius <= PCF_MAX_RADIUS);
+
+    if ( ! (0.0f <= u && u <= 1.0f && 0.0f <= v && v <= 1.0f))
+    {
+        return 1.0f;
+    }
+
+    // the texel centers are at (x + 0.5) / width.
+    const F32 tx = u * m_width  - 0.5f;
+    const F32 ty = v * m_height - 0.5f;
+    const F32 floorX = std::floor(tx), floorY = std::floor(ty);
+    const F32 fracX = tx - floorX, fracY = ty - floorY;
+    const I32 radius = static_cast<I32>(kernelRadius);
+    const I32 kernelSize = 2 * radius + 2;
+    const I32 left   = static_cast<I32>(floorX) - radius;
+    const I32 bottom = static_cast<I32>(floorY) - radius;
+
+    // the weights of the columns, zero for the lanes out of the kernel.
+    alignas(16) F32 columnWeights[8] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    for (I32 i = 0; i < kernelSize; ++i)
+    {
+        columnWeights[i] = i == 0 ? 1.0f - fracX : (i == kernelSize - 1 ? fracX : 1.0f);
+    }
+
+    // read the whole rows directly, when the 8 lanes are in the buffer and no tile is pending.
+    const bool isDirect = left >= 0 && left + 8 <= static_cast<I32>(m_width)
+        && bottom >= 0 && bottom + kernelSize <= static_cast<I32>(m_height)
+        && ! m_clearTiles.HasPendingTiles();
+
+    alignas(16) F32 rowValues[8];
+    F32 litSum = 0.0f;
+#ifdef USING_SSE_MATH
+    const __m128 compare  = _mm_set1_ps(compareValue);
+    const __m128 weights0 = _mm_load_ps(columnWeights);
+    const __m128 weights1 = _mm_load_ps(columnWeights + 4);
+    __m128 sum = _mm_setzero_ps();
+#endif
+    for (I32 j = 0; j < kernelSize; ++j)
     {
-        m_pBuffer[i] = val;
+        const F32 rowWeight = j == 0 ? 1.0f - fracY : (j == kernelSize - 1 ? fracY : 1.0f);
+        const F32 * pRow = nullptr;
+        if (isDirect)
+        {
+            pRow = m_pBuffer + (bottom + j) * m_width + left;
+        }
+        else
+        {
+            const Types::U32 y = static_cast<Types::U32>(std::min(std::max(bottom + j, 0), static_cast<I32>(m_height) - 1));
+            for (I32 i = 0; i < 8; ++i)
+            {
+                const Types::U32 x = static_cast<Types::U32>(std::min(std::max(left + i, 0), static_cast<I32>(m_width) - 1));
+                rowValues[i] = i < kernelSize ? ValueAt(x, y) : 0.0f;
+            }
+            pRow = rowValues;
+        }
+
+#ifdef USING_SSE_MATH
+        // lit lanes are all ones, select the weights of them.
+        const __m128 lit0 = _mm_and_ps(_mm_cmple_ps(compare, _mm_loadu_ps(pRow)),     weights0);
+        const __m128 lit1 = _mm_and_ps(_mm_cmple_ps(compare, _mm_loadu_ps(pRow + 4)), weights1);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_add_ps(lit0, lit1), _mm_set1_ps(rowWeight)));
+#else
+        F32 rowSum = 0.0f;
+        for (I32 i = 0; i < kernelSize; ++i)
+        {
+            rowSum += compareValue <= pRow[i] ? columnWeights[i] : 0.0f;
+        }
+        litSum += rowSum * rowWeight;
+#endif
     }
+
+#ifdef USING_SSE_MATH
+    alignas(16) F32 lanes[4];
+    _mm_store_ps(lanes, sum);
+    litSum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+    const F32 kernelArea = static_cast<F32>((kernelSize - 1) * (kernelSize - 1));
+    return std::min(litSum / kernelArea, 1.0f);
 }
 
 Image ToImage(const DepthBuffer & buffer, Types::F32 maxValue)
@@ -1,5 +1,6 @@
 #pragma once
 #include "CommonTypes.h"
+#include "FastClearTiles.h"
 #include "Image.h"
 
 #include <functional>
@@ -29,6 +30,12 @@ protected:
     */
     Types::U32 m_width, m_height;
 
+    /*!
+        \brief the tiles set by SetAll() but not written yet, and the value of them.
+    */
+    FastClearTiles m_clearTiles;
+    Types::F32 m_clearValue;
+
 public:
     DepthBuffer(const Types::U32 width, const Types::U32 height);
     DepthBuffer(const DepthBuffer &) = delete;
@@ -46,7 +53,7 @@ public:
     const Types::F32 ValueAt(const Types::U32 x, const Types::U32 y) const;
     
     /*!
-        \brief get value and ready to change it.
+        \brief get value and ready to change it, the cleared tile of the value is filled here.
         \param x start from zero to WIDTH - 1, and locate from left to right
         \param y start from zero to HEIGHT - 1, locate from bottom to top
         for example (0, 0) reference to the bottom left corner,
@@ -56,9 +63,43 @@ public:
 
     /*!
         \brief set all float to be the same value.
+        the values are not written here, the tiles are marked as cleared, see FastClearTiles.
     */
     void SetAll(const Types::F32 val);
 
+    /*!
+        \brief the shadow compare sampler of a depth target, which store the ndc z (see PiplineStateObject::m_isDepthOnly).
+        \param u,v the texture coordinate in [0, 1], (0, 0) is the bottom left corner, the nearest value is used.
+        \param compareValue the ndc z of the receiver in the same space.
+        \return 1 if lit (compareValue <= stored value), 0 if in shadow, out of [0, 1] is lit.
+    */
+    Types::F32 SampleCompare(const Types::F32 u, const Types::F32 v, const Types::F32 compareValue) const;
+
+    /*!
+        \brief the percentage closer filtering version of SampleCompare(),
+        the texels of a (2 * kernelRadius + 2) square around (u, v) are compared, and weighted by the bilinear weights at the border,
+        so the result is the lit ratio of a (2 * kernelRadius + 1) texel box filter which is smooth in (u, v).
+        one row of the kernel is compared by two SSE compares, the texels out of the buffer clamp to the edge.
+        \param kernelRadius in [0, PCF_MAX_RADIUS], zero is the 2 * 2 bilinear compare.
+        \return the lit ratio in [0, 1], out of [0, 1] is lit.
+    */
+    Types::F32 SampleComparePCF(const Types::F32 u, const Types::F32 v, const Types::F32 compareValue, const Types::U32 kernelRadius) const;
+
+    /*!
+        \brief the max kernelRadius of SampleComparePCF(), a row of the kernel has 8 texels at most.
+    */
+    static const Types::U32 PCF_MAX_RADIUS = 3;
+
+    /*!
+        \brief fill all the tiles cleared by SetAll(), so the samplers read the values directly.
+    */
+    void ResolveClearedTiles();
+
+    /*!
+        \brief the tiles cleared by SetAll() but not written yet.
+    */
+    const FastClearTiles& GetClearTiles() const { return m_clearTiles; }
+
     Types::U32 GetWidth() const { return m_width; }
 
     Types::U32 GetHeight() const { return m_height; }
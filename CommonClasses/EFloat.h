@@ -1,8 +1,20 @@
 #pragma once
 #include "CommonTypes.h"
 #include <ostream>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <algorithm>
 
+/*!
+    \brief EFLOAT_DEBUG make every EFloat track its precise value in a long double,
+    and check the error bound after each operation, it's very slow.
+    It's on in the debug build, and can be forced on by defining EFLOAT_DEBUG in the compiler options
+    (the CMake option EFLOAT_DEBUG of CommonClass), or forced off by defining EFLOAT_NO_DEBUG.
+*/
+#if defined(_DEBUG) && !defined(EFLOAT_NO_DEBUG) && !defined(EFLOAT_DEBUG)
 #define EFLOAT_DEBUG
+#endif
 
 
 /*!
@@ -33,14 +45,14 @@ constexpr float gamma(const int n)
     \param f the 4 bytes floating point number
     \return the unsigned int type of the float.
 */
-Types::U32 FloatToBits(const Types::F32 & f);
+inline Types::U32 FloatToBits(const Types::F32 & f);
 
 /*!
     \brief copy bits data from uint32 to construct a float
     \param u the uint32 number, maybe the return value of FloatToBits
     \return the float number of the same data bits
 */
-Types::F32 BitsToFloat(const Types::U32 & u);
+inline Types::F32 BitsToFloat(const Types::U32 & u);
 
 /*!
     \brief find the nearest float greater than the parameter
@@ -48,7 +60,7 @@ Types::F32 BitsToFloat(const Types::U32 & u);
     \return if f is +inf ,return +inf
             the -0.0 is same as 0.0, and will return a positive number
 */
-Types::F32 NextFloatUp(Types::F32 f);
+inline Types::F32 NextFloatUp(Types::F32 f);
 
 /*!
     \brief find the nearest float less than the parameter
@@ -56,7 +68,7 @@ Types::F32 NextFloatUp(Types::F32 f);
     \return if f is -inf ,return -inf
             the -0.0 is same as 0.0, and will return a negative number
 */
-Types::F32 NextFloatDown(Types::F32 f);
+inline Types::F32 NextFloatDown(Types::F32 f);
 
 /*!
     \brief EFloat is for error float,
@@ -126,36 +138,37 @@ public:
     friend EFloat abs        (const EFloat& ef1);
     friend EFloat sqrt       (const EFloat& ef);
     friend std::ostream& operator << (std::ostream& out, const EFloat& ef);
+    friend class EFloat4;
 };
 
 /*!
     \brief plus operation test
     \param ef1, ef2 operate numbers
 */
-EFloat operator + (const EFloat& ef1, const EFloat& ef2);
+inline EFloat operator + (const EFloat& ef1, const EFloat& ef2);
 
 /*!
     \brief minus operation test
     \param ef1, ef2 operate numbers
 */
-EFloat operator - (const EFloat& ef1, const EFloat& ef2);
+inline EFloat operator - (const EFloat& ef1, const EFloat& ef2);
 
 /*!
     \brief multiply operation test
     \param ef1, ef2 operate numbers
 */
-EFloat operator * (const EFloat& ef1, const EFloat& ef2);
+inline EFloat operator * (const EFloat& ef1, const EFloat& ef2);
 
 /*!
     \brief divide operation test
     \param ef1, ef2 operate numbers
 */
-EFloat operator / (const EFloat& ef1, const EFloat& ef2);
+inline EFloat operator / (const EFloat& ef1, const EFloat& ef2);
 
 /*!
     \brief negative of the error float
 */
-EFloat operator - (const EFloat& ef);
+inline EFloat operator - (const EFloat& ef);
 
 /*!
     \brief absolute operation
@@ -163,16 +176,277 @@ EFloat operator - (const EFloat& ef);
     note: if ef = { 0.004 -> [ -0.005, 0.0043] }
           will return {0.004 -> [0, 0.005]}
 */
-EFloat abs(const EFloat& ef);
+inline EFloat abs(const EFloat& ef);
 
 /*!
     \brief square root of the error float
 */
-EFloat sqrt(const EFloat& ef);
+inline EFloat sqrt(const EFloat& ef);
 
 /*!
     \brief output the EFloat number to console.
 */
 std::ostream& operator << (std::ostream& out, const EFloat& ef);
 
+/*
+    the constructors and the operators are in the header, so they can be inlined into the intersection code.
+    Without EFLOAT_DEBUG, one operation is only the float operation plus the NextFloatUp/NextFloatDown of the bounds.
+*/
+
+inline EFloat::EFloat()
+    :EFloat(0.0f)
+{
+    // empty
+}
+
+inline EFloat::EFloat(Types::F32 v, Types::F32 err)
+:m_v(v)
+{
+    if (err == 0.0f)
+    {
+        m_low = m_high = v;
+    }
+    else
+    {
+        m_low = NextFloatDown(m_v - err);
+        m_high = NextFloatUp(m_v + err);
+    }
+
+#ifdef EFLOAT_DEBUG
+    m_preciseV = m_v;
+    Check();
+#endif // EFLOAT_DEBUG
+}
+
+inline EFloat& EFloat::operator=(const EFloat & ef)
+{
+    m_v = ef.m_v;
+    m_low = ef.m_low;
+    m_high = ef.m_high;
+    
+#ifdef EFLOAT_DEBUG
+    m_preciseV = ef.m_preciseV;
+#endif // EFLOAT_DEBUG
+
+    return *this;
+}
+
+inline EFloat::~EFloat()
+{
+    // empty
+}
+
+inline Types::F32 EFloat::LowerBound() const
+{
+    return m_low;
+}
+
+inline Types::F32 EFloat::UpperBound() const
+{
+    return m_high;
+}
+
+inline EFloat::operator Types::F32() const
+{
+    return m_v;
+}
+
+inline Types::U32 FloatToBits(const Types::F32 & f)
+{
+    Types::U32 u;
+    memcpy(&u, &f, sizeof(Types::F32));
+    return u;
+}
+
+inline Types::F32 BitsToFloat(const Types::U32 & u)
+{
+    Types::F32 f;
+    memcpy(&f, &u, sizeof(Types::U32));
+    return f;
+}
+
+inline Types::F32 NextFloatUp(Types::F32 f)
+{
+    if (std::isinf(f) && f > 0.0f) return f; // just return the positive infinity
+    if (f == -0.0f) f = 0.0f;
+    Types::U32 u = FloatToBits(f);
+    if (f >= 0.0f)
+    {
+        ++u;
+    }
+    else
+    {
+        --u;
+    }
+
+    return BitsToFloat(u);
+}
+
+inline Types::F32 NextFloatDown(Types::F32 f)
+{
+    if (std::isinf(f) && f < 0.0f) return f; // just return the negative infinity
+    if (f == 0.0f) f = -0.0f;
+    Types::U32 u = FloatToBits(f);
+    if (f <= 0.0f)
+    {
+        ++u;
+    }
+    else
+    {
+        --u;
+    }
+
+    return BitsToFloat(u);
+}
+
+inline EFloat operator+(const EFloat & ef1, const EFloat & ef2)
+{
+    EFloat r;
+    
+    r.m_v = ef1.m_v + ef2.m_v;
+    r.m_low  = NextFloatDown(ef1.m_low + ef2.m_low);
+    r.m_high = NextFloatUp(ef1.m_high + ef2.m_high);
+
+#ifdef EFLOAT_DEBUG
+    r.m_preciseV = ef1.m_preciseV + ef2.m_preciseV;
+    r.Check();
+#endif // EFLOAT_DEBUG
+    
+    return r;
+}
+
+inline EFloat operator-(const EFloat & ef1, const EFloat & ef2)
+{
+    EFloat r;
+
+    r.m_v = ef1.m_v - ef2.m_v;
+    r.m_low = NextFloatDown(ef1.m_low - ef2.m_high);
+    r.m_high = NextFloatUp(ef1.m_high - ef2.m_low);
+
+#ifdef EFLOAT_DEBUG
+    r.m_preciseV = ef1.m_preciseV - ef2.m_preciseV;
+    r.Check();
+#endif // EFLOAT_DEBUG
+
+    return r;
+}
+
+inline EFloat operator*(const EFloat & ef1, const EFloat & ef2)
+{
+    EFloat r;
+
+    r.m_v = ef1.m_v * ef2.m_v;
+    
+    const Types::F32 lowLow   = ef1.m_low  * ef2.m_low;
+    const Types::F32 lowHigh  = ef1.m_low  * ef2.m_high;
+    const Types::F32 highLow  = ef1.m_high * ef2.m_low;
+    const Types::F32 highHigh = ef1.m_high * ef2.m_high;
+
+    // set r.m_low = min(products), r.m_high = max(products), and expand error bound a little
+    r.m_low  = NextFloatDown(std::min(std::min(lowLow, lowHigh), std::min(highLow, highHigh)));
+    r.m_high = NextFloatUp  (std::max(std::max(lowLow, lowHigh), std::max(highLow, highHigh)));
+
+#ifdef EFLOAT_DEBUG
+    r.m_preciseV = ef1.m_preciseV * ef2.m_preciseV;
+    r.Check();
+#endif // EFLOAT_DEBUG
+
+    return r;
+}
+
+inline EFloat operator/(const EFloat & ef1, const EFloat & ef2)
+{
+    EFloat r;
+
+    r.m_v = ef1.m_v / ef2.m_v;
+
+    if (ef2.m_low < 0.0f && ef2.m_high > 0.0f)
+    {
+        // if the bound straddle zero, the ef2 may be near zero, so set the error bound to [-inf, +inf].
+        r.m_low  = - std::numeric_limits<Types::F32>::infinity();
+        r.m_high = + std::numeric_limits<Types::F32>::infinity();
+    }
+    else
+    {
+        const Types::F32 lowLow   = ef1.m_low  / ef2.m_low;
+        const Types::F32 lowHigh  = ef1.m_low  / ef2.m_high;
+        const Types::F32 highLow  = ef1.m_high / ef2.m_low;
+        const Types::F32 highHigh = ef1.m_high / ef2.m_high;
+
+        // set r.m_low = min(quotients), r.m_high = max(quotients), and expand error bound a little
+        r.m_low  = NextFloatDown(std::min(std::min(lowLow, lowHigh), std::min(highLow, highHigh)));
+        r.m_high = NextFloatUp  (std::max(std::max(lowLow, lowHigh), std::max(highLow, highHigh)));
+    }
+
+#ifdef EFLOAT_DEBUG
+    r.m_preciseV = ef1.m_preciseV / ef2.m_preciseV;
+    r.Check();
+#endif // EFLOAT_DEBUG
+
+    return r;
+}
+
+inline EFloat operator-(const EFloat & ef)
+{
+    EFloat r;
+    r.m_v        = -ef.m_v;
+    r.m_low      = -ef.m_high;
+    r.m_high     = -ef.m_low;
+#ifdef EFLOAT_DEBUG
+    r.m_preciseV = -ef.m_preciseV;
+    r.Check();
+#endif // EFLOAT_DEBUG
+    return r;
+}
+
+inline EFloat abs(const EFloat & ef)
+{
+    EFloat r;
+
+    if (ef.m_low > 0.0f)
+    {
+        // the number (include the error bound) is all positive,
+        // just return itself.
+        return ef;
+    }
+    else if (ef.m_high < 0.0f)
+    {
+        // flip all the sign
+        r.m_v        = -ef.m_v;
+        r.m_low      = -ef.m_high;
+        r.m_high     = -ef.m_low;
+#ifdef EFLOAT_DEBUG
+        r.m_preciseV = -ef.m_preciseV;
+#endif // EFLOAT_DEBUG
+    }
+    else
+    {
+        // error bound straddles zero, so the lower bound will be cut to zero,
+        // upper bound will be the max magnitude in (low and high)
+        r.m_v        = std::abs(ef.m_v);
+        r.m_low      = 0.0f;
+        r.m_high     = std::max(-ef.m_low, ef.m_high); // this equal to high = max(abs(ef.low), abs(ef.high))
+#ifdef EFLOAT_DEBUG
+        r.m_preciseV = std::abs(ef.m_preciseV);
+#endif // EFLOAT_DEBUG
+    }
+
+#ifdef EFLOAT_DEBUG
+    r.Check();
+#endif // EFLOAT_DEBUG
+    return r;
+}
+
+inline EFloat sqrt(const EFloat & ef)
+{
+    EFloat r;
+    r.m_v = std::sqrt(ef.m_v);
+    r.m_low = NextFloatDown(std::sqrt(ef.m_low));
+    r.m_high = NextFloatUp(std::sqrt(ef.m_high));
+#ifdef EFLOAT_DEBUG
+    r.m_preciseV = std::sqrt(ef.m_preciseV);
+#endif // EFLOAT_DEBUG
+    return r;
+}
+
 }// namespace CommonClass
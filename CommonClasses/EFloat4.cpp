@@ -0,0 +1,15 @@
+#include "EFloat4.h"
+#include <assert.h>
+
+namespace CommonClass
+{
+
+void EFloat4::Check() const
+{
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        Lane(i).Check();
+    }
+}
+
+} // namespace CommonClass
@@ -0,0 +1,324 @@
+#pragma once
+#include "EFloat.h"
+#include <array>
+#ifdef USING_SSE_MATH
+#include <emmintrin.h>
+#endif
+
+namespace CommonClass
+{
+
+/*!
+    \brief EFloat4 is four EFloat stored as structure of arrays,
+    the values, the lower bounds and the upper bounds are in three arrays,
+    so one operation of the four lanes is a few SSE instructions.
+    It's used to do the robust intersection of four rays (or four primitives) at once.
+    Each lane get exactly the same value and bounds as the EFloat operation of that lane,
+    but there is no precise value tracking, use EFloat with EFLOAT_DEBUG to validate the error bounds.
+*/
+class EFloat4
+{
+public:
+    std::array<Types::F32, 4> m_v;      // main values of the floats
+    std::array<Types::F32, 4> m_low;    // lower bounds
+    std::array<Types::F32, 4> m_high;   // higher bounds
+
+public:
+    /*!
+        \brief default construct four 0.0f +- 0
+    */
+    EFloat4();
+
+    /*!
+        \brief all the four lanes are EFloat(v, err).
+    */
+    explicit EFloat4(const Types::F32 v, const Types::F32 err = 0.0f);
+
+    /*!
+        \brief construct from four values with the same absolute error.
+        \param pV the array of four values
+        \param err absolute error, should greater or equal than 0
+    */
+    explicit EFloat4(const Types::F32 * pV, const Types::F32 err = 0.0f);
+
+    /*!
+        \brief gather four EFloat into the lanes.
+    */
+    EFloat4(const EFloat& ef0, const EFloat& ef1, const EFloat& ef2, const EFloat& ef3);
+    ~EFloat4();
+
+    /*!
+        \brief get one lane as an EFloat.
+        \param i the lane index, [0, 3]
+    */
+    EFloat Lane(const unsigned int i) const;
+
+    /*!
+        \brief set one lane by an EFloat.
+        \param i the lane index, [0, 3]
+    */
+    void SetLane(const unsigned int i, const EFloat& ef);
+
+    /*!
+        \brief check m_low <= m_high of each lane.
+    */
+    void Check() const;
+};
+
+/*!
+    \brief operations of the four lanes, same as the operations of EFloat.
+*/
+inline EFloat4 operator + (const EFloat4& ef1, const EFloat4& ef2);
+inline EFloat4 operator - (const EFloat4& ef1, const EFloat4& ef2);
+inline EFloat4 operator * (const EFloat4& ef1, const EFloat4& ef2);
+inline EFloat4 operator / (const EFloat4& ef1, const EFloat4& ef2);
+inline EFloat4 operator - (const EFloat4& ef);
+inline EFloat4 abs        (const EFloat4& ef);
+inline EFloat4 sqrt       (const EFloat4& ef);
+
+#ifdef USING_SSE_MATH
+/*!
+    \brief NextFloatUp of the four floats, the -0.0 is same as 0.0 and +inf stay +inf.
+*/
+inline __m128 NextFloatUp(__m128 f);
+
+/*!
+    \brief NextFloatDown of the four floats, the 0.0 is same as -0.0 and -inf stay -inf.
+*/
+inline __m128 NextFloatDown(__m128 f);
+#endif
+
+/*
+    the implementations of the constructors and the operators are in the header,
+    so they can be inlined into the batched intersection loops.
+*/
+
+inline EFloat4::EFloat4()
+    :EFloat4(0.0f)
+{
+    // empty
+}
+
+inline EFloat4::EFloat4(const Types::F32 v, const Types::F32 err /*= 0.0f*/)
+{
+    const EFloat ef(v, err);
+    m_v.fill(ef.m_v);
+    m_low.fill(ef.m_low);
+    m_high.fill(ef.m_high);
+}
+
+inline EFloat4::EFloat4(const Types::F32 * pV, const Types::F32 err /*= 0.0f*/)
+{
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        SetLane(i, EFloat(pV[i], err));
+    }
+}
+
+inline EFloat4::EFloat4(const EFloat& ef0, const EFloat& ef1, const EFloat& ef2, const EFloat& ef3)
+{
+    SetLane(0, ef0);
+    SetLane(1, ef1);
+    SetLane(2, ef2);
+    SetLane(3, ef3);
+}
+
+inline EFloat4::~EFloat4()
+{
+    // empty
+}
+
+inline EFloat EFloat4::Lane(const unsigned int i) const
+{
+    EFloat ef(m_v[i]);
+    ef.m_low  = m_low[i];
+    ef.m_high = m_high[i];
+    return ef;
+}
+
+inline void EFloat4::SetLane(const unsigned int i, const EFloat& ef)
+{
+    m_v[i]      = ef.m_v;
+    m_low[i]    = ef.m_low;
+    m_high[i]   = ef.m_high;
+}
+
+#ifdef USING_SSE_MATH
+
+inline __m128 NextFloatUp(__m128 f)
+{
+    const __m128 zero = _mm_setzero_ps();
+
+    // -0.0 + 0.0 = 0.0, so the -0.0 will step up to the smallest positive number, same as NextFloatUp(float).
+    f = _mm_add_ps(f, zero);
+
+    // step the bits by +1 for the positive numbers, -1 for the negative numbers.
+    const __m128i step  = _mm_or_si128(_mm_castps_si128(_mm_cmplt_ps(f, zero)), _mm_set1_epi32(1));
+    const __m128  up    = _mm_castsi128_ps(_mm_add_epi32(_mm_castps_si128(f), step));
+
+    // +inf stay +inf
+    const __m128 isPositiveInf = _mm_cmpeq_ps(f, _mm_set1_ps(std::numeric_limits<Types::F32>::infinity()));
+    return _mm_or_ps(_mm_and_ps(isPositiveInf, f), _mm_andnot_ps(isPositiveInf, up));
+}
+
+inline __m128 NextFloatDown(__m128 f)
+{
+    // NextFloatDown(f) = -NextFloatUp(-f)
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    return _mm_xor_ps(NextFloatUp(_mm_xor_ps(f, signBit)), signBit);
+}
+
+inline EFloat4 operator+(const EFloat4 & ef1, const EFloat4 & ef2)
+{
+    EFloat4 r;
+    _mm_storeu_ps(r.m_v.data(),      _mm_add_ps(_mm_loadu_ps(ef1.m_v.data()), _mm_loadu_ps(ef2.m_v.data())));
+    _mm_storeu_ps(r.m_low.data(),    NextFloatDown(_mm_add_ps(_mm_loadu_ps(ef1.m_low.data()), _mm_loadu_ps(ef2.m_low.data()))));
+    _mm_storeu_ps(r.m_high.data(),   NextFloatUp(_mm_add_ps(_mm_loadu_ps(ef1.m_high.data()), _mm_loadu_ps(ef2.m_high.data()))));
+    return r;
+}
+
+inline EFloat4 operator-(const EFloat4 & ef1, const EFloat4 & ef2)
+{
+    EFloat4 r;
+    _mm_storeu_ps(r.m_v.data(),      _mm_sub_ps(_mm_loadu_ps(ef1.m_v.data()), _mm_loadu_ps(ef2.m_v.data())));
+    _mm_storeu_ps(r.m_low.data(),    NextFloatDown(_mm_sub_ps(_mm_loadu_ps(ef1.m_low.data()), _mm_loadu_ps(ef2.m_high.data()))));
+    _mm_storeu_ps(r.m_high.data(),   NextFloatUp(_mm_sub_ps(_mm_loadu_ps(ef1.m_high.data()), _mm_loadu_ps(ef2.m_low.data()))));
+    return r;
+}
+
+inline EFloat4 operator*(const EFloat4 & ef1, const EFloat4 & ef2)
+{
+    EFloat4 r;
+    const __m128 low1   = _mm_loadu_ps(ef1.m_low.data());
+    const __m128 high1  = _mm_loadu_ps(ef1.m_high.data());
+    const __m128 low2   = _mm_loadu_ps(ef2.m_low.data());
+    const __m128 high2  = _mm_loadu_ps(ef2.m_high.data());
+
+    const __m128 lowLow     = _mm_mul_ps(low1,  low2);
+    const __m128 lowHigh    = _mm_mul_ps(low1,  high2);
+    const __m128 highLow    = _mm_mul_ps(high1, low2);
+    const __m128 highHigh   = _mm_mul_ps(high1, high2);
+
+    _mm_storeu_ps(r.m_v.data(),      _mm_mul_ps(_mm_loadu_ps(ef1.m_v.data()), _mm_loadu_ps(ef2.m_v.data())));
+    _mm_storeu_ps(r.m_low.data(),    NextFloatDown(_mm_min_ps(_mm_min_ps(lowLow, lowHigh), _mm_min_ps(highLow, highHigh))));
+    _mm_storeu_ps(r.m_high.data(),   NextFloatUp(_mm_max_ps(_mm_max_ps(lowLow, lowHigh), _mm_max_ps(highLow, highHigh))));
+    return r;
+}
+
+inline EFloat4 operator/(const EFloat4 & ef1, const EFloat4 & ef2)
+{
+    EFloat4 r;
+    const __m128 zero   = _mm_setzero_ps();
+    const __m128 low1   = _mm_loadu_ps(ef1.m_low.data());
+    const __m128 high1  = _mm_loadu_ps(ef1.m_high.data());
+    const __m128 low2   = _mm_loadu_ps(ef2.m_low.data());
+    const __m128 high2  = _mm_loadu_ps(ef2.m_high.data());
+
+    const __m128 lowLow     = _mm_div_ps(low1,  low2);
+    const __m128 lowHigh    = _mm_div_ps(low1,  high2);
+    const __m128 highLow    = _mm_div_ps(high1, low2);
+    const __m128 highHigh   = _mm_div_ps(high1, high2);
+
+    const __m128 low    = NextFloatDown(_mm_min_ps(_mm_min_ps(lowLow, lowHigh), _mm_min_ps(highLow, highHigh)));
+    const __m128 high   = NextFloatUp(_mm_max_ps(_mm_max_ps(lowLow, lowHigh), _mm_max_ps(highLow, highHigh)));
+
+    // if the bound of the divisor straddle zero, the error bound is [-inf, +inf].
+    const __m128 straddleZero   = _mm_and_ps(_mm_cmplt_ps(low2, zero), _mm_cmpgt_ps(high2, zero));
+    const __m128 infinity       = _mm_set1_ps(std::numeric_limits<Types::F32>::infinity());
+
+    _mm_storeu_ps(r.m_v.data(),      _mm_div_ps(_mm_loadu_ps(ef1.m_v.data()), _mm_loadu_ps(ef2.m_v.data())));
+    _mm_storeu_ps(r.m_low.data(),    _mm_or_ps(_mm_and_ps(straddleZero, _mm_sub_ps(zero, infinity)), _mm_andnot_ps(straddleZero, low)));
+    _mm_storeu_ps(r.m_high.data(),   _mm_or_ps(_mm_and_ps(straddleZero, infinity), _mm_andnot_ps(straddleZero, high)));
+    return r;
+}
+
+inline EFloat4 operator-(const EFloat4 & ef)
+{
+    EFloat4 r;
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    _mm_storeu_ps(r.m_v.data(),      _mm_xor_ps(_mm_loadu_ps(ef.m_v.data()), signBit));
+    _mm_storeu_ps(r.m_low.data(),    _mm_xor_ps(_mm_loadu_ps(ef.m_high.data()), signBit));
+    _mm_storeu_ps(r.m_high.data(),   _mm_xor_ps(_mm_loadu_ps(ef.m_low.data()), signBit));
+    return r;
+}
+
+inline EFloat4 abs(const EFloat4 & ef)
+{
+    EFloat4 r;
+    const __m128 signBit    = _mm_set1_ps(-0.0f);
+    const __m128 low        = _mm_loadu_ps(ef.m_low.data());
+    const __m128 high       = _mm_loadu_ps(ef.m_high.data());
+    const __m128 negLow     = _mm_xor_ps(low, signBit);
+    const __m128 negHigh    = _mm_xor_ps(high, signBit);
+
+    // all positive: [low, high], all negative: [-high, -low], straddle zero: [0, max(-low, high)]
+    // these three cases are same as [max(0, low, -high), max(-low, high)].
+    _mm_storeu_ps(r.m_v.data(),      _mm_andnot_ps(signBit, _mm_loadu_ps(ef.m_v.data())));
+    _mm_storeu_ps(r.m_low.data(),    _mm_max_ps(_mm_max_ps(low, negHigh), _mm_setzero_ps()));
+    _mm_storeu_ps(r.m_high.data(),   _mm_max_ps(negLow, high));
+    return r;
+}
+
+inline EFloat4 sqrt(const EFloat4 & ef)
+{
+    EFloat4 r;
+    _mm_storeu_ps(r.m_v.data(),      _mm_sqrt_ps(_mm_loadu_ps(ef.m_v.data())));
+    _mm_storeu_ps(r.m_low.data(),    NextFloatDown(_mm_sqrt_ps(_mm_loadu_ps(ef.m_low.data()))));
+    _mm_storeu_ps(r.m_high.data(),   NextFloatUp(_mm_sqrt_ps(_mm_loadu_ps(ef.m_high.data()))));
+    return r;
+}
+
+#else
+
+/*!
+    \brief without SSE, apply the EFloat operation lane by lane.
+*/
+template<typename OPERATION>
+inline EFloat4 ForEachLane(const EFloat4 & ef1, const EFloat4 & ef2, OPERATION && operation)
+{
+    EFloat4 r;
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        r.SetLane(i, operation(ef1.Lane(i), ef2.Lane(i)));
+    }
+    return r;
+}
+
+inline EFloat4 operator+(const EFloat4 & ef1, const EFloat4 & ef2)
+{
+    return ForEachLane(ef1, ef2, [](const EFloat& a, const EFloat& b) { return a + b; });
+}
+
+inline EFloat4 operator-(const EFloat4 & ef1, const EFloat4 & ef2)
+{
+    return ForEachLane(ef1, ef2, [](const EFloat& a, const EFloat& b) { return a - b; });
+}
+
+inline EFloat4 operator*(const EFloat4 & ef1, const EFloat4 & ef2)
+{
+    return ForEachLane(ef1, ef2, [](const EFloat& a, const EFloat& b) { return a * b; });
+}
+
+inline EFloat4 operator/(const EFloat4 & ef1, const EFloat4 & ef2)
+{
+    return ForEachLane(ef1, ef2, [](const EFloat& a, const EFloat& b) { return a / b; });
+}
+
+inline EFloat4 operator-(const EFloat4 & ef)
+{
+    return ForEachLane(ef, ef, [](const EFloat& a, const EFloat&) { return -a; });
+}
+
+inline EFloat4 abs(const EFloat4 & ef)
+{
+    return ForEachLane(ef, ef, [](const EFloat& a, const EFloat&) { return abs(a); });
+}
+
+inline EFloat4 sqrt(const EFloat4 & ef)
+{
+    return ForEachLane(ef, ef, [](const EFloat& a, const EFloat&) { return sqrt(a); });
+}
+
+#endif // USING_SSE_MATH
+
+} // namespace CommonClass
@@ -0,0 +1,143 @@
+#include "FFT.h"
+#include <cmath>
+#include <exception>
+#include <utility>
+
+namespace CommonClass
+{
+
+FFT::FFT(const Types::U32 size)
+    :m_size(size)
+{
+    if (size == 0 || (size & (size - 1)) != 0)
+    {
+        throw std::exception("the size of FFT must be a power of two");
+    }
+
+    Types::U32 numBits = 0;
+    while ((1u << numBits) < size)
+    {
+        ++numBits;
+    }
+
+    m_bitReverse.resize(size);
+    for (Types::U32 i = 0; i < size; ++i)
+    {
+        Types::U32 reversed = 0;
+        for (Types::U32 b = 0; b < numBits; ++b)
+        {
+            reversed |= ((i >> b) & 1) << (numBits - 1 - b);
+        }
+        m_bitReverse[i] = reversed;
+    }
+
+    m_twiddles.resize(size / 2);
+    for (Types::U32 k = 0; k < size / 2; ++k)
+    {
+        const double angle = -2.0 * 3.141592653589793238463 * k / size;
+        m_twiddles[k] = Complex(static_cast<Types::F32>(std::cos(angle)), static_cast<Types::F32>(std::sin(angle)));
+    }
+}
+
+FFT::~FFT()
+{
+    // empty
+}
+
+void FFT::Forward(Complex* data) const
+{
+    Transform(data, false);
+}
+
+void FFT::Inverse(Complex* data) const
+{
+    Transform(data, true);
+    const Types::F32 scale = 1.0f / m_size;
+    for (Types::U32 i = 0; i < m_size; ++i)
+    {
+        data[i] *= scale;
+    }
+}
+
+void FFT::Forward2D(Complex* data) const
+{
+    Transform2D(data, false);
+}
+
+void FFT::Inverse2D(Complex* data) const
+{
+    Transform2D(data, true);
+    const Types::F32 scale = 1.0f / (static_cast<Types::F32>(m_size) * m_size);
+    for (Types::U32 i = 0; i < m_size * m_size; ++i)
+    {
+        data[i] *= scale;
+    }
+}
+
+Types::U32 FFT::NextPowerOfTwo(const Types::U32 n)
+{
+    Types::U32 power = 1;
+    while (power < n)
+    {
+        power <<= 1;
+    }
+    return power;
+}
+
+void FFT::Transform(Complex* data, const bool inverse) const
+{
+    for (Types::U32 i = 0; i < m_size; ++i)
+    {
+        if (i < m_bitReverse[i])
+        {
+            std::swap(data[i], data[m_bitReverse[i]]);
+        }
+    }
+
+    // the inverse transform use the conjugate twiddles.
+    const Types::F32 sign = inverse ? -1.0f : 1.0f;
+    for (Types::U32 half = 1; half < m_size; half <<= 1)
+    {
+        const Types::U32 twiddleStep = m_size / (half * 2);
+        for (Types::U32 start = 0; start < m_size; start += half * 2)
+        {
+            for (Types::U32 k = 0; k < half; ++k)
+            {
+                // the complex multiply is written by hand, std::complex operator* check the NaN and infinity.
+                const Complex& w = m_twiddles[k * twiddleStep];
+                const Types::F32 wr = w.real(), wi = sign * w.imag();
+                Complex& a = data[start + k];
+                Complex& b = data[start + k + half];
+                const Types::F32 br = b.real() * wr - b.imag() * wi;
+                const Types::F32 bi = b.real() * wi + b.imag() * wr;
+                const Types::F32 ar = a.real(), ai = a.imag();
+                a = Complex(ar + br, ai + bi);
+                b = Complex(ar - br, ai - bi);
+            }
+        }
+    }
+}
+
+void FFT::Transform2D(Complex* data, const bool inverse) const
+{
+    for (Types::U32 row = 0; row < m_size; ++row)
+    {
+        Transform(data + row * m_size, inverse);
+    }
+
+    std::vector<Complex> column(m_size);
+    for (Types::U32 col = 0; col < m_size; ++col)
+    {
+        for (Types::U32 row = 0; row < m_size; ++row)
+        {
+            column[row] = data[row * m_size + col];
+        }
+        Transform(column.data(), inverse);
+        for (Types::U32 row = 0; row < m_size; ++row)
+        {
+            data[row * m_size + col] = column[row];
+        }
+    }
+}
+
+}// namespace CommonClass
@@ -0,0 +1,74 @@
+#pragma once
+#include <complex>
+#include <vector>
+#include "CommonTypes.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief FFT is the radix-2 fast fourier transform of a fixed power of two size,
+    the bit reversal permutation and the twiddle factors are computed once in the constructor,
+    so one FFT object can be used by multiple threads at the same time.
+*/
+class FFT
+{
+public:
+    using Complex = std::complex<Types::F32>;
+
+protected:
+    Types::U32 m_size;
+
+    /*!
+        \brief m_bitReverse[i] is the index i with the log2(m_size) bits reversed.
+    */
+    std::vector<Types::U32> m_bitReverse;
+
+    /*!
+        \brief m_twiddles[k] = exp(-2 * PI * i * k / m_size) for k in [0, m_size / 2).
+    */
+    std::vector<Complex> m_twiddles;
+
+public:
+    /*!
+        \brief throw if the size is not a power of two.
+    */
+    explicit FFT(const Types::U32 size);
+    ~FFT();
+
+    /*!
+        \brief in place forward transform of m_size complex numbers.
+    */
+    void Forward(Complex* data) const;
+
+    /*!
+        \brief in place inverse transform of m_size complex numbers, the result is divided by m_size.
+    */
+    void Inverse(Complex* data) const;
+
+    /*!
+        \brief in place 2D transform of m_size * m_size complex numbers stored row by row.
+    */
+    void Forward2D(Complex* data) const;
+    void Inverse2D(Complex* data) const;
+
+    Types::U32 GetSize() const { return m_size; }
+
+    /*!
+        \brief the smallest power of two not less than n.
+    */
+    static Types::U32 NextPowerOfTwo(const Types::U32 n);
+
+protected:
+    /*!
+        \brief the iterative Cooley-Tukey transform without scaling.
+    */
+    void Transform(Complex* data, const bool inverse) const;
+
+    /*!
+        \brief transform the rows, then the columns through a buffer of one column.
+    */
+    void Transform2D(Complex* data, const bool inverse) const;
+};
+
+}// namespace CommonClass
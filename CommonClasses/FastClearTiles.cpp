@@ -0,0 +1,97 @@
+#include "FastClearTiles.h"
+
+namespace CommonClass
+{
+
+FastClearTiles::FastClearTiles()
+    :m_mutex(new std::mutex())
+{
+    // empty
+}
+
+FastClearTiles::FastClearTiles(FastClearTiles&& moveObj)
+{
+    *this = std::move(moveObj);
+}
+
+FastClearTiles& FastClearTiles::operator=(FastClearTiles&& moveObj)
+{
+    if (this != &moveObj)
+    {
+        m_width             = moveObj.m_width;
+        m_height            = moveObj.m_height;
+        m_numTilesX         = moveObj.m_numTilesX;
+        m_numTilesY         = moveObj.m_numTilesY;
+        m_isTilePending     = std::move(moveObj.m_isTilePending);
+        m_hasPendingTiles   = moveObj.m_hasPendingTiles;
+        m_mutex             = std::move(moveObj.m_mutex);
+
+        // the moved object has no tile, so MarkAll() and Resolve*() never touch the released flags and mutex.
+        moveObj.m_width             = 0;
+        moveObj.m_height            = 0;
+        moveObj.m_numTilesX         = 0;
+        moveObj.m_numTilesY         = 0;
+        moveObj.m_hasPendingTiles   = false;
+    }
+    return *this;
+}
+
+FastClearTiles::~FastClearTiles()
+{
+    // empty
+}
+
+void FastClearTiles::Init(const Types::U32 width, const Types::U32 height)
+{
+    m_width = width;
+    m_height = height;
+    m_numTilesX = (width + TILE_SIZE - 1) >> TILE_SHIFT;
+    m_numTilesY = (height + TILE_SIZE - 1) >> TILE_SHIFT;
+    m_isTilePending.reset(new std::atomic<Types::U8>[GetNumTiles()]);
+    if ( ! m_mutex)
+    {
+        // the moved object is initialized again.
+        m_mutex.reset(new std::mutex());
+    }
+    for (Types::U32 i = 0; i < GetNumTiles(); ++i)
+    {
+        m_isTilePending[i].store(0, std::memory_order_relaxed);
+    }
+    m_hasPendingTiles = false;
+}
+
+void FastClearTiles::MarkAll()
+{
+    for (Types::U32 i = 0; i < GetNumTiles(); ++i)
+    {
+        m_isTilePending[i].store(1, std::memory_order_relaxed);
+    }
+    m_hasPendingTiles = GetNumTiles() > 0;
+}
+
+void FastClearTiles::Reset()
+{
+    if (m_hasPendingTiles)
+    {
+        for (Types::U32 i = 0; i < GetNumTiles(); ++i)
+        {
+            m_isTilePending[i].store(0, std::memory_order_relaxed);
+        }
+        m_hasPendingTiles = false;
+    }
+}
+
+Types::U32 FastClearTiles::GetNumPendingTiles() const
+{
+    Types::U32 numPending = 0;
+    if (m_hasPendingTiles)
+    {
+        for (Types::U32 i = 0; i < GetNumTiles(); ++i)
+        {
+            numPending += m_isTilePending[i].load(std::memory_order_acquire) != 0 ? 1 : 0;
+        }
+    }
+    return numPending;
+}
+
+}// namespace CommonClass
@@ -0,0 +1,163 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include "CommonTypes.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief FastClearTiles remember which tiles of a render target are cleared but not written yet,
+    so clearing the render target only marks the tiles instead of writing every pixel.
+    The owner (Image, DepthBuffer) return the clear value when reading a pending tile,
+    and fill the tile with the clear value (resolve) before the first write into it,
+    so the cost of clearing is proportional to the covered area instead of the resolution.
+    The tiles are in the (x, y) coordinates of the owner, the owner fill its own memory by the callback
+    fill(left, bottom, right, top) where right and top are exclusive.
+    Resolving is guarded by a mutex, so the const readers of the owner can resolve the tiles on multiple threads.
+*/
+class FastClearTiles
+{
+public:
+    /*!
+        \brief the tiles are TILE_SIZE * TILE_SIZE pixels, the tiles at the right and top borders may be smaller.
+    */
+    static const Types::U32 TILE_SHIFT = 5;
+    static const Types::U32 TILE_SIZE = 1 << TILE_SHIFT;
+
+protected:
+    Types::U32 m_width = 0, m_height = 0;
+    Types::U32 m_numTilesX = 0, m_numTilesY = 0;
+
+    /*!
+        \brief one flag for each tile (row by row from the bottom), not zero if the tile is cleared but not filled.
+    */
+    std::unique_ptr<std::atomic<Types::U8>[]> m_isTilePending;
+
+    /*!
+        \brief whether any tile is marked since the last Init()/Reset()/ResolveAll(),
+        so the targets which are never cleared skip the lookup of the tiles.
+    */
+    bool m_hasPendingTiles = false;
+
+    /*!
+        \brief in the heap so the owner is still movable.
+    */
+    std::unique_ptr<std::mutex> m_mutex;
+
+public:
+    FastClearTiles();
+
+    /*!
+        \brief take the tiles and the mutex, the moved object has no tile until Init() again.
+    */
+    FastClearTiles(FastClearTiles&& moveObj);
+    FastClearTiles& operator=(FastClearTiles&& moveObj);
+    ~FastClearTiles();
+
+    /*!
+        \brief resize to the render target, no tile is pending.
+    */
+    void Init(const Types::U32 width, const Types::U32 height);
+
+    /*!
+        \brief mark all the tiles pending, the owner has recorded the clear value.
+    */
+    void MarkAll();
+
+    /*!
+        \brief forget the pending tiles without filling them, when the owner has overwritten all the pixels.
+    */
+    void Reset();
+
+    /*!
+        \brief whether the pixel is in a pending tile, that is the pixel is the clear value.
+    */
+    bool IsPending(const Types::U32 x, const Types::U32 y) const
+    {
+        return m_hasPendingTiles
+            && m_isTilePending[(y >> TILE_SHIFT) * m_numTilesX + (x >> TILE_SHIFT)].load(std::memory_order_acquire) != 0;
+    }
+
+    /*!
+        \brief fill the tile which contains the pixel if it is pending, before writing the pixel.
+    */
+    template<typename FILL_FUNC>
+    void Resolve(const Types::U32 x, const Types::U32 y, FILL_FUNC&& fill) const
+    {
+        if (m_hasPendingTiles)
+        {
+            ResolveTile(x >> TILE_SHIFT, y >> TILE_SHIFT, fill);
+        }
+    }
+
+    /*!
+        \brief fill the pending tiles which intersect the row y, before accessing the whole row.
+    */
+    template<typename FILL_FUNC>
+    void ResolveRow(const Types::U32 y, FILL_FUNC&& fill) const
+    {
+        if (m_hasPendingTiles)
+        {
+            for (Types::U32 tx = 0; tx < m_numTilesX; ++tx)
+            {
+                ResolveTile(tx, y >> TILE_SHIFT, fill);
+            }
+        }
+    }
+
+    /*!
+        \brief fill all the pending tiles, before exporting the whole target.
+    */
+    template<typename FILL_FUNC>
+    void ResolveAll(FILL_FUNC&& fill)
+    {
+        if (m_hasPendingTiles)
+        {
+            for (Types::U32 ty = 0; ty < m_numTilesY; ++ty)
+            {
+                for (Types::U32 tx = 0; tx < m_numTilesX; ++tx)
+                {
+                    ResolveTile(tx, ty, fill);
+                }
+            }
+            m_hasPendingTiles = false;
+        }
+    }
+
+    /*!
+        \brief whether any tile may be pending, false means all the pixels can be read directly.
+    */
+    bool HasPendingTiles() const { return m_hasPendingTiles; }
+
+    /*!
+        \brief how many tiles are still cleared but not filled.
+    */
+    Types::U32 GetNumPendingTiles() const;
+
+    Types::U32 GetNumTiles() const { return m_numTilesX * m_numTilesY; }
+
+protected:
+    template<typename FILL_FUNC>
+    void ResolveTile(const Types::U32 tx, const Types::U32 ty, FILL_FUNC& fill) const
+    {
+        std::atomic<Types::U8>& isPending = m_isTilePending[ty * m_numTilesX + tx];
+        if (isPending.load(std::memory_order_acquire) == 0)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(*m_mutex);
+        // another thread may have filled the tile.
+        if (isPending.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+        fill(tx << TILE_SHIFT, ty << TILE_SHIFT,
+            std::min((tx + 1) << TILE_SHIFT, m_width), std::min((ty + 1) << TILE_SHIFT, m_height));
+        isPending.store(0, std::memory_order_release);
+    }
+};
+
+}// namespace CommonClass
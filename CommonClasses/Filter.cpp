@@ -33,10 +33,6 @@ Image Filter::Convolve(const Image & img)
         {
             convolutionResult.SetPixel(x, y, Step(img, horizontalScaner));
             horizontalScaner = horizontalScaner.Go<Loc::RIGHT>(static_cast<int>(m_step));
-            if (x % 200 == 0)
-            {
-                printf("x = %4d, y = %4d\r", x, y);
-            }
         }
         rowHead = rowHead.Go<Loc::UP>(static_cast<int>(m_step));
     }
@@ -86,7 +82,8 @@ Filter::Loc Filter::ConvolutionSize(const Loc& imgSize) const
 std::vector<CommonClass::Filter::Loc> Filter::GenerateSampleLocations(const Loc& bottomLeft)
 {
     std::vector<Loc> retList;
-    
+    retList.reserve(m_width * m_height);
+
     Loc RowHead = bottomLeft;
     for (unsigned int y = 0; y < m_height; ++y)
     {
@@ -1,14 +1,17 @@
 #pragma once
 #include "CommonTypes.h"
+#include <cmath>
 
 namespace CommonClass
 {
 
 /*!
-    \brief a Fix Point Number is basically using a signed integal to represent a real number
+    \brief a Fix Point Number is basically using a signed integal to represent a real number,
+    the lowest SHIFT_POINT bits of the integer are the fraction part.
+    e.g. FixPointNumberTemplate<16> is the 16.16 number, FixPointNumberTemplate<4> is the 28.4 number.
 */
-
-class FixPointNumber
+template<unsigned short SHIFT_POINT>
+class FixPointNumberTemplate
 {
 private:
     /*!
@@ -16,30 +19,237 @@ private:
     */
     Types::I32 m_iNumber;
 
-    static const unsigned short SHIFT_POINT = 16;
+public:
     static const unsigned int MAG = 1 << SHIFT_POINT;
 
 public:
     /*!
         \brief default to be zero.
     */
-    FixPointNumber();
-    FixPointNumber(const Types::I32 iNumber);
-    FixPointNumber(const Types::F32 fNumber);
+    FixPointNumberTemplate();
+
+    /*!
+        \brief construct from an integer, the fraction part is zero.
+    */
+    FixPointNumberTemplate(const Types::I32 iNumber);
+
+    /*!
+        \brief construct from a float, rounded to the nearest representable number.
+    */
+    FixPointNumberTemplate(const Types::F32 fNumber);
+
+    ~FixPointNumberTemplate();
+
+    /*!
+        \brief construct from the raw integer, which already has SHIFT_POINT fraction bits.
+    */
+    static FixPointNumberTemplate FromRaw(const Types::I32 raw);
+
+    /*!
+        \brief get the raw integer, which has SHIFT_POINT fraction bits.
+    */
+    Types::I32 GetRaw() const;
 
     /*!
         \brief cast to a normal float pointing number.
     */
-    Types::F32 ToFloat();
-    
-    ~FixPointNumber();
+    Types::F32 ToFloat() const;
+
+    /*!
+        \brief the greatest integer not greater than this number.
+    */
+    Types::I32 Floor() const;
+
+    /*!
+        \brief the least integer not less than this number.
+    */
+    Types::I32 Ceil() const;
 
-    friend FixPointNumber operator * (const FixPointNumber& a, const FixPointNumber& b);
+    FixPointNumberTemplate& operator += (const FixPointNumberTemplate& other);
+    FixPointNumberTemplate& operator -= (const FixPointNumberTemplate& other);
 };
 
-FixPointNumber operator * (const FixPointNumber& a, const FixPointNumber& b);
-//FixPointNumber operator / (const FixPointNumber& a, const FixPointNumber& b);
-//FixPointNumber operator + (const FixPointNumber& a, const FixPointNumber& b);
-//FixPointNumber operator - (const FixPointNumber& a, const FixPointNumber& b);
+/*!
+    \brief 16.16 fix point number.
+*/
+using FixPointNumber = FixPointNumberTemplate<16>;
+
+/*!
+    \brief 28.4 fix point number, the vertex location of the fixed point rasterizer snap to this 1/16 pixel grid.
+*/
+using SubpixelNumber = FixPointNumberTemplate<4>;
+
+/*!
+    \brief the arithmetic operations, multiply and divide use a 64 bits intermediate result,
+    the result is truncated toward zero.
+*/
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT> operator + (const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b);
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT> operator - (const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b);
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT> operator * (const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b);
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT> operator / (const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b);
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT> operator - (const FixPointNumberTemplate<SHIFT_POINT>& a);
+
+/*!
+    \brief compare the raw integers.
+*/
+template<unsigned short SHIFT_POINT>
+bool operator == (const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b);
+template<unsigned short SHIFT_POINT>
+bool operator != (const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b);
+template<unsigned short SHIFT_POINT>
+bool operator <  (const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b);
+template<unsigned short SHIFT_POINT>
+bool operator <= (const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b);
+template<unsigned short SHIFT_POINT>
+bool operator >  (const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b);
+template<unsigned short SHIFT_POINT>
+bool operator >= (const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b);
+
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT>::FixPointNumberTemplate()
+    :m_iNumber(0)
+{
+    // empty
+}
+
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT>::FixPointNumberTemplate(const Types::I32 iNumber)
+    :m_iNumber(static_cast<Types::I32>(static_cast<Types::U32>(iNumber) << SHIFT_POINT))
+{
+    // empty
+}
+
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT>::FixPointNumberTemplate(const Types::F32 fNumber)
+    :m_iNumber(static_cast<Types::I32>(std::lround(fNumber * MAG)))
+{
+    // empty
+}
+
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT>::~FixPointNumberTemplate()
+{
+    // empty
+}
+
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT> FixPointNumberTemplate<SHIFT_POINT>::FromRaw(const Types::I32 raw)
+{
+    FixPointNumberTemplate ret;
+    ret.m_iNumber = raw;
+    return ret;
+}
+
+template<unsigned short SHIFT_POINT>
+Types::I32 FixPointNumberTemplate<SHIFT_POINT>::GetRaw() const
+{
+    return m_iNumber;
+}
+
+template<unsigned short SHIFT_POINT>
+Types::F32 FixPointNumberTemplate<SHIFT_POINT>::ToFloat() const
+{
+    return static_cast<Types::F32>(m_iNumber) / MAG;
+}
+
+template<unsigned short SHIFT_POINT>
+Types::I32 FixPointNumberTemplate<SHIFT_POINT>::Floor() const
+{
+    // arithmetic shift round toward negative infinity.
+    return m_iNumber >> SHIFT_POINT;
+}
+
+template<unsigned short SHIFT_POINT>
+Types::I32 FixPointNumberTemplate<SHIFT_POINT>::Ceil() const
+{
+    return (m_iNumber + static_cast<Types::I32>(MAG - 1)) >> SHIFT_POINT;
+}
+
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT>& FixPointNumberTemplate<SHIFT_POINT>::operator+=(const FixPointNumberTemplate& other)
+{
+    m_iNumber += other.m_iNumber;
+    return *this;
+}
+
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT>& FixPointNumberTemplate<SHIFT_POINT>::operator-=(const FixPointNumberTemplate& other)
+{
+    m_iNumber -= other.m_iNumber;
+    return *this;
+}
+
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT> operator+(const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b)
+{
+    return FixPointNumberTemplate<SHIFT_POINT>::FromRaw(a.GetRaw() + b.GetRaw());
+}
+
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT> operator-(const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b)
+{
+    return FixPointNumberTemplate<SHIFT_POINT>::FromRaw(a.GetRaw() - b.GetRaw());
+}
+
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT> operator*(const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b)
+{
+    const Types::I64 scaleResult = static_cast<Types::I64>(a.GetRaw()) * static_cast<Types::I64>(b.GetRaw());
+    return FixPointNumberTemplate<SHIFT_POINT>::FromRaw(static_cast<Types::I32>(scaleResult / FixPointNumberTemplate<SHIFT_POINT>::MAG));
+}
+
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT> operator/(const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b)
+{
+    const Types::I64 scaleA = static_cast<Types::I64>(a.GetRaw()) * FixPointNumberTemplate<SHIFT_POINT>::MAG;
+    return FixPointNumberTemplate<SHIFT_POINT>::FromRaw(static_cast<Types::I32>(scaleA / b.GetRaw()));
+}
+
+template<unsigned short SHIFT_POINT>
+FixPointNumberTemplate<SHIFT_POINT> operator-(const FixPointNumberTemplate<SHIFT_POINT>& a)
+{
+    return FixPointNumberTemplate<SHIFT_POINT>::FromRaw(-a.GetRaw());
+}
+
+template<unsigned short SHIFT_POINT>
+bool operator==(const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b)
+{
+    return a.GetRaw() == b.GetRaw();
+}
+
+template<unsigned short SHIFT_POINT>
+bool operator!=(const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b)
+{
+    return a.GetRaw() != b.GetRaw();
+}
+
+template<unsigned short SHIFT_POINT>
+bool operator<(const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b)
+{
+    return a.GetRaw() < b.GetRaw();
+}
+
+template<unsigned short SHIFT_POINT>
+bool operator<=(const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b)
+{
+    return a.GetRaw() <= b.GetRaw();
+}
+
+template<unsigned short SHIFT_POINT>
+bool operator>(const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b)
+{
+    return a.GetRaw() > b.GetRaw();
+}
+
+template<unsigned short SHIFT_POINT>
+bool operator>=(const FixPointNumberTemplate<SHIFT_POINT>& a, const FixPointNumberTemplate<SHIFT_POINT>& b)
+{
+    return a.GetRaw() >= b.GetRaw();
+}
 
 } // namespace CommonClass
@@ -1,4 +1,5 @@
 #include "GeomentryBuilder.h"
+#include <algorithm>
 #include <array>
 #include <assert.h>
 
@@ -550,6 +551,25 @@ CommonClass::MeshData GeometryBuilder::BuildGeoSphere(const Types::F32& radius,
     return retData;
 }
 
+AABB GeometryBuilder::ComputeBoundingBox(const MeshData& mesh)
+{
+    if (mesh.m_vertices.empty())
+    {
+        return AABB(vector3::ZERO, vector3::ZERO);
+    }
+
+    AABB box(mesh.m_vertices[0].m_pos, mesh.m_vertices[0].m_pos);
+    for (const auto& vertex : mesh.m_vertices)
+    {
+        for (unsigned int axis = 0; axis < 3; ++axis)
+        {
+            box.m_minPoint.m_arr[axis] = std::min(box.m_minPoint.m_arr[axis], vertex.m_pos.m_arr[axis]);
+            box.m_maxPoint.m_arr[axis] = std::max(box.m_maxPoint.m_arr[axis], vertex.m_pos.m_arr[axis]);
+        }
+    }
+    return box;
+}
+
 void GeometryBuilder::Subdivide(MeshData & target)
 {
     using namespace Types;
@@ -2,6 +2,7 @@
 
 #include "vector3.h"
 #include "vector2.h"
+#include "AABB.h"
 /*!
     \brief this file declare some tools for generate basic geometries like cube, sphere, grid
 */
@@ -79,6 +80,11 @@ public:
     */
     static MeshData BuildGeoSphere(const Types::F32& radius, const Types::U32 subdivide = 0);
 
+    /*!
+        \brief the object space bounding box of the vertices, for culling the draws of the mesh.
+    */
+    static AABB ComputeBoundingBox(const MeshData& mesh);
+
 protected:
     /*!
         \brief subdivide the mesh data by interpolate vertex in each triangle, subdivides each triangle to four sub triangle.
@@ -132,6 +132,7 @@ void GraphicToolSet::CommonRenderingBuffer::BuildMeshDatas()
             vertices.push_back(SimplePoint(vertex.m_pos.Tovector4(), vertex.m_normal.Tovector4(0.0f), vertex.m_uv * 3.0f));
         }
         prebuildMeshData[i].indices = rawData.m_indices;
+        prebuildMeshData[i].bound = GeometryBuilder::ComputeBoundingBox(rawData);
         prebuildMeshData[i].vertexBuffer = std::make_unique<F32Buffer>(vertices.size() * sizeof(decltype(vertices)::value_type));
         memcpy(prebuildMeshData[i].vertexBuffer->GetBuffer(), vertices.data(), prebuildMeshData[i].vertexBuffer->GetSizeOfByte());
     }
@@ -230,6 +231,50 @@ GraphicToolSet::VertexShaderSig GraphicToolSet::GetVertexShaderWithVSOut(Constan
     };
 }
 
+GraphicToolSet::BatchVertexShaderSig GraphicToolSet::GetBatchVertexShaderWithNormalAndConstantBuffer(ConstantBufferForInstance& constBufInstance, ConstantBufferForCamera& constBufCamera)
+{
+    return [&constBufInstance, &constBufCamera](const unsigned char * pSrc, unsigned int srcStride, ScreenSpaceVertexTemplate * pDestV, unsigned int destStride, unsigned int count)->void {
+        const SimplePoint* pSrcH = reinterpret_cast<const SimplePoint*>(pSrc);
+        SimplePoint* pDestH = reinterpret_cast<SimplePoint*>(pDestV);
+
+        // concatenate the matrices once for all the vertices.
+        const Transform toProject               = constBufCamera.m_project * constBufCamera.m_toCamera * constBufInstance.m_toWorld;
+        const Transform transformNormalToCamera = (constBufInstance.m_toWorldInverse * constBufCamera.m_toCameraInverse).T();// take transposes
+
+        TransformArray(&pDestH->m_position, destStride, &pSrcH->m_position, srcStride, toProject, count);
+        TransformNormalArray(&pDestH->m_rayIndex, destStride, &pSrcH->m_rayIndex, srcStride, transformNormalToCamera, count);
+    };
+}
+
+GraphicToolSet::BatchVertexShaderSig GraphicToolSet::GetBatchVertexShaderWithVSOut(ConstantBufferForInstance& constBufInstance, ConstantBufferForCamera& constBufCamera)
+{
+    return [&constBufInstance, &constBufCamera](const unsigned char * pSrc, unsigned int srcStride, ScreenSpaceVertexTemplate * pDestV, unsigned int destStride, unsigned int count)->void {
+        const SimplePoint* pSrcH = reinterpret_cast<const SimplePoint*>(pSrc);
+        VSOut* pDest = reinterpret_cast<VSOut*>(pDestV);
+
+        // concatenate the matrices once for all the vertices.
+        const Transform worldToProject          = constBufCamera.m_project * constBufCamera.m_toCamera;
+        const Transform transformNormalToWorld  = constBufInstance.m_toWorldInverse.T();// take transposes
+
+        TransformArray(&pDest->m_posW, destStride, &pSrcH->m_position, srcStride, constBufInstance.m_toWorld, count);
+        TransformArray(&pDest->m_posH, destStride, &pDest->m_posW, destStride, worldToProject, count);
+        TransformNormalArray(&pDest->m_normalW, destStride, &pSrcH->m_rayIndex, srcStride, transformNormalToWorld, count);
+
+        // normalize and copy uv, vertex by vertex.
+        const unsigned char * pSrcVertex  = pSrc;
+        unsigned char *       pDestVertex = reinterpret_cast<unsigned char *>(pDestV);
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            VSOut* pOut = reinterpret_cast<VSOut*>(pDestVertex);
+            pOut->m_uv = reinterpret_cast<const SimplePoint*>(pSrcVertex)->m_uv;
+            pOut->m_normalW = Normalize(pOut->m_normalW.ToVector3()).Tovector4();
+
+            pSrcVertex  += srcStride;
+            pDestVertex += destStride;
+        }
+    };
+}
+
 vector4 GraphicToolSet::ColdToWarm(const vector3& normal, const vector3& WarmDirection /*= Normalize(vector3::UNIT)*/)
 {
     Types::F32 kw = 0.5f * (1 + dotProd(normal, WarmDirection));
@@ -402,45 +447,110 @@ GraphicToolSet::PixelShaderSig GraphicToolSet::GetPixelShaderForShadowMap(Consta
     };
 }
 
+namespace
+{
+
+/*!
+    \brief the point light and the spot light with shadow, isLit(inLightCamera) test the ndc location of the pixel in the light camera.
+*/
+template<typename IS_LIT_FUNC>
+vector4 ShadeWithSpotLightShadow(
+    const GraphicToolSet::PSIn*                 pPoint,
+    GraphicToolSet::ConstantBufferForInstance&  constBufInstance,
+    GraphicToolSet::ConstantBufferForCamera&    constBufCamera,
+    GraphicToolSet::ConstantBufferForCamera&    lightCamera,
+    IS_LIT_FUNC&&                               isLit)
+{
+    vector3 normal = Normalize(pPoint->m_normalW.ToVector3());
+    vector3 pixelPosW = pPoint->m_posW.ToVector3();
+    vector3 toEye = Normalize(constBufCamera.m_camPos - pixelPosW);
+
+    vector3 resultColor = GraphicToolSet::ComputePointLight(
+        constBufCamera.m_lights[0],
+        vector3(constBufInstance.m_material.m_diffuse.m_arr),
+        vector3(constBufInstance.m_material.m_fresnelR0.m_arr),
+        constBufInstance.m_material.m_shiness,
+        pixelPosW,
+        normal,
+        toEye);
+
+    if (constBufCamera.m_numLights == 2)
+    {
+        // consider shadow effect only of spot light.
+        vector4 inLightCameraH = lightCamera.m_project * lightCamera.m_toCamera * pPoint->m_posW;
+        vector3 inLightCamera = inLightCameraH.ToVector3();
+        inLightCamera = inLightCamera * (1.0f / inLightCameraH.m_w);
+
+        if (isLit(inLightCamera))
+        {
+            vector3 blinnSpot = GraphicToolSet::ComputeSpotLight(
+                constBufCamera.m_lights[1],
+                vector3(constBufInstance.m_material.m_diffuse.m_arr),
+                vector3(constBufInstance.m_material.m_fresnelR0.m_arr),
+                constBufInstance.m_material.m_shiness,
+                pixelPosW,
+                normal,
+                toEye);
+            resultColor = resultColor + blinnSpot;
+        }
+    }
+
+    vector4 color = vector4::BLACK;
+    color = resultColor;
+    return color;
+}
+
+}// anonymous namespace
+
 CommonClass::GraphicToolSet::PixelShaderSig GraphicToolSet::GetPixelShaderForShadowEffect(ConstantBufferForInstance& constBufInstance, ConstantBufferForCamera& constBufCamera, ConstantBufferForCamera& lightCamera, std::shared_ptr<Texture>& shadowMap)
 {
     return [&constBufInstance, &constBufCamera, &lightCamera, &shadowMap](const ScreenSpaceVertexTemplate* pVertex)->vector4 {
         assert(shadowMap->IsValid());
+        return ShadeWithSpotLightShadow(reinterpret_cast<const PSIn*>(pVertex), constBufInstance, constBufCamera, lightCamera,
+            [&shadowMap](const vector3& inLightCamera)->bool {
+                auto sampledDepth = shadowMap->Sample(0.5f + 0.5f * inLightCamera.m_x, 0.5f + 0.5f * inLightCamera.m_y);
+                return (sampledDepth.m_x + 0.01) > inLightCamera.m_z;
+            });
+    };
+}
+
+CommonClass::GraphicToolSet::PixelShaderSig GraphicToolSet::GetPixelShaderForShadowEffect(ConstantBufferForInstance& constBufInstance, ConstantBufferForCamera& constBufCamera, ConstantBufferForCamera& lightCamera, std::shared_ptr<DepthBuffer>& shadowMap, const Types::F32 bias /*= 0.005f*/)
+{
+    return [&constBufInstance, &constBufCamera, &lightCamera, &shadowMap, bias](const ScreenSpaceVertexTemplate* pVertex)->vector4 {
+        assert(shadowMap != nullptr);
+        return ShadeWithSpotLightShadow(reinterpret_cast<const PSIn*>(pVertex), constBufInstance, constBufCamera, lightCamera,
+            [&shadowMap, bias](const vector3& inLightCamera)->bool {
+                return shadowMap->SampleCompare(0.5f + 0.5f * inLightCamera.m_x, 0.5f + 0.5f * inLightCamera.m_y, inLightCamera.m_z - bias) > 0.0f;
+            });
+    };
+}
+
+CommonClass::GraphicToolSet::PixelShaderSig GraphicToolSet::GetPixelShaderWithCascadedShadow(ConstantBufferForInstance& constBufInstance, ConstantBufferForCamera& constBufCamera, std::shared_ptr<CascadedShadowMap>& shadowMap)
+{
+    return [&constBufInstance, &constBufCamera, &shadowMap](const ScreenSpaceVertexTemplate* pVertex)->vector4 {
+        assert(shadowMap != nullptr);
         const PSIn* pPoint = reinterpret_cast<const PSIn*>(pVertex);
 
         vector3 normal = Normalize(pPoint->m_normalW.ToVector3());
         vector3 pixelPosW = pPoint->m_posW.ToVector3();
         vector3 toEye = Normalize(constBufCamera.m_camPos - pixelPosW);
+        vector3 diffuse = vector3(constBufInstance.m_material.m_diffuse.m_arr);
 
-        vector3 resultColor = ComputePointLight(
-            constBufCamera.m_lights[0],
-            vector3(constBufInstance.m_material.m_diffuse.m_arr),
-            vector3(constBufInstance.m_material.m_fresnelR0.m_arr),
-            constBufInstance.m_material.m_shiness,
-            pixelPosW,
-            normal,
-            toEye);
+        vector3 resultColor = vector3(constBufCamera.m_ambientColor.m_arr) * diffuse;
 
-        if (constBufCamera.m_numLights == 2)
+        // the camera looks along -z.
+        const Types::F32 viewDepth = -(constBufCamera.m_toCamera * pPoint->m_posW).m_z;
+        const Types::F32 lit = shadowMap->SampleShadow(pixelPosW, normal, viewDepth);
+        if (lit > 0.0f)
         {
-            // consider shadow effect only of spot light.
-            vector4 inLightCameraH = lightCamera.m_project * lightCamera.m_toCamera * pPoint->m_posW;
-            vector3 inLightCamera = inLightCameraH.ToVector3();
-            inLightCamera = inLightCamera * (1.0f / inLightCameraH.m_w);
-            auto sampledDepth = shadowMap->Sample(0.5f + 0.5f * inLightCamera.m_x, 0.5f + 0.5f * inLightCamera.m_y);
-
-            if ((sampledDepth.m_x + 0.01) > inLightCamera.m_z)
-            {
-                vector3 blinnSpot = ComputeSpotLight(
-                    constBufCamera.m_lights[1],
-                    vector3(constBufInstance.m_material.m_diffuse.m_arr),
-                    vector3(constBufInstance.m_material.m_fresnelR0.m_arr),
-                    constBufInstance.m_material.m_shiness,
-                    pixelPosW,
-                    normal,
-                    toEye);
-                resultColor = resultColor + blinnSpot;
-            }
+            vector3 directional = ComputeDirectionalLight(
+                constBufCamera.m_lights[1],
+                diffuse,
+                vector3(constBufInstance.m_material.m_fresnelR0.m_arr),
+                constBufInstance.m_material.m_shiness,
+                normal,
+                toEye);
+            resultColor = resultColor + directional * lit;
         }
 
         vector4 color = vector4::BLACK;
@@ -480,8 +590,8 @@ CommonClass::vector3 GraphicToolSet::BlinnPhone(const vector3& lightStrength, co
 {
     using namespace Types;
     F32 m = shiness * 256.0f;
-    vector3 halfVec = Normalize(toEye + toLight);
-    F32 roughnessFactor = (m + 8.0f) * 0.125f * std::pow(std::max(dotProd(halfVec, normal), 0.0f), m);
+    vector3 halfVec = FastNormalize(toEye + toLight);
+    F32 roughnessFactor = (m + 8.0f) * 0.125f * MathTool::Pow<MathTool::FAST_MATH>(dotProd(halfVec, normal), m);
     vector3 fresnelFactor = SchlickFresnel(vector3(fresnelR0.m_arr), normal, toLight);
 
     vector3 specAlbedo = fresnelFactor * roughnessFactor;
@@ -513,6 +623,18 @@ CommonClass::vector3 GraphicToolSet::ComputePointLight(const LightBuffer& L, con
     return BlinnPhone(lightStrength, diffuseAlbedo, fresnelR0, shiness, toLight, toEye, normal);
 }
 
+CommonClass::vector3 GraphicToolSet::ComputeDirectionalLight(const LightBuffer& L, const vector3& diffuseAlbedo, const vector3& fresnelR0, const Types::F32 shiness, const vector3 normal, const vector3 toEye)
+{
+    using namespace Types;
+    vector3 toLight = -Normalize(L.m_direction);
+
+    // cosine law, no fade effect.
+    F32 ndotl = std::max(dotProd(toLight, normal), 0.0f);
+    vector3 lightStrength = vector3(L.m_color.m_arr) * ndotl;
+
+    return BlinnPhone(lightStrength, diffuseAlbedo, fresnelR0, shiness, toLight, toEye, normal);
+}
+
 CommonClass::vector3 GraphicToolSet::ComputeSpotLight(const LightBuffer& L, const vector3& diffuseAlbedo, const vector3& fresnelR0, const Types::F32 shiness, const vector3& posW, const vector3 normal, const vector3 toEye)
 {
     using namespace Types;
@@ -534,7 +656,7 @@ CommonClass::vector3 GraphicToolSet::ComputeSpotLight(const LightBuffer& L, cons
     lightStrength = lightStrength * att;
 
     // spot power
-    F32 spotFactor = std::pow(std::max(dotProd(-toLight, L.m_direction), 0.0f), L.m_spotPower);
+    F32 spotFactor = MathTool::Pow<MathTool::FAST_MATH>(dotProd(-toLight, L.m_direction), L.m_spotPower);
     lightStrength = lightStrength * spotFactor;
 
     return BlinnPhone(lightStrength, diffuseAlbedo, fresnelR0, shiness, toLight, toEye, normal);
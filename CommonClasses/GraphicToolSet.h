@@ -9,6 +9,7 @@
 #include "Pipline.h"
 #include "Texture.h"
 #include "CameraFrame.h"
+#include "CascadedShadowMap.h"
 #include <functional>
 #include <memory>
 #include <array>
@@ -26,6 +27,7 @@ class GraphicToolSet
 public:
     using PixelShaderSig  = std::function<vector4(const ScreenSpaceVertexTemplate*)>;
     using VertexShaderSig = std::function<void(const unsigned char * , ScreenSpaceVertexTemplate * pDestV)>;
+    using BatchVertexShaderSig = std::function<void(const unsigned char * pSrc, unsigned int srcStride, ScreenSpaceVertexTemplate * pDestV, unsigned int destStride, unsigned int count)>;
 
     // temp struct for generous case
     struct SimplePoint
@@ -143,6 +145,7 @@ public:
         {
             std::unique_ptr<F32Buffer>  vertexBuffer;
             std::vector<Types::U32>     indices;
+            AABB                        bound = AABB(vector3::ZERO, vector3::ZERO);   // the object space bounding box for culling.
         };
         enum
         {
@@ -225,6 +228,17 @@ public:
     */
     static VertexShaderSig GetVertexShaderWithVSOut(ConstantBufferForInstance& constBufInstance, ConstantBufferForCamera& constBufCamera);
 
+    /*!
+        \brief batch version of GetVertexShaderWithNormalAndConstantBuffer, set it to PiplineStateObject::m_batchVertexShader.
+        the matrix chain is concatenated once per draw call instead of once per vertex.
+    */
+    static BatchVertexShaderSig GetBatchVertexShaderWithNormalAndConstantBuffer(ConstantBufferForInstance& constBufInstance, ConstantBufferForCamera& constBufCamera);
+
+    /*!
+        \brief batch version of GetVertexShaderWithVSOut, set it to PiplineStateObject::m_batchVertexShader.
+    */
+    static BatchVertexShaderSig GetBatchVertexShaderWithVSOut(ConstantBufferForInstance& constBufInstance, ConstantBufferForCamera& constBufCamera);
+
     /*!
         \brief pixel shader for vertex that have normal.
     */
@@ -257,6 +271,19 @@ public:
     */
     static PixelShaderSig GetPixelShaderForShadowEffect(ConstantBufferForInstance& constBufInstance, ConstantBufferForCamera& constBufCamera, ConstantBufferForCamera& lightCamera, std::shared_ptr<Texture>& shadowMap);
 
+    /*!
+        \brief the shadow effect with a depth only shadow map (see PiplineStateObject::m_isDepthOnly),
+        which is read by the shadow compare sampler DepthBuffer::SampleCompare() in full float precision.
+        \param bias the ndc z offset to avoid the self shadowing.
+    */
+    static PixelShaderSig GetPixelShaderForShadowEffect(ConstantBufferForInstance& constBufInstance, ConstantBufferForCamera& constBufCamera, ConstantBufferForCamera& lightCamera, std::shared_ptr<DepthBuffer>& shadowMap, const Types::F32 bias = 0.005f);
+
+    /*!
+        \brief a directional light (lights[1] of the camera buffer, m_direction is where the light travels) shadowed by the cascaded shadow map,
+        and the ambient light.
+    */
+    static PixelShaderSig GetPixelShaderWithCascadedShadow(ConstantBufferForInstance& constBufInstance, ConstantBufferForCamera& constBufCamera, std::shared_ptr<CascadedShadowMap>& shadowMap);
+
     /*!
         \brief compute FresnelR0 efficiency by reflection index.
     */
@@ -275,6 +302,8 @@ public:
 
     static vector3 ComputePointLight(const LightBuffer& L, const vector3& diffuseAlbedo, const vector3& fresnelR0, const Types::F32 shiness, const vector3& posW, const vector3 normal, const vector3 toEye);
 
+    static vector3 ComputeDirectionalLight(const LightBuffer& L, const vector3& diffuseAlbedo, const vector3& fresnelR0, const Types::F32 shiness, const vector3 normal, const vector3 toEye);
+
     static vector3 ComputeSpotLight(const LightBuffer& L, const vector3& diffuseAlbedo, const vector3& fresnelR0, const Types::F32 shiness, const vector3& posW, const vector3 normal, const vector3 toEye);
 
 public:
@@ -1,35 +1,45 @@
 #include "Image.h"
+#include <algorithm>
 #include <assert.h>
-#include "Utils/svpng.inc"
+#include <exception>
+#include "PngEncoder.h"
 
 namespace CommonClass
 {
 
-Image::Image(const Types::U32 width, const Types::U32 height, const RGBA& initColor)
+Image::Image(const Types::U32 width, const Types::U32 height, const RGBA& initColor, const StorageFormat storageFormat)
 {
-    Init(width, height, initColor);
+    Init(width, height, initColor, storageFormat);
 }
 
 Image::Image(Image && moveObj)
 {
-    this->m_height      = moveObj.m_height;
-    this->m_width       = moveObj.m_width;
-    this->m_canvas      = std::move(moveObj.m_canvas);
-    this->m_floatCanvas = std::move(moveObj.m_floatCanvas);
+    this->m_height              = moveObj.m_height;
+    this->m_width               = moveObj.m_width;
+    this->m_canvas              = std::move(moveObj.m_canvas);
+    this->m_floatCanvas         = std::move(moveObj.m_floatCanvas);
+    this->m_storageFormat       = moveObj.m_storageFormat;
+    this->m_isByteCanvasDirty.store(moveObj.m_isByteCanvasDirty.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    this->m_clearTiles          = std::move(moveObj.m_clearTiles);
+    this->m_clearColor          = moveObj.m_clearColor;
 }
 
 Image::Image()
-    :m_width(0), m_height(0), m_canvas(0)
+    :m_width(0), m_height(0), m_canvas(0), m_storageFormat(FLOAT_STORAGE), m_isByteCanvasDirty(true)
 {
     // empty
 }
 
-Image& Image::operator=(const Image&& moveObj)
+Image& Image::operator=(Image&& moveObj)
 {
-    this->m_height      = moveObj.m_height;
-    this->m_width       = moveObj.m_width;
-    this->m_canvas      = std::move(moveObj.m_canvas);
-    this->m_floatCanvas = std::move(moveObj.m_floatCanvas);
+    this->m_height              = moveObj.m_height;
+    this->m_width               = moveObj.m_width;
+    this->m_canvas              = std::move(moveObj.m_canvas);
+    this->m_floatCanvas         = std::move(moveObj.m_floatCanvas);
+    this->m_storageFormat       = moveObj.m_storageFormat;
+    this->m_isByteCanvasDirty.store(moveObj.m_isByteCanvasDirty.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    this->m_clearTiles          = std::move(moveObj.m_clearTiles);
+    this->m_clearColor          = moveObj.m_clearColor;
     return *this;
 }
 
@@ -38,14 +48,32 @@ Image::~Image()
     // empty
 }
 
-void Image::Init(const Types::U32 width, const Types::U32 height, const RGBA& initColor /*= RGBA::BLACK*/)
+void Image::Init(const Types::U32 width, const Types::U32 height, const RGBA& initColor /*= RGBA::BLACK*/, const StorageFormat storageFormat /*= FLOAT_STORAGE*/)
 {
     assert(width > 0 && height > 0);
 
     m_width = width;
     m_height = height;
-    m_canvas.resize(m_width * m_height);
-    m_floatCanvas.resize(m_width * m_height);
+    m_storageFormat = storageFormat;
+    m_isByteCanvasDirty.store(true, std::memory_order_relaxed);
+    m_clearTiles.Init(width, height);
+    // release the canvas which is not used, instead of keeping the capacity.
+    if (storageFormat == FLOAT_STORAGE)
+    {
+        std::vector<Pixel>().swap(m_canvas);
+    }
+    else
+    {
+        m_canvas.resize(m_width * m_height);
+    }
+    if (storageFormat == BYTE_STORAGE)
+    {
+        std::vector<vector4>().swap(m_floatCanvas);
+    }
+    else
+    {
+        m_floatCanvas.resize(m_width * m_height);
+    }
     vector4 initFloatPixel = vector4::WHITE;
 
     auto initPixel = CastPixel(initColor);
@@ -65,7 +93,47 @@ bool Image::IsValid() const
 {
     return m_width > 0 
         && m_height > 0 
-        && !m_canvas.empty();
+        && !(m_storageFormat == BYTE_STORAGE ? m_canvas.empty() : m_floatCanvas.empty());
+}
+
+void Image::SetStorageFormat(const StorageFormat storageFormat)
+{
+    if (storageFormat == m_storageFormat)
+    {
+        return;
+    }
+
+    if (m_storageFormat == BYTE_STORAGE)
+    {
+        // the float canvas is built from the bytes, which are still the same as the floats.
+        m_floatCanvas.resize(m_width * m_height);
+        PixelConverter::ByteToFloat(m_canvas.data(), m_floatCanvas.data(), m_width, m_height);
+        m_isByteCanvasDirty.store(false, std::memory_order_relaxed);
+    }
+    else if (storageFormat != FLOAT_STORAGE)
+    {
+        // the byte canvas must be allocated, and up to date if it becomes the only canvas.
+        if (m_canvas.empty())
+        {
+            m_canvas.resize(m_width * m_height);
+            m_isByteCanvasDirty.store(true, std::memory_order_relaxed);
+        }
+        if (storageFormat == BYTE_STORAGE && m_isByteCanvasDirty.load(std::memory_order_relaxed))
+        {
+            FloatPixelToBytePixel();
+        }
+    }
+
+    if (storageFormat == FLOAT_STORAGE)
+    {
+        std::vector<Pixel>().swap(m_canvas);
+        m_isByteCanvasDirty.store(true, std::memory_order_relaxed);
+    }
+    else if (storageFormat == BYTE_STORAGE)
+    {
+        std::vector<vector4>().swap(m_floatCanvas);
+    }
+    m_storageFormat = storageFormat;
 }
 
 void Image::SaveTo(const std::wstring & filePath)
@@ -86,8 +154,8 @@ void Image::SaveTo(const std::wstring & filePath)
     }
 
     // update byte pixels for output.
-    FloatPixelToBytePixel();
-    svpng(outputFile, m_width, m_height, reinterpret_cast<const unsigned char *>(m_canvas.data()), 1);
+    const std::vector<Types::U8> png = PngEncoder().Encode(GetRawData(), m_width, m_height);
+    fwrite(png.data(), 1, png.size(), outputFile);
 
     fclose(outputFile);
 }
@@ -110,8 +178,8 @@ void Image::SaveTo(const std::string& filePath)
     }
 
     // update byte pixels for output.
-    FloatPixelToBytePixel();
-    svpng(outputFile, m_width, m_height, reinterpret_cast<const unsigned char *>(m_canvas.data()), 1);
+    const std::vector<Types::U8> png = PngEncoder().Encode(GetRawData(), m_width, m_height);
+    fwrite(png.data(), 1, png.size(), outputFile);
 
     fclose(outputFile);
 }
@@ -126,12 +194,43 @@ void Image::SaveTo(const std::string& filePath)
 
 void Image::ClearPixel(const vector4& pixel)
 {
-    for (auto& innerPixel : m_floatCanvas)
+    if (m_storageFormat == BYTE_STORAGE)
+    {
+        std::fill(m_canvas.begin(), m_canvas.end(), PixelConverter::ToPixel(pixel));
+        return;
+    }
+    // the tiles are filled later, only if they are used.
+    m_clearColor = pixel;
+    m_clearTiles.MarkAll();
+    m_isByteCanvasDirty.store(true, std::memory_order_relaxed);
+}
+
+void Image::FillClearedTile(const Types::U32 left, const Types::U32 bottom, const Types::U32 right, const Types::U32 top) const
+{
+    vector4* floatCanvas = const_cast<vector4*>(m_floatCanvas.data());
+    for (Types::U32 y = bottom; y < top; ++y)
     {
-        innerPixel = pixel;
+        const Types::U32 rowStart = To1DArrIndex(left, y);
+        std::fill(floatCanvas + rowStart, floatCanvas + rowStart + (right - left), m_clearColor);
     }
 }
 
+void Image::ResolveClearedTile(const Types::U32 x, const Types::U32 y)
+{
+    m_clearTiles.Resolve(x, y, [this](const Types::U32 left, const Types::U32 bottom, const Types::U32 right, const Types::U32 top)
+    {
+        FillClearedTile(left, bottom, right, top);
+    });
+}
+
+void Image::ResolveClearedTiles()
+{
+    m_clearTiles.ResolveAll([this](const Types::U32 left, const Types::U32 bottom, const Types::U32 right, const Types::U32 top)
+    {
+        FillClearedTile(left, bottom, right, top);
+    });
+}
+
 const Types::U32 Image::To1DArrIndex(const Types::U32 x, const Types::U32 y) const
 {
     assert((0 <= x && x < m_width) && (0 <= y && y < m_height)
@@ -155,20 +254,29 @@ const Types::U32 Image::To1DArrIndex(const Types::U32 x, const Types::U32 y) con
     return (m_height - 1 - y) * m_width + x;
 }
 
-void Image::FloatPixelToBytePixel()
+void Image::FloatPixelToBytePixel(const ColorEncoding encoding /*= LINEAR_ENCODING*/, const bool dither /*= false*/)
 {
-    for (int i = m_floatCanvas.size() - 1; i >= 0; --i)
+    if (m_storageFormat == BYTE_STORAGE)
     {
-        m_canvas[i] = m_floatCanvas[i];
+        return;
     }
+    // the byte canvas of FLOAT_STORAGE is built here for the first time.
+    m_canvas.resize(m_width * m_height);
+    ResolveClearedTiles();
+    PixelConverter::FloatToByte(m_floatCanvas.data(), m_canvas.data(), m_width, m_height, encoding, dither);
+    m_isByteCanvasDirty.store(false, std::memory_order_relaxed);
 }
 
-void Image::BytePixelToFloatPixel()
+void Image::BytePixelToFloatPixel(const ColorEncoding encoding /*= LINEAR_ENCODING*/)
 {
-    for (int i = m_floatCanvas.size() - 1; i >= 0; --i)
+    if (m_canvas.empty() || m_floatCanvas.empty())
     {
-        m_floatCanvas[i] = m_canvas[i].ToVector<vector4>();
+        return;
     }
+    PixelConverter::ByteToFloat(m_canvas.data(), m_floatCanvas.data(), m_width, m_height, encoding);
+    m_isByteCanvasDirty.store(false, std::memory_order_relaxed);
+    // all the pixels are overwritten.
+    m_clearTiles.Reset();
 }
 
 //void Image::SetPixel(const Types::U32 x, const Types::U32 y, const RGBA & pixel)
@@ -195,13 +303,35 @@ void Image::BytePixelToFloatPixel()
 
 void Image::SetPixel(const Types::U32 x, const Types::U32 y, const vector4& pixel)
 {
+    if (m_storageFormat == BYTE_STORAGE)
+    {
+        m_canvas[To1DArrIndex(x, y)] = PixelConverter::ToPixel(pixel);
+        return;
+    }
+    m_isByteCanvasDirty.store(true, std::memory_order_relaxed);
+    ResolveClearedTile(x, y);
     vector4& modifiedPixel = m_floatCanvas[To1DArrIndex(x, y)];
+#ifdef USING_SSE_MATH
+    // clamp the four channels by two instructions.
+    modifiedPixel = StoreSSE(_mm_min_ps(_mm_max_ps(LoadSSE(pixel), _mm_setzero_ps()), _mm_set1_ps(1.0f)));
+#else
     modifiedPixel = pixel;
     ClampChannels(modifiedPixel);
+#endif // USING_SSE_MATH
 }
 
 void Image::SetPixel(const Types::U32 x, const Types::U32 y, const vector3& pixel)
 {
+    if (m_storageFormat == BYTE_STORAGE)
+    {
+        // keep the alpha.
+        vector4 modifiedPixel = GetPixel(x, y);
+        modifiedPixel = pixel;
+        m_canvas[To1DArrIndex(x, y)] = PixelConverter::ToPixel(modifiedPixel);
+        return;
+    }
+    m_isByteCanvasDirty.store(true, std::memory_order_relaxed);
+    ResolveClearedTile(x, y);
     vector4& modifiedPixel = m_floatCanvas[To1DArrIndex(x, y)];
     modifiedPixel = pixel;
     ClampChannels(modifiedPixel);
@@ -209,19 +339,64 @@ void Image::SetPixel(const Types::U32 x, const Types::U32 y, const vector3& pixe
 
 void Image::SetAlpha(const Types::U32 x, const Types::U32 y, const Types::F32 & alpha)
 {
-    m_canvas[To1DArrIndex(x, y)].m_a = static_cast<Types::U8>(alpha * 255);
+    if (m_storageFormat == BYTE_STORAGE)
+    {
+        m_canvas[To1DArrIndex(x, y)].m_a = static_cast<Types::U8>(MathTool::clamp(alpha, 0.0f, 1.0f) * 255.0f + 0.5f);
+        return;
+    }
+    m_isByteCanvasDirty.store(true, std::memory_order_relaxed);
+    ResolveClearedTile(x, y);
     vector4& modifedPixel = m_floatCanvas[To1DArrIndex(x, y)];
     modifedPixel.m_w = MathTool::clamp(alpha, 0.0f, 1.0f);
 }
 
 CommonClass::vector4 Image::GetPixel(const Types::U32 x, const Types::U32 y) const
 {
+    if (m_storageFormat == BYTE_STORAGE)
+    {
+        return PixelConverter::ToVector(m_canvas[To1DArrIndex(x, y)]);
+    }
+    if (m_clearTiles.IsPending(x, y))
+    {
+        return m_clearColor;
+    }
     return m_floatCanvas[To1DArrIndex(x, y)];
 }
 
 unsigned char * Image::GetRawData()
 {
+    if (m_storageFormat != BYTE_STORAGE && (m_isByteCanvasDirty.load(std::memory_order_relaxed) || m_canvas.empty()))
+    {
+        FloatPixelToBytePixel();
+    }
     return reinterpret_cast<unsigned char*>(m_canvas.data());
 }
 
+const vector4 * Image::GetFloatRow(const Types::U32 y) const
+{
+    if (m_storageFormat == BYTE_STORAGE)
+    {
+        throw std::exception("the image with BYTE_STORAGE has no float rows");
+    }
+    m_clearTiles.ResolveRow(y, [this](const Types::U32 left, const Types::U32 bottom, const Types::U32 right, const Types::U32 top)
+    {
+        FillClearedTile(left, bottom, right, top);
+    });
+    return &m_floatCanvas[To1DArrIndex(0, y)];
+}
+
+vector4 * Image::GetFloatRow(const Types::U32 y)
+{
+    if (m_storageFormat == BYTE_STORAGE)
+    {
+        throw std::exception("the image with BYTE_STORAGE has no float rows");
+    }
+    m_isByteCanvasDirty.store(true, std::memory_order_relaxed);
+    m_clearTiles.ResolveRow(y, [this](const Types::U32 left, const Types::U32 bottom, const Types::U32 right, const Types::U32 top)
+    {
+        FillClearedTile(left, bottom, right, top);
+    });
+    return &m_floatCanvas[To1DArrIndex(0, y)];
+}
+
 }// namespace CommonClass
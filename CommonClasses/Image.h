@@ -1,7 +1,10 @@
 #pragma once
 #include "ColorTemplate.h"
+#include "FastClearTiles.h"
+#include "PixelConverter.h"
 #include "vector4.h"
 #include "vector3.h"
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -11,18 +14,56 @@ namespace CommonClass
 class Image
 {
 public:
+    /*!
+        \brief which canvases the image keeps.
+    */
+    enum StorageFormat
+    {
+        /*!
+            \brief the pixels are floats, the byte canvas is only built by the first GetRawData() or SaveTo(),
+            and converted again after the floats are modified. Most images are never saved, they never pay for the bytes.
+        */
+        FLOAT_STORAGE,
+
+        /*!
+            \brief the pixels are bytes, there is no float canvas, GetPixel()/SetPixel() convert the pixel,
+            GetFloatRow() is not supported. Such as the texture loaded from a file.
+        */
+        BYTE_STORAGE,
+
+        /*!
+            \brief like FLOAT_STORAGE, but the byte canvas is allocated in Init(), for the images displayed every frame.
+        */
+        FLOAT_AND_BYTE_STORAGE
+    };
 
 protected:
     /*!
         \brief store pixels, (1 byte for each channel).
+        empty until it is needed with FLOAT_STORAGE.
     */
     std::vector<Pixel> m_canvas;
 
     /*!
         \brief store pixels, (1 float for each channel).
+        empty with BYTE_STORAGE.
     */
     std::vector<vector4> m_floatCanvas;
 
+    StorageFormat m_storageFormat;
+
+    /*!
+        \brief whether the float canvas is modified after the byte canvas is converted,
+        atomic because SetPixel()/SetAlpha()/GetFloatRow() are called by the parallel workers, relaxed is enough for a flag.
+    */
+    std::atomic<bool> m_isByteCanvasDirty;
+
+    /*!
+        \brief the tiles of the float canvas which are cleared by ClearPixel() but not filled yet, and the clear color.
+    */
+    FastClearTiles m_clearTiles;
+    vector4 m_clearColor;
+
     /*!
         \brief the width and height of the image
         they should only be set once in the constructor of the Image.
@@ -35,12 +76,12 @@ public:
         \param width width of the image
         \param height height of the image
     */
-    Image(const Types::U32 width, const Types::U32 height, const RGBA& initColor = RGBA::BLACK);
+    Image(const Types::U32 width, const Types::U32 height, const RGBA& initColor = RGBA::BLACK, const StorageFormat storageFormat = FLOAT_STORAGE);
     Image();
     Image(const Image&) = delete;
     Image(Image&& moveObj);
     Image& operator=(const Image&) = delete;
-    Image& operator=(const Image&&);
+    Image& operator=(Image&&);
     ~Image();
 
     /*!
@@ -63,6 +104,8 @@ public:
 
     /*!
         \brief clear all pixel color.
+        with the float canvas, the pixels are not written here, the tiles are marked as cleared,
+        each tile is filled by the first write into it, or by the export (GetRawData(), SaveTo()).
     */
     //void ClearPixel(const Pixel&   pixel);
     void ClearPixel(const vector4& pixel);
@@ -103,29 +146,58 @@ public:
     Types::U32 GetWidth() const { return m_width; }
     Types::U32 GetHeight() const { return m_height; }
     
+    StorageFormat GetStorageFormat() const { return m_storageFormat; }
+
+    /*!
+        \brief the tiles cleared by ClearPixel() but not written yet.
+    */
+    const FastClearTiles& GetClearTiles() const { return m_clearTiles; }
+
     /*!
         \brief return byte pixel address for entire image, in which each channel in pixel is stored by one byte,
         each pixel has four channel, pixels placed from top left go right, and then step down.
         There is no padding between each row.
+        the byte canvas is built or converted here if the float pixels are modified.
     */
     unsigned char * GetRawData();
 
+    /*!
+        \brief return the float pixels of the row y (from bottom to top), the pixels of the row are continuous from left to right,
+        for the loops which go through all the pixels, writing by the pointer does not clamp the channels like SetPixel.
+        the non-const version mark the byte canvas dirty, get the row again after GetRawData() to keep writing.
+        the cleared tiles of the row are filled here, so the const version can be called on multiple threads.
+        throw with BYTE_STORAGE.
+    */
+    const vector4 * GetFloatRow(const Types::U32 y) const;
+    vector4 * GetFloatRow(const Types::U32 y);
+
     /*!
         \brief reset the image.
         \param width width of the image
         \param height height of the image
     */
-    void Init(const Types::U32 width, const Types::U32 height, const RGBA& initColor = RGBA::BLACK);
+    void Init(const Types::U32 width, const Types::U32 height, const RGBA& initColor = RGBA::BLACK, const StorageFormat storageFormat = FLOAT_STORAGE);
+
+    /*!
+        \brief change the storage format and keep the pixels, the canvas which is not needed anymore is released.
+    */
+    void SetStorageFormat(const StorageFormat storageFormat);
 
     /*!
         \brief update float pixel to byte pixel, (usage: get ready to store image to file)
+        the channels are clamped and rounded to the nearest byte, see PixelConverter.
+        GetRawData() and SaveTo() keep these bytes until the float pixels are modified, do nothing with BYTE_STORAGE.
+        \param encoding how the color channels are stored in the bytes.
+        \param dither whether to use the ordered dithering instead of the rounding, to break the banding.
     */
-    void FloatPixelToBytePixel();
+    void FloatPixelToBytePixel(const ColorEncoding encoding = LINEAR_ENCODING, const bool dither = false);
 
     /*!
         \brief byte pixel to float pixel, (usage: load image from file).
+        do nothing if there is no byte canvas or no float canvas, see SetStorageFormat().
+        \param encoding how the color channels are stored in the bytes.
     */
-    void BytePixelToFloatPixel();
+    void BytePixelToFloatPixel(const ColorEncoding encoding = LINEAR_ENCODING);
 
 protected:
     /*!
@@ -135,6 +207,18 @@ protected:
     */
     const Types::U32 To1DArrIndex(const Types::U32 x, const Types::U32 y) const;
 
+    /*!
+        \brief fill the cleared tile [left, right) * [bottom, top) with the clear color.
+        the tile is already the clear color for the readers, so it can be filled by the const functions.
+    */
+    void FillClearedTile(const Types::U32 left, const Types::U32 bottom, const Types::U32 right, const Types::U32 top) const;
+
+    /*!
+        \brief fill the cleared tiles before writing the pixel / the float canvas.
+    */
+    void ResolveClearedTile(const Types::U32 x, const Types::U32 y);
+    void ResolveClearedTiles();
+
     /*!
         \brief ensure value of each channel is in [0.0, 1.0f]
         v should has a member named as m_arr, whose type is float[]
@@ -0,0 +1,210 @@
+#include "ImagePyramid.h"
+#include <algorithm>
+#include <exception>
+#include "Utils/ParallelTool.h"
+
+namespace CommonClass
+{
+
+ImagePyramid::ImagePyramid(const Image& source, const DownsampleKernel kernel /*= BOX_KERNEL*/, const std::size_t memoryBudget /*= 0*/, const Types::U32 numThreads /*= 0*/)
+    :m_source(source), m_kernel(kernel), m_memoryBudget(memoryBudget), m_numThreads(numThreads)
+{
+    if ( ! source.IsValid())
+    {
+        throw std::exception("cannot build the pyramid of an empty image");
+    }
+
+    Types::U32 width = source.GetWidth(), height = source.GetHeight();
+    m_widths.push_back(width);
+    m_heights.push_back(height);
+    while (width > 1 || height > 1)
+    {
+        width  = std::max(width  / 2, 1u);
+        height = std::max(height / 2, 1u);
+        m_widths.push_back(width);
+        m_heights.push_back(height);
+    }
+    m_levels.resize(m_widths.size());
+}
+
+ImagePyramid::~ImagePyramid()
+{
+    // empty
+}
+
+std::shared_ptr<const Image> ImagePyramid::GetLevel(const Types::U32 level)
+{
+    if (level >= GetNumLevels())
+    {
+        throw std::exception("the level is out of the pyramid");
+    }
+    if (level == 0)
+    {
+        // share nothing, only point to the source.
+        return std::shared_ptr<const Image>(std::shared_ptr<const Image>(), &m_source);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_levels[level])
+    {
+        Touch(level);
+        return m_levels[level];
+    }
+
+    // build from the nearest finer level, the intermediate levels are kept too.
+    Types::U32 finer = level - 1;
+    while (finer > 0 && ! m_levels[finer])
+    {
+        --finer;
+    }
+    std::shared_ptr<const Image> current = finer == 0 ? GetLevel(0) : m_levels[finer];
+    for (Types::U32 l = finer + 1; l <= level; ++l)
+    {
+        current = std::make_shared<const Image>(Downsample(*current, m_kernel, m_numThreads));
+        m_levels[l] = current;
+        m_memoryUsage += ImageBytes(m_widths[l], m_heights[l]);
+        Touch(l);
+    }
+    return current;
+}
+
+Types::U32 ImagePyramid::LevelForSize(const Types::U32 maxWidth, const Types::U32 maxHeight) const
+{
+    for (Types::U32 level = 0; level < GetNumLevels(); ++level)
+    {
+        if (m_widths[level] <= maxWidth && m_heights[level] <= maxHeight)
+        {
+            return level;
+        }
+    }
+    return GetNumLevels() - 1;
+}
+
+bool ImagePyramid::IsLevelBuilt(const Types::U32 level) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return level == 0 || (level < GetNumLevels() && m_levels[level]);
+}
+
+std::size_t ImagePyramid::GetMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_memoryUsage;
+}
+
+std::size_t ImagePyramid::ImageBytes(const Types::U32 width, const Types::U32 height)
+{
+    return static_cast<std::size_t>(width) * height * sizeof(vector4);
+}
+
+Image ImagePyramid::Downsample(const Image& img, const DownsampleKernel kernel, const Types::U32 numThreads /*= 0*/)
+{
+    using namespace Types;
+    const U32 srcWidth  = img.GetWidth();
+    const U32 srcHeight = img.GetHeight();
+    const U32 dstWidth  = std::max(srcWidth  / 2, 1u);
+    const U32 dstHeight = std::max(srcHeight / 2, 1u);
+    Image result(dstWidth, dstHeight);
+
+    // the taps of output pixel n along one axis are the source pixels from (2 * n + firstTap), clamped to the border.
+    const U32 numTaps = kernel == BOX_KERNEL ? 2 : 4;
+    const I32 firstTap = kernel == BOX_KERNEL ? 0 : -1;
+    const F32 BOX_WEIGHTS[]  = { 0.5f, 0.5f };
+    const F32 TENT_WEIGHTS[] = { 0.125f, 0.375f, 0.375f, 0.125f };
+    const F32* weights = kernel == BOX_KERNEL ? BOX_WEIGHTS : TENT_WEIGHTS;
+    auto clampTap = [](const I32 coord, const U32 size)
+    {
+        return static_cast<U32>(std::min(std::max(coord, 0), static_cast<I32>(size) - 1));
+    };
+
+    // the source columns of each output column are computed once.
+    std::vector<U32> columns(dstWidth * numTaps);
+    for (U32 x = 0; x < dstWidth; ++x)
+    {
+        for (U32 i = 0; i < numTaps; ++i)
+        {
+            columns[x * numTaps + i] = clampTap(static_cast<I32>(2 * x) + firstTap + static_cast<I32>(i), srcWidth);
+        }
+    }
+
+    // the kernel is separable, the source rows are blended into one row first, then the columns of the blended row.
+    ParallelTool::ParallelFor(0, dstHeight, [&](const unsigned int y)
+    {
+        const vector4* rows[4];
+        for (U32 j = 0; j < numTaps; ++j)
+        {
+            rows[j] = img.GetFloatRow(clampTap(static_cast<I32>(2 * y) + firstTap + static_cast<I32>(j), srcHeight));
+        }
+        std::vector<vector4> blendedRow(srcWidth);
+        vector4* dstRow = result.GetFloatRow(y);
+#ifdef USING_SSE_MATH
+        for (U32 x = 0; x < srcWidth; ++x)
+        {
+            __m128 acc = _mm_mul_ps(LoadSSE(rows[0][x]), _mm_set1_ps(weights[0]));
+            for (U32 j = 1; j < numTaps; ++j)
+            {
+                acc = _mm_add_ps(acc, _mm_mul_ps(LoadSSE(rows[j][x]), _mm_set1_ps(weights[j])));
+            }
+            blendedRow[x] = StoreSSE(acc);
+        }
+        for (U32 x = 0; x < dstWidth; ++x)
+        {
+            const U32* taps = &columns[x * numTaps];
+            __m128 acc = _mm_mul_ps(LoadSSE(blendedRow[taps[0]]), _mm_set1_ps(weights[0]));
+            for (U32 i = 1; i < numTaps; ++i)
+            {
+                acc = _mm_add_ps(acc, _mm_mul_ps(LoadSSE(blendedRow[taps[i]]), _mm_set1_ps(weights[i])));
+            }
+            dstRow[x] = StoreSSE(acc);
+        }
+#else
+        for (U32 x = 0; x < srcWidth; ++x)
+        {
+            for (U32 c = 0; c < 4; ++c)
+            {
+                F32 acc = 0.0f;
+                for (U32 j = 0; j < numTaps; ++j)
+                {
+                    acc += rows[j][x].m_arr[c] * weights[j];
+                }
+                blendedRow[x].m_arr[c] = acc;
+            }
+        }
+        for (U32 x = 0; x < dstWidth; ++x)
+        {
+            const U32* taps = &columns[x * numTaps];
+            for (U32 c = 0; c < 4; ++c)
+            {
+                F32 acc = 0.0f;
+                for (U32 i = 0; i < numTaps; ++i)
+                {
+                    acc += blendedRow[taps[i]].m_arr[c] * weights[i];
+                }
+                dstRow[x].m_arr[c] = acc;
+            }
+        }
+#endif
+    }, 8, numThreads);
+
+    // the weights are positive and sum to one, so the result is in [0, 1] without clamping.
+    return result;
+}
+
+void ImagePyramid::Touch(const Types::U32 level)
+{
+    m_recentLevels.remove(level);
+    m_recentLevels.push_front(level);
+    if (m_memoryBudget == 0)
+    {
+        return;
+    }
+    while (m_memoryUsage > m_memoryBudget && m_recentLevels.size() > 1)
+    {
+        const Types::U32 leastRecent = m_recentLevels.back();
+        m_recentLevels.pop_back();
+        m_levels[leastRecent].reset();
+        m_memoryUsage -= ImageBytes(m_widths[leastRecent], m_heights[leastRecent]);
+    }
+}
+
+}// namespace CommonClass
@@ -0,0 +1,132 @@
+#pragma once
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Image.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief ImagePyramid is the chain of the reduced images of a source image, e.g. the mipmaps of a texture,
+    the level 0 is the source image, the size of level (n + 1) is half of level n (at least one pixel), until 1 * 1.
+    The levels are built lazily, a level is built from the nearest finer level which is already built,
+    so the levels which are never requested are never built.
+    The built levels are kept until the memory budget is exceeded, then the least recently used levels are released,
+    a released level is built again if it is requested later.
+    GetLevel can be called by multiple threads.
+*/
+class ImagePyramid
+{
+public:
+    /*!
+        \brief the kernel to downsample one level to the next level.
+    */
+    enum DownsampleKernel
+    {
+        /*!
+            \brief the average of the 2 * 2 pixels.
+        */
+        BOX_KERNEL,
+
+        /*!
+            \brief the separable tent [1, 3, 3, 1] / 8 over 4 * 4 pixels, it is smoother than the box (less aliasing),
+            same as the bilinear filter of half size.
+        */
+        TENT_KERNEL
+    };
+
+protected:
+    /*!
+        \brief the source image, it must be alive while the pyramid is used.
+    */
+    const Image& m_source;
+
+    DownsampleKernel m_kernel;
+
+    /*!
+        \brief the size of each level, include the level 0.
+    */
+    std::vector<Types::U32> m_widths;
+    std::vector<Types::U32> m_heights;
+
+    /*!
+        \brief the built levels, m_levels[0] is always empty because the level 0 is the source.
+    */
+    std::vector<std::shared_ptr<const Image>> m_levels;
+
+    /*!
+        \brief the built levels from the most recently used to the least recently used.
+    */
+    std::list<Types::U32> m_recentLevels;
+
+    std::size_t m_memoryBudget;
+    std::size_t m_memoryUsage = 0;
+    Types::U32 m_numThreads;
+
+    mutable std::mutex m_mutex;
+
+public:
+    /*!
+        \brief create the pyramid without building any level.
+        \param source the level 0, it must be alive while the pyramid is used.
+        \param memoryBudget the most bytes of the built levels (the level 0 is not counted), zero for no limit.
+        \param numThreads how many threads to downsample, zero for all the hardware threads.
+    */
+    explicit ImagePyramid(
+        const Image& source,
+        const DownsampleKernel kernel = BOX_KERNEL,
+        const std::size_t memoryBudget = 0,
+        const Types::U32 numThreads = 0);
+    ImagePyramid(const ImagePyramid&) = delete;
+    ImagePyramid& operator=(const ImagePyramid&) = delete;
+    ~ImagePyramid();
+
+    /*!
+        \brief get the level, build it and the missing finer levels if it is not built, throw if the level is out of range.
+        the returned image is still valid after the level is released by the budget, the level 0 is the source without copy.
+    */
+    std::shared_ptr<const Image> GetLevel(const Types::U32 level);
+
+    const Image& GetSource() const { return m_source; }
+
+    /*!
+        \brief the finest level whose size is not larger than maxWidth * maxHeight, e.g. the level of a thumbnail.
+    */
+    Types::U32 LevelForSize(const Types::U32 maxWidth, const Types::U32 maxHeight) const;
+
+    /*!
+        \brief whether the level is built and not released, the level 0 is always built.
+    */
+    bool IsLevelBuilt(const Types::U32 level) const;
+
+    Types::U32 GetNumLevels() const { return static_cast<Types::U32>(m_widths.size()); }
+    Types::U32 GetLevelWidth(const Types::U32 level) const { return m_widths[level]; }
+    Types::U32 GetLevelHeight(const Types::U32 level) const { return m_heights[level]; }
+
+    /*!
+        \brief the bytes of the built levels (the level 0 is not counted).
+    */
+    std::size_t GetMemoryUsage() const;
+
+    /*!
+        \brief the bytes of a level of width * height, the levels only have the float canvas (FLOAT_STORAGE).
+    */
+    static std::size_t ImageBytes(const Types::U32 width, const Types::U32 height);
+
+    /*!
+        \brief downsample the image to the half size by the kernel, the pixels out of the image are clamped to the border.
+        \param numThreads how many threads to downsample the rows, zero for all the hardware threads.
+    */
+    static Image Downsample(const Image& img, const DownsampleKernel kernel, const Types::U32 numThreads = 0);
+
+protected:
+    /*!
+        \brief move the level to the front of m_recentLevels, and release the least recently used levels except the level
+        if the budget is exceeded.
+    */
+    void Touch(const Types::U32 level);
+};
+
+}// namespace CommonClass
@@ -0,0 +1,84 @@
+#include "Instance.h"
+#include <assert.h>
+
+namespace CommonClass
+{
+
+Instance::Instance(std::shared_ptr<const Surface> object, const vector3& t, const vector3& r, const vector3& s)
+    :m_object(std::move(object)),
+    m_objectToWorld(Transform::TRS(t, r, s)),
+    m_worldToObject(Transform::InverseTRS(t, r, s)),
+    m_worldBox(vector3(), vector3())
+{
+    if (m_object.get() == nullptr)
+    {
+        throw std::exception("create instance failed: object is nullptr");
+    }
+
+    Transform inverse = m_worldToObject;
+    m_normalToWorld = inverse.T();
+
+    // transform the eight corners of the object box, and take the box around them.
+    const AABB objectBox = m_object->BoundingBox();
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        const vector3 corner(
+            (i & 1) ? objectBox.m_maxPoint.m_x : objectBox.m_minPoint.m_x,
+            (i & 2) ? objectBox.m_maxPoint.m_y : objectBox.m_minPoint.m_y,
+            (i & 4) ? objectBox.m_maxPoint.m_z : objectBox.m_minPoint.m_z);
+        const vector3 worldCorner(m_objectToWorld * corner.Tovector4(1.0f));
+
+        if (i == 0)
+        {
+            m_worldBox = AABB(worldCorner, worldCorner);
+        }
+        else
+        {
+            m_worldBox.Expand(AABB(worldCorner, worldCorner));
+        }
+    }
+}
+
+Instance::~Instance()
+{
+    // empty
+}
+
+bool Instance::Hit(const Ray & ray, const Types::F32 t0, const Types::F32 t1, HitRecord * pHitRec) const
+{
+    assert(pHitRec != nullptr && "argument nullptr error");
+
+    const vector3 objectOrigin   (m_worldToObject * ray.m_origin.Tovector4(1.0f));
+    const vector3 objectDirection(m_worldToObject * ray.m_direction.Tovector4(0.0f));
+
+    // the Ray normalize the direction, so the distance in object space is scaled by the length.
+    const Types::F32 scale = Length(objectDirection);
+    const Ray objectRay(objectOrigin, objectDirection);
+
+    if ( ! m_object->Hit(objectRay, t0 * scale, t1 * scale, pHitRec))
+    {
+        return false;
+    }
+
+    pHitRec->m_hitT     = pHitRec->m_hitT / scale;
+    pHitRec->m_hitPoint = ray.m_origin + pHitRec->m_hitT * ray.m_direction;
+    pHitRec->m_normal   = Normalize(vector3(m_normalToWorld * pHitRec->m_normal.Tovector4(0.0f)));
+    if (m_material.get() != nullptr)
+    {
+        pHitRec->m_material = m_material;
+    }
+
+    return true;
+}
+
+AABB Instance::BoundingBox() const
+{
+    return m_worldBox;
+}
+
+const std::shared_ptr<const Surface>& Instance::GetSharedObject() const
+{
+    return m_object;
+}
+
+} // namespace CommonClass
@@ -0,0 +1,69 @@
+#pragma once
+#include <memory>
+#include "Surface.h"
+#include "Transform.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief Instance place a shared object (typically a BVH of the object's primitives) into the world with a TRS transform,
+    many instances can reference the same object, so the geometry is stored only once.
+    The ray is transformed into the object space by the inverse transform before hit test,
+    and the hit record is transformed back to the world space.
+    If m_material is setted, it will override the material of the object.
+*/
+class Instance
+    : public Surface
+{
+protected:
+    /*!
+        \brief the shared object in its own space.
+    */
+    std::shared_ptr<const Surface> m_object;
+
+    Transform m_objectToWorld;
+    Transform m_worldToObject;
+
+    /*!
+        \brief the inverse transpose of m_objectToWorld, to transform the normal.
+    */
+    Transform m_normalToWorld;
+
+    /*!
+        \brief the bounding box in world space, computed once in the constructor.
+    */
+    AABB m_worldBox;
+
+public:
+    /*!
+        \brief place the object into the world.
+        \param object the shared object
+        \param t translation for x/y/z
+        \param r rotation x::pitch, y::yaw, z::roll, see Transform::TRS
+        \param s scaling for x/y/z, MUST not be zero.
+    */
+    Instance(std::shared_ptr<const Surface> object, const vector3& t, const vector3& r, const vector3& s);
+    ~Instance();
+
+    /*!
+        \brief hit test in the object space, the returned hit record is in the world space.
+        \param ray hit ray
+        \param t0 min T value
+        \param t1 max T value
+        \param pHitRec return the hit detail
+    */
+    virtual bool Hit(const Ray& ray, const Types::F32 t0, const Types::F32 t1, HitRecord* pHitRec) const override;
+
+    /*!
+        \brief the world space box that contains the transformed box of the object.
+    */
+    virtual AABB BoundingBox() const override;
+
+    /*!
+        \brief get the shared object.
+    */
+    const std::shared_ptr<const Surface>& GetSharedObject() const;
+};
+
+} // namespace CommonClass
@@ -0,0 +1,394 @@
+#include "OcclusionCuller.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include "assert.h"
+#ifdef USING_SSE_MATH
+#include <xmmintrin.h>
+#endif
+
+namespace CommonClass
+{
+
+CoarseDepthBuffer::CoarseDepthBuffer(const Types::U32 width, const Types::U32 height)
+    :DepthBuffer(width, height)
+{
+    if (width % 4 != 0)
+    {
+        throw std::exception("the width of the coarse depth buffer must be the times of four.");
+    }
+    Clear();
+}
+
+void CoarseDepthBuffer::Clear()
+{
+    SetAll(1.0f);
+    ResolveClearedTiles();
+}
+
+void CoarseDepthBuffer::RasterizeOccluder(
+    const Types::F32 x0, const Types::F32 y0,
+    const Types::F32 x1, const Types::F32 y1,
+    const Types::F32 x2, const Types::F32 y2,
+    const Types::F32 depth)
+{
+    using Types::F32;
+    using Types::I32;
+
+    // the rows are accessed directly.
+    ResolveClearedTiles();
+
+    const F32 area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+    if ( ! (std::abs(area) > 0.0f))
+    {
+        return;
+    }
+
+    // counter clock wise, the inside is on the left of the edges.
+    const F32 vx[3] = { x0, area > 0.0f ? x1 : x2, area > 0.0f ? x2 : x1 };
+    const F32 vy[3] = { y0, area > 0.0f ? y1 : y2, area > 0.0f ? y2 : y1 };
+
+    // the pixels whose centers are inside the bounding box of the triangle.
+    const F32 minX = std::max(std::ceil (std::min({ vx[0], vx[1], vx[2] }) - 0.5f), 0.0f);
+    const F32 minY = std::max(std::ceil (std::min({ vy[0], vy[1], vy[2] }) - 0.5f), 0.0f);
+    const F32 maxX = std::min(std::floor(std::max({ vx[0], vx[1], vx[2] }) - 0.5f), static_cast<F32>(m_width  - 1));
+    const F32 maxY = std::min(std::floor(std::max({ vy[0], vy[1], vy[2] }) - 0.5f), static_cast<F32>(m_height - 1));
+    if ( ! (minX <= maxX && minY <= maxY))
+    {
+        return;
+    }
+
+    // the edge function E(x, y) = A * x + B * y + C, positive on the left, the pixel centers on the edges are covered,
+    // so the adjacent triangles of a mesh leave no gap.
+    F32 A[3], B[3], C[3];
+    for (unsigned int k = 0; k < 3; ++k)
+    {
+        const unsigned int next = (k + 1) % 3;
+        A[k] = vy[k] - vy[next];
+        B[k] = vx[next] - vx[k];
+        C[k] = -(A[k] * vx[k] + B[k] * vy[k]);
+    }
+
+    const I32 startX = static_cast<I32>(minX) & ~3;
+    const I32 endX   = static_cast<I32>(maxX);
+#ifdef USING_SSE_MATH
+    const __m128 laneOffsets = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    const __m128 depthValue  = _mm_set1_ps(depth);
+    const __m128 zero        = _mm_setzero_ps();
+    const __m128 firstX      = _mm_set1_ps(minX);
+    const __m128 lastX       = _mm_set1_ps(maxX);
+    const __m128 stepX[3]    = { _mm_set1_ps(4.0f * A[0]), _mm_set1_ps(4.0f * A[1]), _mm_set1_ps(4.0f * A[2]) };
+    const __m128 startLanes  = _mm_add_ps(_mm_set1_ps(static_cast<F32>(startX)), laneOffsets);
+#endif
+    for (I32 y = static_cast<I32>(minY); y <= static_cast<I32>(maxY); ++y)
+    {
+        F32 * pRow = m_pBuffer + y * m_width;
+        const F32 centerY = y + 0.5f;
+#ifdef USING_SSE_MATH
+        __m128 laneX = startLanes;
+        __m128 edge[3];
+        for (unsigned int k = 0; k < 3; ++k)
+        {
+            edge[k] = _mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(A[k]), _mm_add_ps(laneX, _mm_set1_ps(0.5f))),
+                _mm_set1_ps(B[k] * centerY + C[k]));
+        }
+        for (I32 x = startX; x <= endX; x += 4)
+        {
+            // inside all the edges, and inside the bounding box.
+            __m128 isInside = _mm_and_ps(_mm_cmpge_ps(laneX, firstX), _mm_cmple_ps(laneX, lastX));
+            isInside = _mm_and_ps(isInside, _mm_cmpge_ps(edge[0], zero));
+            isInside = _mm_and_ps(isInside, _mm_cmpge_ps(edge[1], zero));
+            isInside = _mm_and_ps(isInside, _mm_cmpge_ps(edge[2], zero));
+
+            const __m128 oldDepth = _mm_loadu_ps(pRow + x);
+            const __m128 newDepth = _mm_min_ps(oldDepth, depthValue);
+            _mm_storeu_ps(pRow + x, _mm_or_ps(_mm_and_ps(isInside, newDepth), _mm_andnot_ps(isInside, oldDepth)));
+
+            laneX   = _mm_add_ps(laneX, _mm_set1_ps(4.0f));
+            edge[0] = _mm_add_ps(edge[0], stepX[0]);
+            edge[1] = _mm_add_ps(edge[1], stepX[1]);
+            edge[2] = _mm_add_ps(edge[2], stepX[2]);
+        }
+#else
+        for (I32 x = static_cast<I32>(minX); x <= endX; ++x)
+        {
+            const F32 centerX = x + 0.5f;
+            if (A[0] * centerX + B[0] * centerY + C[0] >= 0.0f
+                && A[1] * centerX + B[1] * centerY + C[1] >= 0.0f
+                && A[2] * centerX + B[2] * centerY + C[2] >= 0.0f)
+            {
+                pRow[x] = std::min(pRow[x], depth);
+            }
+        }
+#endif
+    }
+}
+
+void CoarseDepthBuffer::ErodeSilhouettes()
+{
+    using Types::F32;
+    using Types::U32;
+
+    ResolveClearedTiles();
+
+    // the maximum of the three rows below, at and above the row y, then the maximum of three columns.
+    std::vector<F32> rowMax(m_width);
+    std::vector<F32> previousRow(m_pBuffer, m_pBuffer + m_width);
+    std::vector<F32> currentRow(m_width);
+    for (U32 y = 0; y < m_height; ++y)
+    {
+        F32 * pRow = m_pBuffer + y * m_width;
+        std::copy(pRow, pRow + m_width, currentRow.begin());
+        const F32 * pAbove = y + 1 < m_height ? pRow + m_width : pRow;
+        U32 x = 0;
+#ifdef USING_SSE_MATH
+        for (; x + 4 <= m_width; x += 4)
+        {
+            const __m128 verticalMax = _mm_max_ps(
+                _mm_max_ps(_mm_loadu_ps(previousRow.data() + x), _mm_loadu_ps(currentRow.data() + x)),
+                _mm_loadu_ps(pAbove + x));
+            _mm_storeu_ps(rowMax.data() + x, verticalMax);
+        }
+#endif
+        for (; x < m_width; ++x)
+        {
+            rowMax[x] = std::max({ previousRow[x], currentRow[x], pAbove[x] });
+        }
+        for (x = 0; x < m_width; ++x)
+        {
+            pRow[x] = std::max({ rowMax[x > 0 ? x - 1 : x], rowMax[x], rowMax[x + 1 < m_width ? x + 1 : x] });
+        }
+        previousRow.swap(currentRow);
+    }
+}
+
+bool CoarseDepthBuffer::IsRectOccluded(
+    const Types::U32 minX, const Types::U32 minY,
+    const Types::U32 maxX, const Types::U32 maxY,
+    const Types::F32 nearestDepth) const
+{
+    using Types::F32;
+    assert(minX <= maxX && maxX < m_width && minY <= maxY && maxY < m_height);
+    assert( ! m_clearTiles.HasPendingTiles() && "the coarse depth buffer is not cleared by Clear()");
+
+#ifdef USING_SSE_MATH
+    const Types::U32 startX = minX & ~3u;
+    const __m128 laneOffsets = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    const __m128 nearest     = _mm_set1_ps(nearestDepth);
+    const __m128 firstX      = _mm_set1_ps(static_cast<F32>(minX));
+    const __m128 lastX       = _mm_set1_ps(static_cast<F32>(maxX));
+    for (Types::U32 y = minY; y <= maxY; ++y)
+    {
+        const F32 * pRow = m_pBuffer + y * m_width;
+        for (Types::U32 x = startX; x <= maxX; x += 4)
+        {
+            const __m128 laneX = _mm_add_ps(_mm_set1_ps(static_cast<F32>(x)), laneOffsets);
+            const __m128 isInRect = _mm_and_ps(_mm_cmpge_ps(laneX, firstX), _mm_cmple_ps(laneX, lastX));
+            // any pixel in the rectangle without a nearer occluder.
+            const __m128 isVisible = _mm_and_ps(isInRect, _mm_cmpge_ps(_mm_loadu_ps(pRow + x), nearest));
+            if (_mm_movemask_ps(isVisible) != 0)
+            {
+                return false;
+            }
+        }
+    }
+#else
+    for (Types::U32 y = minY; y <= maxY; ++y)
+    {
+        const F32 * pRow = m_pBuffer + y * m_width;
+        for (Types::U32 x = minX; x <= maxX; ++x)
+        {
+            if (pRow[x] >= nearestDepth)
+            {
+                return false;
+            }
+        }
+    }
+#endif
+    return true;
+}
+
+OcclusionCuller::OcclusionCuller(const Types::U32 width /*= 128*/, const Types::U32 height /*= 128*/)
+    :m_depthBuffer(width, height)
+{
+    // empty
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+    // empty
+}
+
+void OcclusionCuller::BeginFrame()
+{
+    m_depthBuffer.Clear();
+    m_isEroded = true;
+}
+
+void OcclusionCuller::RenderOccluder(
+    const std::vector<unsigned int>&    indices,
+    const F32Buffer*                    vertices,
+    const unsigned int                  vertexStride,
+    const Transform&                    objectToClip)
+{
+    assert(indices.size() % 3 == 0 && "indices is not the times of three, have incompleted triangle");
+
+    // transform each vertex once.
+    const unsigned int numVertices = static_cast<unsigned int>(vertices->GetSizeOfByte() / vertexStride);
+    std::vector<vector4> positionsH(numVertices);
+    const unsigned char * pSrc = vertices->GetBuffer();
+    for (unsigned int i = 0; i < numVertices; ++i)
+    {
+        positionsH[i] = objectToClip * (*reinterpret_cast<const vector4*>(pSrc + i * vertexStride));
+    }
+
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        RasterizeClipTriangle(positionsH[indices[i]], positionsH[indices[i + 1]], positionsH[indices[i + 2]]);
+    }
+}
+
+void OcclusionCuller::ReprojectPreviousDepth(const DepthBuffer& previousDepth, const Transform& previousClipToCurrentClip)
+{
+    using Types::F32;
+    using Types::I32;
+    using Types::U32;
+
+    const U32 width     = m_depthBuffer.GetWidth(),     height      = m_depthBuffer.GetHeight();
+    const U32 srcWidth  = previousDepth.GetWidth(),     srcHeight   = previousDepth.GetHeight();
+
+    // the farthest reprojected depth of each coarse pixel, negative if no point falls in it.
+    std::vector<F32> farthest(width * height, -1.0f);
+    for (U32 y = 0; y < srcHeight; ++y)
+    {
+        // the pixel centers of the previous target in ndc, the viewport cover the whole target.
+        const F32 ndcY = 2.0f * (y + 0.5f) / srcHeight - 1.0f;
+        for (U32 x = 0; x < srcWidth; ++x)
+        {
+            const F32 ndcX = 2.0f * (x + 0.5f) / srcWidth - 1.0f;
+            const F32 depth = previousDepth.ValueAt(x, y);
+            const vector4 posH = previousClipToCurrentClip * vector4(ndcX, ndcY, depth, 1.0f);
+            if ( ! (posH.m_w > 0.0f))
+            {
+                continue;
+            }
+            const F32 invW = 1.0f / posH.m_w;
+            const F32 coarseX = std::floor((posH.m_x * invW + 1.0f) * 0.5f * width);
+            const F32 coarseY = std::floor((posH.m_y * invW + 1.0f) * 0.5f * height);
+            if ( ! (0.0f <= coarseX && coarseX < width && 0.0f <= coarseY && coarseY < height))
+            {
+                continue;
+            }
+            // the empty pixels stay at the far plane, so the silhouettes are not occluders.
+            const F32 reprojectedDepth = depth >= 1.0f ? 1.0f : std::max(posH.m_z * invW, 0.0f);
+            F32& coarseDepth = farthest[static_cast<I32>(coarseY) * width + static_cast<I32>(coarseX)];
+            coarseDepth = std::max(coarseDepth, reprojectedDepth);
+        }
+    }
+
+    for (U32 y = 0; y < height; ++y)
+    {
+        for (U32 x = 0; x < width; ++x)
+        {
+            const F32 reprojectedDepth = farthest[y * width + x];
+            if (0.0f <= reprojectedDepth && reprojectedDepth < 1.0f)
+            {
+                F32& value = m_depthBuffer.Value(x, y);
+                value = std::min(value, reprojectedDepth);
+            }
+        }
+    }
+    m_isEroded = false;
+}
+
+bool OcclusionCuller::IsOccluded(const AABB& objectBound, const Transform& objectToClip)
+{
+    using Types::F32;
+
+    ++m_statistic.m_numTestedDraws;
+
+    if ( ! m_isEroded)
+    {
+        // the occluders are complete when the first draw is tested.
+        m_depthBuffer.ErodeSilhouettes();
+        m_isEroded = true;
+    }
+
+    const F32 width  = static_cast<F32>(m_depthBuffer.GetWidth());
+    const F32 height = static_cast<F32>(m_depthBuffer.GetHeight());
+    const vector3& minPoint = objectBound.m_minPoint;
+    const vector3& maxPoint = objectBound.m_maxPoint;
+    F32 minX = width, minY = height, maxX = 0.0f, maxY = 0.0f, nearestDepth = 1.0f;
+    for (unsigned int corner = 0; corner < 8; ++corner)
+    {
+        const vector4 posH = objectToClip * vector4(
+            (corner & 1) ? maxPoint.m_x : minPoint.m_x,
+            (corner & 2) ? maxPoint.m_y : minPoint.m_y,
+            (corner & 4) ? maxPoint.m_z : minPoint.m_z,
+            1.0f);
+
+        // the box crossing the near plane cover the whole screen.
+        if ( ! (posH.m_w > 0.0f && posH.m_z >= 0.0f))
+        {
+            return false;
+        }
+        const F32 invW = 1.0f / posH.m_w;
+        const F32 x = (posH.m_x * invW + 1.0f) * 0.5f * width;
+        const F32 y = (posH.m_y * invW + 1.0f) * 0.5f * height;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        nearestDepth = std::min(nearestDepth, posH.m_z * invW);
+    }
+
+    // the coarse pixels which intersect the rectangle.
+    minX = std::max(std::floor(minX), 0.0f);
+    minY = std::max(std::floor(minY), 0.0f);
+    maxX = std::min(std::floor(maxX), width  - 1.0f);
+    maxY = std::min(std::floor(maxY), height - 1.0f);
+    if ( ! (minX <= maxX && minY <= maxY))
+    {
+        // out of the screen, it's the job of the frustum culling.
+        return false;
+    }
+
+    const bool isOccluded = m_depthBuffer.IsRectOccluded(
+        static_cast<Types::U32>(minX), static_cast<Types::U32>(minY),
+        static_cast<Types::U32>(maxX), static_cast<Types::U32>(maxY),
+        nearestDepth);
+    if (isOccluded)
+    {
+        ++m_statistic.m_numOccludedDraws;
+    }
+    return isOccluded;
+}
+
+bool OcclusionCuller::RasterizeClipTriangle(const vector4& p0, const vector4& p1, const vector4& p2)
+{
+    using Types::F32;
+
+    // the triangles crossing the near plane have no simple projection, they are skipped as the occluders are optional.
+    if ( ! (p0.m_w > 0.0f && p1.m_w > 0.0f && p2.m_w > 0.0f
+        && p0.m_z >= 0.0f && p1.m_z >= 0.0f && p2.m_z >= 0.0f))
+    {
+        return false;
+    }
+
+    const F32 halfWidth  = 0.5f * m_depthBuffer.GetWidth();
+    const F32 halfHeight = 0.5f * m_depthBuffer.GetHeight();
+    const F32 invW0 = 1.0f / p0.m_w, invW1 = 1.0f / p1.m_w, invW2 = 1.0f / p2.m_w;
+
+    // the farthest depth is never nearer than the triangle at any pixel.
+    m_depthBuffer.RasterizeOccluder(
+        (p0.m_x * invW0 + 1.0f) * halfWidth, (p0.m_y * invW0 + 1.0f) * halfHeight,
+        (p1.m_x * invW1 + 1.0f) * halfWidth, (p1.m_y * invW1 + 1.0f) * halfHeight,
+        (p2.m_x * invW2 + 1.0f) * halfWidth, (p2.m_y * invW2 + 1.0f) * halfHeight,
+        std::max({ p0.m_z * invW0, p1.m_z * invW1, p2.m_z * invW2 }));
+    ++m_statistic.m_numOccluderTriangles;
+    m_isEroded = false;
+    return true;
+}
+
+}// namespace CommonClass
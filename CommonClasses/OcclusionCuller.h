@@ -0,0 +1,163 @@
+#pragma once
+#include <vector>
+#include "AABB.h"
+#include "DepthBuffer.h"
+#include "F32Buffer.h"
+#include "Transform.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief CoarseDepthBuffer is a low resolution depth buffer for the occlusion culling, which store the ndc z (0 for the near plane).
+    The pixel (x, y) cover the square [x, x + 1) * [y, y + 1) of the buffer, which is the ndc square scaled to the buffer size,
+    so one coarse pixel cover a block of the pixels of the full resolution target.
+    The occluders are rasterized at the pixel centers with the farthest depth of each triangle,
+    then ErodeSilhouettes() keep the farthest depth of the 3 * 3 neighbors, so the pixels partly covered at the silhouettes
+    get the depth of what is behind, and a stored depth is never nearer than the real occluders in the pixel
+    (for the occluders wider than a coarse pixel).
+    The rows are processed by four pixels at once with SSE, the width must be the times of four.
+*/
+class CoarseDepthBuffer : public DepthBuffer
+{
+public:
+    CoarseDepthBuffer(const Types::U32 width, const Types::U32 height);
+
+    /*!
+        \brief set all the pixels to the far plane (1), the pixels are written directly so the rows can be read without the tiles.
+    */
+    void Clear();
+
+    /*!
+        \brief rasterize an occluder triangle, the pixels whose centers are inside the triangle or on the edges are written.
+        \param x0~y2 the vertices in the buffer space, any winding.
+        \param depth the farthest ndc z of the triangle, the written pixels keep the smaller depth.
+    */
+    void RasterizeOccluder(
+        const Types::F32 x0, const Types::F32 y0,
+        const Types::F32 x1, const Types::F32 y1,
+        const Types::F32 x2, const Types::F32 y2,
+        const Types::F32 depth);
+
+    /*!
+        \brief replace each pixel by the farthest depth of the 3 * 3 pixels around it, after all the occluders are drawn.
+        the occluders shrink by one pixel, the pixels out of the buffer are ignored.
+    */
+    void ErodeSilhouettes();
+
+    /*!
+        \brief whether all the pixels in the rectangle are nearer than the depth.
+        \param minX~maxY the pixel rectangle, inclusive, inside the buffer.
+        \param nearestDepth the nearest ndc z of the tested object.
+    */
+    bool IsRectOccluded(
+        const Types::U32 minX, const Types::U32 minY,
+        const Types::U32 maxX, const Types::U32 maxY,
+        const Types::F32 nearestDepth) const;
+};
+
+/*!
+    \brief OcclusionCuller skip the draws hidden by the big objects, before they are submitted to the pipline.
+    Each frame the selected occluders (walls, buildings, terrain) are drawn into a CoarseDepthBuffer by RenderOccluder(),
+    and the depth of the previous frame can be reprojected into it by ReprojectPreviousDepth(),
+    then IsOccluded() project the bounding box of a draw to a screen rectangle with its nearest depth,
+    the draw is occluded if every coarse pixel of the rectangle has a nearer occluder.
+    The occluders are eroded by CoarseDepthBuffer::ErodeSilhouettes() before the first test of the frame.
+    The test is conservative except the gaps narrower than a coarse pixel, and the reprojected depth,
+    which may hide the disoccluded objects for one frame.
+    Use it by Pipline::SetOcclusionCuller(), then the draws with bounding boxes are tested before the vertex shader.
+*/
+class OcclusionCuller
+{
+public:
+    /*!
+        \brief the counters of the culler, accumulated until ResetStatistic().
+    */
+    struct Statistic
+    {
+        /*!
+            \brief how many occluder triangles are rasterized.
+        */
+        Types::U32 m_numOccluderTriangles = 0;
+
+        /*!
+            \brief how many bounding boxes are tested, and how many of them are occluded.
+        */
+        Types::U32 m_numTestedDraws = 0;
+        Types::U32 m_numOccludedDraws = 0;
+    };
+
+protected:
+    CoarseDepthBuffer m_depthBuffer;
+
+    /*!
+        \brief false if some occluders are drawn after the last erosion.
+    */
+    bool m_isEroded = true;
+
+    Statistic m_statistic;
+
+public:
+    /*!
+        \param width the width of the coarse depth buffer, the times of four.
+        \param height the height of the coarse depth buffer.
+    */
+    explicit OcclusionCuller(const Types::U32 width = 128, const Types::U32 height = 128);
+    ~OcclusionCuller();
+
+    /*!
+        \brief clear the coarse depth buffer for a new frame.
+    */
+    void BeginFrame();
+
+    /*!
+        \brief rasterize the triangles of an occluder mesh.
+        \param indices the triangle list.
+        \param vertices the vertex buffer, the position is the first vector4 of each vertex (w is 1), the same as the vertex shader input.
+        \param vertexStride the size of a vertex in bytes.
+        \param objectToClip the transformation from the object space to the homogeneous clip space.
+        the triangles crossing the near plane are skipped.
+    */
+    void RenderOccluder(
+        const std::vector<unsigned int>&    indices,
+        const F32Buffer*                    vertices,
+        const unsigned int                  vertexStride,
+        const Transform&                    objectToClip);
+
+    /*!
+        \brief the hook to reuse the depth of the previous frame, such as a depth only target (PiplineStateObject::m_isDepthOnly).
+        each pixel of the previous depth is reprojected as a point, a coarse pixel keep the farthest depth of the points in it,
+        the coarse pixels without any point (disoccluded) or with an empty point (silhouette) are not occluders,
+        and the pixels next to them are removed by the erosion.
+        \param previousDepth the ndc z of the previous frame, the viewport cover the whole buffer.
+        \param previousClipToCurrentClip the transformation from the clip space of the previous frame to the current one,
+        e.g. currentProject * currentToCamera * previousCameraToWorld * Transform::InversePerspectiveFOV(...).
+    */
+    void ReprojectPreviousDepth(const DepthBuffer& previousDepth, const Transform& previousClipToCurrentClip);
+
+    /*!
+        \brief whether the bounding box is hidden by the occluders.
+        \param objectBound the bounding box in the object space.
+        \param objectToClip the transformation from the object space to the homogeneous clip space.
+        \return false if the box cross the near plane or out of the screen.
+    */
+    bool IsOccluded(const AABB& objectBound, const Transform& objectToClip);
+
+    /*!
+        \brief the coarse depth, which is eroded only after a draw is tested.
+    */
+    const CoarseDepthBuffer& GetDepthBuffer() const { return m_depthBuffer; }
+
+    const Statistic& GetStatistic() const { return m_statistic; }
+
+    void ResetStatistic() { m_statistic = Statistic(); }
+
+protected:
+    /*!
+        \brief rasterize a triangle in the homogeneous clip space.
+        \return false if the triangle is skipped.
+    */
+    bool RasterizeClipTriangle(const vector4& p0, const vector4& p1, const vector4& p2);
+};
+
+}// namespace CommonClass
@@ -1,8 +1,12 @@
 #include "Pipline.h"
 #include <array>
+#include <algorithm>
+#include <cmath>
 #include "DebugConfigs.h"
 #include "EFloat.h"
 #include "EdgeEquation2D.h"
+#include "FixPointNumber.h"
+#include "OcclusionCuller.h"
 
 namespace CommonClass
 {
@@ -33,6 +37,16 @@ void Pipline::SetBackBuffer(std::shared_ptr<Image> backBuffer)
     m_depthBuffer->SetAll(0.0f);
 }
 
+void Pipline::SetDepthTarget(std::shared_ptr<DepthBuffer> depthTarget)
+{
+    m_depthTarget = std::move(depthTarget);
+}
+
+void Pipline::SetOcclusionCuller(std::shared_ptr<OcclusionCuller> occlusionCuller)
+{
+    m_occlusionCuller = std::move(occlusionCuller);
+}
+
 void Pipline::ClearBackBuffer(const vector4& background, const Types::F32& depthValue /*= 0*/)
 {
     if (m_backBuffer != nullptr)
@@ -41,7 +55,7 @@ void Pipline::ClearBackBuffer(const vector4& background, const Types::F32& depth
     }
     if (m_depthBuffer != nullptr)
     {
-        m_depthBuffer->SetAll(0.0f);
+        m_depthBuffer->SetAll(depthValue);
     }
 }
 
@@ -55,8 +69,71 @@ std::shared_ptr<PiplineStateObject> Pipline::GetPSO()
     return m_pso;
 }
 
+bool Pipline::DrawInstance(const std::vector<unsigned int>& indices, const F32Buffer * vertices, const AABB & objectBound, const Transform & objectToClip)
+{
+    const bool isOutside = IsOutsideFrustum(objectBound, objectToClip);
+    const bool isOccluded = ! isOutside && m_occlusionCuller != nullptr && m_occlusionCuller->IsOccluded(objectBound, objectToClip);
+    if (isOutside || isOccluded)
+    {
+        ++m_statistic.m_numDraws;
+        ++(isOutside ? m_statistic.m_numFrustumCulledDraws : m_statistic.m_numOccludedDraws);
+        if (m_pso != nullptr && m_pso->m_vertexLayout.vertexShaderInputSize > 0)
+        {
+            m_statistic.m_numCulledVertices += vertices->GetSizeOfByte() / m_pso->m_vertexLayout.vertexShaderInputSize;
+        }
+        return false;
+    }
+    DrawInstance(indices, vertices);
+    return true;
+}
+
+bool Pipline::IsOutsideFrustum(const AABB & objectBound, const Transform & objectToClip)
+{
+    // one bit for each plane, a corner set the bit when it's on the outer side.
+    enum
+    {
+        OUT_LEFT    = 1 << 0,
+        OUT_RIGHT   = 1 << 1,
+        OUT_BOTTOM  = 1 << 2,
+        OUT_TOP     = 1 << 3,
+        OUT_NEAR    = 1 << 4,
+        OUT_FAR     = 1 << 5,
+        OUT_ALL     = (1 << 6) - 1
+    };
+
+    const vector3& minPoint = objectBound.m_minPoint;
+    const vector3& maxPoint = objectBound.m_maxPoint;
+    unsigned int outsideAll = OUT_ALL;
+    for (unsigned int corner = 0; corner < 8; ++corner)
+    {
+        const vector4 posH = objectToClip * vector4(
+            (corner & 1) ? maxPoint.m_x : minPoint.m_x,
+            (corner & 2) ? maxPoint.m_y : minPoint.m_y,
+            (corner & 4) ? maxPoint.m_z : minPoint.m_z,
+            1.0f);
+
+        unsigned int outside = 0;
+        outside |= posH.m_x < -posH.m_w ? OUT_LEFT   : 0;
+        outside |= posH.m_x >  posH.m_w ? OUT_RIGHT  : 0;
+        outside |= posH.m_y < -posH.m_w ? OUT_BOTTOM : 0;
+        outside |= posH.m_y >  posH.m_w ? OUT_TOP    : 0;
+        outside |= posH.m_z <  0.0f     ? OUT_NEAR   : 0;
+        outside |= posH.m_z >  posH.m_w ? OUT_FAR    : 0;
+
+        outsideAll &= outside;
+        if (outsideAll == 0)
+        {
+            // the corners are not on the outer side of a same plane.
+            return false;
+        }
+    }
+    return true;
+}
+
 void Pipline::DrawInstance(const std::vector<unsigned int>& indices, const F32Buffer * vertices)
 {
+    ++m_statistic.m_numDraws;
+
     if (nullptr == m_pso.get())
     {
         throw std::exception("lack of pipline state object");
@@ -68,16 +145,28 @@ void Pipline::DrawInstance(const std::vector<unsigned int>& indices, const F32Bu
         throw std::exception("unsupported primitive type");
     }
 
-    if (m_pso->m_pixelShader == nullptr)
+    if (m_pso->m_pixelShader == nullptr && ! m_pso->m_isDepthOnly)
     {
         throw std::exception("pipline state object lack of pixel shader.");
     }
 
-    if (m_pso->m_vertexShader == nullptr)
+    if (m_pso->m_vertexShader == nullptr && m_pso->m_batchVertexShader == nullptr)
     {
         throw std::exception("pipline state object lack of vertex shader.");
     }
 
+    if (m_pso->m_isDepthOnly)
+    {
+        if (m_pso->m_primitiveType != PrimitiveType::TRIANGLE_LIST || m_pso->m_fillMode != FillMode::SOLIDE)
+        {
+            throw std::exception("depth only mode only support solid triangle list.");
+        }
+        if (m_depthTarget == nullptr)
+        {
+            throw std::exception("lack of depth target for depth only mode.");
+        }
+    }
+
     // the vertex size which will be passed to vertexShader
     const unsigned int vsInputStride = m_pso->m_vertexLayout.vertexShaderInputSize;
     // the vertex size which will be passed to pixelShader
@@ -90,6 +179,12 @@ void Pipline::DrawInstance(const std::vector<unsigned int>& indices, const F32Bu
     DEBUG_CLIENT(DEBUG_CLIENT_CONF_TRIANGL);
     std::unique_ptr<F32Buffer> vsOutputStream = VertexShaderTransform(vertices, vsInputStride, psInputStride);
 
+    if (m_pso->m_isDepthOnly)
+    {
+        DrawTriangleListDepthOnly(indices, std::move(vsOutputStream), psInputStride);
+        return;
+    }
+
     if (m_pso->m_primitiveType == PrimitiveType::LINE_LIST)
     {
         // clip all the line
@@ -122,8 +217,14 @@ void Pipline::DrawInstance(const std::vector<unsigned int>& indices, const F32Bu
         //auto clippendData = std::make_unique<F32Buffer>(vertices->GetSizeOfByte());
         //memcpy(clippendData->GetBuffer(), vertices->GetBuffer(), clippendData->GetSizeOfByte());
 
+        std::vector<unsigned int> visibleIndices;
+        if (m_pso->m_isCullingBeforeClipping)
+        {
+            CullTrianglesBeforeClipping(indices, vsOutputStream.get(), psInputStride, &visibleIndices);
+        }
+
         std::unique_ptr<F32Buffer> clippedData;
-        ClipTriangleList(indices, std::move(vsOutputStream), psInputStride, &clippedIndices, &clippedData, m_frustumCutPlanes);
+        ClipTriangleList(m_pso->m_isCullingBeforeClipping ? visibleIndices : indices, std::move(vsOutputStream), psInputStride, &clippedIndices, &clippedData, m_frustumCutPlanes);
 
         auto viewportTransData = ViewportTransformVertexStream(std::move(clippedData), psInputStride);
         
@@ -261,6 +362,12 @@ void Pipline::DrawTriangle(
     const ScreenSpaceVertexTemplate * pv3, 
     const unsigned int realVertexSizeBytes)
 {
+    if (m_pso->m_rasterizeMode == FIXED_POINT_SUBPIXEL)
+    {
+        DrawTriangleFixedPoint(pv1, pv2, pv3, realVertexSizeBytes);
+        return;
+    }
+
     EdgeEquation2D 
         f12(pv1->m_posH, pv2->m_posH), 
         f23(pv2->m_posH, pv3->m_posH),
@@ -307,6 +414,226 @@ void Pipline::DrawTriangle(
     }// end for y, raws
 }
 
+void Pipline::DrawTriangleFixedPoint(
+    const ScreenSpaceVertexTemplate * pv1,
+    const ScreenSpaceVertexTemplate * pv2,
+    const ScreenSpaceVertexTemplate * pv3,
+    const unsigned int realVertexSizeBytes)
+{
+    using Types::I32;
+    using Types::I64;
+
+    std::array<const ScreenSpaceVertexTemplate*, 3> vertices = { pv1, pv2, pv3 };
+
+    // snap the vertex locations to the 28.4 subpixel grid,
+    // all the computations below are exact, so the shared edges of two triangles give the same result.
+    std::array<I32, 3> vx, vy;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        vx[i] = SubpixelNumber(vertices[i]->m_posH.m_x).GetRaw();
+        vy[i] = SubpixelNumber(vertices[i]->m_posH.m_y).GetRaw();
+    }
+
+    // twice the signed area, positive for counter clock wise.
+    // the products of two 28.4 numbers are stored in 64 bits to avoid overflow.
+    I64 area = static_cast<I64>(vx[1] - vx[0]) * (vy[2] - vy[0]) - static_cast<I64>(vy[1] - vy[0]) * (vx[2] - vx[0]);
+    if (area == 0)
+    {
+        // degenerated after snapping, no pixel is covered.
+        return;
+    }
+    if (area < 0)
+    {
+        // make the triangle counter clock wise, so the inside of each edge is positive.
+        std::swap(vertices[1], vertices[2]);
+        std::swap(vx[1], vx[2]);
+        std::swap(vy[1], vy[2]);
+        area = -area;
+    }
+
+    // pixel boundary, the sample point of pixel (x, y) is the integer location (x, y).
+    const I32 LEFT      = static_cast<I32>(m_pso->m_viewport.left);
+    const I32 RIGHT     = static_cast<I32>(m_pso->m_viewport.right);
+    const I32 BOTTOM    = static_cast<I32>(m_pso->m_viewport.bottom);
+    const I32 TOP       = static_cast<I32>(m_pso->m_viewport.top);
+    const I32 minX = std::max(SubpixelNumber::FromRaw(std::min({ vx[0], vx[1], vx[2] })).Ceil(),  LEFT);
+    const I32 minY = std::max(SubpixelNumber::FromRaw(std::min({ vy[0], vy[1], vy[2] })).Ceil(),  BOTTOM);
+    const I32 maxX = std::min(SubpixelNumber::FromRaw(std::max({ vx[0], vx[1], vx[2] })).Floor(), RIGHT);
+    const I32 maxY = std::min(SubpixelNumber::FromRaw(std::max({ vy[0], vy[1], vy[2] })).Floor(), TOP);
+    if (minX > maxX || minY > maxY)
+    {
+        return;
+    }
+
+    // edge i is the edge opposite to the vertex i, from vertex a to vertex b,
+    // edge(p) = (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x)
+    // so edge i at the sample point divided by area is the barycentric coordinate of vertex i.
+    const I32 SUBPIXEL_ONE = static_cast<I32>(SubpixelNumber::MAG);
+    std::array<I64, 3> stepX, stepY, rowStart, bias;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        const unsigned int a = (i + 1) % 3;
+        const unsigned int b = (i + 2) % 3;
+        const I32 dx = vx[b] - vx[a];
+        const I32 dy = vy[b] - vy[a];
+
+        // top-left fill rule: a sample exactly on a top edge or a left edge is inside, on the other edges it's outside.
+        // for a counter clock wise triangle, the left edges go down, the top edges are horizontal and go left.
+        const bool isTopLeft = dy < 0 || (dy == 0 && dx < 0);
+        bias[i] = isTopLeft ? 0 : -1;
+
+        stepX[i]    = -static_cast<I64>(dy) * SUBPIXEL_ONE;
+        stepY[i]    =  static_cast<I64>(dx) * SUBPIXEL_ONE;
+        rowStart[i] =  static_cast<I64>(dx) * (minY * SUBPIXEL_ONE - vy[a])
+                     - static_cast<I64>(dy) * (minX * SUBPIXEL_ONE - vx[a])
+                     + bias[i];
+    }
+
+    // pixel shader prepare
+    auto& pixelShader = m_pso->m_pixelShader;
+    auto  vertexBuf   = std::make_unique<F32Buffer>(realVertexSizeBytes);
+    auto  vertexPtr   = reinterpret_cast<ScreenSpaceVertexTemplate*>(vertexBuf->GetBuffer());
+
+    const Types::F32 invArea = 1.0f / static_cast<Types::F32>(area);
+    Types::F32 rhw = 0.0f;
+    for (I32 y = minY; y <= maxY; ++y)
+    {
+        std::array<I64, 3> w = rowStart;
+        for (I32 x = minX; x <= maxX; ++x)
+        {
+            // inside when all the three biased edge values are not negative, only the sign bits are tested.
+            if ((w[0] | w[1] | w[2]) >= 0)
+            {
+                const Types::F32 alpha = static_cast<Types::F32>(w[0] - bias[0]) * invArea;
+                const Types::F32 beta  = static_cast<Types::F32>(w[1] - bias[1]) * invArea;
+                const Types::F32 gamma = 1.0f - alpha - beta;
+
+                Interpolate3(   vertices[0],    vertices[1],    vertices[2],    vertexPtr,
+                                alpha,          beta,           gamma,          realVertexSizeBytes);
+
+                RecoverPerspective(vertexPtr, realVertexSizeBytes);
+
+                rhw = vertexPtr->m_posH.m_w;// rhw = 1/z where z is the world depth in camera space
+
+                if (rhw > m_depthBuffer->ValueAt(x, y))
+                {
+                    m_backBuffer->SetPixel(x, y, pixelShader(vertexPtr));
+                    m_depthBuffer->Value(x, y) = rhw;// update depth value
+                }
+            }
+
+            // step to the next pixel by integer adds.
+            w[0] += stepX[0];
+            w[1] += stepX[1];
+            w[2] += stepX[2];
+        }// end for x, columns
+
+        rowStart[0] += stepY[0];
+        rowStart[1] += stepY[1];
+        rowStart[2] += stepY[2];
+    }// end for y, raws
+}
+
+void Pipline::DrawTriangleDepthOnly(
+    const ScreenSpaceVertexTemplate * pv1,
+    const ScreenSpaceVertexTemplate * pv2,
+    const ScreenSpaceVertexTemplate * pv3)
+{
+    using Types::I32;
+    using Types::I64;
+
+    std::array<const ScreenSpaceVertexTemplate*, 3> vertices = { pv1, pv2, pv3 };
+
+    // the same setup as DrawTriangleFixedPoint(), so the depth only pass cover the same pixels as the color pass.
+    std::array<I32, 3> vx, vy;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        vx[i] = SubpixelNumber(vertices[i]->m_posH.m_x).GetRaw();
+        vy[i] = SubpixelNumber(vertices[i]->m_posH.m_y).GetRaw();
+    }
+
+    I64 area = static_cast<I64>(vx[1] - vx[0]) * (vy[2] - vy[0]) - static_cast<I64>(vy[1] - vy[0]) * (vx[2] - vx[0]);
+    if (area == 0)
+    {
+        return;
+    }
+    if (area < 0)
+    {
+        std::swap(vertices[1], vertices[2]);
+        std::swap(vx[1], vx[2]);
+        std::swap(vy[1], vy[2]);
+        area = -area;
+    }
+
+    // clamp to the viewport and the depth target.
+    DepthBuffer& depthTarget = *m_depthTarget;
+    const I32 LEFT      = std::max(static_cast<I32>(m_pso->m_viewport.left),   0);
+    const I32 RIGHT     = std::min(static_cast<I32>(m_pso->m_viewport.right),  static_cast<I32>(depthTarget.GetWidth()) - 1);
+    const I32 BOTTOM    = std::max(static_cast<I32>(m_pso->m_viewport.bottom), 0);
+    const I32 TOP       = std::min(static_cast<I32>(m_pso->m_viewport.top),    static_cast<I32>(depthTarget.GetHeight()) - 1);
+    const I32 minX = std::max(SubpixelNumber::FromRaw(std::min({ vx[0], vx[1], vx[2] })).Ceil(),  LEFT);
+    const I32 minY = std::max(SubpixelNumber::FromRaw(std::min({ vy[0], vy[1], vy[2] })).Ceil(),  BOTTOM);
+    const I32 maxX = std::min(SubpixelNumber::FromRaw(std::max({ vx[0], vx[1], vx[2] })).Floor(), RIGHT);
+    const I32 maxY = std::min(SubpixelNumber::FromRaw(std::max({ vy[0], vy[1], vy[2] })).Floor(), TOP);
+    if (minX > maxX || minY > maxY)
+    {
+        return;
+    }
+
+    const I32 SUBPIXEL_ONE = static_cast<I32>(SubpixelNumber::MAG);
+    std::array<I64, 3> stepX, stepY, rowStart, bias;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        const unsigned int a = (i + 1) % 3;
+        const unsigned int b = (i + 2) % 3;
+        const I32 dx = vx[b] - vx[a];
+        const I32 dy = vy[b] - vy[a];
+
+        const bool isTopLeft = dy < 0 || (dy == 0 && dx < 0);
+        bias[i] = isTopLeft ? 0 : -1;
+
+        stepX[i]    = -static_cast<I64>(dy) * SUBPIXEL_ONE;
+        stepY[i]    =  static_cast<I64>(dx) * SUBPIXEL_ONE;
+        rowStart[i] =  static_cast<I64>(dx) * (minY * SUBPIXEL_ONE - vy[a])
+                     - static_cast<I64>(dy) * (minX * SUBPIXEL_ONE - vx[a])
+                     + bias[i];
+    }
+
+    // the ndc z is affine in the screen space, z = z0 + beta * (z1 - z0) + gamma * (z2 - z0),
+    // no perspective recovering is needed.
+    const Types::F32 invArea = 1.0f / static_cast<Types::F32>(area);
+    const Types::F32 z0  = vertices[0]->m_posH.m_z;
+    const Types::F32 dz1 = (vertices[1]->m_posH.m_z - z0) * invArea;
+    const Types::F32 dz2 = (vertices[2]->m_posH.m_z - z0) * invArea;
+    for (I32 y = minY; y <= maxY; ++y)
+    {
+        std::array<I64, 3> w = rowStart;
+        for (I32 x = minX; x <= maxX; ++x)
+        {
+            if ((w[0] | w[1] | w[2]) >= 0)
+            {
+                const Types::F32 z = z0
+                    + static_cast<Types::F32>(w[1] - bias[1]) * dz1
+                    + static_cast<Types::F32>(w[2] - bias[2]) * dz2;
+
+                Types::F32& depth = depthTarget.Value(x, y);
+                if (z < depth)
+                {
+                    depth = z;
+                }
+            }
+
+            w[0] += stepX[0];
+            w[1] += stepX[1];
+            w[2] += stepX[2];
+        }// end for x, columns
+
+        rowStart[0] += stepY[0];
+        rowStart[1] += stepY[1];
+        rowStart[2] += stepY[2];
+    }// end for y, raws
+}
+
 void Pipline::FindTriangleBoundary(const ScreenSpaceVertexTemplate * pv1, const ScreenSpaceVertexTemplate * pv2, const ScreenSpaceVertexTemplate * pv3, std::array<Types::U32, 2>* minBound, std::array<Types::U32, 2>* maxBound)
 {
     assert(minBound != nullptr && maxBound != nullptr && "argument nullptr error");
@@ -856,26 +1183,107 @@ void Pipline::ClipTriangleList(
     
 }
 
+void Pipline::CullTrianglesBeforeClipping(
+    const std::vector<unsigned int>&    indices,
+    const F32Buffer*                    vertices,
+    const unsigned int                  realVertexSize,
+    std::vector<unsigned int> *         pVisibleIndices)
+{
+    assert(indices.size() % 3 == 0 && "indices is not the times of three, have incompleted triangle");
+
+    pVisibleIndices->clear();
+    pVisibleIndices->reserve(indices.size());
+
+    // the wire frames of the degenerated triangles are still lines.
+    const bool isSolid = m_pso->m_fillMode == FillMode::SOLIDE;
+    const CullFace cullFace = m_pso->m_cullFace;
+
+    // the screen location is (scale * ndc + offset), the samples are at the integer locations.
+    // the bounding box is extended by one subpixel, because the fixed point rasterizer snap the vertices.
+    const Transform& viewportTransform = m_pso->m_viewportTransform;
+    const vector4 viewportScale  = viewportTransform * vector4(1.0f, 1.0f, 0.0f, 0.0f);
+    const vector4 viewportOffset = viewportTransform * vector4(0.0f, 0.0f, 0.0f, 1.0f);
+    const Types::F32 SNAP_MARGIN = 1.0f / SubpixelNumber::MAG;
+    // a viewport with the flipped axis flip the winding.
+    const double windingSign = viewportScale.m_x * viewportScale.m_y < 0.0f ? -1.0 : 1.0;
+
+    const unsigned char * pVertexStart = vertices->GetBuffer();
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const vector4& p0 = reinterpret_cast<const ScreenSpaceVertexTemplate*>(pVertexStart + indices[i]     * realVertexSize)->m_posH;
+        const vector4& p1 = reinterpret_cast<const ScreenSpaceVertexTemplate*>(pVertexStart + indices[i + 1] * realVertexSize)->m_posH;
+        const vector4& p2 = reinterpret_cast<const ScreenSpaceVertexTemplate*>(pVertexStart + indices[i + 2] * realVertexSize)->m_posH;
+
+        // the determinant of the rows (x, y, w), it's w0 * w1 * w2 times the twice signed area in ndc,
+        // positive for counter clock wise. The sign is still the facing of the visible part when some w are negative,
+        // so the triangles crossing the camera plane are culled without clipping. In double, so the sign is right for the thin triangles.
+        const double det = windingSign * (
+              static_cast<double>(p0.m_x) * (static_cast<double>(p1.m_y) * p2.m_w - static_cast<double>(p1.m_w) * p2.m_y)
+            - static_cast<double>(p0.m_y) * (static_cast<double>(p1.m_x) * p2.m_w - static_cast<double>(p1.m_w) * p2.m_x)
+            + static_cast<double>(p0.m_w) * (static_cast<double>(p1.m_x) * p2.m_y - static_cast<double>(p1.m_y) * p2.m_x));
+
+        if ((det > 0.0 && cullFace == CullFace::COUNTER_CLOCK_WISE)
+            || (det < 0.0 && cullFace == CullFace::CLOCK_WISE))
+        {
+            ++m_statistic.m_numBackFaceTriangles;
+            continue;
+        }
+
+        if (isSolid)
+        {
+            if (det == 0.0)
+            {
+                // the triangle is edge on.
+                ++m_statistic.m_numDegeneratedTriangles;
+                continue;
+            }
+
+            // only the triangles in front of the camera can be projected directly.
+            if (p0.m_w > 0.0f && p1.m_w > 0.0f && p2.m_w > 0.0f)
+            {
+                const Types::F32 sx0 = p0.m_x / p0.m_w * viewportScale.m_x + viewportOffset.m_x;
+                const Types::F32 sx1 = p1.m_x / p1.m_w * viewportScale.m_x + viewportOffset.m_x;
+                const Types::F32 sx2 = p2.m_x / p2.m_w * viewportScale.m_x + viewportOffset.m_x;
+                const Types::F32 sy0 = p0.m_y / p0.m_w * viewportScale.m_y + viewportOffset.m_y;
+                const Types::F32 sy1 = p1.m_y / p1.m_w * viewportScale.m_y + viewportOffset.m_y;
+                const Types::F32 sy2 = p2.m_y / p2.m_w * viewportScale.m_y + viewportOffset.m_y;
+
+                // no integer location in the bounding box, the triangle cover no sample.
+                if (std::ceil(std::min({ sx0, sx1, sx2 }) - SNAP_MARGIN) > std::floor(std::max({ sx0, sx1, sx2 }) + SNAP_MARGIN)
+                    || std::ceil(std::min({ sy0, sy1, sy2 }) - SNAP_MARGIN) > std::floor(std::max({ sy0, sy1, sy2 }) + SNAP_MARGIN))
+                {
+                    ++m_statistic.m_numDegeneratedTriangles;
+                    continue;
+                }
+            }
+        }
+
+        pVisibleIndices->push_back(indices[i]);
+        pVisibleIndices->push_back(indices[i + 1]);
+        pVisibleIndices->push_back(indices[i + 2]);
+    }
+}
+
 std::unique_ptr<F32Buffer> Pipline::ViewportTransformVertexStream(std::unique_ptr<F32Buffer> verticesToBeTransformed, const unsigned int realVertexSizeBytes)
 {
     
     const unsigned int  numVertices             = verticesToBeTransformed->GetSizeOfByte() / realVertexSizeBytes;   // compute the number of vertex.
     auto                viewportTransData       = std::make_unique<F32Buffer>(numVertices * realVertexSizeBytes);   // create transfered data buffer.
 
-    unsigned char *     pSrcFloat               = verticesToBeTransformed->GetBuffer();                             // point to the vertex data before viewport transformation, a address in clippedLineData.
     unsigned char *     pDestFloat              = viewportTransData->GetBuffer();                                   // point to the vertex data after viewport transformation, address in viewportTransData.
 
-    Transform&          viewportTransformMat    = m_pso->m_viewportTransform;
+    // copy the whole stream at once, ensure the data (except the location) is same.
+    memcpy(pDestFloat, verticesToBeTransformed->GetBuffer(), numVertices * realVertexSizeBytes);
+
+    // local copy, so the matrix will not be reloaded after each store to the vertex.
+    const Transform     viewportTransformMat    = m_pso->m_viewportTransform;
+    const unsigned int  numRestFloat            = ScreenSpaceVertexTemplate::NumRestFloat(realVertexSizeBytes);
 
     // loop through all vertices.
     for (unsigned int i = 0; i < numVertices; ++i)
     {
-        ScreenSpaceVertexTemplate* pSrcVertex  = reinterpret_cast<ScreenSpaceVertexTemplate * >(pSrcFloat);     // source data
         ScreenSpaceVertexTemplate* pDestVertex = reinterpret_cast<ScreenSpaceVertexTemplate * >(pDestFloat);    // transformed to
 
-        // copy the memory of the vertex, ensure the data (except the location) is same.
-        memcpy(pDestVertex, pSrcVertex, realVertexSizeBytes);
-
         // perspective divided, please notice that the m_posH.m_w is the depth in camera space
         // and it should be positive.
         const Types::F32 RECIPOCAL_W = 1.0f / pDestVertex->m_posH.m_w;
@@ -893,13 +1301,12 @@ std::unique_ptr<F32Buffer> Pipline::ViewportTransformVertexStream(std::unique_pt
 
         // for perspective correction, store the 1/w where w is the depth in camera space
         pDestVertex->m_posH.m_w = RECIPOCAL_W;
-        for (unsigned int i = 0; i < ScreenSpaceVertexTemplate::NumRestFloat(realVertexSizeBytes); ++i)
+        for (unsigned int restIndex = 0; restIndex < numRestFloat; ++restIndex)
         {
-            pDestVertex->m_restDates[i] *= RECIPOCAL_W;
+            pDestVertex->m_restDates[restIndex] *= RECIPOCAL_W;
         }
 
         // move to next data.
-        pSrcFloat += realVertexSizeBytes;
         pDestFloat += realVertexSizeBytes;
     } // end for vertices.
 
@@ -919,6 +1326,13 @@ std::unique_ptr<F32Buffer> Pipline::VertexShaderTransform(const F32Buffer * pVer
     unsigned char *     pVSInput            = pVertexStream->GetBuffer();
     unsigned char *     pVSOutput           = vertexOutputStream->GetBuffer();
 
+    if (m_pso->m_batchVertexShader != nullptr)
+    {
+        // the whole stream in one call.
+        m_pso->m_batchVertexShader(pVSInput, vsInputStride, reinterpret_cast<ScreenSpaceVertexTemplate*>(pVSOutput), vsOutputStride, numVertex);
+        return vertexOutputStream;
+    }
+
     auto                vertexShader        = m_pso->m_vertexShader;
     for (unsigned int i = 0; i < numVertex; ++i)
     {
@@ -996,6 +1410,47 @@ void Pipline::DrawTriangleList(const std::vector<unsigned int>& indices, std::un
     }
 }
 
+void Pipline::DrawTriangleListDepthOnly(const std::vector<unsigned int>& indices, std::unique_ptr<F32Buffer> vsOutputStream, const unsigned int vsOutputStride)
+{
+    // keep only the homogeneous positions.
+    const unsigned int POSITION_STRIDE  = sizeof(vector4);
+    const unsigned int numVertices      = vsOutputStream->GetSizeOfByte() / vsOutputStride;
+    auto positions = std::make_unique<F32Buffer>(numVertices * POSITION_STRIDE);
+    const unsigned char * pSrc  = vsOutputStream->GetBuffer();
+    unsigned char *       pDest = positions->GetBuffer();
+    for (unsigned int i = 0; i < numVertices; ++i)
+    {
+        memcpy(pDest, pSrc, POSITION_STRIDE);
+        pSrc  += vsOutputStride;
+        pDest += POSITION_STRIDE;
+    }
+    vsOutputStream.reset();
+
+    std::vector<unsigned int> visibleIndices;
+    if (m_pso->m_isCullingBeforeClipping)
+    {
+        CullTrianglesBeforeClipping(indices, positions.get(), POSITION_STRIDE, &visibleIndices);
+    }
+
+    std::vector<unsigned int>  clippedIndices;
+    std::unique_ptr<F32Buffer> clippedData;
+    ClipTriangleList(m_pso->m_isCullingBeforeClipping ? visibleIndices : indices, std::move(positions), POSITION_STRIDE, &clippedIndices, &clippedData, m_frustumCutPlanes);
+
+    auto viewportTransData = ViewportTransformVertexStream(std::move(clippedData), POSITION_STRIDE);
+
+    unsigned char* pVertexAddress = viewportTransData->GetBuffer();
+    for (size_t i = 0; i < clippedIndices.size(); i += 3)
+    {
+        auto pv1 = GetVertexPtrAt<ScreenSpaceVertexTemplate>(pVertexAddress, clippedIndices[i],     POSITION_STRIDE);
+        auto pv2 = GetVertexPtrAt<ScreenSpaceVertexTemplate>(pVertexAddress, clippedIndices[i + 1], POSITION_STRIDE);
+        auto pv3 = GetVertexPtrAt<ScreenSpaceVertexTemplate>(pVertexAddress, clippedIndices[i + 2], POSITION_STRIDE);
+        if ( ! IsCulled(pv1, pv2, pv3))
+        {
+            DrawTriangleDepthOnly(pv1, pv2, pv3);
+        }
+    }
+}
+
 void Pipline::FrustumCutTriangle(
     const ScreenSpaceVertexTemplate*                    pv1,
     const ScreenSpaceVertexTemplate*                    pv2,
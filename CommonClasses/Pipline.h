@@ -6,15 +6,52 @@
 #include "F32Buffer.h"
 #include "HPlaneEquation.h"
 #include "DepthBuffer.h"
+#include "AABB.h"
 
 namespace CommonClass
 {
 
+class OcclusionCuller;
+
 /*!
     \brief abstraction of graphic pipline
 */
 class Pipline
 {
+public:
+    /*!
+        \brief the counters of the draws, accumulated until ResetStatistic().
+    */
+    struct Statistic
+    {
+        /*!
+            \brief how many times DrawInstance() is called, including the culled draws.
+        */
+        Types::U32 m_numDraws = 0;
+
+        /*!
+            \brief how many draws are skipped because the bounding volume is out of the view frustum.
+        */
+        Types::U32 m_numFrustumCulledDraws = 0;
+
+        /*!
+            \brief how many draws are skipped because the bounding volume is hidden by the occluders (see SetOcclusionCuller()).
+        */
+        Types::U32 m_numOccludedDraws = 0;
+
+        /*!
+            \brief how many vertices are not shaded because of the culled draws.
+        */
+        Types::U32 m_numCulledVertices = 0;
+
+        /*!
+            \brief how many triangles are rejected before clipping (see PiplineStateObject::m_isCullingBeforeClipping),
+            because they are back faces, or they have no area or cover no sample.
+        */
+        Types::U32 m_numBackFaceTriangles = 0;
+        Types::U32 m_numDegeneratedTriangles = 0;
+    };
+
 #ifdef _DEBUG
 public:
 #else
@@ -29,6 +66,11 @@ protected:
         \brief depth buffer which will store 1/z
     */
     std::unique_ptr<DepthBuffer> m_depthBuffer;
+
+    /*!
+        \brief the target of the depth only mode (PiplineStateObject::m_isDepthOnly), which store the ndc z.
+    */
+    std::shared_ptr<DepthBuffer> m_depthTarget;
     
 protected:
     /*!
@@ -38,6 +80,13 @@ protected:
 
     std::vector<std::unique_ptr<HPlaneEquation>> m_frustumCutPlanes;
 
+    /*!
+        \brief optional, test the draws with bounding volumes after the frustum culling.
+    */
+    std::shared_ptr<OcclusionCuller> m_occlusionCuller;
+
+    Statistic m_statistic;
+
 public:
     Pipline();
     ~Pipline();
@@ -47,8 +96,21 @@ public:
     */
     void SetBackBuffer(std::shared_ptr<Image> backBuffer);
 
+    /*!
+        \brief bind a depth buffer for the depth only mode, such as a shadow map,
+        clear it with SetAll(1.0f) (the far plane) before drawing.
+    */
+    void SetDepthTarget(std::shared_ptr<DepthBuffer> depthTarget);
+
+    /*!
+        \brief bind an occlusion culler, whose occluders are already drawn for the frame,
+        then the draws with bounding volumes are skipped if they are hidden. nullptr to disable it.
+    */
+    void SetOcclusionCuller(std::shared_ptr<OcclusionCuller> occlusionCuller);
+
     /*!
         \brief clear back buffer color, and depth value.
+        both are fast clears, only the tiles covered by the later draws are filled.
         \param background back color
         \param depthValue the depthValue = 1/z where z is the world depth.
     */
@@ -73,6 +135,35 @@ public:
         const std::vector<unsigned int>& indices, 
         const F32Buffer*                 vertices);
 
+    /*!
+        \brief draw the vertices only if the bounding volume intersect the view frustum and is not occluded (see SetOcclusionCuller()),
+        the test is done before the vertex shader, so the draws out of the view cost nothing.
+        \param objectBound the bounding box in the object space, e.g. GeometryBuilder::ComputeBoundingBox().
+        \param objectToClip the transformation from the object space to the homogeneous clip space,
+        the same as what the vertex shader does, e.g. project * toCamera * toWorld.
+        \return false if the draw is culled.
+    */
+    bool DrawInstance(
+        const std::vector<unsigned int>& indices,
+        const F32Buffer*                 vertices,
+        const AABB&                      objectBound,
+        const Transform&                 objectToClip);
+
+    /*!
+        \brief whether the box is completely out of the view frustum,
+        that is all the eight corners are on the outer side of one frustum plane in the homogeneous clip space,
+        -w <= x <= w, -w <= y <= w, 0 <= z <= w. The test is conservative, a box may pass when it's out of a frustum corner.
+        The corners behind the camera (w < 0) are handled by the same inequalities.
+    */
+    static bool IsOutsideFrustum(const AABB& objectBound, const Transform& objectToClip);
+
+    /*!
+        \brief get the counters of the draws.
+    */
+    const Statistic& GetStatistic() const { return m_statistic; }
+
+    void ResetStatistic() { m_statistic = Statistic(); }
+
     // next function will be used in the development phase, which will be public in the debug mode and private in the release mode.
 #ifdef _DEBUG
 public:
@@ -90,6 +181,29 @@ private:
         const ScreenSpaceVertexTemplate*    pv3,
         const unsigned int                  realVertexSizeBytes);
 
+    /*!
+        \brief draw one triangle with the fixed point rasterizer (RasterizeMode::FIXED_POINT_SUBPIXEL),
+        the vertex locations are snapped to the 28.4 subpixel grid, the edge equations are evaluated exactly in integers,
+        and the pixels on the shared edges are drawn only once by the top-left fill rule.
+        \param pv1~3 three vertex of the triangle, in the screen space(x/y in pixel unit)
+        \param realVertexSizeBytes the vertex size of the vertices, in byte unit.
+    */
+    void DrawTriangleFixedPoint(
+        const ScreenSpaceVertexTemplate*    pv1,
+        const ScreenSpaceVertexTemplate*    pv2,
+        const ScreenSpaceVertexTemplate*    pv3,
+        const unsigned int                  realVertexSizeBytes);
+
+    /*!
+        \brief draw one triangle into the depth target in the depth only mode,
+        the edges are set up like DrawTriangleFixedPoint(), and the ndc z is interpolated linearly in the screen space.
+        \param pv1~3 three vertex of the triangle, only m_posH is used, z is the ndc z after the viewport transformation.
+    */
+    void DrawTriangleDepthOnly(
+        const ScreenSpaceVertexTemplate*    pv1,
+        const ScreenSpaceVertexTemplate*    pv2,
+        const ScreenSpaceVertexTemplate*    pv3);
+
     /*!
         \brief find the pixel boundary of the triangle in the screen space
         \param pv1~3 three vertex and the function only care about the first two Float32 in each vertex which mean the {x,y} in screen space
@@ -243,6 +357,30 @@ private:
         std::unique_ptr<F32Buffer> *                        pClippedVertices,
         const std::vector<std::unique_ptr<HPlaneEquation>>& cutPlanes);
 
+    /*!
+        \brief the depth only path of DrawInstance(), the vertex shader output is compacted to the positions,
+        so the clipping and the viewport transformation have no attributes to interpolate.
+        \param vsOutputStream the output of the vertex shader.
+        \param vsOutputStride the vertex size of vsOutputStream in bytes.
+    */
+    void DrawTriangleListDepthOnly(
+        const std::vector<unsigned int>&    indices,
+        std::unique_ptr<F32Buffer>          vsOutputStream,
+        const unsigned int                  vsOutputStride);
+
+    /*!
+        \brief reject the back faces and the degenerated triangles in the homogeneous clip space, before clipping.
+        \param indices the triangle list after the vertex shader.
+        \param vertices the output of the vertex shader.
+        \param realVertexSize the vertex size in bytes.
+        \param pVisibleIndices return the indices of the triangles that are not rejected.
+    */
+    void CullTrianglesBeforeClipping(
+        const std::vector<unsigned int>&    indices,
+        const F32Buffer*                    vertices,
+        const unsigned int                  realVertexSize,
+        std::vector<unsigned int> *         pVisibleIndices);
+
     /*!
         \brief first perspective divided, and then do the viewport transformation for the vertex stream.
         for each vertex, we assum the first four component is the homogenous coordinates location, 
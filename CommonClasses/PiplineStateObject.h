@@ -54,6 +54,15 @@ enum FillMode
     WIREFRAME
 };
 
+/*!
+    \brief how to rasterize the solid triangles.
+*/
+enum RasterizeMode
+{
+    FLOAT_POINT = 0,        // evaluate the barycentric coordinates of each pixel in float.
+    FIXED_POINT_SUBPIXEL    // snap the vertices to the 28.4 subpixel grid, step the edge equations by integer adds with the top-left fill rule.
+};
+
 /*!
     \brief a viewport struct to describe how 
     to project normalized device coordinate into pixel space.
@@ -95,6 +104,29 @@ public:
     */
     FillMode m_fillMode = SOLIDE;
 
+    /*!
+        \brief how to rasterize the solid triangles,
+        the FIXED_POINT_SUBPIXEL mode make the adjacent triangles cover each pixel exactly once.
+    */
+    RasterizeMode m_rasterizeMode = FLOAT_POINT;
+
+    /*!
+        \brief the depth only mode for the shadow maps and the depth prepass,
+        no pixel shader is needed, only the positions are clipped and interpolated, and no color is written.
+        the ndc z (0 near, 1 far) is written to the depth target of the pipline with the less test,
+        the triangles are rasterized by the fixed point rasterizer whatever m_rasterizeMode is.
+        only the solid triangle lists are supported.
+    */
+    bool m_isDepthOnly = false;
+
+    /*!
+        \brief reject the back faces and the triangles that cover no sample right after the vertex shader,
+        before the clipping allocates anything for them. The facing is the sign of the homogeneous determinant |x y w|,
+        which is right even if some vertices are behind the camera (w < 0).
+        the culled triangles are the same as the later tests in the screen space, it can be turned off for comparison.
+    */
+    bool m_isCullingBeforeClipping = true;
+
     /*!
         \brief the vertex size of different of stage in the pipeline.
         the pipeline will using the destination vertex size to create vertices.
@@ -122,6 +154,14 @@ public:
     */
     std::function< void(const unsigned char *, ScreenSpaceVertexTemplate*)> m_vertexShader = nullptr;
 
+    /*!
+        \brief the batch vertex shader, transform all the vertices of a draw call in one call,
+        so the shader can concatenate the constant matrices once and use the array transform kernels.
+        if it's setted, the pipeline use it instead of m_vertexShader.
+        \paramType (pSrc, srcStride, pDest, destStride, count), the strides are in bytes.
+    */
+    std::function< void(const unsigned char *, unsigned int, ScreenSpaceVertexTemplate*, unsigned int, unsigned int)> m_batchVertexShader = nullptr;
+
 public:
     PiplineStateObject();
     ~PiplineStateObject();
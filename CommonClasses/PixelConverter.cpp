@@ -0,0 +1,269 @@
+#include "PixelConverter.h"
+#include <algorithm>
+#include <cmath>
+#include "Utils/ParallelTool.h"
+#ifdef USING_SSE_MATH
+#include <emmintrin.h>
+#endif
+
+namespace CommonClass
+{
+
+namespace
+{
+
+/*!
+    \brief how many linear levels to look up the sRGB encoding, the darkest step is less than one byte level.
+*/
+const Types::U32 SRGB_ENCODE_LEVELS = 4096;
+
+/*!
+    \brief how many pixels are converted by one task at least.
+*/
+const Types::U32 PIXELS_PER_TASK = 16384;
+
+/*!
+    \brief the 4 * 4 bayer matrix, the rounding offset of the pixel (x, y) is (BAYER[y & 3][x & 3] + 0.5) / 16.
+*/
+const Types::U32 BAYER_MATRIX[4][4] =
+{
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 }
+};
+
+/*!
+    \brief the lookup tables of the sRGB transfer function, built once.
+*/
+struct SRGBTables
+{
+    /*!
+        \brief the sRGB byte of the linear value (i / (SRGB_ENCODE_LEVELS - 1)), in 8.8 fixed point.
+    */
+    Types::U32 m_encode[SRGB_ENCODE_LEVELS];
+
+    /*!
+        \brief the linear value of the sRGB byte.
+    */
+    Types::F32 m_decode[256];
+
+    SRGBTables()
+    {
+        for (Types::U32 i = 0; i < SRGB_ENCODE_LEVELS; ++i)
+        {
+            const Types::F32 srgb = PixelConverter::LinearToSRGB(i / static_cast<Types::F32>(SRGB_ENCODE_LEVELS - 1));
+            m_encode[i] = static_cast<Types::U32>(srgb * 255.0f * 256.0f + 0.5f);
+        }
+        for (Types::U32 i = 0; i < 256; ++i)
+        {
+            m_decode[i] = PixelConverter::SRGBToLinear(i / 255.0f);
+        }
+    }
+};
+
+const SRGBTables& GetSRGBTables()
+{
+    static const SRGBTables tables;
+    return tables;
+}
+
+/*!
+    \brief the rounding offsets of the four pixels (x & 3) in the row y.
+*/
+void RowOffsets(const Types::U32 y, const bool dither, Types::F32 offsets[4])
+{
+    for (Types::U32 i = 0; i < 4; ++i)
+    {
+        offsets[i] = dither ? (BAYER_MATRIX[y & 3][i] + 0.5f) / 16.0f : 0.5f;
+    }
+}
+
+Types::F32 Clamp01(const Types::F32 value)
+{
+    // NaN is treated as zero.
+    return value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+}
+
+/*!
+    \brief the reference conversion of one pixel, also convert the pixels left by the SSE loop.
+*/
+void FloatToBytePixel(const vector4& src, Pixel& dst, const Types::F32 offset, const SRGBTables* tables)
+{
+    for (Types::U32 ch = 0; ch < 4; ++ch)
+    {
+        const Types::F32 value = Clamp01(src.m_arr[ch]);
+        if (tables && ch < 3)
+        {
+            const Types::U32 level = static_cast<Types::U32>(value * (SRGB_ENCODE_LEVELS - 1) + 0.5f);
+            dst.m_arr[ch] = static_cast<Types::U8>((tables->m_encode[level] + static_cast<Types::U32>(offset * 256.0f)) >> 8);
+        }
+        else
+        {
+            dst.m_arr[ch] = static_cast<Types::U8>(value * 255.0f + offset);
+        }
+    }
+}
+
+void FloatToByteRow(const vector4* src, Pixel* dst, const Types::U32 width, const Types::U32 y, const bool dither, const SRGBTables* tables)
+{
+    Types::F32 offsets[4];
+    RowOffsets(y, dither, offsets);
+    Types::U32 x = 0;
+
+#ifdef USING_SSE_MATH
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    if (tables)
+    {
+        // the color channels are looked up, alpha is (a * 255 + offset) like the linear encoding.
+        const __m128 levelScale = _mm_setr_ps(SRGB_ENCODE_LEVELS - 1.0f, SRGB_ENCODE_LEVELS - 1.0f, SRGB_ENCODE_LEVELS - 1.0f, 255.0f);
+        alignas(16) Types::I32 levels[4];
+        for (; x < width; ++x)
+        {
+            const Types::F32 offset = offsets[x & 3];
+            __m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src[x].m_arr.data()), zero), one);
+            value = _mm_add_ps(_mm_mul_ps(value, levelScale), _mm_setr_ps(0.5f, 0.5f, 0.5f, offset));
+            _mm_store_si128(reinterpret_cast<__m128i*>(levels), _mm_cvttps_epi32(value));
+            const Types::U32 fixOffset = static_cast<Types::U32>(offset * 256.0f);
+            dst[x].m_r = static_cast<Types::U8>((tables->m_encode[levels[0]] + fixOffset) >> 8);
+            dst[x].m_g = static_cast<Types::U8>((tables->m_encode[levels[1]] + fixOffset) >> 8);
+            dst[x].m_b = static_cast<Types::U8>((tables->m_encode[levels[2]] + fixOffset) >> 8);
+            dst[x].m_a = static_cast<Types::U8>(levels[3]);
+        }
+        return;
+    }
+
+    // four pixels (16 channels) are packed into 16 bytes.
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128 offset0 = _mm_set1_ps(offsets[0]);
+    const __m128 offset1 = _mm_set1_ps(offsets[1]);
+    const __m128 offset2 = _mm_set1_ps(offsets[2]);
+    const __m128 offset3 = _mm_set1_ps(offsets[3]);
+    for (; x + 4 <= width; x += 4)
+    {
+        // _mm_max_ps return the second operand if the first one is NaN.
+        const __m128 p0 = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src[x + 0].m_arr.data()), zero), one);
+        const __m128 p1 = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src[x + 1].m_arr.data()), zero), one);
+        const __m128 p2 = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src[x + 2].m_arr.data()), zero), one);
+        const __m128 p3 = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src[x + 3].m_arr.data()), zero), one);
+        const __m128i i0 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(p0, scale), offset0));
+        const __m128i i1 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(p1, scale), offset1));
+        const __m128i i2 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(p2, scale), offset2));
+        const __m128i i3 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(p3, scale), offset3));
+        const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(i0, i1), _mm_packs_epi32(i2, i3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), bytes);
+    }
+#endif // USING_SSE_MATH
+
+    for (; x < width; ++x)
+    {
+        FloatToBytePixel(src[x], dst[x], offsets[x & 3], tables);
+    }
+}
+
+void ByteToFloatRow(const Pixel* src, vector4* dst, const Types::U32 width, const SRGBTables* tables)
+{
+    Types::U32 x = 0;
+    if (tables)
+    {
+        for (; x < width; ++x)
+        {
+            dst[x].m_x = tables->m_decode[src[x].m_r];
+            dst[x].m_y = tables->m_decode[src[x].m_g];
+            dst[x].m_z = tables->m_decode[src[x].m_b];
+            dst[x].m_w = src[x].m_a / 255.0f;
+        }
+        return;
+    }
+
+#ifdef USING_SSE_MATH
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+    for (; x + 4 <= width; x += 4)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        _mm_storeu_ps(dst[x + 0].m_arr.data(), _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), scale));
+        _mm_storeu_ps(dst[x + 1].m_arr.data(), _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), scale));
+        _mm_storeu_ps(dst[x + 2].m_arr.data(), _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), scale));
+        _mm_storeu_ps(dst[x + 3].m_arr.data(), _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), scale));
+    }
+#endif // USING_SSE_MATH
+
+    for (; x < width; ++x)
+    {
+        for (Types::U32 ch = 0; ch < 4; ++ch)
+        {
+            dst[x].m_arr[ch] = src[x].m_arr[ch] * (1.0f / 255.0f);
+        }
+    }
+}
+
+Types::U32 RowsPerTask(const Types::U32 width)
+{
+    return std::max(PIXELS_PER_TASK / std::max(width, 1u), 1u);
+}
+
+}// anonymous namespace
+
+void PixelConverter::FloatToByte(
+    const vector4* src,
+    Pixel* dst,
+    const Types::U32 width,
+    const Types::U32 height,
+    const ColorEncoding encoding /*= LINEAR_ENCODING*/,
+    const bool dither /*= false*/,
+    const Types::U32 numThreads /*= 0*/)
+{
+    const SRGBTables* tables = encoding == SRGB_ENCODING ? &GetSRGBTables() : nullptr;
+    ParallelTool::ParallelFor(0, height, [=](const unsigned int y)
+    {
+        const std::size_t rowStart = static_cast<std::size_t>(y) * width;
+        FloatToByteRow(src + rowStart, dst + rowStart, width, y, dither, tables);
+    }, RowsPerTask(width), numThreads);
+}
+
+void PixelConverter::ByteToFloat(
+    const Pixel* src,
+    vector4* dst,
+    const Types::U32 width,
+    const Types::U32 height,
+    const ColorEncoding encoding /*= LINEAR_ENCODING*/,
+    const Types::U32 numThreads /*= 0*/)
+{
+    const SRGBTables* tables = encoding == SRGB_ENCODING ? &GetSRGBTables() : nullptr;
+    ParallelTool::ParallelFor(0, height, [=](const unsigned int y)
+    {
+        const std::size_t rowStart = static_cast<std::size_t>(y) * width;
+        ByteToFloatRow(src + rowStart, dst + rowStart, width, tables);
+    }, RowsPerTask(width), numThreads);
+}
+
+Pixel PixelConverter::ToPixel(const vector4& color)
+{
+    Pixel pixel;
+    FloatToBytePixel(color, pixel, 0.5f, nullptr);
+    return pixel;
+}
+
+vector4 PixelConverter::ToVector(const Pixel& pixel)
+{
+    const Types::F32 scale = 1.0f / 255.0f;
+    return vector4(pixel.m_r * scale, pixel.m_g * scale, pixel.m_b * scale, pixel.m_a * scale);
+}
+
+Types::F32 PixelConverter::LinearToSRGB(const Types::F32 linear)
+{
+    const Types::F32 value = Clamp01(linear);
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+Types::F32 PixelConverter::SRGBToLinear(const Types::F32 srgb)
+{
+    const Types::F32 value = Clamp01(srgb);
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+}// namespace CommonClass
@@ -0,0 +1,72 @@
+#pragma once
+#include "ColorTemplate.h"
+#include "vector4.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief how the color channels (not the alpha) are stored in the bytes.
+*/
+enum ColorEncoding
+{
+    /*!
+        \brief byte = value * 255.
+    */
+    LINEAR_ENCODING,
+
+    /*!
+        \brief the sRGB transfer function, the float values are linear, the bytes are gamma encoded for the display.
+    */
+    SRGB_ENCODING
+};
+
+/*!
+    \brief PixelConverter convert the whole canvas between the float pixels and the byte pixels,
+    the rows are converted on multiple threads, and four pixels are converted by a few SSE instructions with USING_SSE_MATH.
+    The float channels are clamped to [0, 1] and rounded to the nearest byte, or rounded by the 4 * 4 ordered dithering,
+    which breaks the banding of the smooth gradients.
+    The sRGB encoding of the color channels use a lookup table of 4096 linear levels, the alpha is always linear.
+*/
+class PixelConverter
+{
+public:
+    /*!
+        \brief convert the float pixels to the byte pixels, the pixels of a row are continuous, so are the rows.
+        \param dither whether to use the ordered dithering instead of the rounding.
+        \param numThreads how many threads to convert the rows, zero for all the hardware threads.
+    */
+    static void FloatToByte(
+        const vector4* src,
+        Pixel* dst,
+        const Types::U32 width,
+        const Types::U32 height,
+        const ColorEncoding encoding = LINEAR_ENCODING,
+        const bool dither = false,
+        const Types::U32 numThreads = 0);
+
+    /*!
+        \brief convert the byte pixels to the float pixels in [0, 1].
+    */
+    static void ByteToFloat(
+        const Pixel* src,
+        vector4* dst,
+        const Types::U32 width,
+        const Types::U32 height,
+        const ColorEncoding encoding = LINEAR_ENCODING,
+        const Types::U32 numThreads = 0);
+
+    /*!
+        \brief convert one pixel with the linear encoding, the same as FloatToByte() and ByteToFloat() without dithering.
+    */
+    static Pixel ToPixel(const vector4& color);
+    static vector4 ToVector(const Pixel& pixel);
+
+    /*!
+        \brief the exact sRGB transfer functions of one channel in [0, 1].
+    */
+    static Types::F32 LinearToSRGB(const Types::F32 linear);
+    static Types::F32 SRGBToLinear(const Types::F32 srgb);
+};
+
+}// namespace CommonClass
@@ -0,0 +1,820 @@
+#include "PngEncoder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include "Utils/ParallelTool.h"
+
+namespace
+{
+
+using Types::U8;
+using Types::U32;
+using Types::I32;
+
+const U32 WINDOW_SIZE       = 32768;
+const U32 WINDOW_MASK       = WINDOW_SIZE - 1;
+const U32 MIN_MATCH         = 3;
+const U32 MAX_MATCH         = 258;
+const U32 HASH_BITS         = 15;
+const U32 MAX_BLOCK_SYMBOLS = 32768;
+const U32 MAX_STORED_BYTES  = 65535;
+const U32 NUM_LITERAL_CODES = 286;
+const U32 NUM_DISTANCE_CODES = 30;
+const U32 NUM_CODE_LENGTH_CODES = 19;
+
+const unsigned short LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const U8 LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const unsigned short DISTANCE_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+    1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+const U8 DISTANCE_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+const U8 CODE_LENGTH_ORDER[NUM_CODE_LENGTH_CODES] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+/*!
+    \brief the lookup tables which are computed once.
+*/
+struct DeflateTables
+{
+    /*!
+        \brief the length code (minus 257) of each match length in [3, 258].
+    */
+    U8 m_lengthCode[MAX_MATCH + 1];
+
+    /*!
+        \brief the distance code, the index is (distance - 1) for the distance <= 256, else 256 + ((distance - 1) >> 7),
+        the bases of the large distance codes are multiple of 128 plus one.
+    */
+    U8 m_distanceCode[512];
+
+    U32 m_crc[256];
+
+    DeflateTables()
+    {
+        for (U32 code = 0; code < 29; ++code)
+        {
+            const U32 last = code + 1 < 29 ? LENGTH_BASE[code + 1] : MAX_MATCH + 1;
+            for (U32 length = LENGTH_BASE[code]; length < last && length <= MAX_MATCH; ++length)
+            {
+                m_lengthCode[length] = static_cast<U8>(code);
+            }
+        }
+        // the length 258 has its own code.
+        m_lengthCode[MAX_MATCH] = 28;
+
+        for (U32 code = 0; code < NUM_DISTANCE_CODES; ++code)
+        {
+            const U32 last = code + 1 < NUM_DISTANCE_CODES ? DISTANCE_BASE[code + 1] : WINDOW_SIZE + 1;
+            for (U32 distance = DISTANCE_BASE[code]; distance < last; ++distance)
+            {
+                const U32 index = distance <= 256 ? distance - 1 : 256 + ((distance - 1) >> 7);
+                m_distanceCode[index] = static_cast<U8>(code);
+            }
+        }
+
+        for (U32 n = 0; n < 256; ++n)
+        {
+            U32 c = n;
+            for (U32 k = 0; k < 8; ++k)
+            {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            m_crc[n] = c;
+        }
+    }
+
+    U32 DistanceCode(const U32 distance) const
+    {
+        return m_distanceCode[distance <= 256 ? distance - 1 : 256 + ((distance - 1) >> 7)];
+    }
+};
+
+const DeflateTables& Tables()
+{
+    static const DeflateTables tables;
+    return tables;
+}
+
+/*!
+    \brief a literal (m_distance is zero) or a match of LZ77.
+*/
+struct Symbol
+{
+    unsigned short m_literalOrLength;
+    unsigned short m_distance;
+};
+
+/*!
+    \brief write the bits from the least significant bit of each byte, as the deflate format.
+*/
+class BitWriter
+{
+public:
+    std::vector<U8> m_bytes;
+
+    /*!
+        \brief write the lowest numBits (at most 32) bits of the value.
+    */
+    void Write(const U32 value, const U32 numBits)
+    {
+        m_buffer |= static_cast<unsigned long long>(value) << m_numBits;
+        m_numBits += numBits;
+        while (m_numBits >= 8)
+        {
+            m_bytes.push_back(static_cast<U8>(m_buffer));
+            m_buffer >>= 8;
+            m_numBits -= 8;
+        }
+    }
+
+    void AlignToByte()
+    {
+        if (m_numBits > 0)
+        {
+            m_bytes.push_back(static_cast<U8>(m_buffer));
+        }
+        m_buffer = 0;
+        m_numBits = 0;
+    }
+
+protected:
+    unsigned long long m_buffer = 0;
+    U32 m_numBits = 0;
+};
+
+/*!
+    \brief the code lengths of the huffman code which is limited by maxLength.
+    \param frequencies at least two of them are not zero.
+*/
+void BuildCodeLengths(const U32* frequencies, const U32 numSymbols, const U32 maxLength, U8* outLengths)
+{
+    std::vector<U32> used;
+    for (U32 i = 0; i < numSymbols; ++i)
+    {
+        outLengths[i] = 0;
+        if (frequencies[i] > 0)
+        {
+            used.push_back(i);
+        }
+    }
+    std::stable_sort(used.begin(), used.end(), [frequencies](const U32 a, const U32 b) { return frequencies[a] < frequencies[b]; });
+    const U32 numLeaves = static_cast<U32>(used.size());
+
+    // the huffman tree by two queues, the leaves sorted by frequency and the internal nodes in creating order.
+    std::vector<unsigned long long> weights(2 * numLeaves - 1);
+    std::vector<U32> parents(2 * numLeaves - 1, 0);
+    for (U32 i = 0; i < numLeaves; ++i)
+    {
+        weights[i] = frequencies[used[i]];
+    }
+    U32 nextLeaf = 0, nextNode = numLeaves;
+    for (U32 node = numLeaves; node < 2 * numLeaves - 1; ++node)
+    {
+        U32 children[2];
+        for (auto& child : children)
+        {
+            child = (nextLeaf < numLeaves && (nextNode >= node || weights[nextLeaf] <= weights[nextNode])) ? nextLeaf++ : nextNode++;
+        }
+        weights[node] = weights[children[0]] + weights[children[1]];
+        parents[children[0]] = parents[children[1]] = node;
+    }
+
+    // the depth of the nodes, the parent always has a larger index.
+    std::vector<U32> depths(2 * numLeaves - 1, 0);
+    std::vector<U32> numCodes(std::max(maxLength, numLeaves) + 1, 0);
+    for (I32 node = 2 * numLeaves - 3; node >= 0; --node)
+    {
+        depths[node] = depths[parents[node]] + 1;
+    }
+    for (U32 i = 0; i < numLeaves; ++i)
+    {
+        ++numCodes[std::min(depths[i], maxLength)];
+    }
+
+    // the deep leaves are moved up to maxLength, then the shorter codes are moved down until the kraft sum is one.
+    unsigned long long kraftSum = 0;
+    for (U32 length = 1; length <= maxLength; ++length)
+    {
+        kraftSum += static_cast<unsigned long long>(numCodes[length]) << (maxLength - length);
+    }
+    while (kraftSum > (1ull << maxLength))
+    {
+        --numCodes[maxLength];
+        for (U32 length = maxLength - 1; length > 0; --length)
+        {
+            if (numCodes[length] > 0)
+            {
+                --numCodes[length];
+                numCodes[length + 1] += 2;
+                break;
+            }
+        }
+        --kraftSum;
+    }
+
+    // the least frequent symbols get the longest codes.
+    U32 leaf = 0;
+    for (U32 length = maxLength; length > 0; --length)
+    {
+        for (U32 n = 0; n < numCodes[length]; ++n)
+        {
+            outLengths[used[leaf++]] = static_cast<U8>(length);
+        }
+    }
+}
+
+/*!
+    \brief the canonical huffman codes, the bits are reversed because the deflate write the codes from the most significant bit.
+*/
+void BuildCodes(const U8* lengths, const U32 numSymbols, U32* outCodes)
+{
+    U32 numCodes[16] = { 0 };
+    for (U32 i = 0; i < numSymbols; ++i)
+    {
+        ++numCodes[lengths[i]];
+    }
+    numCodes[0] = 0;
+    U32 nextCode[16] = { 0 };
+    for (U32 length = 1, code = 0; length < 16; ++length)
+    {
+        code = (code + numCodes[length - 1]) << 1;
+        nextCode[length] = code;
+    }
+    for (U32 i = 0; i < numSymbols; ++i)
+    {
+        const U32 length = lengths[i];
+        const U32 code = length > 0 ? nextCode[length]++ : 0;
+        U32 reversed = 0;
+        for (U32 b = 0; b < length; ++b)
+        {
+            reversed |= ((code >> b) & 1) << (length - 1 - b);
+        }
+        outCodes[i] = reversed;
+    }
+}
+
+/*!
+    \brief make sure at least two symbols are used, so the huffman code is complete.
+*/
+void EnsureTwoSymbols(U32* frequencies, const U32 numSymbols)
+{
+    U32 numUsed = 0;
+    for (U32 i = 0; i < numSymbols; ++i)
+    {
+        numUsed += frequencies[i] > 0 ? 1 : 0;
+    }
+    for (U32 i = 0; numUsed < 2 && i < numSymbols; ++i)
+    {
+        if (frequencies[i] == 0)
+        {
+            frequencies[i] = 1;
+            ++numUsed;
+        }
+    }
+}
+
+void WriteStoredBlocks(BitWriter& writer, const U8* raw, std::size_t size, const bool isFinal)
+{
+    do
+    {
+        const U32 blockSize = static_cast<U32>(std::min<std::size_t>(size, MAX_STORED_BYTES));
+        writer.Write(isFinal && blockSize == size ? 1 : 0, 1);
+        writer.Write(0, 2);
+        writer.AlignToByte();
+        writer.Write(blockSize, 16);
+        writer.Write(~blockSize & 0xFFFF, 16);
+        writer.m_bytes.insert(writer.m_bytes.end(), raw, raw + blockSize);
+        raw += blockSize;
+        size -= blockSize;
+    } while (size > 0);
+}
+
+/*!
+    \brief write the symbols as a block of dynamic huffman codes, or stored block if it is smaller.
+    \param raw the bytes which the symbols come from.
+*/
+void WriteBlock(BitWriter& writer, const std::vector<Symbol>& symbols, const U8* raw, const std::size_t rawSize, const bool isFinal)
+{
+    const DeflateTables& tables = Tables();
+    U32 literalFrequencies[NUM_LITERAL_CODES] = { 0 };
+    U32 distanceFrequencies[NUM_DISTANCE_CODES] = { 0 };
+    unsigned long long extraBits = 0;
+    for (const auto& symbol : symbols)
+    {
+        if (symbol.m_distance == 0)
+        {
+            ++literalFrequencies[symbol.m_literalOrLength];
+        }
+        else
+        {
+            const U32 lengthCode = tables.m_lengthCode[symbol.m_literalOrLength];
+            const U32 distanceCode = tables.DistanceCode(symbol.m_distance);
+            ++literalFrequencies[257 + lengthCode];
+            ++distanceFrequencies[distanceCode];
+            extraBits += LENGTH_EXTRA[lengthCode] + DISTANCE_EXTRA[distanceCode];
+        }
+    }
+    literalFrequencies[256] = 1;
+    EnsureTwoSymbols(literalFrequencies, NUM_LITERAL_CODES);
+    EnsureTwoSymbols(distanceFrequencies, NUM_DISTANCE_CODES);
+
+    U8 literalLengths[NUM_LITERAL_CODES], distanceLengths[NUM_DISTANCE_CODES];
+    BuildCodeLengths(literalFrequencies, NUM_LITERAL_CODES, 15, literalLengths);
+    BuildCodeLengths(distanceFrequencies, NUM_DISTANCE_CODES, 15, distanceLengths);
+    U32 numLiterals = NUM_LITERAL_CODES, numDistances = NUM_DISTANCE_CODES;
+    while (numLiterals > 257 && literalLengths[numLiterals - 1] == 0)
+    {
+        --numLiterals;
+    }
+    while (numDistances > 1 && distanceLengths[numDistances - 1] == 0)
+    {
+        --numDistances;
+    }
+
+    // the run length encoding of the code lengths, 16 repeat the previous length 3-6 times, 17 and 18 repeat zero 3-10 and 11-138 times.
+    std::vector<U8> lengths(literalLengths, literalLengths + numLiterals);
+    lengths.insert(lengths.end(), distanceLengths, distanceLengths + numDistances);
+    std::vector<std::pair<U8, U8>> runs;
+    U32 codeLengthFrequencies[NUM_CODE_LENGTH_CODES] = { 0 };
+    auto emitRun = [&](const U8 code, const U8 extra)
+    {
+        runs.emplace_back(code, extra);
+        ++codeLengthFrequencies[code];
+    };
+    for (U32 i = 0; i < lengths.size();)
+    {
+        const U8 length = lengths[i];
+        U32 runLength = 1;
+        while (i + runLength < lengths.size() && lengths[i + runLength] == length)
+        {
+            ++runLength;
+        }
+        i += runLength;
+        if (length == 0)
+        {
+            while (runLength >= 11)
+            {
+                const U32 n = std::min(runLength, 138u);
+                emitRun(18, static_cast<U8>(n - 11));
+                runLength -= n;
+            }
+            if (runLength >= 3)
+            {
+                emitRun(17, static_cast<U8>(runLength - 3));
+                runLength = 0;
+            }
+        }
+        else
+        {
+            emitRun(length, 0);
+            --runLength;
+            while (runLength >= 3)
+            {
+                const U32 n = std::min(runLength, 6u);
+                emitRun(16, static_cast<U8>(n - 3));
+                runLength -= n;
+            }
+        }
+        for (; runLength > 0; --runLength)
+        {
+            emitRun(length, 0);
+        }
+    }
+    EnsureTwoSymbols(codeLengthFrequencies, NUM_CODE_LENGTH_CODES);
+    U8 codeLengthLengths[NUM_CODE_LENGTH_CODES];
+    BuildCodeLengths(codeLengthFrequencies, NUM_CODE_LENGTH_CODES, 7, codeLengthLengths);
+    U32 numCodeLengths = NUM_CODE_LENGTH_CODES;
+    while (numCodeLengths > 4 && codeLengthLengths[CODE_LENGTH_ORDER[numCodeLengths - 1]] == 0)
+    {
+        --numCodeLengths;
+    }
+
+    // choose the smaller block.
+    unsigned long long dynamicBits = 3 + 5 + 5 + 4 + 3 * numCodeLengths + extraBits;
+    for (const auto& run : runs)
+    {
+        dynamicBits += codeLengthLengths[run.first] + (run.first == 16 ? 2 : run.first == 17 ? 3 : run.first == 18 ? 7 : 0);
+    }
+    for (U32 i = 0; i < NUM_LITERAL_CODES; ++i)
+    {
+        dynamicBits += static_cast<unsigned long long>(literalFrequencies[i]) * literalLengths[i];
+    }
+    for (U32 i = 0; i < NUM_DISTANCE_CODES; ++i)
+    {
+        dynamicBits += static_cast<unsigned long long>(distanceFrequencies[i]) * distanceLengths[i];
+    }
+    const unsigned long long storedBits = (rawSize + 5 * (rawSize / MAX_STORED_BYTES + 1)) * 8;
+    if (rawSize > 0 && storedBits < dynamicBits)
+    {
+        WriteStoredBlocks(writer, raw, rawSize, isFinal);
+        return;
+    }
+
+    U32 literalCodes[NUM_LITERAL_CODES], distanceCodes[NUM_DISTANCE_CODES], codeLengthCodes[NUM_CODE_LENGTH_CODES];
+    BuildCodes(literalLengths, NUM_LITERAL_CODES, literalCodes);
+    BuildCodes(distanceLengths, NUM_DISTANCE_CODES, distanceCodes);
+    BuildCodes(codeLengthLengths, NUM_CODE_LENGTH_CODES, codeLengthCodes);
+
+    writer.Write(isFinal ? 1 : 0, 1);
+    writer.Write(2, 2);
+    writer.Write(numLiterals - 257, 5);
+    writer.Write(numDistances - 1, 5);
+    writer.Write(numCodeLengths - 4, 4);
+    for (U32 i = 0; i < numCodeLengths; ++i)
+    {
+        writer.Write(codeLengthLengths[CODE_LENGTH_ORDER[i]], 3);
+    }
+    for (const auto& run : runs)
+    {
+        writer.Write(codeLengthCodes[run.first], codeLengthLengths[run.first]);
+        if (run.first >= 16)
+        {
+            writer.Write(run.second, run.first == 16 ? 2 : run.first == 17 ? 3 : 7);
+        }
+    }
+
+    for (const auto& symbol : symbols)
+    {
+        if (symbol.m_distance == 0)
+        {
+            writer.Write(literalCodes[symbol.m_literalOrLength], literalLengths[symbol.m_literalOrLength]);
+        }
+        else
+        {
+            const U32 lengthCode = tables.m_lengthCode[symbol.m_literalOrLength];
+            writer.Write(literalCodes[257 + lengthCode], literalLengths[257 + lengthCode]);
+            writer.Write(symbol.m_literalOrLength - LENGTH_BASE[lengthCode], LENGTH_EXTRA[lengthCode]);
+            const U32 distanceCode = tables.DistanceCode(symbol.m_distance);
+            writer.Write(distanceCodes[distanceCode], distanceLengths[distanceCode]);
+            writer.Write(symbol.m_distance - DISTANCE_BASE[distanceCode], DISTANCE_EXTRA[distanceCode]);
+        }
+    }
+    writer.Write(literalCodes[256], literalLengths[256]);
+}
+
+/*!
+    \brief the adler32 of the concatenated data, secondSize is the size of the second data, same as adler32_combine of zlib.
+*/
+U32 CombineAdler32(const U32 first, const U32 second, const std::size_t secondSize)
+{
+    const U32 BASE = 65521;
+    const U32 remainder = static_cast<U32>(secondSize % BASE);
+    U32 sum1 = first & 0xFFFF;
+    U32 sum2 = static_cast<U32>((static_cast<unsigned long long>(remainder) * sum1) % BASE);
+    sum1 += (second & 0xFFFF) + BASE - 1;
+    sum2 += (first >> 16) + (second >> 16) + BASE - remainder;
+    if (sum1 >= BASE) sum1 -= BASE;
+    if (sum1 >= BASE) sum1 -= BASE;
+    if (sum2 >= (BASE << 1)) sum2 -= (BASE << 1);
+    if (sum2 >= BASE) sum2 -= BASE;
+    return sum1 | (sum2 << 16);
+}
+
+void AppendBigEndian(std::vector<U8>& bytes, const U32 value)
+{
+    bytes.push_back(static_cast<U8>(value >> 24));
+    bytes.push_back(static_cast<U8>(value >> 16));
+    bytes.push_back(static_cast<U8>(value >> 8));
+    bytes.push_back(static_cast<U8>(value));
+}
+
+/*!
+    \brief append the length placeholder and the type of a PNG chunk, return where the chunk begin.
+*/
+std::size_t BeginPngChunk(std::vector<U8>& png, const char* type)
+{
+    const std::size_t begin = png.size();
+    AppendBigEndian(png, 0);
+    png.insert(png.end(), type, type + 4);
+    return begin;
+}
+
+/*!
+    \brief fill the length and append the CRC of the chunk.
+*/
+void EndPngChunk(std::vector<U8>& png, const std::size_t begin)
+{
+    const U32 length = static_cast<U32>(png.size() - begin - 8);
+    png[begin]     = static_cast<U8>(length >> 24);
+    png[begin + 1] = static_cast<U8>(length >> 16);
+    png[begin + 2] = static_cast<U8>(length >> 8);
+    png[begin + 3] = static_cast<U8>(length);
+    AppendBigEndian(png, CommonClass::PngEncoder::Crc32(&png[begin + 4], png.size() - begin - 4));
+}
+
+inline U8 Paeth(const U8 a, const U8 b, const U8 c)
+{
+    const I32 p = static_cast<I32>(a) + b - c;
+    const I32 pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+}
+
+/*!
+    \brief the predictor of the filter type, a is the left byte, b is the up byte, c is the up left byte.
+*/
+inline U8 Predict(const U32 filterType, const U8 a, const U8 b, const U8 c)
+{
+    switch (filterType)
+    {
+    case 1:     return a;
+    case 2:     return b;
+    case 3:     return static_cast<U8>((static_cast<U32>(a) + b) >> 1);
+    case 4:     return Paeth(a, b, c);
+    default:    return 0;
+    }
+}
+
+}
+
+namespace CommonClass
+{
+
+PngEncoder::PngEncoder()
+{
+    // empty
+}
+
+PngEncoder::PngEncoder(const Compression compression, const Types::U32 numThreads /*= 0*/)
+    :m_compression(compression), m_numThreads(numThreads)
+{
+    // empty
+}
+
+PngEncoder::~PngEncoder()
+{
+    // empty
+}
+
+std::vector<Types::U8> PngEncoder::Encode(const Types::U8* rgba, const Types::U32 width, const Types::U32 height, Statistic* outStatistic /*= nullptr*/) const
+{
+    if (rgba == nullptr || width == 0 || height == 0)
+    {
+        throw std::exception("cannot encode an empty image to PNG");
+    }
+    const auto startTime = std::chrono::steady_clock::now();
+
+    // filter the rows, each filtered row begin with the filter type.
+    const U32 rowBytes = width * 4;
+    const std::size_t filteredRowBytes = rowBytes + 1;
+    std::vector<U8> filtered(filteredRowBytes * height);
+    ParallelTool::ParallelFor(0, height, [&](const unsigned int y)
+    {
+        FilterRow(rgba + static_cast<std::size_t>(y) * rowBytes, y > 0 ? rgba + static_cast<std::size_t>(y - 1) * rowBytes : nullptr,
+            rowBytes, &filtered[y * filteredRowBytes]);
+    }, 16, m_numThreads);
+
+    // compress the chunks of rows.
+    const U32 rowsPerChunk = static_cast<U32>(std::max<std::size_t>(1, m_chunkBytes / filteredRowBytes));
+    const U32 numChunks = (height + rowsPerChunk - 1) / rowsPerChunk;
+    std::vector<std::vector<U8>> compressedChunks(numChunks);
+    std::vector<U32> chunkAdlers(numChunks);
+    ParallelTool::ParallelFor(0, numChunks, [&](const unsigned int chunk)
+    {
+        const std::size_t begin = chunk * rowsPerChunk * filteredRowBytes;
+        const std::size_t end = std::min(begin + rowsPerChunk * filteredRowBytes, filtered.size());
+        compressedChunks[chunk] = DeflateChunk(filtered.data(), begin, end, chunk + 1 == numChunks);
+        chunkAdlers[chunk] = Adler32(&filtered[begin], end - begin);
+    }, 1, m_numThreads);
+
+    std::size_t compressedBytes = 0;
+    for (const auto& compressed : compressedChunks)
+    {
+        compressedBytes += compressed.size();
+    }
+    std::vector<U8> png;
+    png.reserve(compressedBytes + 64);
+
+    const U8 SIGNATURE[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    png.insert(png.end(), SIGNATURE, SIGNATURE + sizeof(SIGNATURE));
+
+    // 8 bits RGBA, deflate, adaptive filter, not interlaced.
+    std::size_t chunkBegin = BeginPngChunk(png, "IHDR");
+    AppendBigEndian(png, width);
+    AppendBigEndian(png, height);
+    const U8 HEADER_REST[] = { 8, 6, 0, 0, 0 };
+    png.insert(png.end(), HEADER_REST, HEADER_REST + sizeof(HEADER_REST));
+    EndPngChunk(png, chunkBegin);
+
+    // the zlib header of 32KB window (the check bits make it multiple of 31), then the deflate stream and the adler32.
+    chunkBegin = BeginPngChunk(png, "IDAT");
+    png.push_back(0x78);
+    png.push_back(0x01);
+    U32 adler = chunkAdlers[0];
+    for (U32 chunk = 0; chunk < numChunks; ++chunk)
+    {
+        png.insert(png.end(), compressedChunks[chunk].begin(), compressedChunks[chunk].end());
+        if (chunk > 0)
+        {
+            const std::size_t chunkSize = std::min<std::size_t>(rowsPerChunk * filteredRowBytes, filtered.size() - chunk * rowsPerChunk * filteredRowBytes);
+            adler = CombineAdler32(adler, chunkAdlers[chunk], chunkSize);
+        }
+    }
+    AppendBigEndian(png, adler);
+    EndPngChunk(png, chunkBegin);
+
+    chunkBegin = BeginPngChunk(png, "IEND");
+    EndPngChunk(png, chunkBegin);
+
+    if (outStatistic)
+    {
+        outStatistic->m_rawBytes = static_cast<std::size_t>(rowBytes) * height;
+        outStatistic->m_encodedBytes = png.size();
+        outStatistic->m_elapsedMs = std::chrono::duration<Types::F32, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+    return png;
+}
+
+Types::U32 PngEncoder::Crc32(const Types::U8* data, const std::size_t size, const Types::U32 crc /*= 0*/)
+{
+    const U32* table = Tables().m_crc;
+    U32 c = ~crc;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        c = table[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    }
+    return ~c;
+}
+
+Types::U32 PngEncoder::Adler32(const Types::U8* data, std::size_t size, const Types::U32 adler /*= 1*/)
+{
+    // 5552 bytes is the most bytes before the sums overflow 32 bits.
+    const U32 BASE = 65521, MAX_RUN = 5552;
+    U32 sum1 = adler & 0xFFFF, sum2 = adler >> 16;
+    while (size > 0)
+    {
+        const U32 run = static_cast<U32>(std::min<std::size_t>(size, MAX_RUN));
+        for (U32 i = 0; i < run; ++i)
+        {
+            sum1 += data[i];
+            sum2 += sum1;
+        }
+        sum1 %= BASE;
+        sum2 %= BASE;
+        data += run;
+        size -= run;
+    }
+    return sum1 | (sum2 << 16);
+}
+
+void PngEncoder::FilterRow(const Types::U8* row, const Types::U8* previousRow, const Types::U32 rowBytes, Types::U8* output) const
+{
+    // each byte is predicted by the bytes of the left pixel and the up pixel.
+    const U32 BYTES_PER_PIXEL = 4;
+    auto filterByte = [row, previousRow](const U32 filterType, const U32 i)
+    {
+        const U8 a = i >= BYTES_PER_PIXEL ? row[i - BYTES_PER_PIXEL] : 0;
+        const U8 b = previousRow ? previousRow[i] : 0;
+        const U8 c = (previousRow && i >= BYTES_PER_PIXEL) ? previousRow[i - BYTES_PER_PIXEL] : 0;
+        return static_cast<U8>(row[i] - Predict(filterType, a, b, c));
+    };
+
+    // the filter with the least sum of the absolute (signed) residuals usually compress best.
+    U32 bestFilter = 0;
+    if (m_compression != STORE_COMPRESSION)
+    {
+        U32 bestSum = 0xFFFFFFFFu;
+        for (U32 filterType = 0; filterType < 5; ++filterType)
+        {
+            U32 sum = 0;
+            for (U32 i = 0; i < rowBytes && sum < bestSum; ++i)
+            {
+                sum += std::abs(static_cast<I32>(static_cast<signed char>(filterByte(filterType, i))));
+            }
+            if (sum < bestSum)
+            {
+                bestSum = sum;
+                bestFilter = filterType;
+            }
+        }
+    }
+
+    output[0] = static_cast<U8>(bestFilter);
+    for (U32 i = 0; i < rowBytes; ++i)
+    {
+        output[i + 1] = filterByte(bestFilter, i);
+    }
+}
+
+std::vector<Types::U8> PngEncoder::DeflateChunk(const Types::U8* data, const std::size_t begin, const std::size_t end, const bool isLast) const
+{
+    BitWriter writer;
+    if (m_compression == STORE_COMPRESSION)
+    {
+        writer.m_bytes.reserve(end - begin + (end - begin) / MAX_STORED_BYTES * 5 + 16);
+        WriteStoredBlocks(writer, data + begin, end - begin, isLast);
+    }
+    else
+    {
+        const U32 maxChainLength = m_compression == FAST_COMPRESSION ? 8 : 128;
+        const U32 niceLength = m_compression == FAST_COMPRESSION ? 32 : MAX_MATCH;
+
+        // the hash chains of the 3 bytes at each position, the positions are relative to the window begin.
+        const std::size_t windowBegin = begin > WINDOW_SIZE ? begin - WINDOW_SIZE : 0;
+        const U8* window = data + windowBegin;
+        const I32 chunkEnd = static_cast<I32>(end - windowBegin);
+        std::vector<I32> heads(1 << HASH_BITS, -1);
+        std::vector<I32> previous(WINDOW_SIZE, -1);
+        auto hash = [window](const I32 p)
+        {
+            const U32 key = (static_cast<U32>(window[p]) << 16) | (static_cast<U32>(window[p + 1]) << 8) | window[p + 2];
+            return (key * 2654435761u) >> (32 - HASH_BITS);
+        };
+        auto insert = [&](const I32 p)
+        {
+            if (p + static_cast<I32>(MIN_MATCH) <= chunkEnd)
+            {
+                const U32 h = hash(p);
+                previous[p & WINDOW_MASK] = heads[h];
+                heads[h] = p;
+            }
+        };
+
+        // the data before the chunk is the dictionary.
+        I32 p = static_cast<I32>(begin - windowBegin);
+        for (I32 q = 0; q < p; ++q)
+        {
+            insert(q);
+        }
+
+        std::vector<Symbol> symbols;
+        symbols.reserve(MAX_BLOCK_SYMBOLS);
+        I32 blockBegin = p;
+        while (p < chunkEnd)
+        {
+            U32 bestLength = 0, bestDistance = 0;
+            if (p + static_cast<I32>(MIN_MATCH) <= chunkEnd)
+            {
+                const U32 maxLength = std::min(MAX_MATCH, static_cast<U32>(chunkEnd - p));
+                U32 chainLength = maxChainLength;
+                for (I32 candidate = heads[hash(p)]; candidate >= 0 && p - candidate <= static_cast<I32>(WINDOW_SIZE) && chainLength > 0; --chainLength)
+                {
+                    if (window[candidate + bestLength] == window[p + bestLength])
+                    {
+                        U32 length = 0;
+                        while (length < maxLength && window[candidate + length] == window[p + length])
+                        {
+                            ++length;
+                        }
+                        if (length > bestLength)
+                        {
+                            bestLength = length;
+                            bestDistance = p - candidate;
+                            if (length >= niceLength || length == maxLength)
+                            {
+                                break;
+                            }
+                        }
+                    }
+                    // the slot may be reused by a newer position, then the chain is broken.
+                    const I32 next = previous[candidate & WINDOW_MASK];
+                    if (next >= candidate)
+                    {
+                        break;
+                    }
+                    candidate = next;
+                }
+            }
+
+            if (bestLength >= MIN_MATCH)
+            {
+                symbols.push_back({ static_cast<unsigned short>(bestLength), static_cast<unsigned short>(bestDistance) });
+                for (U32 i = 0; i < bestLength; ++i)
+                {
+                    insert(p + i);
+                }
+                p += bestLength;
+            }
+            else
+            {
+                symbols.push_back({ window[p], 0 });
+                insert(p);
+                ++p;
+            }
+
+            if (symbols.size() >= MAX_BLOCK_SYMBOLS && p < chunkEnd)
+            {
+                WriteBlock(writer, symbols, window + blockBegin, p - blockBegin, false);
+                symbols.clear();
+                blockBegin = p;
+            }
+        }
+        WriteBlock(writer, symbols, window + blockBegin, p - blockBegin, isLast);
+    }
+
+    if ( ! isLast)
+    {
+        // the empty stored block align the chunk to the byte boundary.
+        writer.Write(0, 3);
+        writer.AlignToByte();
+        writer.Write(0x0000, 16);
+        writer.Write(0xFFFF, 16);
+    }
+    writer.AlignToByte();
+    return std::move(writer.m_bytes);
+}
+
+}// namespace CommonClass
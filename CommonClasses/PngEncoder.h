@@ -0,0 +1,117 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "CommonTypes.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief PngEncoder encode the 8 bits RGBA pixels to a compressed PNG file in memory, without any external library.
+    Each row is filtered by the PNG filter (none, sub, up, average, paeth) which has the least sum of absolute differences,
+    then the filtered rows are compressed by deflate (LZ77 with hash chains and dynamic huffman codes).
+    The rows are split into independent chunks which are compressed on multiple threads,
+    each chunk can still refer to the last 32KB of the previous chunk, and ends at a byte boundary by an empty stored block,
+    so the compressed chunks are simply concatenated into one zlib stream.
+*/
+class PngEncoder
+{
+public:
+    enum Compression
+    {
+        /*!
+            \brief no filter and no compression (deflate stored blocks), the fastest, the file is larger than the pixels.
+        */
+        STORE_COMPRESSION,
+
+        /*!
+            \brief short hash chains, most of the size reduction at a high speed.
+        */
+        FAST_COMPRESSION,
+
+        /*!
+            \brief long hash chains, smaller file and slower.
+        */
+        SMALL_COMPRESSION
+    };
+
+    /*!
+        \brief what have been done by one Encode().
+    */
+    struct Statistic
+    {
+        /*!
+            \brief the bytes of the input pixels.
+        */
+        std::size_t m_rawBytes = 0;
+
+        /*!
+            \brief the bytes of the PNG file.
+        */
+        std::size_t m_encodedBytes = 0;
+
+        /*!
+            \brief the time cost in milliseconds.
+        */
+        Types::F32 m_elapsedMs = 0.0f;
+
+        /*!
+            \brief how many input megabytes are encoded per second.
+        */
+        Types::F32 MegabytesPerSecond() const
+        {
+            return m_elapsedMs > 0.0f ? m_rawBytes / (m_elapsedMs * 1000.0f) : 0.0f;
+        }
+    };
+
+public:
+    Compression m_compression = FAST_COMPRESSION;
+
+    /*!
+        \brief how many threads to filter and compress the chunks, zero for all the hardware threads.
+    */
+    Types::U32 m_numThreads = 0;
+
+    /*!
+        \brief the bytes of the filtered rows in one chunk, the chunks are compressed in parallel,
+        the smaller chunk has more parallelism and a little larger file.
+    */
+    Types::U32 m_chunkBytes = 256 * 1024;
+
+public:
+    PngEncoder();
+    explicit PngEncoder(const Compression compression, const Types::U32 numThreads = 0);
+    ~PngEncoder();
+
+    /*!
+        \brief encode the pixels to the PNG file.
+        \param rgba width * height pixels of 4 bytes (r, g, b, a), from the top row to the bottom row, like Image::GetRawData().
+        \param outStatistic if not null, return the size and the time.
+    */
+    std::vector<Types::U8> Encode(const Types::U8* rgba, const Types::U32 width, const Types::U32 height, Statistic* outStatistic = nullptr) const;
+
+    /*!
+        \brief the CRC32 of the PNG chunks.
+    */
+    static Types::U32 Crc32(const Types::U8* data, const std::size_t size, const Types::U32 crc = 0);
+
+    /*!
+        \brief the Adler32 of the zlib stream.
+    */
+    static Types::U32 Adler32(const Types::U8* data, const std::size_t size, const Types::U32 adler = 1);
+
+protected:
+    /*!
+        \brief filter the row by the chosen filter, the first byte of the output is the filter type.
+        \param previousRow the unfiltered previous row, nullptr for the first row.
+    */
+    void FilterRow(const Types::U8* row, const Types::U8* previousRow, const Types::U32 rowBytes, Types::U8* output) const;
+
+    /*!
+        \brief compress data[begin, end) to the deflate blocks, the data before begin (at most 32KB) can be referred.
+        \param isLast whether the chunk is the last chunk of the stream, otherwise the blocks end with a empty stored block.
+    */
+    std::vector<Types::U8> DeflateChunk(const Types::U8* data, const std::size_t begin, const std::size_t end, const bool isLast) const;
+};
+
+}// namespace CommonClass
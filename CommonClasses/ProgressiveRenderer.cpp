@@ -0,0 +1,172 @@
+#include "ProgressiveRenderer.h"
+#include <assert.h>
+#include <algorithm>
+#include "Utils/CounterRandom.h"
+#include "Utils/SampleSequence.h"
+#include "Utils/ParallelTool.h"
+
+namespace CommonClass
+{
+
+ProgressiveRenderer::ProgressiveRenderer()
+{
+    // empty
+}
+
+ProgressiveRenderer::~ProgressiveRenderer()
+{
+    // empty
+}
+
+ProgressiveRenderer::Statistic ProgressiveRenderer::Render(Camera& camera, const RadianceFunction& radiance, const Clock::time_point deadline)
+{
+    if (camera.m_film.get() == nullptr)
+    {
+        throw std::exception("progressive render failed: film is not setted");
+    }
+
+    m_accumulation = std::make_unique<AccumulationFilm>(camera.m_film->GetWidth(), camera.m_film->GetHeight());
+    m_passIndex = 0;
+    m_rowDone.clear();
+
+    return Refine(camera, radiance, deadline);
+}
+
+ProgressiveRenderer::Statistic ProgressiveRenderer::Render(Camera& camera, const RadianceFunction& radiance, const std::chrono::milliseconds budget)
+{
+    return Render(camera, radiance, Clock::now() + budget);
+}
+
+ProgressiveRenderer::Statistic ProgressiveRenderer::Refine(Camera& camera, const RadianceFunction& radiance, const Clock::time_point deadline)
+{
+    if (m_accumulation.get() == nullptr)
+    {
+        throw std::exception("progressive refine failed: Render() has not been called");
+    }
+
+    if (camera.m_film.get() == nullptr
+        || camera.m_film->GetWidth()  != m_accumulation->GetWidth()
+        || camera.m_film->GetHeight() != m_accumulation->GetHeight())
+    {
+        throw std::exception("progressive refine failed: film is changed");
+    }
+
+    assert(m_samplesPerPass > 0);
+
+    const Clock::time_point startTime = Clock::now();
+    Statistic stat;
+
+    while (m_passIndex < PassCount())
+    {
+        if (m_rowDone.empty())
+        {
+            m_rowDone.assign(RowCountOfPass(), 0);
+        }
+
+        if ( ! RenderPass(camera, radiance, deadline))
+        {
+            stat.m_isDeadlineReached = true;
+            break;
+        }
+
+        ++stat.m_completedPasses;
+        ++m_passIndex;
+        m_rowDone.clear();
+    }
+
+    stat.m_isFinished = m_passIndex >= PassCount();
+
+    // the best image till now.
+    m_accumulation->ResolveTo(camera.m_film.get());
+
+    stat.m_minSamples = m_accumulation->GetSampleCount(0, 0);
+    for (Types::U32 y = 0; y < m_accumulation->GetHeight(); ++y)
+    {
+        for (Types::U32 x = 0; x < m_accumulation->GetWidth(); ++x)
+        {
+            stat.m_minSamples = std::min(stat.m_minSamples, m_accumulation->GetSampleCount(x, y));
+        }
+    }
+
+    stat.m_elapsedMs = std::chrono::duration<Types::F32, std::milli>(Clock::now() - startTime).count();
+
+    return stat;
+}
+
+const AccumulationFilm * ProgressiveRenderer::GetAccumulationFilm() const
+{
+    return m_accumulation.get();
+}
+
+bool ProgressiveRenderer::RenderPass(Camera& camera, const RadianceFunction& radiance, const Clock::time_point deadline)
+{
+    const Types::U32 width      = m_accumulation->GetWidth();
+    const Types::U32 height     = m_accumulation->GetHeight();
+    const Types::U32 numRows    = RowCountOfPass();
+    const Types::U32 numPreview = static_cast<Types::U32>(m_previewBlockSizes.size());
+
+    // the refine samples of a pixel are the continuous points of a Sobol sequence, each pixel use its own random scramble,
+    // so the result is same no matter how many threads.
+    const RandomTool::SobolSequence sobol(2);
+    const RandomTool::CounterRandom scrambleRandom;
+
+    ParallelTool::ParallelFor(0, numRows, [&](const unsigned int row)
+    {
+        if (m_rowDone[row] || Clock::now() >= deadline)
+        {
+            return;
+        }
+
+        if (m_passIndex < numPreview)
+        {
+            // one sample at the center of each block.
+            const Types::U32 blockSize = m_previewBlockSizes[m_passIndex];
+            const Types::U32 bottom = row * blockSize;
+            const Types::F32 centerY = std::min(bottom + 0.5f * blockSize, static_cast<Types::F32>(height - 1));
+            for (Types::U32 left = 0; left < width; left += blockSize)
+            {
+                const Types::F32 centerX = std::min(left + 0.5f * blockSize, static_cast<Types::F32>(width - 1));
+                m_accumulation->SetPreviewBlock(left, bottom, blockSize, radiance(camera.GetRay(centerX, centerY)));
+            }
+        }
+        else
+        {
+            const Types::U32 firstSample = (m_passIndex - numPreview) * m_samplesPerPass;
+            for (Types::U32 x = 0; x < width; ++x)
+            {
+                const Types::U32 pixel = row * width + x;
+                const Types::U32 scrambleX = scrambleRandom.Bits(pixel, 0, 0);
+                const Types::U32 scrambleY = scrambleRandom.Bits(pixel, 0, 1);
+                for (Types::U32 s = 0; s < m_samplesPerPass; ++s)
+                {
+                    const Types::F32 sampleX = x + sobol.Sample(firstSample + s, 0, scrambleX);
+                    const Types::F32 sampleY = row + sobol.Sample(firstSample + s, 1, scrambleY);
+                    m_accumulation->AddSample(x, row, radiance(camera.GetRay(sampleX, sampleY)));
+                }
+            }
+        }
+
+        m_rowDone[row] = 1;
+    }, 1, m_numThreads);
+
+    return std::all_of(m_rowDone.begin(), m_rowDone.end(), [](const Types::U8 done) { return done != 0; });
+}
+
+Types::U32 ProgressiveRenderer::RowCountOfPass() const
+{
+    const Types::U32 height = m_accumulation->GetHeight();
+    if (m_passIndex < m_previewBlockSizes.size())
+    {
+        const Types::U32 blockSize = m_previewBlockSizes[m_passIndex];
+        assert(blockSize > 0);
+        return (height + blockSize - 1) / blockSize;
+    }
+    return height;
+}
+
+Types::U32 ProgressiveRenderer::PassCount() const
+{
+    return static_cast<Types::U32>(m_previewBlockSizes.size()) + (m_maxSamples + m_samplesPerPass - 1) / m_samplesPerPass;
+}
+
+} // namespace CommonClass
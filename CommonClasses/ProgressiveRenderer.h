@@ -0,0 +1,150 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <functional>
+#include "Camera.h"
+#include "AccumulationFilm.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief ProgressiveRenderer render the film of a camera pass by pass, and stop at a wall-clock deadline.
+    the passes are:
+        1. the preview passes, one sample for each block of m_previewBlockSizes[i] x m_previewBlockSizes[i] pixels,
+           from the coarsest to the finest, so a blocky image is available very soon.
+        2. the refine passes, m_samplesPerPass jittered samples for each pixel, until m_maxSamples or the deadline.
+    all the samples are accumulated in an AccumulationFilm, and when the deadline is reached,
+    the best image till now is resolved into the film of the camera.
+    the deadline is checked before each row, so the time exceeded is at most the time of one row.
+    Refine() can be called again to continue the progress from where it stopped.
+*/
+class ProgressiveRenderer
+{
+public:
+    /*!
+        \brief the radiance function, return the color of the ray, e.g. Scene::RayColor.
+    */
+    using RadianceFunction = std::function<vector3(const Ray&)>;
+
+    using Clock = std::chrono::steady_clock;
+
+    /*!
+        \brief what have been done in one call of Render() or Refine().
+    */
+    struct Statistic
+    {
+        /*!
+            \brief how many passes are completed in this call, including the preview passes.
+        */
+        Types::U32 m_completedPasses = 0;
+
+        /*!
+            \brief the min full resolution samples of all the pixels.
+        */
+        Types::U32 m_minSamples = 0;
+
+        /*!
+            \brief whether the rendering is stopped by the deadline.
+        */
+        bool m_isDeadlineReached = false;
+
+        /*!
+            \brief whether all the passes are done (every pixel has m_maxSamples).
+        */
+        bool m_isFinished = false;
+
+        /*!
+            \brief the time cost in milliseconds.
+        */
+        Types::F32 m_elapsedMs = 0.0f;
+    };
+
+public:
+    /*!
+        \brief the block sizes of the preview passes, from the coarsest to the finest.
+    */
+    std::vector<Types::U32> m_previewBlockSizes = { 8, 4, 2 };
+
+    /*!
+        \brief the samples for each pixel in one refine pass.
+    */
+    Types::U32 m_samplesPerPass = 1;
+
+    /*!
+        \brief the max full resolution samples for each pixel, the refine passes stop when reach this.
+    */
+    Types::U32 m_maxSamples = 64;
+
+    /*!
+        \brief how many threads to render rows, zero for all the hardware threads.
+    */
+    Types::U32 m_numThreads = 0;
+
+protected:
+    std::unique_ptr<AccumulationFilm> m_accumulation;
+
+    /*!
+        \brief the index of the pass to be done, the preview passes come first.
+    */
+    Types::U32 m_passIndex = 0;
+
+    /*!
+        \brief which rows of the current pass have been done, U8 for writing by multiple threads.
+    */
+    std::vector<Types::U8> m_rowDone;
+
+public:
+    ProgressiveRenderer();
+    ProgressiveRenderer(const ProgressiveRenderer&) = delete;
+    ProgressiveRenderer& operator=(const ProgressiveRenderer&) = delete;
+    ~ProgressiveRenderer();
+
+    /*!
+        \brief drop all the samples and render from the first pass.
+        \param camera the camera to generate rays, the film of the camera MUST be setted.
+        \param radiance the function to evaluate the color of one ray, it will be called on multiple threads.
+        \param deadline stop rendering at this time point.
+        \return what have been done.
+    */
+    Statistic Render(Camera& camera, const RadianceFunction& radiance, const Clock::time_point deadline);
+
+    /*!
+        \brief same as above, but the deadline is the time budget from now.
+    */
+    Statistic Render(Camera& camera, const RadianceFunction& radiance, const std::chrono::milliseconds budget);
+
+    /*!
+        \brief continue the passes of last Render(), the camera and the film size MUST be the same.
+        \param camera the camera to generate rays.
+        \param radiance the function to evaluate the color of one ray.
+        \param deadline stop rendering at this time point.
+        \return what have been done in this call.
+    */
+    Statistic Refine(Camera& camera, const RadianceFunction& radiance, const Clock::time_point deadline);
+
+    /*!
+        \brief get the accumulated samples, nullptr before the first Render().
+    */
+    const AccumulationFilm * GetAccumulationFilm() const;
+
+protected:
+    /*!
+        \brief render the rows of the current pass that are not done.
+        \return whether all the rows of the pass are done.
+    */
+    bool RenderPass(Camera& camera, const RadianceFunction& radiance, const Clock::time_point deadline);
+
+    /*!
+        \brief the number of rows of the current pass, a row of blocks for the preview pass.
+    */
+    Types::U32 RowCountOfPass() const;
+
+    /*!
+        \brief the total number of passes.
+    */
+    Types::U32 PassCount() const;
+};
+
+} // namespace CommonClass
@@ -27,4 +27,19 @@ void Ray::SetDirection(const vector3 & direction)
     m_direction = Normalize(direction);
 }
 
+PrecomputedRay::PrecomputedRay(const Ray & ray)
+    :m_origin(ray.m_origin)
+{
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        // IEEE division, 1 / (+-0) is (+-)infinity, which is what the slab test need.
+        m_inverseDirection.m_arr[i] = 1.0f / ray.m_direction.m_arr[i];
+        m_sign[i] = m_inverseDirection.m_arr[i] < 0.0f ? 1 : 0;
+    }
+}
+
+PrecomputedRay::~PrecomputedRay()
+{
+}
+
 } // namespace CommonClass
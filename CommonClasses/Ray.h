@@ -44,4 +44,29 @@ public:
 
 };
 
+/*!
+    \brief PrecomputedRay cache the inverse direction and the sign of each direction component of a Ray,
+    build it once for one ray, and then it can be tested with many AABBs without any division or branch.
+*/
+class PrecomputedRay
+{
+public:
+    vector3 m_origin;
+
+    /*!
+        \brief 1 / direction of each component, zero component become infinity.
+    */
+    vector3 m_inverseDirection;
+
+    /*!
+        \brief 1 if the direction component is negative, else 0,
+        used to pick the near/far slab plane of the AABB.
+    */
+    Types::U32 m_sign[3];
+
+public:
+    explicit PrecomputedRay(const Ray& ray);
+    ~PrecomputedRay();
+};
+
 } // namespace CommonClass
@@ -17,6 +17,7 @@ Scene::~Scene()
 
 void Scene::Add(std::unique_ptr<Surface> surf)
 {
+    m_boundingBoxes.push_back(surf->BoundingBox());
     m_surfaces.push_back(std::move(surf));
 }
 
@@ -30,19 +31,18 @@ bool Scene::Hit(const Ray & ray, const Types::F32 t0, const Types::F32 t1, HitRe
     Types::F32 t = t1;
     bool isHit = false;
 
-    // MUST use another HitRecord for bounding box ray hit test.
-    // if not the information will influence the normal surface hit test.
-    HitRecord recForBBox;
-    for (auto & surf : m_surfaces)
+    // the inverse direction is computed once for all the bounding boxes.
+    const PrecomputedRay precomputedRay(ray);
+    const size_t numSurfaces = m_surfaces.size();
+    for (size_t i = 0; i < numSurfaces; ++i)
     {
         // when hit with bounding box, the t is limited to [0.0f, t1], 
         // because it's possible that "RayOrigin(0.0f) ----> BoundingBox ------> t0 -------> Object -------> t1"
         // which the ray (dist belong to [t0, t1]) doesn't hit the BoundingBox but hit the Object, so set t0 to 0.0f to avoid this mistake.
         // However we do not modify the t1, because if a ray cannot hit a BoundingBox, it cannot hit the Object.
-        if (surf->BoundingBox().Hit(ray, 0.0f, t, &recForBBox))
-        //if (surf->BoundingBox().Hit(ray, 0.0f, t, pHitRec))
+        if (m_boundingBoxes[i].Hit(precomputedRay, 0.0f, t))
         {
-            if (surf->Hit(ray, t0, t, pHitRec))
+            if (m_surfaces[i]->Hit(ray, t0, t, pHitRec))
             {
                 isHit = true;
                 if (pHitRec->m_hitT < t)
@@ -109,7 +109,7 @@ CommonClass::vector3 Scene::RefractColor(const Ray &ray, const HitRecord &hitRec
         attenuation = attenuation * (-hitRec.m_hitT);
         for (int i = 0; i < 3; ++i)
         {
-            k.m_arr[i] = std::exp(attenuation.m_arr[i]);
+            k.m_arr[i] = MathTool::Exp<MathTool::FAST_MATH>(attenuation.m_arr[i]);
         }
 
         if (Refract(ray.m_direction, -hitRec.m_normal, 1.0f / hitRec.m_material->m_reflectIndex, &refractorVec))
@@ -152,13 +152,13 @@ CommonClass::vector3 Scene::LightColor(const Ray& viewRay, const HitRecord& hitR
         if (!this->Hit(shadowRayTest, 0.0f, toLightDist, &shadowHitRec))
         {// yes it's in the shadow.
             vector3 toEye = -viewRay.m_direction;
-            vector3 halfVec = Normalize(toEye + toLight);
+            vector3 halfVec = FastNormalize(toEye + toLight);
 
             vector3 lightStrength = light->m_color * std::max(0.0f, dotProd(hitRec.m_normal, toLight));
 
             const Types::F32 m = hitRec.m_material->m_shinness;
 
-            Types::F32 shinnessSthrength = (m + 8.0f) * 0.125f * std::powf(dotProd(halfVec, hitRec.m_normal), m);
+            Types::F32 shinnessSthrength = (m + 8.0f) * 0.125f * MathTool::Pow<MathTool::FAST_MATH>(dotProd(halfVec, hitRec.m_normal), m);
 
             vector3 fresnelCoefficient = hitRec.m_material->RFresnel(dotProd(toEye, hitRec.m_normal));
 
@@ -172,4 +172,19 @@ CommonClass::vector3 Scene::LightColor(const Ray& viewRay, const HitRecord& hitR
     return lightColor;
 }
 
+const std::vector<std::unique_ptr<Surface>>& Scene::GetSurfaces() const
+{
+    return m_surfaces;
+}
+
+const std::vector<std::unique_ptr<Light>>& Scene::GetLights() const
+{
+    return m_lights;
+}
+
+const std::vector<AABB>& Scene::GetBoundingBoxes() const
+{
+    return m_boundingBoxes;
+}
+
 } // namespace CommonClass
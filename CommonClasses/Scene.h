@@ -29,6 +29,12 @@ public:
 private:
     std::vector<std::unique_ptr<Surface>> m_surfaces;
 
+    /*!
+        \brief the bounding boxes of the m_surfaces, computed once when the surface is added,
+        so the surfaces should not be moved after they are added.
+    */
+    std::vector<AABB> m_boundingBoxes;
+
     /*!
         \brief all the point light in the scene
     */
@@ -80,6 +86,21 @@ public:
         this will take multiple light into account.
     */
     vector3 LightColor(const Ray& viewRay, const HitRecord& hitRec) const;
+
+    /*!
+        \brief get all the surfaces in the scene, used by the renderers that process rays in batch.
+    */
+    const std::vector<std::unique_ptr<Surface>>& GetSurfaces() const;
+
+    /*!
+        \brief get all the lights in the scene.
+    */
+    const std::vector<std::unique_ptr<Light>>& GetLights() const;
+
+    /*!
+        \brief get the cached bounding boxes, in the same order as GetSurfaces().
+    */
+    const std::vector<AABB>& GetBoundingBoxes() const;
 };
 
 } // namespace CommonClass
@@ -0,0 +1,190 @@
+#include "SummedAreaTable.h"
+#include <algorithm>
+#include <exception>
+#include "Utils/ParallelTool.h"
+
+namespace CommonClass
+{
+
+SummedAreaTable::SummedAreaTable(const Image& img, const Types::U32 numThreads /*= 0*/)
+    :m_width(img.GetWidth()), m_height(img.GetHeight()), m_numThreads(numThreads)
+{
+    using namespace Types;
+    const U32 stride = m_width + 1;
+    const Sums ZERO = { 0.0, 0.0, 0.0, 0.0 };
+    m_sum      .assign(stride * (m_height + 1), ZERO);
+    m_sumSquare.assign(stride * (m_height + 1), ZERO);
+
+    // prefix sum of each row.
+    ParallelTool::ParallelFor(0, m_height, [&](const unsigned int y)
+    {
+        Sums rowSum = ZERO, rowSumSquare = ZERO;
+        Sums* pSum       = &m_sum      [(y + 1) * stride + 1];
+        Sums* pSumSquare = &m_sumSquare[(y + 1) * stride + 1];
+        for (U32 x = 0; x < m_width; ++x)
+        {
+            const vector4 pixel = img.GetPixel(x, y);
+            for (U32 c = 0; c < 4; ++c)
+            {
+                const double v = pixel.m_arr[c];
+                rowSum[c]       += v;
+                rowSumSquare[c] += v * v;
+            }
+            pSum[x]       = rowSum;
+            pSumSquare[x] = rowSumSquare;
+        }
+    }, 8, m_numThreads);
+
+    // prefix sum of each column, the columns are split into strips so each thread go through the rows in memory order.
+    const U32 STRIP_WIDTH = 64;
+    const U32 numStrips = (m_width + STRIP_WIDTH - 1) / STRIP_WIDTH;
+    ParallelTool::ParallelFor(0, numStrips, [&](const unsigned int strip)
+    {
+        const U32 beginX = 1 + strip * STRIP_WIDTH;
+        const U32 endX = std::min(beginX + STRIP_WIDTH, stride);
+        for (U32 y = 2; y <= m_height; ++y)
+        {
+            for (U32 x = beginX; x < endX; ++x)
+            {
+                const Sums& below       = m_sum      [(y - 1) * stride + x];
+                const Sums& belowSquare = m_sumSquare[(y - 1) * stride + x];
+                Sums& sum       = m_sum      [y * stride + x];
+                Sums& sumSquare = m_sumSquare[y * stride + x];
+                for (U32 c = 0; c < 4; ++c)
+                {
+                    sum[c]       += below[c];
+                    sumSquare[c] += belowSquare[c];
+                }
+            }
+        }
+    }, 1, m_numThreads);
+}
+
+SummedAreaTable::~SummedAreaTable()
+{
+    // empty
+}
+
+vector4 SummedAreaTable::BoxSum(const Types::I32 left, const Types::I32 bottom, const Types::I32 right, const Types::I32 top) const
+{
+    Types::U32 l, b, r, t;
+    if ( ! Clip(left, bottom, right, top, l, b, r, t))
+    {
+        return vector4(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+    const Sums sum = RectSum(m_sum, m_width + 1, l, b, r, t);
+    return vector4(
+        static_cast<Types::F32>(sum[0]), static_cast<Types::F32>(sum[1]),
+        static_cast<Types::F32>(sum[2]), static_cast<Types::F32>(sum[3]));
+}
+
+vector4 SummedAreaTable::BoxMean(const Types::I32 left, const Types::I32 bottom, const Types::I32 right, const Types::I32 top) const
+{
+    Types::U32 l, b, r, t;
+    if ( ! Clip(left, bottom, right, top, l, b, r, t))
+    {
+        return vector4(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+    const Sums sum = RectSum(m_sum, m_width + 1, l, b, r, t);
+    const double recipoCount = 1.0 / (static_cast<double>(r - l) * (t - b));
+    return vector4(
+        static_cast<Types::F32>(sum[0] * recipoCount), static_cast<Types::F32>(sum[1] * recipoCount),
+        static_cast<Types::F32>(sum[2] * recipoCount), static_cast<Types::F32>(sum[3] * recipoCount));
+}
+
+vector4 SummedAreaTable::BoxVariance(const Types::I32 left, const Types::I32 bottom, const Types::I32 right, const Types::I32 top) const
+{
+    Types::U32 l, b, r, t;
+    if ( ! Clip(left, bottom, right, top, l, b, r, t))
+    {
+        return vector4(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+    const Sums sum       = RectSum(m_sum,       m_width + 1, l, b, r, t);
+    const Sums sumSquare = RectSum(m_sumSquare, m_width + 1, l, b, r, t);
+    const double recipoCount = 1.0 / (static_cast<double>(r - l) * (t - b));
+    vector4 variance;
+    for (Types::U32 c = 0; c < 4; ++c)
+    {
+        const double mean = sum[c] * recipoCount;
+        variance.m_arr[c] = static_cast<Types::F32>(std::max(0.0, sumSquare[c] * recipoCount - mean * mean));
+    }
+    return variance;
+}
+
+Image SummedAreaTable::BoxFilter(const Types::U32 radius) const
+{
+    const Types::I32 r = static_cast<Types::I32>(radius);
+    return ForEachPixel(m_width, m_height, [this, r](const Types::I32 x, const Types::I32 y)
+    {
+        return BoxMean(x - r, y - r, x + r + 1, y + r + 1);
+    });
+}
+
+Image SummedAreaTable::VarianceFilter(const Types::U32 radius) const
+{
+    const Types::I32 r = static_cast<Types::I32>(radius);
+    return ForEachPixel(m_width, m_height, [this, r](const Types::I32 x, const Types::I32 y)
+    {
+        return BoxVariance(x - r, y - r, x + r + 1, y + r + 1);
+    });
+}
+
+Image SummedAreaTable::Downsample(const Types::U32 factor) const
+{
+    if (factor == 0 || factor > m_width || factor > m_height)
+    {
+        throw std::exception("the downsample factor is larger than the image");
+    }
+    const Types::I32 f = static_cast<Types::I32>(factor);
+    return ForEachPixel(m_width / factor, m_height / factor, [this, f](const Types::I32 x, const Types::I32 y)
+    {
+        return BoxMean(x * f, y * f, (x + 1) * f, (y + 1) * f);
+    });
+}
+
+SummedAreaTable::Sums SummedAreaTable::RectSum(const std::vector<Sums>& table, const Types::U32 stride, const Types::U32 left, const Types::U32 bottom, const Types::U32 right, const Types::U32 top)
+{
+    const Sums& rt = table[top    * stride + right];
+    const Sums& lt = table[top    * stride + left];
+    const Sums& rb = table[bottom * stride + right];
+    const Sums& lb = table[bottom * stride + left];
+    Sums ret;
+    for (Types::U32 c = 0; c < 4; ++c)
+    {
+        ret[c] = rt[c] - lt[c] - rb[c] + lb[c];
+    }
+    return ret;
+}
+
+bool SummedAreaTable::Clip(Types::I32 left, Types::I32 bottom, Types::I32 right, Types::I32 top, Types::U32& outLeft, Types::U32& outBottom, Types::U32& outRight, Types::U32& outTop) const
+{
+    left    = std::max(left,   0);
+    bottom  = std::max(bottom, 0);
+    right   = std::min(right,  static_cast<Types::I32>(m_width));
+    top     = std::min(top,    static_cast<Types::I32>(m_height));
+    if (left >= right || bottom >= top)
+    {
+        return false;
+    }
+    outLeft     = static_cast<Types::U32>(left);
+    outBottom   = static_cast<Types::U32>(bottom);
+    outRight    = static_cast<Types::U32>(right);
+    outTop      = static_cast<Types::U32>(top);
+    return true;
+}
+
+template<typename FUNC>
+Image SummedAreaTable::ForEachPixel(const Types::U32 width, const Types::U32 height, FUNC&& func) const
+{
+    Image result(width, height);
+    ParallelTool::ParallelFor(0, height, [&](const unsigned int y)
+    {
+        for (Types::U32 x = 0; x < width; ++x)
+        {
+            result.SetPixel(x, y, func(static_cast<Types::I32>(x), static_cast<Types::I32>(y)));
+        }
+    }, 8, m_numThreads);
+    return result;
+}
+
+}// namespace CommonClass
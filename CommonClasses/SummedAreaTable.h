@@ -0,0 +1,100 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "Image.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief SummedAreaTable store the sum of all the pixels below and left to each pixel (and the sum of squares),
+    so the sum, mean and variance of any rectangle can be got by four lookups,
+    the cost of the box filters is constant for each pixel no matter how large the box is.
+    The sums are stored in double, so the large images do not lose precision.
+*/
+class SummedAreaTable
+{
+public:
+    using Sums = std::array<double, 4>;
+
+protected:
+    Types::U32 m_width  = 0;
+    Types::U32 m_height = 0;
+
+    /*!
+        \brief (m_width + 1) * (m_height + 1) entries, m_sum[y * (m_width + 1) + x] is the sum of the pixels in [0, x) * [0, y),
+        the first row and the first column are zero.
+    */
+    std::vector<Sums> m_sum;
+    std::vector<Sums> m_sumSquare;
+
+public:
+    /*!
+        \brief how many threads to build the table and run the filters, zero for all the hardware threads.
+    */
+    Types::U32 m_numThreads = 0;
+
+public:
+    /*!
+        \brief build the table of the image.
+        \param numThreads how many threads to build the table, zero for all the hardware threads.
+    */
+    explicit SummedAreaTable(const Image& img, const Types::U32 numThreads = 0);
+    ~SummedAreaTable();
+
+    /*!
+        \brief the sum of the pixels in [left, right) * [bottom, top), the rectangle is clipped by the image.
+    */
+    vector4 BoxSum(const Types::I32 left, const Types::I32 bottom, const Types::I32 right, const Types::I32 top) const;
+
+    /*!
+        \brief the mean of the pixels in [left, right) * [bottom, top) which are inside the image,
+        return zero if no pixel is inside.
+    */
+    vector4 BoxMean(const Types::I32 left, const Types::I32 bottom, const Types::I32 right, const Types::I32 top) const;
+
+    /*!
+        \brief the variance of each channel of the pixels in [left, right) * [bottom, top) which are inside the image.
+    */
+    vector4 BoxVariance(const Types::I32 left, const Types::I32 bottom, const Types::I32 right, const Types::I32 top) const;
+
+    /*!
+        \brief blur the image, each pixel is the mean of the (2 * radius + 1)^2 box around it,
+        near the border only the pixels inside the image are averaged.
+    */
+    Image BoxFilter(const Types::U32 radius) const;
+
+    /*!
+        \brief each pixel is the variance of the (2 * radius + 1)^2 box around it.
+    */
+    Image VarianceFilter(const Types::U32 radius) const;
+
+    /*!
+        \brief each pixel of the result is the mean of a factor * factor block, e.g. resolve the supersampled image,
+        the size of the result is (width / factor, height / factor), the rest pixels are ignored.
+    */
+    Image Downsample(const Types::U32 factor) const;
+
+    Types::U32 GetWidth() const { return m_width; }
+    Types::U32 GetHeight() const { return m_height; }
+
+protected:
+    /*!
+        \brief the rectangle sum of the table, the rectangle must be inside the image.
+    */
+    static Sums RectSum(const std::vector<Sums>& table, const Types::U32 stride, const Types::U32 left, const Types::U32 bottom, const Types::U32 right, const Types::U32 top);
+
+    /*!
+        \brief clip the rectangle by the image, return false if nothing left.
+    */
+    bool Clip(Types::I32 left, Types::I32 bottom, Types::I32 right, Types::I32 top,
+        Types::U32& outLeft, Types::U32& outBottom, Types::U32& outRight, Types::U32& outTop) const;
+
+    /*!
+        \brief run func(x, y) for each pixel of a width * height image on multiple threads, and store the result.
+    */
+    template<typename FUNC>
+    Image ForEachPixel(const Types::U32 width, const Types::U32 height, FUNC&& func) const;
+};
+
+}// namespace CommonClass
@@ -1,7 +1,8 @@
 
 #include <array>
+#include <algorithm>
 #include "Utils/MathTool.h"
-#include "Utils/MTRandom.h"
+#include "Utils/CounterRandom.h"
 #include "Texture.h"
 #include "vector3.h"
 
@@ -40,13 +41,13 @@ bool Texture::LoadFile(const std::string& file)
         return false;
     }
 
-    Init(x, y); // resize image memory, discard previous data.
+    Init(x, y, RGBA::BLACK, BYTE_STORAGE); // resize image memory, discard previous data.
     unsigned char * restoreAddr = GetRawData(); // get destination ptr
     memcpy(restoreAddr, data, x * y * 4);
     stbi_image_free(data);
 
-    // update byte pixels to float pixels.
-    this->BytePixelToFloatPixel();
+    // update byte pixels to float pixels, the byte canvas is released.
+    SetStorageFormat(FLOAT_STORAGE);
     return true;
 }
 
@@ -91,54 +92,60 @@ vector3 GammaVector(const Types::U32 i, const Types::U32 j, const Types::U32 k)
 {
     using namespace Types;
     const U32 NUM_PRECOMPUTED_VEC = 256;
-    static std::vector<vector3> precomputeVecList;
-    static std::vector<U32> randomIndices;
 
-    if (precomputeVecList.empty())
-    {// pre compute random vectors and indices.
-        precomputeVecList.resize(NUM_PRECOMPUTED_VEC);
-        randomIndices    .resize(NUM_PRECOMPUTED_VEC);
+    struct PrecomputedTable
+    {
+        std::array<vector3, NUM_PRECOMPUTED_VEC>    m_vecList;
+        std::array<U32, NUM_PRECOMPUTED_VEC>        m_randomIndices;
+    };
+
+    // pre compute random vectors and indices, the static local is initialized only once even with multiple threads,
+    // and the counter based generator make the table same in every run.
+    static const PrecomputedTable table = []()
+    {
+        PrecomputedTable ret;
+        const RandomTool::CounterRandom random;
 
-        RandomTool::MTRandom mtr;
-        for (auto& vec : precomputeVecList)
+        for (U32 vecIndex = 0; vecIndex < NUM_PRECOMPUTED_VEC; ++vecIndex)
         {
             vector3 randomVecInSphere;
-            std::array<F32, 3> sigma;
+            U32 attempt = 0;
 
             do {
-                // three sigma valus
-                for (auto& sig : sigma) { sig = mtr.Random(); }
-
-                // set vector3
-                for (U32 i = 0; i < sigma.size(); ++i)
+                // set vector3 by three sigma valus
+                for (U32 i = 0; i < 3; ++i)
                 {
-                    randomVecInSphere.m_arr[i] = 2.0f * sigma[i] - 1.0f;
+                    randomVecInSphere.m_arr[i] = 2.0f * random.Uniform(vecIndex, attempt, i) - 1.0f;
                 }
+                ++attempt;
             } while (Length(randomVecInSphere) >= 1.0f);
             // loop until get a random vector inside the unit sphere
 
             // store the normalized random vector.
-            vec = Normalize(randomVecInSphere);
+            ret.m_vecList[vecIndex] = Normalize(randomVecInSphere);
         }
 
-        // index
-        for (U32 index = 0; index < randomIndices.size(); ++index)
+        // index, Fisher-Yates shuffle.
+        for (U32 index = 0; index < NUM_PRECOMPUTED_VEC; ++index)
         {
-            randomIndices[index] = index;
+            ret.m_randomIndices[index] = index;
         }
-        std::random_shuffle(randomIndices.begin(), randomIndices.end());
-    }
-
-    assert(precomputeVecList.size() == NUM_PRECOMPUTED_VEC && randomIndices.size() == NUM_PRECOMPUTED_VEC);
+        for (U32 index = NUM_PRECOMPUTED_VEC - 1; index > 0; --index)
+        {
+            const U32 swapWith = random.Bits(NUM_PRECOMPUTED_VEC, index, 0) % (index + 1);
+            std::swap(ret.m_randomIndices[index], ret.m_randomIndices[swapWith]);
+        }
+        return ret;
+    }();
 
     U32 vecIndex;
-    vecIndex = randomIndices[k              % NUM_PRECOMPUTED_VEC];
-    vecIndex = randomIndices[(vecIndex + j) % NUM_PRECOMPUTED_VEC];
-    vecIndex = randomIndices[(vecIndex + i) % NUM_PRECOMPUTED_VEC];
+    vecIndex = table.m_randomIndices[k              % NUM_PRECOMPUTED_VEC];
+    vecIndex = table.m_randomIndices[(vecIndex + j) % NUM_PRECOMPUTED_VEC];
+    vecIndex = table.m_randomIndices[(vecIndex + i) % NUM_PRECOMPUTED_VEC];
 
     assert(vecIndex < NUM_PRECOMPUTED_VEC);
 
-    return precomputeVecList[vecIndex];
+    return table.m_vecList[vecIndex];
 }
 
 Types::F32 Texture::PerlinNoise(const Types::F32 x, const Types::F32 y /*= 0.0f*/, const Types::F32 z /*= 0.0f*/)
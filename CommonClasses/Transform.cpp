@@ -4,62 +4,6 @@
 namespace CommonClass
 {
 
-Transform::Transform()
-{
-    // NOTICE: vectors are column vector
-    m_column[0] = vector4(1.0f, 0.0f, 0.0f, 0.0f);
-    m_column[1] = vector4(0.0f, 1.0f, 0.0f, 0.0f);
-    m_column[2] = vector4(0.0f, 0.0f, 1.0f, 0.0f);
-    m_column[3] = vector4(0.0f, 0.0f, 0.0f, 1.0f);
-}
-
-
-Transform::Transform(
-    const Types::F32 m11, const Types::F32 m12, const Types::F32 m13, const Types::F32 m14, 
-    const Types::F32 m21, const Types::F32 m22, const Types::F32 m23, const Types::F32 m24, 
-    const Types::F32 m31, const Types::F32 m32, const Types::F32 m33, const Types::F32 m34, 
-    const Types::F32 m41, const Types::F32 m42, const Types::F32 m43, const Types::F32 m44)
-{
-    // NOTICE: vectors are column vector
-
-    m_column[0] = vector4(
-        m11, 
-        m21,
-        m31,
-        m41);
-
-    m_column[1] = vector4(
-        m12,
-        m22,
-        m32,
-        m42);
-
-    m_column[2] = vector4(
-        m13,
-        m23,
-        m33,
-        m43);
-
-    m_column[3] = vector4(
-        m14,
-        m24,
-        m34,
-        m44);
-}
-
-Transform::~Transform()
-{
-}
-
-Transform & Transform::operator=(const Transform & m)
-{
-    for (unsigned int c = 0; c < 4; ++c)
-    {
-        this->m_column[c] = m.m_column[c];
-    }
-    return *this;
-}
-
 CommonClass::Transform Transform::T()
 {
     return Transform(m_11, m_21, m_31, m_41,
@@ -236,6 +180,28 @@ Transform Transform::PerspectiveFOV(const Types::F32 fovAngleY, const Types::F32
     
 }
 
+Transform Transform::InversePerspectiveFOV(const Types::F32 fovAngleY, const Types::F32 aspectRatio, const Types::F32 near, const Types::F32 far)
+{
+    if (fovAngleY < 0.0f
+        || aspectRatio < 0.0f
+        || near <= 0.0f
+        || far < 0.0f
+        || near >= far)
+    {
+        throw std::exception("inverse perspective matrix of field of view error, arguments invalid.");
+    }
+
+    const Types::F32 TAN_ANGLE = std::tan(fovAngleY * 0.5f);
+    const Types::F32 RECIPO_NEAR_FAR = 1.0f / (near * far);
+
+    // z = -w', w = (z' * (near - far) + far * w') / (near * far).
+    return Transform(
+        aspectRatio * TAN_ANGLE,    0.0f,           0.0f,                               0.0f,
+        0.0f,                       TAN_ANGLE,      0.0f,                               0.0f,
+        0.0f,                       0.0f,           0.0f,                               -1.0f,
+        0.0f,                       0.0f,           (near - far) * RECIPO_NEAR_FAR,     far * RECIPO_NEAR_FAR);
+}
+
 bool operator==(const Transform & m1, const Transform & m2)
 {
     for (unsigned int i = 0; i < 4; ++i)
@@ -266,45 +232,83 @@ bool operator!=(const Transform & m1, const Transform & m2)
     return false;
 }
 
-vector4 operator*(const Transform & m, const vector4 & v)
+void TransformArray(vector4 * pOut, const Types::U32 outStride, const vector4 * pIn, const Types::U32 inStride, const Transform & m, const Types::U32 count)
 {
-    const Types::F32 column1 = m.m_column[0].m_arr[0] * v.m_arr[0] + m.m_column[1].m_arr[0] * v.m_arr[1] + m.m_column[2].m_arr[0] * v.m_arr[2] + m.m_column[3].m_arr[0] * v.m_arr[3];
-    const Types::F32 column2 = m.m_column[0].m_arr[1] * v.m_arr[0] + m.m_column[1].m_arr[1] * v.m_arr[1] + m.m_column[2].m_arr[1] * v.m_arr[2] + m.m_column[3].m_arr[1] * v.m_arr[3];
-    const Types::F32 column3 = m.m_column[0].m_arr[2] * v.m_arr[0] + m.m_column[1].m_arr[2] * v.m_arr[1] + m.m_column[2].m_arr[2] * v.m_arr[2] + m.m_column[3].m_arr[2] * v.m_arr[3];
-    const Types::F32 column4 = m.m_column[0].m_arr[3] * v.m_arr[0] + m.m_column[1].m_arr[3] * v.m_arr[1] + m.m_column[2].m_arr[3] * v.m_arr[2] + m.m_column[3].m_arr[3] * v.m_arr[3];
-
-    return vector4(
-        column1, 
-        column2, 
-        column3, 
-        column4);
+    const unsigned char * pSrc  = reinterpret_cast<const unsigned char *>(pIn);
+    unsigned char *       pDest = reinterpret_cast<unsigned char *>(pOut);
+
+#ifdef USING_SSE_MATH
+    // keep the columns in the registers, the output may alias the matrix if they are in the same buffer, so never reload it.
+    const __m128 column0 = LoadSSE(m.m_column[0]);
+    const __m128 column1 = LoadSSE(m.m_column[1]);
+    const __m128 column2 = LoadSSE(m.m_column[2]);
+    const __m128 column3 = LoadSSE(m.m_column[3]);
+
+    for (Types::U32 i = 0; i < count; ++i)
+    {
+        const __m128 v = _mm_loadu_ps(reinterpret_cast<const Types::F32 *>(pSrc));
+
+        __m128 result = _mm_mul_ps(column0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        result = _mm_add_ps(result, _mm_mul_ps(column1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+        result = _mm_add_ps(result, _mm_mul_ps(column2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+        result = _mm_add_ps(result, _mm_mul_ps(column3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+
+        _mm_storeu_ps(reinterpret_cast<Types::F32 *>(pDest), result);
+
+        pSrc  += inStride;
+        pDest += outStride;
+    }
+#else
+    const Transform localMat = m;
+    for (Types::U32 i = 0; i < count; ++i)
+    {
+        *reinterpret_cast<vector4 *>(pDest) = localMat * (*reinterpret_cast<const vector4 *>(pSrc));
+
+        pSrc  += inStride;
+        pDest += outStride;
+    }
+#endif
 }
 
-Transform operator*(const Transform & m1, const Transform & m2)
+void TransformNormalArray(vector4 * pOut, const Types::U32 outStride, const vector4 * pIn, const Types::U32 inStride, const Transform & m, const Types::U32 count)
 {
-    std::array<std::array<Types::F32, 4>, 4> arr_4_4;
+    const unsigned char * pSrc  = reinterpret_cast<const unsigned char *>(pIn);
+    unsigned char *       pDest = reinterpret_cast<unsigned char *>(pOut);
 
-    for (unsigned int row = 0; row < 4; ++row)
+#ifdef USING_SSE_MATH
+    // the w of the columns is cleared, so the output w is always 0.
+    const __m128 column0 = LoadSSE(vector4(m.m_column[0].m_x, m.m_column[0].m_y, m.m_column[0].m_z, 0.0f));
+    const __m128 column1 = LoadSSE(vector4(m.m_column[1].m_x, m.m_column[1].m_y, m.m_column[1].m_z, 0.0f));
+    const __m128 column2 = LoadSSE(vector4(m.m_column[2].m_x, m.m_column[2].m_y, m.m_column[2].m_z, 0.0f));
+
+    for (Types::U32 i = 0; i < count; ++i)
     {
-        for (unsigned int column = 0; column < 4; ++column)
-        {
-            Types::F32 component = 0.0f;
+        const __m128 v = _mm_loadu_ps(reinterpret_cast<const Types::F32 *>(pSrc));
 
-            for (unsigned int iter = 0; iter < 4; ++iter)
-            {
-                component += m1.m_column[iter].m_arr[row] * m2.m_column[column].m_arr[iter];
-            }
+        __m128 result = _mm_mul_ps(column0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        result = _mm_add_ps(result, _mm_mul_ps(column1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+        result = _mm_add_ps(result, _mm_mul_ps(column2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
 
-            arr_4_4[row][column] = component;
-        }
+        _mm_storeu_ps(reinterpret_cast<Types::F32 *>(pDest), result);
+
+        pSrc  += inStride;
+        pDest += outStride;
     }
+#else
+    const Transform localMat = m;
+    for (Types::U32 i = 0; i < count; ++i)
+    {
+        vector4 direction = *reinterpret_cast<const vector4 *>(pSrc);
+        direction.m_w = 0.0f;
 
-    return Transform(
-        arr_4_4[0][0], arr_4_4[0][1], arr_4_4[0][2], arr_4_4[0][3],
-        arr_4_4[1][0], arr_4_4[1][1], arr_4_4[1][2], arr_4_4[1][3],
-        arr_4_4[2][0], arr_4_4[2][1], arr_4_4[2][2], arr_4_4[2][3],
-        arr_4_4[3][0], arr_4_4[3][1], arr_4_4[3][2], arr_4_4[3][3]
-    );
+        vector4 result = localMat * direction;
+        result.m_w = 0.0f;
+        *reinterpret_cast<vector4 *>(pDest) = result;
+
+        pSrc  += inStride;
+        pDest += outStride;
+    }
+#endif
 }
 
 } // namespace CommonClass
@@ -185,6 +185,16 @@ public:
         \param far far plane distance to projection plane, only positive value avaliable.
     */
     static Transform PerspectiveFOV(const Types::F32 fovAngleY, const Types::F32 aspectRatio, const Types::F32 near, const Types::F32 far);
+
+    /*!
+        \brief the inverse of PerspectiveFOV() with the same parameters, which maps the homogeneous clip space back to the camera space,
+        e.g. to reproject a depth buffer, the result must be divided by w.
+        \param fovAngleY vertical angle for field of view
+        \param aspectRatio width : height
+        \param near near plane distance to projection plane, only positive value avaliable.
+        \param far far plane distance to projection plane, only positive value avaliable.
+    */
+    static Transform InversePerspectiveFOV(const Types::F32 fovAngleY, const Types::F32 aspectRatio, const Types::F32 near, const Types::F32 far);
 };
 // ensurance
 static_assert(sizeof(Transform) == 16 * sizeof(Types::F32), "size of transform is wrong");
@@ -202,12 +212,129 @@ bool operator != (const Transform& m1, const Transform& m2);
 /*!
     \brief apply matrix transformation on the vector4, return an new instance.
 */
-vector4 operator * (const Transform& m, const vector4& v);
+inline vector4 operator * (const Transform& m, const vector4& v);
 
 /*!
     \brief combine two transformation together
     \param m1, m2 the two matrix to be combined.
 */
-Transform operator * (const Transform& m1, const Transform& m2);
+inline Transform operator * (const Transform& m1, const Transform& m2);
+
+/*!
+    \brief transform an array of vector4 by one matrix in one call,
+    the columns of the matrix are loaded into registers only once for the whole array.
+    \param pOut the first output vector, can be same as pIn
+    \param outStride the byte distance between two output vectors,
+           so the vectors can be a member of an interleaved vertex structure.
+    \param pIn the first input vector
+    \param inStride the byte distance between two input vectors
+    \param m the matrix, use a pre-concatenated matrix (such as project * toCamera * toWorld) for a transform chain.
+    \param count the number of vectors
+*/
+void TransformArray(vector4 * pOut, const Types::U32 outStride, const vector4 * pIn, const Types::U32 inStride, const Transform& m, const Types::U32 count);
+
+/*!
+    \brief same as TransformArray, but the w component of the input is treated as 0 and the output w is 0,
+    use it for the directions, and for the normals with the inverse transpose matrix.
+*/
+void TransformNormalArray(vector4 * pOut, const Types::U32 outStride, const vector4 * pIn, const Types::U32 inStride, const Transform& m, const Types::U32 count);
+
+/*
+    the constructors and the multiplications are in the header,
+    so they can be inlined into the vertex transformation and the ray transformation loops.
+*/
+
+inline Transform::Transform()
+{
+    // NOTICE: vectors are column vector
+    m_column[0] = vector4(1.0f, 0.0f, 0.0f, 0.0f);
+    m_column[1] = vector4(0.0f, 1.0f, 0.0f, 0.0f);
+    m_column[2] = vector4(0.0f, 0.0f, 1.0f, 0.0f);
+    m_column[3] = vector4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+inline Transform::Transform(
+    const Types::F32 m11, const Types::F32 m12, const Types::F32 m13, const Types::F32 m14,
+    const Types::F32 m21, const Types::F32 m22, const Types::F32 m23, const Types::F32 m24,
+    const Types::F32 m31, const Types::F32 m32, const Types::F32 m33, const Types::F32 m34,
+    const Types::F32 m41, const Types::F32 m42, const Types::F32 m43, const Types::F32 m44)
+{
+    // NOTICE: vectors are column vector
+    m_column[0] = vector4(m11, m21, m31, m41);
+    m_column[1] = vector4(m12, m22, m32, m42);
+    m_column[2] = vector4(m13, m23, m33, m43);
+    m_column[3] = vector4(m14, m24, m34, m44);
+}
+
+inline Transform::~Transform()
+{
+}
+
+inline Transform & Transform::operator=(const Transform & m)
+{
+    for (unsigned int c = 0; c < 4; ++c)
+    {
+        this->m_column[c] = m.m_column[c];
+    }
+    return *this;
+}
+
+#ifdef USING_SSE_MATH
+
+/*!
+    \brief multiply the matrix with a vector in SSE register, (column0 * x + column1 * y + column2 * z + column3 * w).
+*/
+inline __m128 TransformSSE(const Transform & m, const __m128 v)
+{
+    __m128 result =                    _mm_mul_ps(LoadSSE(m.m_column[0]), _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+    result = _mm_add_ps(result,        _mm_mul_ps(LoadSSE(m.m_column[1]), _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+    result = _mm_add_ps(result,        _mm_mul_ps(LoadSSE(m.m_column[2]), _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+    return   _mm_add_ps(result,        _mm_mul_ps(LoadSSE(m.m_column[3]), _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+}
+
+inline vector4 operator*(const Transform & m, const vector4 & v)
+{
+    return StoreSSE(TransformSSE(m, LoadSSE(v)));
+}
+
+inline Transform operator*(const Transform & m1, const Transform & m2)
+{
+    // each column of the result is m1 * (the column of m2).
+    Transform result;
+    for (unsigned int c = 0; c < 4; ++c)
+    {
+        _mm_storeu_ps(result.m_column[c].m_arr.data(), TransformSSE(m1, LoadSSE(m2.m_column[c])));
+    }
+    return result;
+}
+
+#else
+
+inline vector4 operator*(const Transform & m, const vector4 & v)
+{
+    const Types::F32 column1 = m.m_column[0].m_arr[0] * v.m_arr[0] + m.m_column[1].m_arr[0] * v.m_arr[1] + m.m_column[2].m_arr[0] * v.m_arr[2] + m.m_column[3].m_arr[0] * v.m_arr[3];
+    const Types::F32 column2 = m.m_column[0].m_arr[1] * v.m_arr[0] + m.m_column[1].m_arr[1] * v.m_arr[1] + m.m_column[2].m_arr[1] * v.m_arr[2] + m.m_column[3].m_arr[1] * v.m_arr[3];
+    const Types::F32 column3 = m.m_column[0].m_arr[2] * v.m_arr[0] + m.m_column[1].m_arr[2] * v.m_arr[1] + m.m_column[2].m_arr[2] * v.m_arr[2] + m.m_column[3].m_arr[2] * v.m_arr[3];
+    const Types::F32 column4 = m.m_column[0].m_arr[3] * v.m_arr[0] + m.m_column[1].m_arr[3] * v.m_arr[1] + m.m_column[2].m_arr[3] * v.m_arr[2] + m.m_column[3].m_arr[3] * v.m_arr[3];
+
+    return vector4(
+        column1, 
+        column2, 
+        column3, 
+        column4);
+}
+
+inline Transform operator*(const Transform & m1, const Transform & m2)
+{
+    // each column of the result is m1 * (the column of m2).
+    Transform result;
+    for (unsigned int c = 0; c < 4; ++c)
+    {
+        result.m_column[c] = m1 * m2.m_column[c];
+    }
+    return result;
+}
+
+#endif // USING_SSE_MATH
 
 } // namespace CommonClass
@@ -0,0 +1,154 @@
+#include "CounterRandom.h"
+#include "../CommonTypes.h"
+#ifdef USING_SSE_MATH
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+
+/* Philox4x32 constants */
+const unsigned int PHILOX_M0 = 0xD2511F53;
+const unsigned int PHILOX_M1 = 0xCD9E8D57;
+const unsigned int PHILOX_W0 = 0x9E3779B9; /* golden ratio */
+const unsigned int PHILOX_W1 = 0xBB67AE85; /* sqrt(3) - 1 */
+const unsigned int PHILOX_ROUNDS = 10;
+
+inline void MulHiLo(unsigned int a, unsigned int b, unsigned int& hi, unsigned int& lo)
+{
+    const unsigned long long product = static_cast<unsigned long long>(a) * b;
+    hi = static_cast<unsigned int>(product >> 32);
+    lo = static_cast<unsigned int>(product);
+}
+
+#ifdef USING_SSE_MATH
+/*!
+    \brief the high and low 32 bits of a * b for all the four lanes.
+*/
+inline void MulHiLo(__m128i a, __m128i b, __m128i& hi, __m128i& lo)
+{
+    // lane 0 and 2 -> [lo0, hi0, lo2, hi2], lane 1 and 3 -> [lo1, hi1, lo3, hi3]
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    const __m128i low01  = _mm_unpacklo_epi32(even, odd); // [lo0, lo1, hi0, hi1]
+    const __m128i high23 = _mm_unpackhi_epi32(even, odd); // [lo2, lo3, hi2, hi3]
+    lo = _mm_unpacklo_epi64(low01, high23);
+    hi = _mm_unpackhi_epi64(low01, high23);
+}
+#endif
+
+}
+
+namespace RandomTool
+{
+
+CounterRandom::CounterRandom(unsigned int seed /*= 0*/)
+    :m_seed(seed)
+{
+    // empty
+}
+
+CounterRandom::Block CounterRandom::Philox(const Block& counter, unsigned int key0, unsigned int key1)
+{
+    Block ctr = counter;
+    for (unsigned int round = 0; round < PHILOX_ROUNDS; ++round)
+    {
+        unsigned int hi0, lo0, hi1, lo1;
+        MulHiLo(PHILOX_M0, ctr[0], hi0, lo0);
+        MulHiLo(PHILOX_M1, ctr[2], hi1, lo1);
+        ctr = { hi1 ^ ctr[1] ^ key0, lo1, hi0 ^ ctr[3] ^ key1, lo0 };
+        key0 += PHILOX_W0;
+        key1 += PHILOX_W1;
+    }
+    return ctr;
+}
+
+unsigned int CounterRandom::Bits(unsigned int pixel, unsigned int sample, unsigned int dimension) const
+{
+    const Block block = Philox({ pixel, sample, dimension / DIMENSIONS_PER_BLOCK, 0 }, m_seed, ~m_seed);
+    return block[dimension % DIMENSIONS_PER_BLOCK];
+}
+
+float CounterRandom::Uniform(unsigned int pixel, unsigned int sample, unsigned int dimension) const
+{
+    return BitsToUniform(Bits(pixel, sample, dimension));
+}
+
+void CounterRandom::FillUniform(unsigned int pixel, unsigned int sample, unsigned int firstDimension, float* out, unsigned int count) const
+{
+    unsigned int dimension = firstDimension;
+    const unsigned int end = firstDimension + count;
+
+    // the head dimensions before the first whole block.
+    while (dimension < end && dimension % DIMENSIONS_PER_BLOCK != 0)
+    {
+        *out++ = Uniform(pixel, sample, dimension++);
+    }
+
+#ifdef USING_SSE_MATH
+    // four blocks (16 dimensions) each time, the counters are stored as structure of arrays,
+    // lane i of ctrN is the N-th word of the block i.
+    const unsigned int BATCH = DIMENSIONS_PER_BLOCK * 4;
+    const __m128i m0 = _mm_set1_epi32(static_cast<int>(PHILOX_M0));
+    const __m128i m1 = _mm_set1_epi32(static_cast<int>(PHILOX_M1));
+    const __m128  toUniform = _mm_set1_ps(1.0f / 16777216.0f);
+    while (end - dimension >= BATCH)
+    {
+        const unsigned int firstBlock = dimension / DIMENSIONS_PER_BLOCK;
+        __m128i ctr0 = _mm_set1_epi32(static_cast<int>(pixel));
+        __m128i ctr1 = _mm_set1_epi32(static_cast<int>(sample));
+        __m128i ctr2 = _mm_setr_epi32(firstBlock, firstBlock + 1, firstBlock + 2, firstBlock + 3);
+        __m128i ctr3 = _mm_setzero_si128();
+        unsigned int key0 = m_seed, key1 = ~m_seed;
+        for (unsigned int round = 0; round < PHILOX_ROUNDS; ++round)
+        {
+            __m128i hi0, lo0, hi1, lo1;
+            MulHiLo(m0, ctr0, hi0, lo0);
+            MulHiLo(m1, ctr2, hi1, lo1);
+            ctr0 = _mm_xor_si128(_mm_xor_si128(hi1, ctr1), _mm_set1_epi32(static_cast<int>(key0)));
+            ctr1 = lo1;
+            ctr2 = _mm_xor_si128(_mm_xor_si128(hi0, ctr3), _mm_set1_epi32(static_cast<int>(key1)));
+            ctr3 = lo0;
+            key0 += PHILOX_W0;
+            key1 += PHILOX_W1;
+        }
+
+        __m128 f0 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(ctr0, 8)), toUniform);
+        __m128 f1 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(ctr1, 8)), toUniform);
+        __m128 f2 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(ctr2, 8)), toUniform);
+        __m128 f3 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(ctr3, 8)), toUniform);
+        // back to the order of dimensions.
+        _MM_TRANSPOSE4_PS(f0, f1, f2, f3);
+        _mm_storeu_ps(out +  0, f0);
+        _mm_storeu_ps(out +  4, f1);
+        _mm_storeu_ps(out +  8, f2);
+        _mm_storeu_ps(out + 12, f3);
+
+        out += BATCH;
+        dimension += BATCH;
+    }
+#endif
+
+    // the rest blocks.
+    while (dimension < end)
+    {
+        const Block block = Philox({ pixel, sample, dimension / DIMENSIONS_PER_BLOCK, 0 }, m_seed, ~m_seed);
+        for (unsigned int lane = 0; lane < DIMENSIONS_PER_BLOCK && dimension < end; ++lane, ++dimension)
+        {
+            *out++ = BitsToUniform(block[lane]);
+        }
+    }
+}
+
+void CounterRandom::SetSeed(unsigned int seed)
+{
+    m_seed = seed;
+}
+
+unsigned int CounterRandom::GetSeed() const
+{
+    return m_seed;
+}
+
+}// namespace RandomTool
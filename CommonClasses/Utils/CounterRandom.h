@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+
+//========================================================================
+//
+//  "Philox4x32-10 counter based random number generator"
+//  Algorithm from the paper <<Parallel Random Numbers: As Easy as 1, 2, 3>>
+//  by John K. Salmon, Mark A. Moraes, Ron O. Dror and David E. Shaw.
+//
+//========================================================================
+
+namespace RandomTool
+{
+
+/*!
+    \brief CounterRandom is a stateless random number generator, the random number is a pure function of
+    (seed, pixel, sample, dimension), so the same sample always get the same number no matter which thread
+    take it and in which order, and one generator can be shared by all the threads.
+    Every call hash the counter {pixel, sample, dimension / 4, 0} with the key {seed, ~seed} through ten Philox rounds,
+    which produce four 32 bits numbers for four continuous dimensions.
+*/
+class CounterRandom
+{
+public:
+    using Block = std::array<unsigned int, 4>;
+
+    /*!
+        \brief how many dimensions one Philox block produce.
+    */
+    static const unsigned int DIMENSIONS_PER_BLOCK = 4;
+
+private:
+    unsigned int m_seed;
+
+public:
+    explicit CounterRandom(unsigned int seed = 0);
+
+    /*!
+        \brief the raw Philox4x32-10 function.
+    */
+    static Block Philox(const Block& counter, unsigned int key0, unsigned int key1);
+
+    /*!
+        \brief 32 random bits for one dimension of one sample.
+    */
+    unsigned int Bits(unsigned int pixel, unsigned int sample, unsigned int dimension) const;
+
+    /*!
+        \brief a uniform float in [0, 1) for one dimension of one sample, it has 24 random bits.
+    */
+    float Uniform(unsigned int pixel, unsigned int sample, unsigned int dimension) const;
+
+    /*!
+        \brief fill out[i] = Uniform(pixel, sample, firstDimension + i) for i in [0, count),
+        with USING_SSE_MATH four Philox blocks are computed together.
+    */
+    void FillUniform(unsigned int pixel, unsigned int sample, unsigned int firstDimension, float* out, unsigned int count) const;
+
+    void            SetSeed(unsigned int seed);
+    unsigned int    GetSeed() const;
+};
+
+/*!
+    \brief convert 32 random bits to a float in [0, 1).
+*/
+inline float BitsToUniform(unsigned int bits)
+{
+    return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+}
+
+}// namespace RandomTool
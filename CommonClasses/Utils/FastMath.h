@@ -0,0 +1,261 @@
+#pragma once
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "../CommonTypes.h"
+#ifdef USING_SSE_MATH
+#include <emmintrin.h>
+#endif
+
+// this head file define the fast approximations of the transcendental functions used by the shading code.
+// they only use float arithmetic and integer operations on the float bits, there is no table and no loop inside,
+// with USING_SSE_MATH there are also the four lanes versions taking __m128 for the shading loops.
+// every function has a PRECISE_MATH version (the std function) and a FAST_MATH version,
+// the call site choose one by the template argument, e.g. MathTool::Pow<MathTool::FAST_MATH>(x, m).
+// the error bounds are checked by the FastMath case in the test suit.
+
+namespace MathTool
+{
+
+/*!
+    \brief which version of the math function to use.
+*/
+enum MathPrecision
+{
+    PRECISE_MATH = 0,
+    FAST_MATH
+};
+
+namespace FastMathDetail
+{
+
+inline unsigned int FloatAsBits(const float f)
+{
+    unsigned int bits;
+    std::memcpy(&bits, &f, sizeof(float));
+    return bits;
+}
+
+inline float BitsAsFloat(const unsigned int bits)
+{
+    float f;
+    std::memcpy(&f, &bits, sizeof(float));
+    return f;
+}
+
+/*!
+    \brief adding this number round a float in [-2^22, 2^22] to integer with the default rounding mode,
+    the integer is stored in the low bits of the mantissa.
+*/
+const float ROUND_MAGIC = 12582912.0f; // 1.5 * 2^23
+
+/*!
+    \brief bits of sqrt(0.5), the log2 split the mantissa to [sqrt(0.5), sqrt(2)).
+*/
+const unsigned int SQRT_HALF_BITS = 0x3f3504f3;
+
+// 2^f = e^(f ln2) for f in [-0.5, 0.5], Taylor polynomial, truncation error < 1.2e-7.
+const float EXP2_C1 = 0.693147180559945f;
+const float EXP2_C2 = 0.240226506959101f;
+const float EXP2_C3 = 0.0555041086648216f;
+const float EXP2_C4 = 0.00961812910762848f;
+const float EXP2_C5 = 0.00133335581464284f;
+const float EXP2_C6 = 0.000154035303933816f;
+
+// log2(m) = 2 / ln2 * atanh(s), s = (m - 1) / (m + 1), |s| < 0.1716, truncation error < 5e-8.
+const float LOG2_C1 = 2.88539008177793f;
+const float LOG2_C3 = 0.961796693925976f;
+const float LOG2_C5 = 0.577078016355585f;
+const float LOG2_C7 = 0.412198583111132f;
+
+const float LOG2_E = 1.44269504088896f;
+
+}// namespace FastMathDetail
+
+/*!
+    \brief 2^x, the relative error is less than 3e-7 for x in [-126, 127].
+    the input is clamped to that range, so the result never overflow to infinity or become a denormal number.
+*/
+inline float FastExp2(float x)
+{
+    using namespace FastMathDetail;
+    x = std::min(std::max(x, -126.0f), 127.0f);
+    // x = i + f, i is the nearest integer and f in [-0.5, 0.5].
+    const float rounded = x + ROUND_MAGIC;
+    const int i = static_cast<int>(FloatAsBits(rounded) - FloatAsBits(ROUND_MAGIC));
+    const float f = x - (rounded - ROUND_MAGIC);
+    const float p = 1.0f + f * (EXP2_C1 + f * (EXP2_C2 + f * (EXP2_C3 + f * (EXP2_C4 + f * (EXP2_C5 + f * EXP2_C6)))));
+    // multiply 2^i by adding i to the exponent.
+    return BitsAsFloat(FloatAsBits(p) + (static_cast<unsigned int>(i) << 23));
+}
+
+/*!
+    \brief log2(x) for a normal positive x, the absolute error is less than 2e-7 * max(1, |log2(x)|).
+    the result of zero, negative, denormal, infinity or NaN is undefined.
+*/
+inline float FastLog2(const float x)
+{
+    using namespace FastMathDetail;
+    // x = m * 2^e, m in [sqrt(0.5), sqrt(2))
+    const unsigned int bits = FloatAsBits(x);
+    const int e = static_cast<int>(bits - SQRT_HALF_BITS) >> 23;
+    const float m = BitsAsFloat(bits - (static_cast<unsigned int>(e) << 23));
+    const float s = (m - 1.0f) / (m + 1.0f);
+    const float s2 = s * s;
+    return static_cast<float>(e) + s * (LOG2_C1 + s2 * (LOG2_C3 + s2 * (LOG2_C5 + s2 * LOG2_C7)));
+}
+
+/*!
+    \brief x^y = 2^(y * log2(x)) for x >= 0, return 0 if x <= 0 (e.g. the cosine of a back facing light),
+    except x^0 is 1 for any x as std::pow, the relative error is less than 4e-7 * max(1, |y * log2(x)|), x must not be a denormal number.
+*/
+inline float FastPow(const float x, const float y)
+{
+    if (y == 0.0f)
+    {
+        return 1.0f;
+    }
+    const float result = FastExp2(y * FastLog2(x));
+    return x > 0.0f ? result : 0.0f;
+}
+
+/*!
+    \brief e^x, the relative error is less than 4e-7 * max(1, |x|) for x in [-87, 88].
+*/
+inline float FastExp(const float x)
+{
+    return FastExp2(x * FastMathDetail::LOG2_E);
+}
+
+/*!
+    \brief 1 / sqrt(x) for a normal positive x, the relative error is less than 5e-7 with USING_SSE_MATH,
+    otherwise less than 5e-6.
+*/
+inline float FastRsqrt(const float x)
+{
+#ifdef USING_SSE_MATH
+    // 12 bits estimation and one Newton step.
+    const float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+    return y * (1.5f - 0.5f * x * y * y);
+#else
+    // magic number estimation and two Newton steps.
+    float y = FastMathDetail::BitsAsFloat(0x5f375a86 - (FastMathDetail::FloatAsBits(x) >> 1));
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+    return y;
+#endif
+}
+
+#ifdef USING_SSE_MATH
+/*!
+    \brief four lanes versions, same algorithms and error bounds as the scalar versions.
+*/
+inline __m128 FastExp2(__m128 x)
+{
+    using namespace FastMathDetail;
+    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-126.0f)), _mm_set1_ps(127.0f));
+    const __m128 magic = _mm_set1_ps(ROUND_MAGIC);
+    const __m128 rounded = _mm_add_ps(x, magic);
+    const __m128i i = _mm_sub_epi32(_mm_castps_si128(rounded), _mm_castps_si128(magic));
+    const __m128 f = _mm_sub_ps(x, _mm_sub_ps(rounded, magic));
+    __m128 p = _mm_set1_ps(EXP2_C6);
+    p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C5));
+    p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C4));
+    p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C3));
+    p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C2));
+    p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C1));
+    p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(1.0f));
+    return _mm_castsi128_ps(_mm_add_epi32(_mm_castps_si128(p), _mm_slli_epi32(i, 23)));
+}
+
+inline __m128 FastLog2(const __m128 x)
+{
+    using namespace FastMathDetail;
+    const __m128i bits = _mm_castps_si128(x);
+    const __m128i e = _mm_srai_epi32(_mm_sub_epi32(bits, _mm_set1_epi32(static_cast<int>(SQRT_HALF_BITS))), 23);
+    const __m128 m = _mm_castsi128_ps(_mm_sub_epi32(bits, _mm_slli_epi32(e, 23)));
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 s = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+    const __m128 s2 = _mm_mul_ps(s, s);
+    __m128 p = _mm_set1_ps(LOG2_C7);
+    p = _mm_add_ps(_mm_mul_ps(p, s2), _mm_set1_ps(LOG2_C5));
+    p = _mm_add_ps(_mm_mul_ps(p, s2), _mm_set1_ps(LOG2_C3));
+    p = _mm_add_ps(_mm_mul_ps(p, s2), _mm_set1_ps(LOG2_C1));
+    return _mm_add_ps(_mm_cvtepi32_ps(e), _mm_mul_ps(s, p));
+}
+
+inline __m128 FastPow(const __m128 x, const __m128 y)
+{
+    const __m128 result = _mm_and_ps(FastExp2(_mm_mul_ps(y, FastLog2(x))), _mm_cmpgt_ps(x, _mm_setzero_ps()));
+    const __m128 isZeroPower = _mm_cmpeq_ps(y, _mm_setzero_ps());
+    return _mm_or_ps(_mm_and_ps(isZeroPower, _mm_set1_ps(1.0f)), _mm_andnot_ps(isZeroPower, result));
+}
+
+inline __m128 FastExp(const __m128 x)
+{
+    return FastExp2(_mm_mul_ps(x, _mm_set1_ps(FastMathDetail::LOG2_E)));
+}
+
+inline __m128 FastRsqrt(const __m128 x)
+{
+    const __m128 y = _mm_rsqrt_ps(x);
+    const __m128 yyx = _mm_mul_ps(_mm_mul_ps(y, y), x);
+    return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_set1_ps(0.5f), yyx)));
+}
+#endif // USING_SSE_MATH
+
+/*!
+    \brief x^y, choose the version by the precision.
+*/
+template<MathPrecision PRECISION>
+inline float Pow(const float x, const float y);
+
+/*!
+    \brief e^x, choose the version by the precision.
+*/
+template<MathPrecision PRECISION>
+inline float Exp(const float x);
+
+/*!
+    \brief 1 / sqrt(x), choose the version by the precision.
+*/
+template<MathPrecision PRECISION>
+inline float Rsqrt(const float x);
+
+template<>
+inline float Pow<PRECISE_MATH>(const float x, const float y)
+{
+    return std::pow(x, y);
+}
+
+template<>
+inline float Pow<FAST_MATH>(const float x, const float y)
+{
+    return FastPow(x, y);
+}
+
+template<>
+inline float Exp<PRECISE_MATH>(const float x)
+{
+    return std::exp(x);
+}
+
+template<>
+inline float Exp<FAST_MATH>(const float x)
+{
+    return FastExp(x);
+}
+
+template<>
+inline float Rsqrt<PRECISE_MATH>(const float x)
+{
+    return 1.0f / std::sqrt(x);
+}
+
+template<>
+inline float Rsqrt<FAST_MATH>(const float x)
+{
+    return FastRsqrt(x);
+}
+
+}// namespace MathTool
@@ -0,0 +1,73 @@
+#pragma once
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+// this head file define some useful function for running loops on multiple threads
+
+namespace ParallelTool
+{
+
+/*!
+    \brief get the number of worker threads to use, at least one.
+    \param requested the thread count the user want, zero means using all the hardware threads.
+*/
+inline unsigned int WorkerCount(const unsigned int requested = 0)
+{
+    if (requested > 0)
+    {
+        return requested;
+    }
+    const unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
+
+/*!
+    \brief run func(index) for each index in [begin, end) on multiple threads.
+    \param begin first index
+    \param end one past the last index
+    \param func the function to run, it MUST be thread safe, signature: void(unsigned int index)
+    \param grain how many continuous indices one thread take each time, larger grain has less scheduling cost.
+    \param numThreads the thread count, zero means using all the hardware threads.
+    the calling thread will also take part in the work, and this function return only when all the indices are done.
+*/
+template<typename FUNC>
+void ParallelFor(const unsigned int begin, const unsigned int end, FUNC&& func, const unsigned int grain = 1, const unsigned int numThreads = 0)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    const unsigned int step = std::max(grain, 1u);
+    const unsigned int numChunks = (end - begin + step - 1) / step;
+    const unsigned int numWorkers = std::min(WorkerCount(numThreads), numChunks);
+
+    std::atomic<unsigned int> nextChunk(0);
+    auto worker = [&]()
+    {
+        for (unsigned int chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+        {
+            const unsigned int chunkBegin = begin + chunk * step;
+            const unsigned int chunkEnd = std::min(chunkBegin + step, end);
+            for (unsigned int i = chunkBegin; i < chunkEnd; ++i)
+            {
+                func(i);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < numWorkers; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+}
+
+}// namespace ParallelTool
@@ -0,0 +1,156 @@
+#include "SampleSequence.h"
+#include <exception>
+#include <cassert>
+#include <limits>
+#include "CounterRandom.h"
+
+namespace
+{
+
+/*!
+    \brief primitive polynomial and initial direction numbers of one Sobol dimension,
+    the degree is the number of valid m values.
+*/
+struct SobolInitialNumbers
+{
+    unsigned int m_degree;
+    unsigned int m_coefficients;
+    unsigned int m_m[5];
+};
+
+// from the new-joe-kuo-6.21201 table, dimension 0 is the van der Corput sequence and has no polynomial.
+const SobolInitialNumbers SOBOL_INITIAL_NUMBERS[] = {
+    { 1, 0, { 1 } },
+    { 2, 1, { 1, 3 } },
+    { 3, 1, { 1, 3, 1 } },
+    { 3, 2, { 1, 1, 1 } },
+    { 4, 1, { 1, 1, 3, 3 } },
+    { 4, 4, { 1, 3, 5, 13 } },
+    { 5, 2, { 1, 1, 5, 5, 17 } },
+    { 5, 4, { 1, 1, 5, 5, 5 } },
+    { 5, 7, { 1, 1, 7, 11, 19 } },
+};
+
+const unsigned int PRIMES[] = {
+      2,   3,   5,   7,  11,  13,  17,  19,  23,  29,  31,  37,  41,  43,  47,  53,
+     59,  61,  67,  71,  73,  79,  83,  89,  97, 101, 103, 107, 109, 113, 127, 131 };
+
+/*!
+    \brief the largest float less than one.
+*/
+const float ONE_MINUS_EPSILON = 1.0f - std::numeric_limits<float>::epsilon() * 0.5f;
+
+static_assert(sizeof(SOBOL_INITIAL_NUMBERS) / sizeof(SOBOL_INITIAL_NUMBERS[0]) + 1 == RandomTool::SobolSequence::MAX_DIMENSIONS,
+    "one set of initial numbers for each dimension except the first one");
+static_assert(sizeof(PRIMES) / sizeof(PRIMES[0]) == RandomTool::HaltonSequence::MAX_DIMENSIONS,
+    "one prime for each dimension");
+
+}
+
+namespace RandomTool
+{
+
+SobolSequence::SobolSequence(unsigned int numDimensions /*= 2*/)
+{
+    if (numDimensions == 0 || numDimensions > MAX_DIMENSIONS)
+    {
+        throw std::exception("the dimensions of Sobol sequence is out of range");
+    }
+
+    m_directions.resize(numDimensions);
+
+    // dimension 0, v[k] = 1 / 2^(k+1)
+    for (unsigned int k = 0; k < 32; ++k)
+    {
+        m_directions[0][k] = 1u << (31 - k);
+    }
+
+    for (unsigned int d = 1; d < numDimensions; ++d)
+    {
+        const SobolInitialNumbers& init = SOBOL_INITIAL_NUMBERS[d - 1];
+        const unsigned int s = init.m_degree;
+        std::array<unsigned int, 32>& v = m_directions[d];
+
+        for (unsigned int k = 0; k < s; ++k)
+        {
+            v[k] = init.m_m[k] << (31 - k);
+        }
+        // v[k] = a1 v[k-1] ^ a2 v[k-2] ^ ... ^ a(s-1) v[k-s+1] ^ v[k-s] ^ (v[k-s] >> s)
+        for (unsigned int k = s; k < 32; ++k)
+        {
+            v[k] = v[k - s] ^ (v[k - s] >> s);
+            for (unsigned int j = 1; j < s; ++j)
+            {
+                if ((init.m_coefficients >> (s - 1 - j)) & 1)
+                {
+                    v[k] ^= v[k - j];
+                }
+            }
+        }
+    }
+}
+
+unsigned int SobolSequence::SampleBits(unsigned int index, unsigned int dimension, unsigned int scramble /*= 0*/) const
+{
+    assert(dimension < m_directions.size());
+    const std::array<unsigned int, 32>& v = m_directions[dimension];
+
+    unsigned int result = scramble;
+    for (unsigned int k = 0; index != 0; index >>= 1, ++k)
+    {
+        // branchless, the mask is all ones when the bit is set.
+        result ^= v[k] & (0u - (index & 1));
+    }
+    return result;
+}
+
+float SobolSequence::Sample(unsigned int index, unsigned int dimension, unsigned int scramble /*= 0*/) const
+{
+    return BitsToUniform(SampleBits(index, dimension, scramble));
+}
+
+unsigned int SobolSequence::GetDimensions() const
+{
+    return static_cast<unsigned int>(m_directions.size());
+}
+
+float HaltonSequence::Sample(unsigned int index, unsigned int dimension, float shift /*= 0.0f*/)
+{
+    float result = RadicalInverse(PrimeOf(dimension), index) + shift;
+    if (result >= 1.0f)
+    {
+        result -= 1.0f;
+    }
+    // keep the result less than one after the float rounding.
+    return result < 1.0f ? result : ONE_MINUS_EPSILON;
+}
+
+float HaltonSequence::RadicalInverse(unsigned int base, unsigned int index)
+{
+    assert(base >= 2);
+    // accumulate the reversed digits as an integer, divide only once at the end.
+    const double invBase = 1.0 / base;
+    unsigned long long reversedDigits = 0;
+    double invBaseN = 1.0;
+    while (index > 0)
+    {
+        const unsigned int next = index / base;
+        const unsigned int digit = index - next * base;
+        reversedDigits = reversedDigits * base + digit;
+        invBaseN *= invBase;
+        index = next;
+    }
+    const float result = static_cast<float>(reversedDigits * invBaseN);
+    return result < 1.0f ? result : ONE_MINUS_EPSILON;
+}
+
+unsigned int HaltonSequence::PrimeOf(unsigned int dimension)
+{
+    if (dimension >= MAX_DIMENSIONS)
+    {
+        throw std::exception("the dimension of Halton sequence is out of range");
+    }
+    return PRIMES[dimension];
+}
+
+}// namespace RandomTool
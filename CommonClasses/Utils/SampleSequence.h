@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <vector>
+
+// this head file define the low discrepancy sequences for sampling pixels and lights.
+// compare to independent random samples, the first N points of these sequences are well stratified in every dimension,
+// so the error of the pixel estimator drop faster at the same sample count.
+
+namespace RandomTool
+{
+
+/*!
+    \brief the Sobol sequence with the direction numbers from Joe and Kuo (new-joe-kuo-6.21201).
+    the first two dimensions are a (0, 2)-sequence, any 2^m points starting from a multiple of 2^m
+    have exactly one point in each elementary interval of area 1 / 2^m.
+*/
+class SobolSequence
+{
+public:
+    /*!
+        \brief the max dimensions supported by the built in direction numbers.
+    */
+    static const unsigned int MAX_DIMENSIONS = 10;
+
+private:
+    /*!
+        \brief m_directions[d][k] is the k-th direction number of the dimension d.
+    */
+    std::vector<std::array<unsigned int, 32>> m_directions;
+
+public:
+    /*!
+        \brief build the direction numbers.
+        \param numDimensions how many dimensions will be sampled, throw if greater than MAX_DIMENSIONS.
+    */
+    explicit SobolSequence(unsigned int numDimensions = 2);
+
+    /*!
+        \brief the 32 bits fraction of the point index in the dimension.
+        \param scramble xor with the result (random digital shift), which keep the stratification.
+    */
+    unsigned int SampleBits(unsigned int index, unsigned int dimension, unsigned int scramble = 0) const;
+
+    /*!
+        \brief the point in [0, 1).
+    */
+    float Sample(unsigned int index, unsigned int dimension, unsigned int scramble = 0) const;
+
+    unsigned int GetDimensions() const;
+};
+
+/*!
+    \brief the Halton sequence, dimension d is the radical inverse of the index in the d-th prime base.
+    it supports more dimensions than SobolSequence, but the high dimensions need many points to be well stratified.
+*/
+class HaltonSequence
+{
+public:
+    /*!
+        \brief the max dimensions supported by the built in prime table.
+    */
+    static const unsigned int MAX_DIMENSIONS = 32;
+
+    /*!
+        \brief the radical inverse of the index in the prime base of the dimension.
+        \param shift Cranley-Patterson rotation, the result is (point + shift) mod 1.
+    */
+    static float Sample(unsigned int index, unsigned int dimension, float shift = 0.0f);
+
+    /*!
+        \brief mirror the digits of index in base around the radix point, e.g. base 2, index 6 (110) -> 0.011.
+    */
+    static float RadicalInverse(unsigned int base, unsigned int index);
+
+    /*!
+        \brief the prime base of the dimension.
+    */
+    static unsigned int PrimeOf(unsigned int dimension);
+};
+
+}// namespace RandomTool
@@ -0,0 +1,333 @@
+#include "WavefrontRenderer.h"
+#include <algorithm>
+#include <assert.h>
+#include "Utils/ParallelTool.h"
+
+namespace CommonClass
+{
+
+WavefrontRenderer::WavefrontRenderer(const Scene& scene)
+    :m_scene(scene)
+{
+    // empty
+}
+
+WavefrontRenderer::~WavefrontRenderer()
+{
+    // empty
+}
+
+void WavefrontRenderer::Render(Camera& camera) const
+{
+    if (camera.m_film.get() == nullptr)
+    {
+        throw std::exception("wavefront render failed: film is not setted");
+    }
+
+    assert(m_tileSize > 0);
+
+    const Types::U32 filmWidth  = camera.m_film->GetWidth();
+    const Types::U32 filmHeight = camera.m_film->GetHeight();
+    const Types::U32 numTileX   = (filmWidth  + m_tileSize - 1) / m_tileSize;
+    const Types::U32 numTileY   = (filmHeight + m_tileSize - 1) / m_tileSize;
+
+    ParallelTool::ParallelFor(0, numTileX * numTileY, [&](const unsigned int tileIndex)
+    {
+        const Types::U32 left   = (tileIndex % numTileX) * m_tileSize;
+        const Types::U32 bottom = (tileIndex / numTileX) * m_tileSize;
+
+        RenderTile(camera, left, bottom,
+            std::min(m_tileSize, filmWidth  - left),
+            std::min(m_tileSize, filmHeight - bottom));
+    }, 1, m_numThreads);
+}
+
+void WavefrontRenderer::RenderTile(Camera& camera, const Types::U32 left, const Types::U32 bottom, const Types::U32 width, const Types::U32 height) const
+{
+    const Types::U32 numPixels = width * height;
+
+    std::vector<vector3>    colors(numPixels, vector3::BLACK);
+    std::vector<PathRay>    rays;
+    std::vector<PathRay>    nextRays;
+    std::vector<ShadowRay>  shadowRays;
+    std::vector<HitRecord>  hitRecs;
+    std::vector<bool>       isHit;
+    std::vector<Types::U32> hitOrder;
+
+    // generate all the camera rays of the tile.
+    rays.reserve(numPixels);
+    for (Types::U32 y = 0; y < height; ++y)
+    {
+        for (Types::U32 x = 0; x < width; ++x)
+        {
+            PathRay pathRay;
+            pathRay.m_ray        = camera.GetRay(static_cast<Types::F32>(left + x), static_cast<Types::F32>(bottom + y));
+            pathRay.m_weight     = vector3::UNIT;
+            pathRay.m_pixelIndex = y * width + x;
+            pathRay.m_depth      = m_maxDepth;
+            rays.push_back(pathRay);
+        }
+    }
+
+    while ( ! rays.empty())
+    {
+        IntersectStage(rays, &hitRecs, &isHit);
+
+        SortStage(rays, hitRecs, isHit, &colors, &hitOrder);
+
+        nextRays.clear();
+        shadowRays.clear();
+        ShadeStage(rays, hitRecs, hitOrder, &colors, &shadowRays, &nextRays);
+
+        ShadowStage(shadowRays, &colors);
+
+        std::swap(rays, nextRays);
+    }
+
+    for (Types::U32 y = 0; y < height; ++y)
+    {
+        for (Types::U32 x = 0; x < width; ++x)
+        {
+            camera.IncomeLight(left + x, bottom + y, colors[y * width + x]);
+        }
+    }
+}
+
+void WavefrontRenderer::IntersectStage(const std::vector<PathRay>& rays, std::vector<HitRecord>* pOutHitRecs, std::vector<bool>* pOutIsHit) const
+{
+    assert(pOutHitRecs != nullptr && pOutIsHit != nullptr);
+
+    const size_t numRays = rays.size();
+    pOutHitRecs->resize(numRays);
+    pOutIsHit->assign(numRays, false);
+
+    // the closest hit distance of each ray till now.
+    std::vector<Types::F32> closestT(numRays, m_t1);
+
+    // compute the inverse directions once for all the surfaces.
+    std::vector<PrecomputedRay> precomputedRays;
+    precomputedRays.reserve(numRays);
+    for (size_t i = 0; i < numRays; ++i)
+    {
+        precomputedRays.emplace_back(rays[i].m_ray);
+    }
+
+    const auto& surfaces = m_scene.GetSurfaces();
+    const auto& boundingBoxes = m_scene.GetBoundingBoxes();
+
+    // loop surfaces in the outer loop, so one surface is tested with all the rays while it's in the cache.
+    for (size_t s = 0; s < surfaces.size(); ++s)
+    {
+        const AABB& boundingBox = boundingBoxes[s];
+
+        for (size_t i = 0; i < numRays; ++i)
+        {
+            // see Scene::Hit for why the bounding box test start from 0.0f.
+            if (boundingBox.Hit(precomputedRays[i], 0.0f, closestT[i])
+                && surfaces[s]->Hit(rays[i].m_ray, m_t0, closestT[i], &(*pOutHitRecs)[i]))
+            {
+                (*pOutIsHit)[i] = true;
+                if ((*pOutHitRecs)[i].m_hitT < closestT[i])
+                {
+                    closestT[i] = (*pOutHitRecs)[i].m_hitT;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < numRays; ++i)
+    {
+        if ((*pOutIsHit)[i])
+        {
+            HitRecord& hitRec = (*pOutHitRecs)[i];
+            hitRec.m_hitPoint = rays[i].m_ray.m_origin + (hitRec.m_hitT + Surface::s_offsetHitT) * rays[i].m_ray.m_direction;
+        }
+    }
+}
+
+void WavefrontRenderer::SortStage(
+    const std::vector<PathRay>&     rays,
+    const std::vector<HitRecord>&   hitRecs,
+    const std::vector<bool>&        isHit,
+    std::vector<vector3>*           pColors,
+    std::vector<Types::U32>*        pOutHitOrder) const
+{
+    pOutHitOrder->clear();
+
+    for (Types::U32 i = 0; i < rays.size(); ++i)
+    {
+        if (isHit[i])
+        {
+            pOutHitOrder->push_back(i);
+        }
+        else
+        {
+            // the missed ray bring back the background color.
+            (*pColors)[rays[i].m_pixelIndex] = (*pColors)[rays[i].m_pixelIndex] + rays[i].m_weight * m_scene.m_background;
+        }
+    }
+
+    if (m_sortByMaterial)
+    {
+        // group the hit rays with the same material together.
+        std::stable_sort(pOutHitOrder->begin(), pOutHitOrder->end(), [&hitRecs](const Types::U32 a, const Types::U32 b)
+        {
+            return hitRecs[a].m_material.get() < hitRecs[b].m_material.get();
+        });
+    }
+}
+
+void WavefrontRenderer::ShadeStage(
+    const std::vector<PathRay>&     rays,
+    const std::vector<HitRecord>&   hitRecs,
+    const std::vector<Types::U32>&  hitOrder,
+    std::vector<vector3>*           pColors,
+    std::vector<ShadowRay>*         pOutShadowRays,
+    std::vector<PathRay>*           pOutNextRays) const
+{
+    for (const Types::U32 index : hitOrder)
+    {
+        const PathRay&   pathRay  = rays[index];
+        const Ray&       ray      = pathRay.m_ray;
+        const HitRecord& hitRec   = hitRecs[index];
+        Material&        material = *hitRec.m_material;
+
+        PathRay nextRay;
+        nextRay.m_pixelIndex = pathRay.m_pixelIndex;
+        nextRay.m_depth      = pathRay.m_depth - 1;
+
+        // the same branches as Scene::RayColor and Scene::RefractColor.
+        if (material.IsDielectric() && pathRay.m_depth > 1)
+        {
+            vector3 k;
+            Types::F32 c;
+
+            vector3 reflectVec = Reflect(ray.m_direction, hitRec.m_normal);
+            vector3 refractorVec;
+
+            if (dotProd(ray.m_direction, hitRec.m_normal) < 0)
+            {
+                Refract(ray.m_direction, hitRec.m_normal, material.m_reflectIndex, &refractorVec);
+                c = -dotProd(ray.m_direction, hitRec.m_normal);
+                k = vector3::UNIT;
+            }
+            else
+            {
+                vector3 attenuation = material.m_attenuation * (-hitRec.m_hitT);
+                for (int i = 0; i < 3; ++i)
+                {
+                    k.m_arr[i] = MathTool::Exp<MathTool::FAST_MATH>(attenuation.m_arr[i]);
+                }
+
+                if (Refract(ray.m_direction, -hitRec.m_normal, 1.0f / material.m_reflectIndex, &refractorVec))
+                {
+                    c = dotProd(refractorVec, hitRec.m_normal);
+                }
+                else
+                {
+                    // total internal reflection.
+                    nextRay.m_ray    = Ray(hitRec.m_hitPoint, reflectVec);
+                    nextRay.m_weight = pathRay.m_weight * (material.m_shinness / 32.0f);
+                    pOutNextRays->push_back(nextRay);
+                    continue;
+                }
+            }
+
+            Types::F32 R0 = material.m_rFresnel_0.m_x;
+            Types::F32 R = R0 + (1 - R0) * (1 - c) * (1 - c) * (1 - c) * (1 - c) * (1 - c);
+
+            nextRay.m_ray    = Ray(hitRec.m_hitPoint, reflectVec);
+            nextRay.m_weight = pathRay.m_weight * k * (R * material.m_shinness / 32.0f);
+            pOutNextRays->push_back(nextRay);
+
+            nextRay.m_ray    = Ray(hitRec.m_hitPoint + ray.m_direction * 0.0004f, refractorVec);
+            nextRay.m_weight = pathRay.m_weight * k * (1 - R);
+            pOutNextRays->push_back(nextRay);
+            continue;
+        }
+
+        vector3& pixelColor = (*pColors)[pathRay.m_pixelIndex];
+
+        // ambient light
+        pixelColor = pixelColor + pathRay.m_weight * material.m_kDiffuse * m_scene.m_ambient;
+
+        // reflection
+        if (pathRay.m_depth > 0 && material.m_shinness != 0.0f)
+        {
+            nextRay.m_ray    = Ray(hitRec.m_hitPoint, Reflect(ray.m_direction, hitRec.m_normal));
+            nextRay.m_weight = pathRay.m_weight * (material.m_shinness / 32.0f);
+            pOutNextRays->push_back(nextRay);
+        }
+
+        // one shadow ray for each light, the shading is same as Scene::LightColor.
+        const vector3 toEye = -ray.m_direction;
+        for (auto & light : m_scene.GetLights())
+        {
+            ShadowRay shadowRay;
+            vector3 toLight = light->ToMeFrom(hitRec.m_hitPoint, &shadowRay.m_maxDist);
+            vector3 halfVec = FastNormalize(toEye + toLight);
+
+            vector3 lightStrength = light->m_color * std::max(0.0f, dotProd(hitRec.m_normal, toLight));
+
+            const Types::F32 m = material.m_shinness;
+
+            Types::F32 shinnessSthrength = (m + 8.0f) * 0.125f * MathTool::Pow<MathTool::FAST_MATH>(dotProd(halfVec, hitRec.m_normal), m);
+
+            vector3 fresnelCoefficient = material.RFresnel(dotProd(toEye, hitRec.m_normal));
+
+            shadowRay.m_ray          = Ray(hitRec.m_hitPoint, toLight);
+            shadowRay.m_contribution = pathRay.m_weight * lightStrength * (material.m_kDiffuse + fresnelCoefficient * shinnessSthrength);
+            shadowRay.m_pixelIndex   = pathRay.m_pixelIndex;
+            pOutShadowRays->push_back(shadowRay);
+        }
+    }
+}
+
+void WavefrontRenderer::ShadowStage(const std::vector<ShadowRay>& shadowRays, std::vector<vector3>* pColors) const
+{
+    const size_t numRays = shadowRays.size();
+    std::vector<bool> isBlocked(numRays, false);
+
+    std::vector<PrecomputedRay> precomputedRays;
+    precomputedRays.reserve(numRays);
+    for (size_t i = 0; i < numRays; ++i)
+    {
+        precomputedRays.emplace_back(shadowRays[i].m_ray);
+    }
+
+    const auto& surfaces = m_scene.GetSurfaces();
+    const auto& boundingBoxes = m_scene.GetBoundingBoxes();
+
+    HitRecord shadowHitRec;
+    for (size_t s = 0; s < surfaces.size(); ++s)
+    {
+        const AABB& boundingBox = boundingBoxes[s];
+
+        for (size_t i = 0; i < numRays; ++i)
+        {
+            // any hit is enough to block the light.
+            if (isBlocked[i])
+            {
+                continue;
+            }
+
+            const ShadowRay& shadowRay = shadowRays[i];
+            if (boundingBox.Hit(precomputedRays[i], 0.0f, shadowRay.m_maxDist)
+                && surfaces[s]->Hit(shadowRay.m_ray, 0.0f, shadowRay.m_maxDist, &shadowHitRec))
+            {
+                isBlocked[i] = true;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < numRays; ++i)
+    {
+        if ( ! isBlocked[i])
+        {
+            vector3& pixelColor = (*pColors)[shadowRays[i].m_pixelIndex];
+            pixelColor = pixelColor + shadowRays[i].m_contribution;
+        }
+    }
+}
+
+} // namespace CommonClass
@@ -0,0 +1,158 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include "Scene.h"
+#include "Camera.h"
+
+namespace CommonClass
+{
+
+/*!
+    \brief WavefrontRenderer render the scene tile by tile, instead of "one pixel, full recursion, next pixel" like Scene::RayColor.
+    For each tile, all the camera rays are generated into a queue, and the queue is processed by several batched stages:
+        1. intersect all the rays in the queue with all the surfaces (surface by surface, so the surface data stay in the cache).
+        2. resolve the missed rays with the background, sort the hit rays by material.
+        3. shade the hit rays, generate one shadow ray for each light into the shadow queue,
+           and generate the reflection/refraction rays into the next queue.
+        4. test all the shadow rays, add the light that is not blocked to the pixels.
+        5. swap the queues, go to 1 until the queue is empty.
+    Tiles are rendered on multiple threads.
+    The result is same as calling Scene::RayColor(ray, m_t0, m_t1, m_maxDepth) for each pixel.
+*/
+class WavefrontRenderer
+{
+public:
+    /*!
+        \brief one ray in the queue, it carries the weight of the light it will bring back to the pixel.
+    */
+    struct PathRay
+    {
+        Ray         m_ray;
+
+        /*!
+            \brief how much the color of this ray contributes to the pixel.
+        */
+        vector3     m_weight;
+
+        /*!
+            \brief the pixel index inside the tile.
+        */
+        Types::U32  m_pixelIndex;
+
+        /*!
+            \brief same as the reflectLayerIndex in the Scene::RayColor.
+        */
+        Types::U32  m_depth;
+    };
+
+    /*!
+        \brief a ray from the hit point to one light, if it's not blocked, add m_contribution to the pixel.
+    */
+    struct ShadowRay
+    {
+        Ray         m_ray;
+        Types::F32  m_maxDist;
+        vector3     m_contribution;
+        Types::U32  m_pixelIndex;
+    };
+
+public:
+    /*!
+        \brief the size of the square tile in pixel.
+    */
+    Types::U32 m_tileSize = 32;
+
+    /*!
+        \brief max recursion depth, same as the default reflectLayerIndex of Scene::RayColor.
+    */
+    Types::U32 m_maxDepth = 3;
+
+    /*!
+        \brief the distance interval of all the rays (not including the shadow rays).
+    */
+    Types::F32 m_t0 = 0.0f;
+    Types::F32 m_t1 = 1000.0f;
+
+    /*!
+        \brief whether to sort the hit rays by material before shading.
+    */
+    bool m_sortByMaterial = true;
+
+    /*!
+        \brief how many threads to render tiles, zero for all the hardware threads.
+    */
+    Types::U32 m_numThreads = 0;
+
+private:
+    const Scene& m_scene;
+
+public:
+    WavefrontRenderer(const Scene& scene);
+    WavefrontRenderer(const WavefrontRenderer&) = delete;
+    WavefrontRenderer& operator=(const WavefrontRenderer&) = delete;
+    ~WavefrontRenderer();
+
+    /*!
+        \brief render the whole film of the camera.
+        \param camera the camera to generate rays, the film of the camera MUST be setted.
+    */
+    void Render(Camera& camera) const;
+
+    /*!
+        \brief render one tile of the film.
+        \param camera the camera to generate rays
+        \param left/bottom the pixel index of the left bottom corner of the tile
+        \param width/height the size of the tile in pixels
+    */
+    void RenderTile(Camera& camera, const Types::U32 left, const Types::U32 bottom, const Types::U32 width, const Types::U32 height) const;
+
+    /*!
+        \brief find the closest hit for all the rays in the queue.
+        \param rays the ray queue
+        \param pOutHitRecs return the hit records, resized to the size of the queue.
+        \param pOutIsHit return whether each ray hit anything, resized to the size of the queue.
+    */
+    void IntersectStage(const std::vector<PathRay>& rays, std::vector<HitRecord>* pOutHitRecs, std::vector<bool>* pOutIsHit) const;
+
+    /*!
+        \brief test all the shadow rays, and add the contribution of the unblocked rays to the colors.
+        \param shadowRays the shadow ray queue
+        \param pColors the color of the pixels in the tile.
+    */
+    void ShadowStage(const std::vector<ShadowRay>& shadowRays, std::vector<vector3>* pColors) const;
+
+private:
+    /*!
+        \brief resolve the missed rays and sort the hit rays.
+        \param rays the ray queue
+        \param hitRecs the hit records from the IntersectStage
+        \param isHit whether each ray hit from the IntersectStage
+        \param pColors the color of the pixels in the tile
+        \param pOutHitOrder return the indices of the hit rays in the order to be shaded.
+    */
+    void SortStage(
+        const std::vector<PathRay>&     rays,
+        const std::vector<HitRecord>&   hitRecs,
+        const std::vector<bool>&        isHit,
+        std::vector<vector3>*           pColors,
+        std::vector<Types::U32>*        pOutHitOrder) const;
+
+    /*!
+        \brief shade the hit rays, generate shadow rays and secondary rays.
+        \param rays the ray queue
+        \param hitRecs the hit records from the IntersectStage
+        \param hitOrder the hit ray indices from the SortStage
+        \param pColors the color of the pixels in the tile
+        \param pOutShadowRays append the shadow rays
+        \param pOutNextRays append the reflection/refraction rays
+    */
+    void ShadeStage(
+        const std::vector<PathRay>&     rays,
+        const std::vector<HitRecord>&   hitRecs,
+        const std::vector<Types::U32>&  hitOrder,
+        std::vector<vector3>*           pColors,
+        std::vector<ShadowRay>*         pOutShadowRays,
+        std::vector<PathRay>*           pOutNextRays) const;
+};
+
+} // namespace CommonClass
@@ -1,5 +1,8 @@
 #pragma once
 #include "CommonTypes.h"
+#include "Utils/FastMath.h"
+#include <cmath>
+#include <exception>
 
 namespace CommonClass
 {
@@ -77,50 +80,55 @@ public:
 /*! ensurance */
 static_assert(sizeof(vector3) == 3 * sizeof(Types::F32), "size of vector3 is wrong");
 
-vector3    operator + (const vector3 & a, const vector3 & b);
-vector3    operator - (const vector3 & a, const vector3 & b);
-bool       operator ==(const vector3 & a, const vector3 & b);
-bool       operator !=(const vector3 & a, const vector3 & b);
-vector3       operator * (const vector3 & a, const vector3 & b);
-vector3       operator / (const vector3 & a, const vector3 & b);
-vector3       operator * (const vector3 & a, const Types::F32 bFloat);
-vector3       operator * (const Types::F32 bFloat, const vector3 & a);
-vector3       operator / (const vector3 & a, const Types::F32 bFloat);
-vector3       operator - (const vector3 & a);
+inline vector3    operator + (const vector3 & a, const vector3 & b);
+inline vector3    operator - (const vector3 & a, const vector3 & b);
+inline bool       operator ==(const vector3 & a, const vector3 & b);
+inline bool       operator !=(const vector3 & a, const vector3 & b);
+inline vector3       operator * (const vector3 & a, const vector3 & b);
+inline vector3       operator / (const vector3 & a, const vector3 & b);
+inline vector3       operator * (const vector3 & a, const Types::F32 bFloat);
+inline vector3       operator * (const Types::F32 bFloat, const vector3 & a);
+inline vector3       operator / (const vector3 & a, const Types::F32 bFloat);
+inline vector3       operator - (const vector3 & a);
 
 /*!
     \brief compute the dot product of two vector
 */
-Types::F32 dotProd    (const vector3 & a, const vector3 & b);    // same as operator *
+inline Types::F32 dotProd    (const vector3 & a, const vector3 & b);    // same as operator *
 
 /*!
     \brief compute the cross product of two 3D vector
 */
-vector3    crossProd  (const vector3 & a, const vector3 & b);
+inline vector3    crossProd  (const vector3 & a, const vector3 & b);
 
 /*!
     \brief normalize the vector3
 */
-vector3       Normalize(const vector3 & a);
+inline vector3       Normalize(const vector3 & a);
 
 /*!
     \brief normalize the vector3 and return the length of it (before normalize)
     \param a the vector to be normalized
     \param pOutLength point to the return length.
 */
-vector3    Normalize(const vector3 & a, Types::F32 * const pOutLength);
+inline vector3    Normalize(const vector3 & a, Types::F32 * const pOutLength);
+
+/*!
+    \brief normalize the vector3 by MathTool::FastRsqrt, the relative error of the length is less than 5e-6.
+*/
+inline vector3    FastNormalize(const vector3 & a);
 
 /*!
     \brief get length of the vector.
 */
-Types::F32 Length(const vector3 & a);
+inline Types::F32 Length(const vector3 & a);
 
 /*!
     \brief reflect a vector by a unit vector
     \param incomeVec the vector to be reflected
     \param unitNormal the normal of the reflect plane.
 */
-vector3 Reflect(const vector3& incomeVec, const vector3& unitNormal);
+inline vector3 Reflect(const vector3& incomeVec, const vector3& unitNormal);
 
 /*!
     \brief refract light, assume always from air into another medium
@@ -155,4 +163,142 @@ bool AlmostPerpendicular(const vector3 & a, const vector3 & b, const Types::F32
 */
 bool AlmostIsUnitVector(const vector3 & a, int ulp = 8);
 
+/*
+    the implementations of the constructors and the hot operators are in the header,
+    so they can be inlined into the loops of the rasterizer and the ray tracer without LTO.
+*/
+
+inline vector3::vector3()
+    :m_x(0.0f), m_y(0.0f), m_z(0.0f)
+{
+    // empty
+}
+
+inline vector3::vector3(const Types::F32 & x, const Types::F32 & y, const Types::F32 & z)
+    : m_x(x), m_y(y), m_z(z)
+{
+    // empty
+}
+
+inline vector3::vector3(const Types::F32* pArr)
+    :m_x(pArr[0]), m_y(pArr[1]), m_z(pArr[2])
+{
+    // empty
+}
+
+inline vector3::~vector3()
+{
+    // empty
+}
+
+inline vector3 operator+(const vector3 & a, const vector3 & b)
+{
+    return vector3(a.m_x + b.m_x, a.m_y + b.m_y, a.m_z + b.m_z);
+}
+
+inline vector3 operator-(const vector3 & a, const vector3 & b)
+{
+    return vector3(a.m_x - b.m_x, a.m_y - b.m_y, a.m_z - b.m_z);
+}
+
+inline bool operator==(const vector3 & a, const vector3 & b)
+{
+    return a.m_x == b.m_x
+        && a.m_y == b.m_y
+        && a.m_z == b.m_z;
+}
+
+inline bool operator!=(const vector3 & a, const vector3 & b)
+{
+    return a.m_x != b.m_x
+        || a.m_y != b.m_y
+        || a.m_z != b.m_z;
+}
+
+inline vector3 operator*(const vector3 & a, const vector3 & b)
+{
+    return vector3(a.m_x * b.m_x, a.m_y * b.m_y, a.m_z * b.m_z);
+}
+
+inline vector3 operator*(const vector3 & a, const Types::F32 bFloat)
+{
+    return vector3(a.m_x * bFloat, a.m_y * bFloat, a.m_z * bFloat);
+}
+
+inline vector3 operator*(const Types::F32 bFloat, const vector3 & a)
+{
+    return vector3(a.m_x * bFloat, a.m_y * bFloat, a.m_z * bFloat);
+}
+
+inline vector3 operator-(const vector3 & a)
+{
+    return vector3(-a.m_x, -a.m_y, -a.m_z);
+}
+
+inline vector3 operator/(const vector3 & a, const vector3 & b)
+{
+    return vector3(a.m_x / b.m_x, a.m_y / b.m_y, a.m_z / b.m_z);
+}
+
+inline vector3 operator/(const vector3 & a, const Types::F32 bFloat)
+{
+    return vector3(a.m_x / bFloat, a.m_y / bFloat, a.m_z / bFloat);
+}
+
+inline Types::F32 dotProd(const vector3 & a, const vector3 & b)
+{
+    return (a.m_x * b.m_x + a.m_y * b.m_y + a.m_z * b.m_z);
+}
+
+inline vector3 crossProd(const vector3 & a, const vector3 & b)
+{
+    return vector3(
+        a.m_y * b.m_z - b.m_y * a.m_z,
+        b.m_x * a.m_z - a.m_x * b.m_z,
+        a.m_x * b.m_y - b.m_x * a.m_y);
+}
+
+inline vector3 Normalize(const vector3 & a)
+{
+    const Types::F32 squreLen = a.m_x * a.m_x + a.m_y * a.m_y + a.m_z * a.m_z;
+    if (squreLen == 0.0f)
+    {
+        throw std::exception("cannot normalize a zero vector.");
+    }
+    const Types::F32 reciprocalLen = 1 / (std::sqrtf(squreLen));
+    return a * reciprocalLen;
+}
+
+inline vector3 Normalize(const vector3 & a, Types::F32 * const pOutLength)
+{
+    const Types::F32 squreLen = a.m_x * a.m_x + a.m_y * a.m_y + a.m_z * a.m_z;
+    if (squreLen == 0.0f)
+    {
+        throw std::exception("cannot normalize a zero vector.");
+    }
+    *pOutLength = std::sqrtf(squreLen);
+    const Types::F32 reciprocalLen = 1 / (*pOutLength);
+    return a * reciprocalLen;
+}
+
+inline vector3 FastNormalize(const vector3 & a)
+{
+    const Types::F32 squreLen = a.m_x * a.m_x + a.m_y * a.m_y + a.m_z * a.m_z;
+    if (squreLen == 0.0f)
+    {
+        throw std::exception("cannot normalize a zero vector.");
+    }
+    return a * MathTool::Rsqrt<MathTool::FAST_MATH>(squreLen);
+}
+
+inline Types::F32 Length(const vector3 & a)
+{
+    return std::sqrtf(a.m_x * a.m_x + a.m_y * a.m_y + a.m_z * a.m_z);
+}
+
+inline vector3 Reflect(const vector3 & incomeVec, const vector3 & unitNormal)
+{
+    return incomeVec - (2.0f * (dotProd(incomeVec, unitNormal)) * unitNormal);
+}
+
 }// namespace CommonClass
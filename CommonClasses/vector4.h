@@ -1,12 +1,15 @@
 #pragma once
 #include "CommonTypes.h"
+#include "vector3.h"
 #include <array>
+#include <cmath>
+#ifdef USING_SSE_MATH
+#include <xmmintrin.h>
+#endif
 
 namespace CommonClass
 {
 
-class vector3;
-
 /*!
     \brief homogeneous vector with four components
     we assume the vector4 is column vector
@@ -72,19 +75,19 @@ static_assert(sizeof(vector4) == 4 * sizeof(Types::F32), "sizeof vector4 should
 /*!
     \brief ignore the w component, which will stay same as the first vector4's w component
 */
-vector4  operator +  (const vector4&    v1,     const vector4&      v2      );
-vector4  operator -  (const vector4&    v1,     const vector4&      v2      );
-vector4  operator *  (const vector4&    v1,     const vector4&      v2      );
-vector4  operator /  (const vector4&    v1,     const vector4&      v2      );
-vector4  operator *  (const Types::F32  s,      const vector4&      v       );
-vector4  operator *  (const vector4&    v,      const Types::F32    s       );
-vector4  operator /  (const vector4&    v,      const Types::F32    s       );
-vector4& operator += (vector4&          v1,     const vector4&      v2      );
-vector4& operator -= (vector4&          v1,     const vector4&      v2      );
-vector4& operator *= (vector4&          v1,     const vector4&      v2      );
-vector4& operator /= (vector4&          v1,     const vector4&      v2      );
-vector4& operator *= (vector4&          v,      Types::F32          s       );
-vector4& operator /= (vector4&          v,      Types::F32          s       );
+inline vector4  operator +  (const vector4&    v1,     const vector4&      v2      );
+inline vector4  operator -  (const vector4&    v1,     const vector4&      v2      );
+inline vector4  operator *  (const vector4&    v1,     const vector4&      v2      );
+inline vector4  operator /  (const vector4&    v1,     const vector4&      v2      );
+inline vector4  operator *  (const Types::F32  s,      const vector4&      v       );
+inline vector4  operator *  (const vector4&    v,      const Types::F32    s       );
+inline vector4  operator /  (const vector4&    v,      const Types::F32    s       );
+inline vector4& operator += (vector4&          v1,     const vector4&      v2      );
+inline vector4& operator -= (vector4&          v1,     const vector4&      v2      );
+inline vector4& operator *= (vector4&          v1,     const vector4&      v2      );
+inline vector4& operator /= (vector4&          v1,     const vector4&      v2      );
+inline vector4& operator *= (vector4&          v,      Types::F32          s       );
+inline vector4& operator /= (vector4&          v,      Types::F32          s       );
 bool     operator != (const vector4&    v1,     const vector4&      v2      );
 bool     operator == (const vector4&    v1,     const vector4&      v2      );
 
@@ -95,4 +98,171 @@ bool     operator == (const vector4&    v1,     const vector4&      v2      );
 */
 bool AlmostEqual(const vector4& v1, const vector4& v2, Types::F32 tolerance = 1e-7f);
 
+/*
+    the implementations of the constructors and the arithmetic operators are in the header,
+    so they can be inlined into the loops of the rasterizer and the ray tracer without LTO.
+    with USING_SSE_MATH, the four components are computed by one SSE instruction,
+    and the w component is restored from the first operand in the register.
+*/
+
+inline vector4::vector4(const Types::F32 x, const Types::F32 y, const Types::F32 z, const Types::F32 w)
+    :m_x(x), m_y(y), m_z(z), m_w(w)
+{
+    // empty
+}
+
+inline vector4::~vector4()
+{
+    // empty
+}
+
+inline vector3 vector4::ToVector3() const
+{
+    return vector3(m_x, m_y, m_z);
+}
+
+inline vector4 vector3::Tovector4(const Types::F32& w /*= 1.0f*/) const
+{
+    return vector4(m_x, m_y, m_z, w);
+}
+
+#ifdef USING_SSE_MATH
+
+/*!
+    \brief load/store vector4 from/into SSE register, the vector4 may not be 16 bytes aligned.
+*/
+inline __m128 LoadSSE(const vector4& v)
+{
+    return _mm_loadu_ps(v.m_arr.data());
+}
+
+inline vector4 StoreSSE(const __m128 r)
+{
+    vector4 v;
+    _mm_storeu_ps(v.m_arr.data(), r);
+    return v;
+}
+
+/*!
+    \brief replace the w component of r with the w component of keepW, in register (SSE4.1 blend is not assumed).
+*/
+inline __m128 KeepW(const __m128 r, const __m128 keepW)
+{
+    // (r.z, r.z, keepW.w, keepW.w)
+    const __m128 zw = _mm_shuffle_ps(r, keepW, _MM_SHUFFLE(3, 3, 2, 2));
+    // (r.x, r.y, r.z, keepW.w)
+    return _mm_shuffle_ps(r, zw, _MM_SHUFFLE(2, 0, 1, 0));
+}
+
+inline vector4 operator+(const vector4 & v1, const vector4 & v2)
+{
+    const __m128 r1 = LoadSSE(v1);
+    return StoreSSE(KeepW(_mm_add_ps(r1, LoadSSE(v2)), r1));
+}
+
+inline vector4 operator-(const vector4 & v1, const vector4 & v2)
+{
+    const __m128 r1 = LoadSSE(v1);
+    return StoreSSE(KeepW(_mm_sub_ps(r1, LoadSSE(v2)), r1));
+}
+
+inline vector4 operator*(const vector4 & v1, const vector4 & v2)
+{
+    const __m128 r1 = LoadSSE(v1);
+    return StoreSSE(KeepW(_mm_mul_ps(r1, LoadSSE(v2)), r1));
+}
+
+inline vector4 operator/(const vector4 & v1, const vector4 & v2)
+{
+    const __m128 r1 = LoadSSE(v1);
+    return StoreSSE(KeepW(_mm_div_ps(r1, LoadSSE(v2)), r1));
+}
+
+inline vector4 operator*(const Types::F32 s, const vector4 & v)
+{
+    const __m128 r = LoadSSE(v);
+    return StoreSSE(KeepW(_mm_mul_ps(_mm_set1_ps(s), r), r));
+}
+
+inline vector4 operator*(const vector4 & v, const Types::F32 s)
+{
+    const __m128 r = LoadSSE(v);
+    return StoreSSE(KeepW(_mm_mul_ps(r, _mm_set1_ps(s)), r));
+}
+
+inline vector4 operator/(const vector4 & v, const Types::F32 s)
+{
+    const __m128 r = LoadSSE(v);
+    return StoreSSE(KeepW(_mm_div_ps(r, _mm_set1_ps(s)), r));
+}
+
+#else
+
+inline vector4 operator+(const vector4 & v1, const vector4 & v2)
+{
+    return vector4(v1.m_x + v2.m_x, v1.m_y + v2.m_y, v1.m_z + v2.m_z, v1.m_w);
+}
+
+inline vector4 operator-(const vector4 & v1, const vector4 & v2)
+{
+    return vector4(v1.m_x - v2.m_x, v1.m_y - v2.m_y, v1.m_z - v2.m_z, v1.m_w);
+}
+
+inline vector4 operator*(const vector4 & v1, const vector4 & v2)
+{
+    return vector4(v1.m_x * v2.m_x, v1.m_y * v2.m_y, v1.m_z * v2.m_z, v1.m_w);
+}
+
+inline vector4 operator/(const vector4 & v1, const vector4 & v2)
+{
+    return vector4(v1.m_x / v2.m_x, v1.m_y / v2.m_y, v1.m_z / v2.m_z, v1.m_w);
+}
+
+inline vector4 operator*(const Types::F32 s, const vector4 & v)
+{
+    return vector4(s * v.m_x, s * v.m_y, s * v.m_z, v.m_w);
+}
+
+inline vector4 operator*(const vector4 & v, const Types::F32 s)
+{
+    return vector4(v.m_x * s, v.m_y * s, v.m_z * s, v.m_w);
+}
+
+inline vector4 operator/(const vector4 & v, const Types::F32 s)
+{
+    return vector4(v.m_x / s, v.m_y / s, v.m_z / s, v.m_w);
+}
+
+#endif // USING_SSE_MATH
+
+inline vector4 & operator+=(vector4 & v1, const vector4 & v2)
+{
+    return v1 = v1 + v2;
+}
+
+inline vector4 & operator-=(vector4 & v1, const vector4 & v2)
+{
+    return v1 = v1 - v2;
+}
+
+inline vector4 & operator*=(vector4 & v1, const vector4 & v2)
+{
+    return v1 = v1 * v2;
+}
+
+inline vector4 & operator/=(vector4 & v1, const vector4 & v2)
+{
+    return v1 = v1 / v2;
+}
+
+inline vector4 & operator*=(vector4 & v, Types::F32 s)
+{
+    return v = v * s;
+}
+
+inline vector4 & operator/=(vector4 & v, Types::F32 s)
+{
+    return v = v / s;
+}
+
 } // namespace CommonClass
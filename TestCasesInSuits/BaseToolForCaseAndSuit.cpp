@@ -177,6 +177,148 @@ std::array<std::unique_ptr<CommonClass::Polygon>, 6> CaseForPipline::CreatBox(co
     return boxPolys;
 }
 
+void CaseForPipline::BuildSimpleRayTraceScene(CommonClass::Scene * pScene)
+{
+    assert(pScene != nullptr);
+
+    auto sphereMat      = std::make_shared<Material>(vector3(0.5f, 0.2f, 1.0f), 8, 16.0f);
+    auto glassMat       = std::make_shared<Material>(vector3::WHITE * 0.8f,     8, 2.0f);
+    auto triMat         = std::make_shared<Material>(vector3::YELLOW,           8, 1.0f);
+    auto wallMat        = std::make_shared<Material>(vector3::WHITE * 0.6f,     8, 3.0f);
+    auto leftWallMat    = std::make_shared<Material>(vector3::RED,              8, 1.0f);
+    auto rightWallMat   = std::make_shared<Material>(vector3::GREEN,            8, 1.0f);
+
+    glassMat->SetDielectric(true, vector3(0.0f, 0.5f, 0.3f));
+    glassMat->SetRFresnel0(4);
+
+    pScene->Add(std::make_unique<Light>(vector3(0.0f, 5.0f, 0.0f), vector3::WHITE * 0.5f));
+    pScene->Add(std::make_unique<Light>(vector3(2.0f, 2.7f, 1.0f), vector3::WHITE * 0.25f));
+
+    auto sphere = std::make_unique<Sphere>(vector3(-1.0617f, 0.8190f, 1.2368f), 0.8f);
+    sphere->m_material = sphereMat;
+    pScene->Add(std::move(sphere));
+
+    auto glassSphere = std::make_unique<Sphere>(vector3(1.2f, 1.0f, 0.3f), 0.9f);
+    glassSphere->m_material = glassMat;
+    pScene->Add(std::move(glassSphere));
+
+    auto tri = std::make_unique<Triangle>(vector3(-1.5f, 0.1f, -2.0f), vector3(0.0f, 3.5f, -2.0f), vector3(1.5f, 0.1f, -2.0f));
+    tri->m_material = triMat;
+    pScene->Add(std::move(tri));
+
+    const Types::F32 left = -2.5f, right = +2.5f, top = 5.470f, back = -2.813f, front = 2.813f, bottom = 0.100f;
+
+    std::array<vector3, 8> boxPoints = {
+        vector3(left,  top,    front),
+        vector3(left,  top,    back),
+        vector3(right, top,    back),
+        vector3(right, top,    front),
+        vector3(left,  bottom, front),
+        vector3(left,  bottom, back),
+        vector3(right, bottom, back),
+        vector3(right, bottom, front)
+    };
+
+    // the faces are visible from the inside of the box, so the points order is reversed from CreatBox.
+    auto leftPoly   = CreatQuadPoly(boxPoints[TOP_LEFT_FRONT],      boxPoints[TOP_LEFT_BACK],       boxPoints[BOTTOM_LEFT_BACK],    boxPoints[BOTTOM_LEFT_FRONT]);
+    auto rightPoly  = CreatQuadPoly(boxPoints[TOP_RIGHT_BACK],      boxPoints[TOP_RIGHT_FRONT],     boxPoints[BOTTOM_RIGHT_FRONT],  boxPoints[BOTTOM_RIGHT_BACK]);
+    auto bottomPoly = CreatQuadPoly(boxPoints[BOTTOM_LEFT_FRONT],   boxPoints[BOTTOM_LEFT_BACK],    boxPoints[BOTTOM_RIGHT_BACK],   boxPoints[BOTTOM_RIGHT_FRONT]);
+    auto backPoly   = CreatQuadPoly(boxPoints[TOP_LEFT_BACK],       boxPoints[TOP_RIGHT_BACK],      boxPoints[BOTTOM_RIGHT_BACK],   boxPoints[BOTTOM_LEFT_BACK]);
+
+    leftPoly    ->m_material = leftWallMat;
+    rightPoly   ->m_material = rightWallMat;
+    bottomPoly  ->m_material = wallMat;
+    backPoly    ->m_material = wallMat;
+
+    pScene->Add(std::move(leftPoly));
+    pScene->Add(std::move(rightPoly));
+    pScene->Add(std::move(bottomPoly));
+    pScene->Add(std::move(backPoly));
+}
+
+CaseForPipline::MeshInstances CaseForPipline::BuildRandomInstances(
+    const CommonRenderingBuffer::SpecializedMeshData&   mesh,
+    const unsigned int                                  numInstances,
+    const GraphicToolSet::MaterialBuffer&               material,
+    const std::function<vector3(unsigned int)>&         getPosition,
+    const std::function<Types::F32(unsigned int)>&      getScale)
+{
+    MeshInstances meshInstances;
+    meshInstances.m_pMesh = &mesh;
+    meshInstances.m_instances.resize(numInstances);
+    for (unsigned int i = 0; i < numInstances; ++i)
+    {
+        const vector3 position = getPosition(i);
+        const vector3 rotation(mtr.Random() * 3.0f, mtr.Random() * 3.0f, mtr.Random() * 3.0f);
+        const vector3 scale = vector3::UNIT * getScale(i);
+        auto& instance = meshInstances.m_instances[i];
+        instance.m_toWorld          = Transform::TRS(position, rotation, scale);
+        instance.m_toWorldInverse   = Transform::InverseTRS(position, rotation, scale);
+        instance.m_material         = material;
+    }
+    return meshInstances;
+}
+
+std::unique_ptr<Pipline> CaseForPipline::DrawMeshInstances(
+    CommonRenderingBuffer&                      renderingBuffer,
+    const std::vector<MeshInstances>&           scene,
+    const std::function<void(Pipline&)>&        setupPipline,
+    TestSuit::TimeCounter&                      counter)
+{
+    auto pipline = graphicToolSet.GetCommonPipline();
+    auto pso = pipline->GetPSO();
+    pso->m_vertexLayout.vertexShaderInputSize   = sizeof(SimplePoint);
+    pso->m_vertexLayout.pixelShaderInputSize    = sizeof(GraphicToolSet::PSIn);
+    pso->m_vertexShader     = graphicToolSet.GetVertexShaderWithVSOut(instanceBufAgent, renderingBuffer.cameraBuffer);
+    pso->m_pixelShader      = graphicToolSet.GetPixelShaderWithPSIn(instanceBufAgent, renderingBuffer.cameraBuffer);
+    pso->m_primitiveType    = PrimitiveType::TRIANGLE_LIST;
+    pso->m_cullFace         = CullFace::CLOCK_WISE;
+    if (setupPipline)
+    {
+        setupPipline(*pipline);
+    }
+    pipline->ClearBackBuffer(vector4::WHITE * 0.5f);
+
+    const Transform toClip = renderingBuffer.cameraBuffer.m_project * renderingBuffer.cameraBuffer.m_toCamera;
+    TestSuit::TimeGuard guard(counter);
+    for (const auto& meshInstances : scene)
+    {
+        const auto& mesh = *meshInstances.m_pMesh;
+        for (const auto& instance : meshInstances.m_instances)
+        {
+            instanceBufAgent = instance;
+            if (meshInstances.m_isBounded)
+            {
+                pipline->DrawInstance(mesh.indices, mesh.vertexBuffer.get(), mesh.bound, toClip * instance.m_toWorld);
+            }
+            else
+            {
+                pipline->DrawInstance(mesh.indices, mesh.vertexBuffer.get());
+            }
+        }
+    }
+    return pipline;
+}
+
+unsigned int CaseForPipline::CountDifferentPixels(const Image& image1, const Image& image2) const
+{
+    assert(image1.GetWidth() == image2.GetWidth() && image1.GetHeight() == image2.GetHeight());
+    unsigned int numDifferentPixels = 0;
+    for (Types::U32 y = 0; y < image1.GetHeight(); ++y)
+    {
+        for (Types::U32 x = 0; x < image1.GetWidth(); ++x)
+        {
+            numDifferentPixels += AlmostEqual(image1.GetPixel(x, y), image2.GetPixel(x, y), 1e-6f) ? 0 : 1;
+        }
+    }
+    return numDifferentPixels;
+}
+
+void CaseForPipline::PrintDuration(const std::string& label, const TestSuit::TimeCounter& counter) const
+{
+    printf("%-32s %8.3f ms\n", label.c_str(), std::chrono::duration<double, std::milli>(counter.m_sumDuration).count());
+}
+
 std::wstring CaseForPipline::GetStoragePath() const
 {
     return OUTPUT_PATH;
@@ -39,6 +39,22 @@ protected:
 
     GraphicToolSet graphicToolSet;
 
+    /*!
+        \brief the instance constant buffer read by the shaders of the piplines from DrawMeshInstances().
+    */
+    GraphicToolSet::ConstantBufferForInstance instanceBufAgent;
+
+public:
+    /*!
+        \brief the instances of a mesh, a part of the scene drawn by DrawMeshInstances().
+    */
+    struct MeshInstances
+    {
+        const CommonRenderingBuffer::SpecializedMeshData*       m_pMesh = nullptr;
+        std::vector<GraphicToolSet::ConstantBufferForInstance>  m_instances;
+        bool                                                    m_isBounded = false;    // draw with the bounding box of the mesh, so the draws can be culled.
+    };
+
 public:
     CaseForPipline(const std::string& caseName) : Case(caseName) {}
 
@@ -172,6 +188,51 @@ public:
     */
     std::array<std::unique_ptr<CommonClass::Polygon>, 6> CreatBox(const std::array<vector3, 8>& points);
 
+    /*!
+        \brief build a small scene for ray tracing, which have an open box, two spheres (one is transparent), a triangle, and two point lights.
+        \param pScene the scene to add objects into.
+        this scene is used to compare different ray tracing renderers, it's much smaller than the scene in the CaseAndSuitForRayRender.
+    */
+    void BuildSimpleRayTraceScene(CommonClass::Scene * pScene);
+
+    /*!
+        \brief build the instances of a mesh with random rotations and uniform scales.
+        \param mesh the mesh to draw, which must live as long as the instances.
+        \param numInstances how many instances to build.
+        \param material the material of all the instances.
+        \param getPosition return the position of the i-th instance, which is called before the rotation is generated.
+        \param getScale return the scale of the i-th instance, which is called after the rotation is generated.
+    */
+    MeshInstances BuildRandomInstances(
+        const CommonRenderingBuffer::SpecializedMeshData&   mesh,
+        const unsigned int                                  numInstances,
+        const GraphicToolSet::MaterialBuffer&               material,
+        const std::function<vector3(unsigned int)>&         getPosition,
+        const std::function<Types::F32(unsigned int)>&      getScale);
+
+    /*!
+        \brief draw the instances by a common pipline with the camera of the rendering buffer, the cases can compare the back buffers of different settings.
+        \param renderingBuffer the camera, which must live as long as the pipline.
+        \param scene the instances to draw in order.
+        \param setupPipline change the settings of the pipline before drawing, such as the culling, can be empty.
+        \param counter only the draw calls are timed.
+    */
+    std::unique_ptr<Pipline> DrawMeshInstances(
+        CommonRenderingBuffer&                      renderingBuffer,
+        const std::vector<MeshInstances>&           scene,
+        const std::function<void(Pipline&)>&        setupPipline,
+        TestSuit::TimeCounter&                      counter);
+
+    /*!
+        \brief count the pixels which are different in the two images of the same size.
+    */
+    unsigned int CountDifferentPixels(const Image& image1, const Image& image2) const;
+
+    /*!
+        \brief print the time of the counter in milliseconds after the label.
+    */
+    void PrintDuration(const std::string& label, const TestSuit::TimeCounter& counter) const;
+
     /*!
         \brief get the path for output files.
     */
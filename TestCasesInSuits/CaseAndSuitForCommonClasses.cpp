@@ -934,3 +934,681 @@ void CASE_NAME_IN_COMMON_CLASSES(RayColorFunction)::Run()
 
     BlockShowImg(camera.m_film.get(), L"power of Scene::RayColor()");
 }
+
+void CASE_NAME_IN_COMMON_CLASSES(AABBSlabTest)::Run()
+{
+    const unsigned int NUM_BOXES = 1024;
+    const unsigned int NUM_RAYS = 1024;
+
+    auto randomPoint = [this](const Types::F32 range)
+    {
+        return vector3((mtr.Random() * 2.0f - 1.0f) * range, (mtr.Random() * 2.0f - 1.0f) * range, (mtr.Random() * 2.0f - 1.0f) * range);
+    };
+
+    std::vector<AABB> boxes;
+    for (unsigned int i = 0; i < NUM_BOXES; ++i)
+    {
+        const vector3 center = randomPoint(10.0f);
+        const vector3 halfSize(mtr.Random() + 0.1f, mtr.Random() + 0.1f, mtr.Random() + 0.1f);
+        boxes.push_back(AABB(center - halfSize, center + halfSize));
+    }
+
+    std::vector<Ray> rays;
+    for (unsigned int i = 0; i < NUM_RAYS; ++i)
+    {
+        vector3 direction = randomPoint(1.0f);
+        // some rays are parallel to the axis planes.
+        if (i % 8 == 0)
+        {
+            direction.m_arr[i % 3] = 0.0f;
+        }
+        rays.push_back(Ray(randomPoint(12.0f), direction));
+    }
+
+    std::vector<PrecomputedRay> precomputedRays;
+    for (const auto & ray : rays)
+    {
+        precomputedRays.push_back(PrecomputedRay(ray));
+    }
+
+    // the two tests should agree.
+    HitRecord recForBBox;
+    unsigned int numMismatch = 0;
+    for (unsigned int r = 0; r < NUM_RAYS; ++r)
+    {
+        for (const auto & box : boxes)
+        {
+            if (box.Hit(rays[r], 0.0f, 100.0f, &recForBBox) != box.Hit(precomputedRays[r], 0.0f, 100.0f))
+            {
+                ++numMismatch;
+            }
+        }
+    }
+    TEST_ASSERT(numMismatch == 0);
+
+    TestSuit::TimeCounter oldTime, slabTime;
+    unsigned int oldHitCount = 0, slabHitCount = 0;
+    {
+        TestSuit::TimeGuard guard(oldTime);
+        for (unsigned int r = 0; r < NUM_RAYS; ++r)
+        {
+            for (const auto & box : boxes)
+            {
+                oldHitCount += box.Hit(rays[r], 0.0f, 100.0f, &recForBBox) ? 1 : 0;
+            }
+        }
+    }
+    {
+        TestSuit::TimeGuard guard(slabTime);
+        for (unsigned int r = 0; r < NUM_RAYS; ++r)
+        {
+            for (const auto & box : boxes)
+            {
+                slabHitCount += box.Hit(precomputedRays[r], 0.0f, 100.0f) ? 1 : 0;
+            }
+        }
+    }
+    TEST_ASSERT(oldHitCount == slabHitCount);
+
+    const double numTests = static_cast<double>(NUM_BOXES) * NUM_RAYS;
+    const double oldSeconds  = std::chrono::duration<double>(oldTime.m_sumDuration).count();
+    const double slabSeconds = std::chrono::duration<double>(slabTime.m_sumDuration).count();
+    printf("box tests per second, old: %.2f M, slab: %.2f M\n",
+        numTests / oldSeconds * 1e-6, numTests / slabSeconds * 1e-6);
+}
+
+void CASE_NAME_IN_COMMON_CLASSES(MathBenchmark)::Run()
+{
+    const unsigned int NUM_ELEMENTS = 4096;
+    const unsigned int NUM_LOOPS = 256;
+
+    auto randomF32 = [this]() { return mtr.Random() * 2.0f - 1.0f; };
+
+    std::vector<vector3> vec3s;
+    std::vector<vector4> vec4s;
+    for (unsigned int i = 0; i < NUM_ELEMENTS; ++i)
+    {
+        vec3s.push_back(vector3(randomF32(), randomF32(), randomF32() + 2.0f));
+        vec4s.push_back(vector4(randomF32(), randomF32(), randomF32(), 1.0f));
+    }
+    Transform mat = Transform::TRS(vector3(1.0f, 2.0f, 3.0f), vector3(0.3f, 0.2f, 0.1f), vector3(1.0f, 2.0f, 0.5f));
+
+    // check the results with the plain scalar math.
+    for (unsigned int i = 0; i < NUM_ELEMENTS; ++i)
+    {
+        const vector4& v = vec4s[i];
+        vector4 expect;
+        for (unsigned int row = 0; row < 4; ++row)
+        {
+            expect.m_arr[row] = mat.m_column[0].m_arr[row] * v.m_x + mat.m_column[1].m_arr[row] * v.m_y + mat.m_column[2].m_arr[row] * v.m_z + mat.m_column[3].m_arr[row] * v.m_w;
+        }
+        TEST_ASSERT(AlmostEqual(mat * v, expect, 1e-5f));
+
+        const vector4 sum = v + vec4s[(i + 1) % NUM_ELEMENTS];
+        TEST_ASSERT(sum.m_x == v.m_x + vec4s[(i + 1) % NUM_ELEMENTS].m_x && sum.m_w == v.m_w);
+    }
+    Transform product = mat * mat;
+    for (unsigned int c = 0; c < 4; ++c)
+    {
+        TEST_ASSERT(AlmostEqual(product.m_column[c], mat * mat.m_column[c], 1e-5f));
+    }
+
+    // 'sink' keep the results alive, so the loops will not be removed by the compiler.
+    Types::F32 sink = 0.0f;
+    auto benchmark = [&](const char * name, auto && func)
+    {
+        TestSuit::TimeCounter counter;
+        {
+            TestSuit::TimeGuard guard(counter);
+            for (unsigned int loop = 0; loop < NUM_LOOPS; ++loop)
+            {
+                for (unsigned int i = 0; i < NUM_ELEMENTS; ++i)
+                {
+                    sink += func(i);
+                }
+            }
+        }
+        const double seconds = std::chrono::duration<double>(counter.m_sumDuration).count();
+        printf("%-24s %8.2f M ops/s\n", name, static_cast<double>(NUM_LOOPS) * NUM_ELEMENTS / seconds * 1e-6);
+    };
+
+    benchmark("vector3 dotProd",    [&](unsigned int i) { return dotProd(vec3s[i], vec3s[(i + 1) % NUM_ELEMENTS]); });
+    benchmark("vector3 crossProd",  [&](unsigned int i) { return crossProd(vec3s[i], vec3s[(i + 1) % NUM_ELEMENTS]).m_x; });
+    benchmark("vector3 Normalize",  [&](unsigned int i) { return Normalize(vec3s[i]).m_y; });
+    benchmark("vector4 mul add",    [&](unsigned int i) { return (vec4s[i] * 0.5f + vec4s[(i + 1) % NUM_ELEMENTS]).m_z; });
+    benchmark("Transform * vector4", [&](unsigned int i) { return (mat * vec4s[i]).m_w; });
+    benchmark("Transform * Transform", [&](unsigned int i) { return (mat * mat).m_column[i & 3].m_x; });
+
+    printf("sink %f\n", sink);
+}
+
+void CASE_NAME_IN_COMMON_CLASSES(RandomSequences)::Run()
+{
+    using RandomTool::CounterRandom;
+    using RandomTool::SobolSequence;
+    using RandomTool::HaltonSequence;
+
+    // known answers of Philox4x32-10 from the Random123 library.
+    {
+        const CounterRandom::Block zero = CounterRandom::Philox({ 0, 0, 0, 0 }, 0, 0);
+        const CounterRandom::Block expectZero = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+        TEST_ASSERT(zero == expectZero);
+        const CounterRandom::Block pi = CounterRandom::Philox({ 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, 0xa4093822, 0x299f31d0);
+        const CounterRandom::Block expectPi = { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 };
+        TEST_ASSERT(pi == expectPi);
+    }
+
+    // the batch fill is same as the single numbers, for any start and count.
+    const CounterRandom random(7);
+    {
+        std::vector<float> batch(64);
+        for (unsigned int first = 0; first < 8; ++first)
+        {
+            for (unsigned int count = 0; count <= 40; count += 5)
+            {
+                random.FillUniform(3, 5, first, batch.data(), count);
+                for (unsigned int i = 0; i < count; ++i)
+                {
+                    TEST_ASSERT(batch[i] == random.Uniform(3, 5, first + i));
+                    TEST_ASSERT(batch[i] >= 0.0f && batch[i] < 1.0f);
+                }
+            }
+        }
+    }
+
+    // the numbers only depend on (pixel, sample, dimension), not on how many threads take them.
+    {
+        const unsigned int NUM_PIXELS = 256 * 256;
+        std::vector<float> singleThread(NUM_PIXELS), multiThread(NUM_PIXELS);
+        ParallelTool::ParallelFor(0, NUM_PIXELS, [&](unsigned int pixel) { singleThread[pixel] = random.Uniform(pixel, 1, 2); }, 64, 1);
+        ParallelTool::ParallelFor(0, NUM_PIXELS, [&](unsigned int pixel) { multiThread[pixel] = random.Uniform(pixel, 1, 2); }, 64, 8);
+        TEST_ASSERT(singleThread == multiThread);
+    }
+
+    // the first two Sobol dimensions are a (0, 2)-sequence, even with a digital shift:
+    // every elementary interval of area 1/256 has exactly one of 256 points.
+    const SobolSequence sobol(SobolSequence::MAX_DIMENSIONS);
+    {
+        const unsigned int M = 8, NUM_POINTS = 1 << M;
+        const unsigned int scrambleX = random.Bits(0, 0, 0), scrambleY = random.Bits(0, 0, 1);
+        auto highBits = [](unsigned int bits, unsigned int n) { return n == 0 ? 0 : bits >> (32 - n); };
+        for (unsigned int xBits = 0; xBits <= M; ++xBits)
+        {
+            // the intervals are 1/2^xBits wide and 1/2^(M-xBits) high.
+            std::vector<unsigned int> counts(NUM_POINTS, 0);
+            for (unsigned int i = 0; i < NUM_POINTS; ++i)
+            {
+                const unsigned int cellX = highBits(sobol.SampleBits(i, 0, scrambleX), xBits);
+                const unsigned int cellY = highBits(sobol.SampleBits(i, 1, scrambleY), M - xBits);
+                ++counts[(cellX << (M - xBits)) + cellY];
+            }
+            TEST_ASSERT(std::all_of(counts.begin(), counts.end(), [](unsigned int c) { return c == 1; }));
+        }
+        // every dimension is stratified by itself.
+        for (unsigned int d = 0; d < sobol.GetDimensions(); ++d)
+        {
+            std::vector<unsigned int> counts(NUM_POINTS, 0);
+            for (unsigned int i = 0; i < NUM_POINTS; ++i)
+            {
+                ++counts[static_cast<unsigned int>(sobol.Sample(i, d) * NUM_POINTS)];
+            }
+            TEST_ASSERT(std::all_of(counts.begin(), counts.end(), [](unsigned int c) { return c == 1; }));
+        }
+    }
+
+    // the first base^2 points of a Halton dimension are exactly i / base^2 in some order.
+    for (unsigned int d = 0; d < 8; ++d)
+    {
+        const unsigned int base = HaltonSequence::PrimeOf(d);
+        const unsigned int numPoints = base * base;
+        std::vector<unsigned int> counts(numPoints, 0);
+        for (unsigned int i = 0; i < numPoints; ++i)
+        {
+            const float x = HaltonSequence::Sample(i, d);
+            TEST_ASSERT(x >= 0.0f && x < 1.0f);
+            ++counts[std::min(numPoints - 1, static_cast<unsigned int>(std::lround(x * numPoints)))];
+        }
+        TEST_ASSERT(std::all_of(counts.begin(), counts.end(), [](unsigned int c) { return c == 1; }));
+    }
+
+    // estimate the area of a quarter disk (PI / 4) in many 'pixels' with the same samples per pixel,
+    // the scrambled Sobol points converge faster than the independent random numbers.
+    {
+        const unsigned int NUM_ESTIMATES = 1024, SPP = 64;
+        auto inside = [](float x, float y) { return x * x + y * y < 1.0f ? 1.0f : 0.0f; };
+        double errorMT = 0.0, errorCounter = 0.0, errorSobol = 0.0, errorHalton = 0.0;
+        for (unsigned int pixel = 0; pixel < NUM_ESTIMATES; ++pixel)
+        {
+            const unsigned int scrambleX = random.Bits(pixel, 0, 0), scrambleY = random.Bits(pixel, 0, 1);
+            const float shiftX = random.Uniform(pixel, 0, 2), shiftY = random.Uniform(pixel, 0, 3);
+            float sumMT = 0.0f, sumCounter = 0.0f, sumSobol = 0.0f, sumHalton = 0.0f;
+            for (unsigned int s = 0; s < SPP; ++s)
+            {
+                sumMT       += inside(mtr.Random(), mtr.Random());
+                sumCounter  += inside(random.Uniform(pixel, s, 0), random.Uniform(pixel, s, 1));
+                sumSobol    += inside(sobol.Sample(s, 0, scrambleX), sobol.Sample(s, 1, scrambleY));
+                sumHalton   += inside(HaltonSequence::Sample(s, 0, shiftX), HaltonSequence::Sample(s, 1, shiftY));
+            }
+            errorMT         += std::abs(sumMT       / SPP - MathTool::PI / 4);
+            errorCounter    += std::abs(sumCounter  / SPP - MathTool::PI / 4);
+            errorSobol      += std::abs(sumSobol    / SPP - MathTool::PI / 4);
+            errorHalton     += std::abs(sumHalton   / SPP - MathTool::PI / 4);
+        }
+        printf("mean error at %u spp: MTRandom %f, CounterRandom %f, Sobol %f, Halton %f\n",
+            SPP, errorMT / NUM_ESTIMATES, errorCounter / NUM_ESTIMATES, errorSobol / NUM_ESTIMATES, errorHalton / NUM_ESTIMATES);
+        TEST_ASSERT(errorSobol < errorCounter * 0.5 && errorHalton < errorCounter * 0.5);
+        TEST_ASSERT(errorCounter < errorMT * 1.5 && errorMT < errorCounter * 1.5);
+    }
+
+    // throughput
+    {
+        const unsigned int NUM_NUMBERS = 1 << 22;
+        std::vector<float> buffer(NUM_NUMBERS);
+        auto benchmark = [&](const char * name, auto && func)
+        {
+            TestSuit::TimeCounter counter;
+            {
+                TestSuit::TimeGuard guard(counter);
+                func();
+            }
+            const double seconds = std::chrono::duration<double>(counter.m_sumDuration).count();
+            printf("%-28s %8.2f M numbers/s\n", name, NUM_NUMBERS / seconds * 1e-6);
+        };
+
+        benchmark("MTRandom::Random",           [&]() { for (auto& f : buffer) { f = mtr.Random(); } });
+        benchmark("CounterRandom::Uniform",     [&]() { for (unsigned int i = 0; i < NUM_NUMBERS; ++i) { buffer[i] = random.Uniform(i >> 4, 0, i & 15); } });
+        benchmark("CounterRandom::FillUniform", [&]() { random.FillUniform(0, 0, 0, buffer.data(), NUM_NUMBERS); });
+        benchmark("SobolSequence::Sample",      [&]() { for (unsigned int i = 0; i < NUM_NUMBERS; ++i) { buffer[i] = sobol.Sample(i, 1); } });
+        printf("sink %f\n", buffer[NUM_NUMBERS / 2]);
+    }
+}
+
+void CASE_NAME_IN_COMMON_CLASSES(FastMath)::Run()
+{
+    using namespace MathTool;
+
+    // the max relative error to the double precision std function over a uniform grid of the input range.
+    auto maxRelativeError = [](float begin, float end, auto && fastFunc, auto && preciseFunc)
+    {
+        const unsigned int NUM_STEPS = 1 << 20;
+        double maxError = 0.0;
+        for (unsigned int i = 0; i <= NUM_STEPS; ++i)
+        {
+            const float x = begin + (end - begin) * i / NUM_STEPS;
+            const double precise = preciseFunc(static_cast<double>(x));
+            maxError = std::max(maxError, std::abs(fastFunc(x) - precise) / std::max(1e-30, std::abs(precise)));
+        }
+        return maxError;
+    };
+
+    const double exp2Error  = maxRelativeError(-126.0f, 127.0f, [](float x) { return FastExp2(x); },  [](double x) { return std::exp2(x); });
+    const double expError   = maxRelativeError(-20.0f, 20.0f,   [](float x) { return FastExp(x); },   [](double x) { return std::exp(x); });
+    const double log2Error  = maxRelativeError(0.5f, 64.0f,     [](float x) { return FastLog2(x) - std::log2(0.25f); }, [](double x) { return std::log2(x) + 2.0; });
+    const double rsqrtError = maxRelativeError(1e-6f, 1e6f,     [](float x) { return FastRsqrt(x); }, [](double x) { return 1.0 / std::sqrt(x); });
+    // the specular term, cosine in (0, 1] and shininess up to 256.
+    double powError = 0.0;
+    for (unsigned int m = 1; m <= 256; m *= 2)
+    {
+        powError = std::max(powError, maxRelativeError(0.01f, 1.0f,
+            [m](float x) { return FastPow(x, static_cast<float>(m)); },
+            [m](double x) { return std::pow(x, static_cast<double>(m)); }) / std::max(1.0, m * std::abs(std::log2(0.01))));
+    }
+    printf("max relative error: exp2 %g, exp %g, log2 %g, rsqrt %g, pow %g (scaled by |y log2(x)|)\n", exp2Error, expError, log2Error, rsqrtError, powError);
+
+    // the bounds documented in FastMath.h
+    TEST_ASSERT(exp2Error < 3e-7);
+    TEST_ASSERT(expError < 4e-7 * 20);
+    TEST_ASSERT(log2Error < 2e-7 * 6);
+    TEST_ASSERT(rsqrtError < 5e-6);
+    TEST_ASSERT(powError < 4e-7);
+    TEST_ASSERT(FastPow(0.0f, 8.0f) == 0.0f && FastPow(-0.5f, 8.0f) == 0.0f && FastPow(1.0f, 64.0f) == 1.0f);
+    TEST_ASSERT(FastPow(0.0f, 0.0f) == 1.0f && FastPow(-0.5f, 0.0f) == 1.0f && FastPow(0.3f, 0.0f) == 1.0f);
+    TEST_ASSERT(FastExp2(1000.0f) < std::numeric_limits<float>::infinity() && FastExp2(-1000.0f) > 0.0f);
+
+#ifdef USING_SSE_MATH
+    // the four lanes versions are same as the scalar versions.
+    for (unsigned int i = 0; i < 1024; ++i)
+    {
+        const float x = mtr.Random() * 0.999f + 0.001f, y = mtr.Random() * 256.0f;
+        float lanes[4];
+        _mm_storeu_ps(lanes, FastPow(_mm_set1_ps(x), _mm_set1_ps(y)));
+        TEST_ASSERT(lanes[0] == FastPow(x, y));
+        _mm_storeu_ps(lanes, FastPow(_mm_set_ps(-x, 0.0f, x, x), _mm_set_ps(0.0f, 0.0f, 0.0f, y)));
+        TEST_ASSERT(lanes[1] == 1.0f && lanes[2] == 1.0f && lanes[3] == 1.0f);
+        _mm_storeu_ps(lanes, FastExp(_mm_set1_ps(-y * 0.1f)));
+        TEST_ASSERT(lanes[0] == FastExp(-y * 0.1f));
+        _mm_storeu_ps(lanes, FastLog2(_mm_set1_ps(y + 1.0f)));
+        TEST_ASSERT(lanes[0] == FastLog2(y + 1.0f));
+    }
+#endif
+
+    // throughput
+    const unsigned int NUM_ELEMENTS = 4096;
+    const unsigned int NUM_LOOPS = 1024;
+    alignas(16) std::array<float, NUM_ELEMENTS> cosines, shininess, results;
+    for (unsigned int i = 0; i < NUM_ELEMENTS; ++i)
+    {
+        cosines[i] = mtr.Random();
+        shininess[i] = 1.0f + mtr.Random() * 255.0f;
+    }
+
+    float sink = 0.0f;
+    auto benchmark = [&](const char * name, auto && func)
+    {
+        TestSuit::TimeCounter counter;
+        {
+            TestSuit::TimeGuard guard(counter);
+            for (unsigned int loop = 0; loop < NUM_LOOPS; ++loop)
+            {
+                func();
+                sink += results[loop % NUM_ELEMENTS];
+            }
+        }
+        const double seconds = std::chrono::duration<double>(counter.m_sumDuration).count();
+        printf("%-24s %8.2f M ops/s\n", name, static_cast<double>(NUM_LOOPS) * NUM_ELEMENTS / seconds * 1e-6);
+    };
+
+    benchmark("std::pow",   [&]() { for (unsigned int i = 0; i < NUM_ELEMENTS; ++i) { results[i] = Pow<PRECISE_MATH>(cosines[i], shininess[i]); } });
+    benchmark("FastPow",    [&]() { for (unsigned int i = 0; i < NUM_ELEMENTS; ++i) { results[i] = Pow<FAST_MATH>(cosines[i], shininess[i]); } });
+    benchmark("std::exp",   [&]() { for (unsigned int i = 0; i < NUM_ELEMENTS; ++i) { results[i] = Exp<PRECISE_MATH>(-shininess[i] * 0.1f); } });
+    benchmark("FastExp",    [&]() { for (unsigned int i = 0; i < NUM_ELEMENTS; ++i) { results[i] = Exp<FAST_MATH>(-shininess[i] * 0.1f); } });
+    benchmark("1 / std::sqrt", [&]() { for (unsigned int i = 0; i < NUM_ELEMENTS; ++i) { results[i] = Rsqrt<PRECISE_MATH>(shininess[i]); } });
+    benchmark("FastRsqrt",  [&]() { for (unsigned int i = 0; i < NUM_ELEMENTS; ++i) { results[i] = Rsqrt<FAST_MATH>(shininess[i]); } });
+#ifdef USING_SSE_MATH
+    benchmark("FastPow x4", [&]()
+    {
+        for (unsigned int i = 0; i < NUM_ELEMENTS; i += 4)
+        {
+            _mm_store_ps(&results[i], FastPow(_mm_load_ps(&cosines[i]), _mm_load_ps(&shininess[i])));
+        }
+    });
+    benchmark("FastRsqrt x4", [&]()
+    {
+        for (unsigned int i = 0; i < NUM_ELEMENTS; i += 4)
+        {
+            _mm_store_ps(&results[i], FastRsqrt(_mm_load_ps(&shininess[i])));
+        }
+    });
+#endif
+
+    printf("sink %f\n", sink);
+}
+
+void CASE_NAME_IN_COMMON_CLASSES(AsyncImageWriter)::Run()
+{
+    using namespace Types;
+    const U32 WIDTH = 640, HEIGHT = 360, NUM_FRAMES = 6;
+    const std::wstring widePath = GetSafeStoragePath();
+    const std::string path(widePath.begin(), widePath.end());
+
+    // a moving ball on the gradient, each frame cost some time to render.
+    auto renderFrame = [&](Image& frame, const U32 frameIndex)
+    {
+        const F32 centerX = WIDTH * (0.2f + 0.1f * frameIndex), centerY = HEIGHT * 0.5f;
+        for (U32 y = 0; y < HEIGHT; ++y)
+        {
+            for (U32 x = 0; x < WIDTH; ++x)
+            {
+                const F32 dx = x - centerX, dy = y - centerY;
+                const F32 shade = std::exp(-(dx * dx + dy * dy) / (HEIGHT * 20.0f));
+                frame.SetPixel(x, y, vector4(shade, x * 1.0f / WIDTH, y * 1.0f / HEIGHT, 1.0f));
+            }
+        }
+    };
+
+    // the frame is saved in place, the render of the next frame wait for it.
+    TestSuit::TimeCounter syncTime, asyncTime;
+    Image frame(WIDTH, HEIGHT);
+    {
+        TestSuit::TimeGuard guard(syncTime);
+        for (U32 i = 0; i < NUM_FRAMES; ++i)
+        {
+            renderFrame(frame, i);
+            frame.SaveTo(widePath + L"async_writer_sync_" + std::to_wstring(i) + L".png");
+        }
+    }
+
+    // the next frame is rendered while the previous frame is written.
+    AsyncImageWriter::Statistic statistic;
+    {
+        TestSuit::TimeGuard guard(asyncTime);
+        AsyncImageWriter writer;
+        for (U32 i = 0; i < NUM_FRAMES; ++i)
+        {
+            renderFrame(frame, i);
+            writer.Submit(frame, widePath + L"async_writer_" + std::to_wstring(i) + L".png");
+        }
+        TEST_ASSERT(writer.Flush());
+        statistic = writer.GetStatistic();
+    }
+    TEST_ASSERT(statistic.m_numWritten == NUM_FRAMES && statistic.m_numFailed == 0);
+    printf("%u frames of %ux%u, save in place: %lld %s, async writer: %lld %s (write %.1f ms, blocked %.1f ms)\n",
+        NUM_FRAMES, WIDTH, HEIGHT,
+        syncTime.m_sumDuration.count(), syncTime.DURATION_TYPE_NAME.c_str(),
+        asyncTime.m_sumDuration.count(), asyncTime.DURATION_TYPE_NAME.c_str(),
+        statistic.m_writeMs, statistic.m_blockedMs);
+
+    // the snapshot is not affected by the later changes of the image, and the queue is bounded.
+    {
+        AsyncImageWriter writer(1);
+        Image canvas(64, 32);
+        for (U32 i = 0; i < 4; ++i)
+        {
+            canvas.ClearPixel(vector4(i * 0.25f, 0.5f, 1.0f, 1.0f));
+            writer.Submit(canvas, path + "async_writer_snapshot_" + std::to_string(i) + ".png");
+            TEST_ASSERT(writer.GetNumPending() <= 2);
+        }
+        canvas.ClearPixel(vector4(1.0f, 1.0f, 1.0f, 1.0f));
+        TEST_ASSERT(writer.Flush());
+        TEST_ASSERT(writer.GetNumPending() == 0);
+
+        for (U32 i = 0; i < 4; ++i)
+        {
+            Texture written;
+            written.LoadFile(path + "async_writer_snapshot_" + std::to_string(i) + ".png");
+            TEST_ASSERT(written.GetWidth() == 64 && written.GetHeight() == 32);
+            TEST_ASSERT(AlmostEqual(written.GetPixel(10, 10), vector4(i * 0.25f, 0.5f, 1.0f, 1.0f), 1.0f / 255.0f));
+        }
+
+        // the moved image is written without copy.
+        Image moved(16, 16);
+        moved.ClearPixel(vector4(0.0f, 1.0f, 0.0f, 1.0f));
+        writer.Submit(std::move(moved), path + "async_writer_moved.png");
+
+        // the failure is reported by the next Flush only.
+        writer.Submit(canvas, path + "no_such_directory/async_writer_failed.png");
+        TEST_ASSERT( ! writer.Flush());
+        TEST_ASSERT(writer.Flush());
+        TEST_ASSERT(writer.GetStatistic().m_numFailed == 1 && writer.GetStatistic().m_numWritten == 5);
+    }
+}
+
+void CASE_NAME_IN_COMMON_CLASSES(PixelConverter)::Run()
+{
+    using namespace Types;
+    // a 4K frame, the width is not a multiple of four to cover the pixels left by the SSE loop.
+    const U32 WIDTH = 3841, HEIGHT = 2160, NUM_PIXELS = WIDTH * HEIGHT;
+    std::vector<vector4> floats(NUM_PIXELS);
+    for (U32 i = 0; i < NUM_PIXELS; ++i)
+    {
+        // some values are out of [0, 1] and must be clamped.
+        const F32 t = i * 1.0f / NUM_PIXELS;
+        floats[i] = vector4(t, std::sin(i * 0.001f) * 1.2f, 1.0f - t * 1.5f, (i % 257) / 256.0f);
+    }
+    floats[7] = vector4(std::numeric_limits<F32>::quiet_NaN(), -1.0f, 2.0f, 0.5f);
+
+    // linear, the nearest byte.
+    std::vector<Pixel> bytes(NUM_PIXELS);
+    PixelConverter::FloatToByte(floats.data(), bytes.data(), WIDTH, HEIGHT);
+    U32 numLinearErrors = 0;
+    for (U32 i = 0; i < NUM_PIXELS; ++i)
+    {
+        for (U32 ch = 0; ch < 4; ++ch)
+        {
+            const F32 v = floats[i].m_arr[ch];
+            const I32 expected = static_cast<I32>(std::floor((v > 0.0f ? std::min(v, 1.0f) : 0.0f) * 255.0f + 0.5f));
+            numLinearErrors += bytes[i].m_arr[ch] != expected ? 1 : 0;
+        }
+    }
+    TEST_ASSERT(numLinearErrors == 0);
+    TEST_ASSERT(bytes[7].m_r == 0 && bytes[7].m_g == 0 && bytes[7].m_b == 255 && bytes[7].m_a == 128);
+
+    // sRGB, the table lookup is at most one level away from the exact encoding.
+    PixelConverter::FloatToByte(floats.data(), bytes.data(), WIDTH, HEIGHT, SRGB_ENCODING);
+    I32 maxSRGBError = 0;
+    for (U32 i = 0; i < NUM_PIXELS; ++i)
+    {
+        for (U32 ch = 0; ch < 3; ++ch)
+        {
+            const I32 expected = static_cast<I32>(std::floor(PixelConverter::LinearToSRGB(floats[i].m_arr[ch]) * 255.0f + 0.5f));
+            maxSRGBError = std::max(maxSRGBError, std::abs(bytes[i].m_arr[ch] - expected));
+        }
+    }
+    TEST_ASSERT(maxSRGBError <= 1);
+
+    // all the bytes come back after the round trip.
+    std::vector<Pixel> allBytes(256 * 256);
+    for (U32 i = 0; i < allBytes.size(); ++i)
+    {
+        allBytes[i] = Pixel(i & 255, 255 - (i & 255), (i >> 8) & 255, i & 255);
+    }
+    for (const ColorEncoding encoding : { LINEAR_ENCODING, SRGB_ENCODING })
+    {
+        std::vector<vector4> decoded(allBytes.size());
+        std::vector<Pixel> encoded(allBytes.size());
+        PixelConverter::ByteToFloat(allBytes.data(), decoded.data(), 256, 256, encoding);
+        PixelConverter::FloatToByte(decoded.data(), encoded.data(), 256, 256, encoding);
+        TEST_ASSERT(std::memcmp(allBytes.data(), encoded.data(), allBytes.size() * sizeof(Pixel)) == 0);
+        TEST_ASSERT(AlmostEqual(decoded[255 * 256 + 255], vector4(1.0f, 0.0f, 1.0f, 1.0f), 1e-6f));
+    }
+
+    // the ordered dithering keep the average of a smooth area between two bytes.
+    {
+        const U32 SIZE = 64;
+        const F32 value = 100.3f / 255.0f;
+        std::vector<vector4> flat(SIZE * SIZE, vector4(value, value, value, 1.0f));
+        std::vector<Pixel> dithered(SIZE * SIZE), rounded(SIZE * SIZE);
+        PixelConverter::FloatToByte(flat.data(), dithered.data(), SIZE, SIZE, LINEAR_ENCODING, true);
+        PixelConverter::FloatToByte(flat.data(), rounded.data(), SIZE, SIZE);
+        F32 ditheredMean = 0.0f, roundedMean = 0.0f;
+        for (U32 i = 0; i < SIZE * SIZE; ++i)
+        {
+            TEST_ASSERT(dithered[i].m_r == 100 || dithered[i].m_r == 101);
+            ditheredMean += dithered[i].m_r;
+            roundedMean += rounded[i].m_r;
+        }
+        ditheredMean /= SIZE * SIZE;
+        roundedMean /= SIZE * SIZE;
+        TEST_ASSERT(std::abs(ditheredMean - 100.3f) < 0.05f);
+        TEST_ASSERT(roundedMean == 100.0f);
+    }
+
+    // the throughput, compare with converting the pixels one by one like the old Image::FloatPixelToBytePixel().
+    floats[7] = vector4(0.0f, 0.0f, 1.0f, 0.5f);
+    const U32 NUM_LOOPS = 5;
+    TestSuit::TimeCounter perPixelTime, linearTime, ditherTime, srgbTime, byteToFloatTime;
+    {
+        TestSuit::TimeGuard guard(perPixelTime);
+        for (U32 loop = 0; loop < NUM_LOOPS; ++loop)
+        {
+            for (U32 i = 0; i < NUM_PIXELS; ++i)
+            {
+                bytes[i] = floats[i];
+            }
+        }
+    }
+    auto timeConversion = [&](TestSuit::TimeCounter& counter, auto&& convert)
+    {
+        TestSuit::TimeGuard guard(counter);
+        for (U32 loop = 0; loop < NUM_LOOPS; ++loop)
+        {
+            convert();
+        }
+    };
+    timeConversion(linearTime,      [&]() { PixelConverter::FloatToByte(floats.data(), bytes.data(), WIDTH, HEIGHT); });
+    timeConversion(ditherTime,      [&]() { PixelConverter::FloatToByte(floats.data(), bytes.data(), WIDTH, HEIGHT, LINEAR_ENCODING, true); });
+    timeConversion(srgbTime,        [&]() { PixelConverter::FloatToByte(floats.data(), bytes.data(), WIDTH, HEIGHT, SRGB_ENCODING); });
+    timeConversion(byteToFloatTime, [&]() { PixelConverter::ByteToFloat(bytes.data(), floats.data(), WIDTH, HEIGHT); });
+    printf("%ux%u, %u loops, per pixel: %lld, linear: %lld, dithered: %lld, sRGB: %lld, byte to float: %lld (%s)\n",
+        WIDTH, HEIGHT, NUM_LOOPS,
+        perPixelTime.m_sumDuration.count(), linearTime.m_sumDuration.count(), ditherTime.m_sumDuration.count(),
+        srgbTime.m_sumDuration.count(), byteToFloatTime.m_sumDuration.count(), linearTime.DURATION_TYPE_NAME.c_str());
+}
+
+void CASE_NAME_IN_COMMON_CLASSES(ImageStorageFormat)::Run()
+{
+    using namespace Types;
+    const std::wstring widePath = GetSafeStoragePath();
+    const std::string path(widePath.begin(), widePath.end());
+
+    // the byte canvas follows the float pixels.
+    Image img(8, 4);
+    TEST_ASSERT(img.GetStorageFormat() == Image::FLOAT_STORAGE);
+    img.ClearPixel(vector4(0.2f, 0.4f, 0.6f, 1.0f));
+    const U8* bytes = img.GetRawData();
+    TEST_ASSERT(bytes[0] == 51 && bytes[1] == 102 && bytes[2] == 153 && bytes[3] == 255);
+    img.SetPixel(0, 3, vector4(1.0f, 0.0f, 0.0f, 0.5f));
+    bytes = img.GetRawData();
+    TEST_ASSERT(bytes[0] == 255 && bytes[1] == 0 && bytes[2] == 0 && bytes[3] == 128);
+    img.GetFloatRow(3)[1] = vector4(0.0f, 1.0f, 0.0f, 1.0f);
+    bytes = img.GetRawData();
+    TEST_ASSERT(bytes[4] == 0 && bytes[5] == 255);
+
+    // the explicit conversion is kept until the pixels are modified.
+    img.FloatPixelToBytePixel(SRGB_ENCODING);
+    TEST_ASSERT(img.GetRawData()[8] == 124);
+    img.SetAlpha(7, 0, 0.0f);
+    TEST_ASSERT(img.GetRawData()[8] == 51);
+
+    // the byte image converts the pixels by GetPixel and SetPixel.
+    Image byteImg(8, 4, RGBA::BLACK, Image::BYTE_STORAGE);
+    byteImg.ClearPixel(vector4(0.2f, 0.4f, 0.6f, 1.0f));
+    byteImg.SetPixel(2, 1, vector3(1.0f, 0.5f, 0.0f));
+    byteImg.SetAlpha(2, 1, 0.25f);
+    TEST_ASSERT(AlmostEqual(byteImg.GetPixel(0, 0), vector4(0.2f, 0.4f, 0.6f, 1.0f), 0.5f / 255.0f));
+    TEST_ASSERT(AlmostEqual(byteImg.GetPixel(2, 1), vector4(1.0f, 0.5f, 0.0f, 0.25f), 1.0f / 255.0f));
+    bool isThrown = false;
+    try
+    {
+        byteImg.GetFloatRow(0);
+    }
+    catch (const std::exception&)
+    {
+        isThrown = true;
+    }
+    TEST_ASSERT(isThrown);
+
+    // the pixels are kept when the format changes.
+    const vector4 bytePixel = byteImg.GetPixel(2, 1);
+    for (const Image::StorageFormat format : { Image::FLOAT_STORAGE, Image::FLOAT_AND_BYTE_STORAGE, Image::BYTE_STORAGE, Image::FLOAT_AND_BYTE_STORAGE })
+    {
+        byteImg.SetStorageFormat(format);
+        TEST_ASSERT(byteImg.GetStorageFormat() == format && byteImg.IsValid());
+        TEST_ASSERT(AlmostEqual(byteImg.GetPixel(2, 1), bytePixel, 0.0f));
+        TEST_ASSERT(byteImg.GetRawData()[(2 * 8 + 2) * 4 + 3] == 64);
+    }
+
+    // the texture only keeps the float pixels after loading.
+    img.SaveTo(path + "storage_format.png");
+    Texture texture;
+    texture.LoadFile(path + "storage_format.png");
+    TEST_ASSERT(texture.GetStorageFormat() == Image::FLOAT_STORAGE);
+    TEST_ASSERT(AlmostEqual(texture.GetPixel(1, 3), vector4(0.0f, 1.0f, 0.0f, 1.0f), 0.0f));
+
+    // the cost of the images which are never saved, such as the filter results.
+    const U32 WIDTH = 1920, HEIGHT = 1080, NUM_IMAGES = 10;
+    TestSuit::TimeCounter floatTime, bothTime;
+    for (const Image::StorageFormat format : { Image::FLOAT_STORAGE, Image::FLOAT_AND_BYTE_STORAGE })
+    {
+        TestSuit::TimeGuard guard(format == Image::FLOAT_STORAGE ? floatTime : bothTime);
+        for (U32 i = 0; i < NUM_IMAGES; ++i)
+        {
+            Image temp(WIDTH, HEIGHT, RGBA::BLACK, format);
+            temp.SetPixel(i, i, vector4(1.0f, 1.0f, 1.0f, 1.0f));
+        }
+    }
+    printf("%u images of %ux%u, float only: %lld %s, float and byte: %lld %s\n",
+        NUM_IMAGES, WIDTH, HEIGHT,
+        floatTime.m_sumDuration.count(), floatTime.DURATION_TYPE_NAME.c_str(),
+        bothTime.m_sumDuration.count(), bothTime.DURATION_TYPE_NAME.c_str());
+}
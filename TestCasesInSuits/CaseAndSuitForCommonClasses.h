@@ -60,6 +60,20 @@ DECLARE_CASE_IN_COMMON_CLASSES_FOR(PointLight, "render a scene with a point ligh
 
 DECLARE_CASE_IN_COMMON_CLASSES_FOR(RayColorFunction, "render a scene with Scene::RayColor()");
 
+DECLARE_CASE_IN_COMMON_CLASSES_FOR(AABBSlabTest, "branchless AABB slab test and box tests per second");
+
+DECLARE_CASE_IN_COMMON_CLASSES_FOR(MathBenchmark, "inline vector and matrix math throughput");
+
+DECLARE_CASE_IN_COMMON_CLASSES_FOR(RandomSequences, "counter based random numbers and low discrepancy sequences");
+
+DECLARE_CASE_IN_COMMON_CLASSES_FOR(FastMath, "accuracy and throughput of the fast math functions");
+
+DECLARE_CASE_IN_COMMON_CLASSES_FOR(AsyncImageWriter, "write the frames on a background thread with a bounded queue");
+
+DECLARE_CASE_IN_COMMON_CLASSES_FOR(PixelConverter, "accuracy and throughput of the float and byte canvas conversion");
+
+DECLARE_CASE_IN_COMMON_CLASSES_FOR(ImageStorageFormat, "float only, byte only images and the lazy byte canvas");
+
 using SuitForCommonClasses =
 SuitForPipline<
     CASE_NAME_IN_COMMON_CLASSES(BasicImage),
@@ -77,5 +91,12 @@ SuitForPipline<
     CASE_NAME_IN_COMMON_CLASSES(SceneAndRay),
     CASE_NAME_IN_COMMON_CLASSES(PolygoneAndRay),
     CASE_NAME_IN_COMMON_CLASSES(PointLight),
-    CASE_NAME_IN_COMMON_CLASSES(RayColorFunction)
+    CASE_NAME_IN_COMMON_CLASSES(RayColorFunction),
+    CASE_NAME_IN_COMMON_CLASSES(AABBSlabTest),
+    CASE_NAME_IN_COMMON_CLASSES(MathBenchmark),
+    CASE_NAME_IN_COMMON_CLASSES(RandomSequences),
+    CASE_NAME_IN_COMMON_CLASSES(FastMath),
+    CASE_NAME_IN_COMMON_CLASSES(AsyncImageWriter),
+    CASE_NAME_IN_COMMON_CLASSES(PixelConverter),
+    CASE_NAME_IN_COMMON_CLASSES(ImageStorageFormat)
 >;
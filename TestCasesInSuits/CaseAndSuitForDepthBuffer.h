@@ -18,7 +18,121 @@ public:
     }
 };
 
+class CaseForFastClear : public CaseForPipline
+{
+public:
+    CaseForFastClear() :CaseForPipline("fast clear of the depth buffer and the back buffer") {}
+
+    virtual void Run() override
+    {
+        using namespace Types;
+        const U32 TILE = FastClearTiles::TILE_SIZE;
+
+        // the depth buffer, the cleared tiles are read as the clear value, and filled by the first write.
+        DepthBuffer dpbuffer(100, 70);
+        const U32 numTiles = dpbuffer.GetClearTiles().GetNumTiles();
+        TEST_ASSERT(numTiles == 4 * 3);
+        dpbuffer.Value(5, 5) = 1.0f;
+        dpbuffer.SetAll(0.5f);
+        TEST_ASSERT(dpbuffer.GetClearTiles().GetNumPendingTiles() == numTiles);
+        TEST_ASSERT(dpbuffer.ValueAt(5, 5) == 0.5f && dpbuffer.ValueAt(99, 69) == 0.5f);
+        dpbuffer.Value(TILE + 1, 2) = 0.25f;
+        TEST_ASSERT(dpbuffer.GetClearTiles().GetNumPendingTiles() == numTiles - 1);
+        TEST_ASSERT(dpbuffer.ValueAt(TILE + 1, 2) == 0.25f && dpbuffer.ValueAt(TILE, 0) == 0.5f && dpbuffer.ValueAt(2 * TILE - 1, TILE - 1) == 0.5f);
+
+        // the image, the export fill all the cleared tiles.
+        Image img(100, 70);
+        img.ClearPixel(vector4(0.2f, 0.4f, 0.6f, 1.0f));
+        TEST_ASSERT(img.GetClearTiles().GetNumPendingTiles() == numTiles);
+        TEST_ASSERT(AlmostEqual(img.GetPixel(50, 50), vector4(0.2f, 0.4f, 0.6f, 1.0f), 0.0f));
+        img.SetPixel(99, 69, vector4(1.0f, 0.0f, 0.0f, 1.0f));
+        TEST_ASSERT(img.GetClearTiles().GetNumPendingTiles() == numTiles - 1);
+        TEST_ASSERT(AlmostEqual(img.GetPixel(98, 69), vector4(0.2f, 0.4f, 0.6f, 1.0f), 0.0f));
+        const U8* bytes = img.GetRawData();
+        TEST_ASSERT(img.GetClearTiles().GetNumPendingTiles() == 0);
+        TEST_ASSERT(bytes[0] == 51 && bytes[1] == 102 && bytes[2] == 153);
+        TEST_ASSERT(bytes[99 * 4] == 255 && bytes[99 * 4 + 1] == 0);
+        TEST_ASSERT(bytes[(100 * 70 - 1) * 4] == 51);
+
+        // the rows are filled by the readers on multiple threads.
+        img.ClearPixel(vector4(0.0f, 1.0f, 0.0f, 1.0f));
+        const Image& constImg = img;
+        std::atomic<U32> numWrongPixels(0);
+        ParallelTool::ParallelFor(0, 70, [&](const unsigned int y)
+        {
+            const vector4* row = constImg.GetFloatRow(y);
+            for (U32 x = 0; x < 100; ++x)
+            {
+                numWrongPixels += AlmostEqual(row[x], vector4(0.0f, 1.0f, 0.0f, 1.0f), 0.0f) ? 0 : 1;
+            }
+        }, 1, 4);
+        TEST_ASSERT(numWrongPixels == 0);
+        TEST_ASSERT(img.GetClearTiles().GetNumPendingTiles() == 0);
+
+        // moving takes the pending tiles, the moved object can still be cleared without any tile.
+        img.ClearPixel(vector4(0.0f, 0.0f, 1.0f, 1.0f));
+        Image movedImg(std::move(img));
+        TEST_ASSERT(movedImg.GetClearTiles().GetNumPendingTiles() == numTiles);
+        TEST_ASSERT(AlmostEqual(movedImg.GetPixel(50, 50), vector4(0.0f, 0.0f, 1.0f, 1.0f), 0.0f));
+        img.ClearPixel(vector4(0.0f, 0.0f, 1.0f, 1.0f));
+        TEST_ASSERT(img.GetClearTiles().GetNumTiles() == 0 && ! img.GetClearTiles().HasPendingTiles());
+
+        // the cost of clearing a 1080p target every frame, a small object covers 200 * 200 pixels.
+        const U32 WIDTH = 1920, HEIGHT = 1080, NUM_FRAMES = 50;
+        Image backBuffer(WIDTH, HEIGHT);
+        DepthBuffer depthBuffer(WIDTH, HEIGHT);
+        auto drawObject = [&]()
+        {
+            for (U32 y = 400; y < 600; ++y)
+            {
+                for (U32 x = 800; x < 1000; ++x)
+                {
+                    if (0.5f > depthBuffer.ValueAt(x, y))
+                    {
+                        backBuffer.SetPixel(x, y, vector4(1.0f, 0.0f, 0.0f, 1.0f));
+                        depthBuffer.Value(x, y) = 0.5f;
+                    }
+                }
+            }
+        };
+        TestSuit::TimeCounter fastClearTime, fullClearTime;
+        {
+            TestSuit::TimeGuard guard(fastClearTime);
+            for (U32 i = 0; i < NUM_FRAMES; ++i)
+            {
+                backBuffer.ClearPixel(vector4(0.5f, 0.5f, 0.5f, 1.0f));
+                depthBuffer.SetAll(0.0f);
+                drawObject();
+            }
+        }
+        const U32 numPending = backBuffer.GetClearTiles().GetNumPendingTiles();
+        TEST_ASSERT(numPending < backBuffer.GetClearTiles().GetNumTiles() && numPending == depthBuffer.GetClearTiles().GetNumPendingTiles());
+        {
+            // write every pixel like the clear without the tiles.
+            TestSuit::TimeGuard guard(fullClearTime);
+            for (U32 i = 0; i < NUM_FRAMES; ++i)
+            {
+                for (U32 y = 0; y < HEIGHT; ++y)
+                {
+                    std::fill(backBuffer.GetFloatRow(y), backBuffer.GetFloatRow(y) + WIDTH, vector4(0.5f, 0.5f, 0.5f, 1.0f));
+                    for (U32 x = 0; x < WIDTH; ++x)
+                    {
+                        depthBuffer.Value(x, y) = 0.0f;
+                    }
+                }
+                drawObject();
+            }
+        }
+        printf("%u frames of %ux%u, fast clear: %lld %s (%u of %u tiles untouched), full clear: %lld %s\n",
+            NUM_FRAMES, WIDTH, HEIGHT,
+            fastClearTime.m_sumDuration.count(), fastClearTime.DURATION_TYPE_NAME.c_str(),
+            numPending, backBuffer.GetClearTiles().GetNumTiles(),
+            fullClearTime.m_sumDuration.count(), fullClearTime.DURATION_TYPE_NAME.c_str());
+    }
+};
+
 using SuitForDepthBuffer = SuitForPipline
 <
-    CaseForDepthBufferToImg
+    CaseForDepthBufferToImg,
+    CaseForFastClear
 >;
\ No newline at end of file
@@ -151,4 +151,511 @@ void CASE_NAME_IN_FILTER(Exercise)::Run()
     auto convResult3 = filter2x2x2.Convolve(convResult2);
     BlockShowImg(&convResult3, L"re convolve convolution result 2");
     convResult3.SaveTo(this->GetSafeStoragePath() + L"cube_" + pictureIndex + L"_convolution2_2x2x2.png");
-}
\ No newline at end of file
+}
+
+void CASE_NAME_IN_FILTER(ConvolutionKernel)::Run()
+{
+    // a noisy image with some edges.
+    const Types::U32 WIDTH = 256, HEIGHT = 256;
+    Image img(WIDTH, HEIGHT);
+    for (Types::U32 y = 0; y < HEIGHT; ++y)
+    {
+        for (Types::U32 x = 0; x < WIDTH; ++x)
+        {
+            const Types::F32 checker = ((x / 32 + y / 32) % 2) ? 0.8f : 0.2f;
+            img.SetPixel(x, y, vector4(checker, mtr.Random(), x * 1.0f / WIDTH, mtr.Random()));
+        }
+    }
+
+    auto maxDifference = [](const Image& a, const Image& b, const Types::U32 numChannels)
+    {
+        Types::F32 maxDiff = 0.0f;
+        for (Types::U32 y = 0; y < a.GetHeight(); ++y)
+        {
+            for (Types::U32 x = 0; x < a.GetWidth(); ++x)
+            {
+                const vector4 pa = a.GetPixel(x, y), pb = b.GetPixel(x, y);
+                for (Types::U32 c = 0; c < numChannels; ++c)
+                {
+                    maxDiff = std::max(maxDiff, std::abs(pa.m_arr[c] - pb.m_arr[c]));
+                }
+            }
+        }
+        return maxDiff;
+    };
+
+    // the box kernel is same as the Filter (the Filter does not convolve the alpha channel).
+    TestSuit::TimeCounter filterTime, boxTime;
+    const std::array<std::array<Types::U32, 4>, 3> boxConfigs = { {
+        // step, width, height, padding
+        { 2, 2, 2, 0 },
+        { 1, 3, 3, 1 },
+        { 3, 9, 5, 4 } } };
+    for (const auto& config : boxConfigs)
+    {
+        Filter filter(config[0], config[1], config[2], config[3]);
+        const ConvolutionKernel box = ConvolutionKernel::Box(config[0], config[1], config[2], config[3]);
+        TEST_ASSERT(box.IsSeparable());
+
+        Image filterResult, boxResult;
+        {
+            TestSuit::TimeGuard guard(filterTime);
+            filterResult = filter.Convolve(img);
+        }
+        {
+            TestSuit::TimeGuard guard(boxTime);
+            boxResult = box.Convolve(img);
+        }
+        TEST_ASSERT(filterResult.GetWidth() == boxResult.GetWidth() && filterResult.GetHeight() == boxResult.GetHeight());
+        TEST_ASSERT(maxDifference(filterResult, boxResult, 3) < 1e-5f);
+    }
+    printf("box filters, Filter: %lld %s, ConvolutionKernel: %lld %s\n",
+        filterTime.m_sumDuration.count(), filterTime.DURATION_TYPE_NAME.c_str(),
+        boxTime.m_sumDuration.count(), boxTime.DURATION_TYPE_NAME.c_str());
+
+    // the separable passes are same as the direct 2D convolution.
+    ConvolutionKernel gaussian = ConvolutionKernel::Gaussian(6, 3.0f);
+    TEST_ASSERT(gaussian.IsSeparable());
+    TestSuit::TimeCounter separableTime, directTime;
+    Image separableResult, directResult;
+    {
+        TestSuit::TimeGuard guard(separableTime);
+        separableResult = gaussian.Convolve(img);
+    }
+    gaussian.m_path = ConvolutionKernel::DIRECT_PATH;
+    {
+        TestSuit::TimeGuard guard(directTime);
+        directResult = gaussian.Convolve(img);
+    }
+    TEST_ASSERT(separableResult.GetWidth() == WIDTH && separableResult.GetHeight() == HEIGHT);
+    TEST_ASSERT(maxDifference(separableResult, directResult, 4) < 1e-5f);
+    printf("gaussian 13x13, direct: %lld %s, separable: %lld %s\n",
+        directTime.m_sumDuration.count(), directTime.DURATION_TYPE_NAME.c_str(),
+        separableTime.m_sumDuration.count(), separableTime.DURATION_TYPE_NAME.c_str());
+
+    // the 2D weights are factorized, and a non-separable kernel is convolved directly.
+    const std::vector<Types::F32> sobelX = {
+        -1.0f, 0.0f, 1.0f,
+        -2.0f, 0.0f, 2.0f,
+        -1.0f, 0.0f, 1.0f };
+    TEST_ASSERT(ConvolutionKernel(3, 3, sobelX).IsSeparable());
+
+    const std::vector<Types::F32> sharpen = {
+         0.0f, -1.0f,  0.0f,
+        -1.0f,  5.0f, -1.0f,
+         0.0f, -1.0f,  0.0f };
+    ConvolutionKernel sharpenKernel(3, 3, sharpen, 1, 1);
+    TEST_ASSERT( ! sharpenKernel.IsSeparable());
+    Image sharpenResult = sharpenKernel.Convolve(img);
+    for (Types::U32 y = 0; y < HEIGHT; y += 17)
+    {
+        for (Types::U32 x = 0; x < WIDTH; x += 13)
+        {
+            vector4 expect(0.0f, 0.0f, 0.0f, 0.0f);
+            for (int j = 0; j < 3; ++j)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    const int srcX = static_cast<int>(x) - 1 + i, srcY = static_cast<int>(y) - 1 + j;
+                    if (srcX >= 0 && srcX < static_cast<int>(WIDTH) && srcY >= 0 && srcY < static_cast<int>(HEIGHT))
+                    {
+                        const vector4 pixel = img.GetPixel(srcX, srcY);
+                        for (int c = 0; c < 4; ++c)
+                        {
+                            expect.m_arr[c] += sharpen[j * 3 + i] * pixel.m_arr[c];
+                        }
+                    }
+                }
+            }
+            const vector4 result = sharpenResult.GetPixel(x, y);
+            for (int c = 0; c < 4; ++c)
+            {
+                TEST_ASSERT(std::abs(result.m_arr[c] - MathTool::Saturate(expect.m_arr[c])) < 1e-5f);
+            }
+        }
+    }
+
+    // the result does not depend on the thread count.
+    gaussian.m_path = ConvolutionKernel::AUTO_PATH;
+    gaussian.m_numThreads = 1;
+    const Image singleThreadResult = gaussian.Convolve(img);
+    TEST_ASSERT(maxDifference(singleThreadResult, separableResult, 4) == 0.0f);
+
+    separableResult.SaveTo(this->GetSafeStoragePath() + L"convolution_gaussian_13x13.png");
+    sharpenResult.SaveTo(this->GetSafeStoragePath() + L"convolution_sharpen.png");
+}
+
+void CASE_NAME_IN_FILTER(SummedAreaTable)::Run()
+{
+    const Types::U32 WIDTH = 320, HEIGHT = 240;
+    Image img(WIDTH, HEIGHT);
+    for (Types::U32 y = 0; y < HEIGHT; ++y)
+    {
+        for (Types::U32 x = 0; x < WIDTH; ++x)
+        {
+            const Types::F32 checker = ((x / 16 + y / 16) % 2) ? 0.9f : 0.1f;
+            img.SetPixel(x, y, vector4(checker, mtr.Random(), y * 1.0f / HEIGHT, 1.0f));
+        }
+    }
+
+    TestSuit::TimeCounter buildTime;
+    std::unique_ptr<SummedAreaTable> pTable;
+    {
+        TestSuit::TimeGuard guard(buildTime);
+        pTable = std::make_unique<SummedAreaTable>(img);
+    }
+    const SummedAreaTable& table = *pTable;
+    printf("build summed-area table of %ux%u: %lld %s\n", WIDTH, HEIGHT, buildTime.m_sumDuration.count(), buildTime.DURATION_TYPE_NAME.c_str());
+
+    // brute force statistic of the pixels in the box which are inside the image.
+    auto bruteForce = [&img](int left, int bottom, int right, int top, vector4& mean, vector4& variance)
+    {
+        std::array<double, 4> sum = { 0.0, 0.0, 0.0, 0.0 }, sumSquare = { 0.0, 0.0, 0.0, 0.0 };
+        int count = 0;
+        for (int y = std::max(bottom, 0); y < std::min(top, static_cast<int>(img.GetHeight())); ++y)
+        {
+            for (int x = std::max(left, 0); x < std::min(right, static_cast<int>(img.GetWidth())); ++x)
+            {
+                const vector4 pixel = img.GetPixel(x, y);
+                for (int c = 0; c < 4; ++c)
+                {
+                    sum[c] += pixel.m_arr[c];
+                    sumSquare[c] += pixel.m_arr[c] * pixel.m_arr[c];
+                }
+                ++count;
+            }
+        }
+        for (int c = 0; c < 4; ++c)
+        {
+            mean.m_arr[c] = static_cast<Types::F32>(sum[c] / count);
+            variance.m_arr[c] = static_cast<Types::F32>(sumSquare[c] / count - (sum[c] / count) * (sum[c] / count));
+        }
+    };
+
+    // boxes inside, across the border and at the corners.
+    const std::array<std::array<int, 4>, 5> boxes = { {
+        { 10, 20, 50, 33 },
+        { -7, -7, 8, 8 },
+        { 300, 200, 400, 300 },
+        { 0, 0, 320, 240 },
+        { 123, 45, 124, 46 } } };
+    for (const auto& box : boxes)
+    {
+        vector4 expectMean, expectVariance;
+        bruteForce(box[0], box[1], box[2], box[3], expectMean, expectVariance);
+        const vector4 mean = table.BoxMean(box[0], box[1], box[2], box[3]);
+        const vector4 variance = table.BoxVariance(box[0], box[1], box[2], box[3]);
+        for (int c = 0; c < 4; ++c)
+        {
+            TEST_ASSERT(std::abs(mean.m_arr[c] - expectMean.m_arr[c]) < 1e-5f);
+            TEST_ASSERT(std::abs(variance.m_arr[c] - expectVariance.m_arr[c]) < 1e-5f);
+        }
+    }
+    TEST_ASSERT(table.BoxSum(-10, -10, 0, 0).m_x == 0.0f);
+
+    // same as the convolution with a box kernel where the box is inside the image,
+    // the cost of the summed-area table does not grow with the radius.
+    for (const Types::U32 radius : { 1u, 4u, 16u, 48u })
+    {
+        const Types::U32 side = 2 * radius + 1;
+        TestSuit::TimeCounter satTime, convolutionTime;
+        Image satResult, convolutionResult;
+        {
+            TestSuit::TimeGuard guard(satTime);
+            satResult = table.BoxFilter(radius);
+        }
+        {
+            TestSuit::TimeGuard guard(convolutionTime);
+            convolutionResult = ConvolutionKernel::Box(1, side, side, radius).Convolve(img);
+        }
+        for (Types::U32 y = radius; y + radius < HEIGHT; y += 7)
+        {
+            for (Types::U32 x = radius; x + radius < WIDTH; x += 5)
+            {
+                TEST_ASSERT(AlmostEqual(satResult.GetPixel(x, y), convolutionResult.GetPixel(x, y), 1e-5f));
+            }
+        }
+        printf("box blur radius %2u, summed-area table: %lld %s, separable convolution: %lld %s\n", radius,
+            satTime.m_sumDuration.count(), satTime.DURATION_TYPE_NAME.c_str(),
+            convolutionTime.m_sumDuration.count(), convolutionTime.DURATION_TYPE_NAME.c_str());
+    }
+
+    // the downsample is the box filter with the step of the factor.
+    Image downsampled = table.Downsample(4);
+    Image expectDownsampled = ConvolutionKernel::Box(4, 4, 4, 0).Convolve(img);
+    TEST_ASSERT(downsampled.GetWidth() == WIDTH / 4 && downsampled.GetHeight() == HEIGHT / 4);
+    for (Types::U32 y = 0; y < downsampled.GetHeight(); ++y)
+    {
+        for (Types::U32 x = 0; x < downsampled.GetWidth(); ++x)
+        {
+            TEST_ASSERT(AlmostEqual(downsampled.GetPixel(x, y), expectDownsampled.GetPixel(x, y), 1e-5f));
+        }
+    }
+
+    // the variance is high on the edges of the checker board.
+    Image variance = table.VarianceFilter(2);
+    TEST_ASSERT(variance.GetPixel(16, 8).m_x > 0.1f && variance.GetPixel(8, 8).m_x < 1e-5f);
+
+    Image blurred = table.BoxFilter(8);
+    blurred.SaveTo(this->GetSafeStoragePath() + L"summed_area_table_blur_r8.png");
+    variance.SaveTo(this->GetSafeStoragePath() + L"summed_area_table_variance_r2.png");
+}
+
+void CASE_NAME_IN_FILTER(FFTConvolution)::Run()
+{
+    const Types::U32 WIDTH = 320, HEIGHT = 240;
+    Image img(WIDTH, HEIGHT);
+    for (Types::U32 y = 0; y < HEIGHT; ++y)
+    {
+        for (Types::U32 x = 0; x < WIDTH; ++x)
+        {
+            const Types::F32 checker = ((x / 24 + y / 24) % 2) ? 0.9f : 0.1f;
+            img.SetPixel(x, y, vector4(checker, mtr.Random(), y * 1.0f / HEIGHT, mtr.Random()));
+        }
+    }
+
+    auto maxDifference = [](const Image& a, const Image& b)
+    {
+        Types::F32 maxDiff = 0.0f;
+        for (Types::U32 y = 0; y < a.GetHeight(); ++y)
+        {
+            for (Types::U32 x = 0; x < a.GetWidth(); ++x)
+            {
+                const vector4 pa = a.GetPixel(x, y), pb = b.GetPixel(x, y);
+                for (Types::U32 c = 0; c < 4; ++c)
+                {
+                    maxDiff = std::max(maxDiff, std::abs(pa.m_arr[c] - pb.m_arr[c]));
+                }
+            }
+        }
+        return maxDiff;
+    };
+
+    // the bokeh disk is not separable, the weights are normalized.
+    auto diskKernel = [](const Types::U32 diameter, const Types::U32 step, const Types::U32 padding)
+    {
+        std::vector<Types::F32> weights(diameter * diameter, 0.0f);
+        const Types::F32 center = (diameter - 1) * 0.5f, radius = diameter * 0.5f;
+        Types::F32 sum = 0.0f;
+        for (Types::U32 j = 0; j < diameter; ++j)
+        {
+            for (Types::U32 i = 0; i < diameter; ++i)
+            {
+                const Types::F32 dx = i - center, dy = j - center;
+                if (dx * dx + dy * dy <= radius * radius)
+                {
+                    weights[j * diameter + i] = 1.0f;
+                    sum += 1.0f;
+                }
+            }
+        }
+        for (auto& w : weights)
+        {
+            w /= sum;
+        }
+        return ConvolutionKernel(diameter, diameter, weights, step, padding);
+    };
+
+    // the FFT path is same as the direct path, include the step, the padding and the non-square kernels.
+    const std::array<std::array<Types::U32, 4>, 4> configs = { {
+        // width, height, step, padding
+        { 25, 25, 1, 12 },
+        { 31, 9, 1, 0 },
+        { 17, 17, 2, 8 },
+        { 64, 64, 3, 5 } } };
+    for (const auto& config : configs)
+    {
+        std::vector<Types::F32> weights(config[0] * config[1]);
+        for (auto& w : weights)
+        {
+            w = (mtr.Random() - 0.3f) * 4.0f / weights.size();
+        }
+        ConvolutionKernel kernel(config[0], config[1], weights, config[2], config[3]);
+        TEST_ASSERT( ! kernel.IsSeparable());
+        kernel.m_path = ConvolutionKernel::DIRECT_PATH;
+        const Image directResult = kernel.Convolve(img);
+        kernel.m_path = ConvolutionKernel::FFT_PATH;
+        const Image fftResult = kernel.Convolve(img);
+        TEST_ASSERT(directResult.GetWidth() == fftResult.GetWidth() && directResult.GetHeight() == fftResult.GetHeight());
+        TEST_ASSERT(maxDifference(directResult, fftResult) < 1e-4f);
+
+        // the copy share the cached spectrum, the result does not depend on the thread count.
+        ConvolutionKernel copy = kernel;
+        copy.m_numThreads = 1;
+        TEST_ASSERT(maxDifference(copy.Convolve(img), fftResult) == 0.0f);
+    }
+
+    // the separable kernel can also be convolved by FFT.
+    ConvolutionKernel gaussian = ConvolutionKernel::Gaussian(20, 8.0f);
+    gaussian.m_path = ConvolutionKernel::SEPARABLE_PATH;
+    const Image separableResult = gaussian.Convolve(img);
+    gaussian.m_path = ConvolutionKernel::FFT_PATH;
+    TEST_ASSERT(maxDifference(separableResult, gaussian.Convolve(img)) < 1e-4f);
+
+    // the small kernels are convolved directly, the large ones by FFT.
+    TEST_ASSERT(diskKernel(5, 1, 2).ChoosePath(WIDTH, HEIGHT) == ConvolutionKernel::DIRECT_PATH);
+    TEST_ASSERT(diskKernel(63, 1, 31).ChoosePath(WIDTH, HEIGHT) == ConvolutionKernel::FFT_PATH);
+    TEST_ASSERT(ConvolutionKernel::Gaussian(3, 1.0f).ChoosePath(WIDTH, HEIGHT) == ConvolutionKernel::SEPARABLE_PATH);
+
+    // the crossover of the paths, the spectrum is cached by the first FFT convolution so it is not timed.
+    const char* PATH_NAMES[] = { "auto", "direct", "separable", "fft" };
+    printf("disk kernel on %ux%u, time of direct / fft (%s), auto path\n", WIDTH, HEIGHT, TestSuit::TimeCounter().DURATION_TYPE_NAME.c_str());
+    Image bokeh;
+    for (const Types::U32 diameter : { 5u, 9u, 13u, 17u, 21u, 31u, 45u, 63u })
+    {
+        ConvolutionKernel disk = diskKernel(diameter, 1, diameter / 2);
+        disk.m_path = ConvolutionKernel::FFT_PATH;
+        disk.Convolve(img);
+        TestSuit::TimeCounter directTime, fftTime;
+        {
+            TestSuit::TimeGuard guard(fftTime);
+            bokeh = disk.Convolve(img);
+        }
+        disk.m_path = ConvolutionKernel::DIRECT_PATH;
+        {
+            TestSuit::TimeGuard guard(directTime);
+            disk.Convolve(img);
+        }
+        disk.m_path = ConvolutionKernel::AUTO_PATH;
+        printf("    %2ux%2u: %6lld / %6lld, %s\n", diameter, diameter,
+            directTime.m_sumDuration.count(), fftTime.m_sumDuration.count(), PATH_NAMES[disk.ChoosePath(WIDTH, HEIGHT)]);
+    }
+
+    printf("gaussian kernel on %ux%u, time of separable / fft (%s), auto path\n", WIDTH, HEIGHT, TestSuit::TimeCounter().DURATION_TYPE_NAME.c_str());
+    for (const Types::U32 radius : { 4u, 16u, 32u, 64u, 96u })
+    {
+        ConvolutionKernel blur = ConvolutionKernel::Gaussian(radius, radius * 0.5f);
+        blur.m_path = ConvolutionKernel::FFT_PATH;
+        blur.Convolve(img);
+        TestSuit::TimeCounter separableTime, fftTime;
+        {
+            TestSuit::TimeGuard guard(fftTime);
+            blur.Convolve(img);
+        }
+        blur.m_path = ConvolutionKernel::SEPARABLE_PATH;
+        {
+            TestSuit::TimeGuard guard(separableTime);
+            blur.Convolve(img);
+        }
+        blur.m_path = ConvolutionKernel::AUTO_PATH;
+        printf("    radius %2u: %6lld / %6lld, %s\n", radius,
+            separableTime.m_sumDuration.count(), fftTime.m_sumDuration.count(), PATH_NAMES[blur.ChoosePath(WIDTH, HEIGHT)]);
+    }
+
+    bokeh.SaveTo(this->GetSafeStoragePath() + L"fft_convolution_bokeh_63.png");
+}
+
+void CASE_NAME_IN_FILTER(ImagePyramid)::Run()
+{
+    const Types::U32 WIDTH = 300, HEIGHT = 200;
+    Image img(WIDTH, HEIGHT);
+    for (Types::U32 y = 0; y < HEIGHT; ++y)
+    {
+        for (Types::U32 x = 0; x < WIDTH; ++x)
+        {
+            const Types::F32 checker = ((x / 10 + y / 10) % 2) ? 0.75f : 0.25f;
+            img.SetPixel(x, y, vector4(checker, mtr.Random(), x * 1.0f / WIDTH, 1.0f));
+        }
+    }
+
+    // the levels are halved until 1 * 1, the odd sizes are rounded down.
+    ImagePyramid pyramid(img);
+    TEST_ASSERT(pyramid.GetNumLevels() == 9);
+    TEST_ASSERT(pyramid.GetLevelWidth(3) == 37 && pyramid.GetLevelHeight(3) == 25);
+    TEST_ASSERT(pyramid.GetLevelWidth(8) == 1 && pyramid.GetLevelHeight(8) == 1);
+    TEST_ASSERT(pyramid.LevelForSize(64, 64) == 3);
+    TEST_ASSERT(pyramid.GetLevel(0).get() == &img);
+
+    // only the requested levels and the levels between are built.
+    TEST_ASSERT( ! pyramid.IsLevelBuilt(1) && pyramid.GetMemoryUsage() == 0);
+    const auto level2 = pyramid.GetLevel(2);
+    TEST_ASSERT(pyramid.IsLevelBuilt(1) && pyramid.IsLevelBuilt(2) && ! pyramid.IsLevelBuilt(3));
+    TEST_ASSERT(pyramid.GetMemoryUsage() == ImagePyramid::ImageBytes(150, 100) + ImagePyramid::ImageBytes(75, 50));
+    TEST_ASSERT(pyramid.GetLevel(2) == level2);
+
+    // the box kernel is the average of each 2 * 2 block.
+    const Image expectLevel1 = ConvolutionKernel::Box(2, 2, 2, 0).Convolve(img);
+    const auto level1 = pyramid.GetLevel(1);
+    for (Types::U32 y = 0; y < level1->GetHeight(); ++y)
+    {
+        for (Types::U32 x = 0; x < level1->GetWidth(); ++x)
+        {
+            TEST_ASSERT(AlmostEqual(level1->GetPixel(x, y), expectLevel1.GetPixel(x, y), 1e-5f));
+        }
+    }
+
+    // the tent kernel keeps the constant image, and the average of the image.
+    Image constant(64, 48);
+    constant.ClearPixel(vector4(0.3f, 0.6f, 0.9f, 1.0f));
+    const Image tent = ImagePyramid::Downsample(constant, ImagePyramid::TENT_KERNEL);
+    TEST_ASSERT(tent.GetWidth() == 32 && tent.GetHeight() == 24);
+    TEST_ASSERT(AlmostEqual(tent.GetPixel(0, 0), vector4(0.3f, 0.6f, 0.9f, 1.0f), 1e-6f));
+    TEST_ASSERT(AlmostEqual(tent.GetPixel(31, 23), vector4(0.3f, 0.6f, 0.9f, 1.0f), 1e-6f));
+
+    // the tent is smoother than the box on the checker board, less aliasing.
+    auto contrast = [](const Image& level)
+    {
+        Types::F32 minRed = 1.0f, maxRed = 0.0f;
+        for (Types::U32 y = 0; y < level.GetHeight(); ++y)
+        {
+            for (Types::U32 x = 0; x < level.GetWidth(); ++x)
+            {
+                minRed = std::min(minRed, level.GetPixel(x, y).m_x);
+                maxRed = std::max(maxRed, level.GetPixel(x, y).m_x);
+            }
+        }
+        return maxRed - minRed;
+    };
+    ImagePyramid tentPyramid(img, ImagePyramid::TENT_KERNEL);
+    TEST_ASSERT(contrast(*tentPyramid.GetLevel(3)) < contrast(*pyramid.GetLevel(3)));
+
+    // the least recently used levels are released by the budget, the released level is still valid for the holder.
+    ImagePyramid budgetPyramid(img, ImagePyramid::BOX_KERNEL, ImagePyramid::ImageBytes(150, 100));
+    const auto heldLevel1 = budgetPyramid.GetLevel(1);
+    budgetPyramid.GetLevel(3);
+    TEST_ASSERT(budgetPyramid.GetMemoryUsage() <= ImagePyramid::ImageBytes(150, 100));
+    TEST_ASSERT( ! budgetPyramid.IsLevelBuilt(1) && budgetPyramid.IsLevelBuilt(3));
+    TEST_ASSERT(AlmostEqual(heldLevel1->GetPixel(20, 20), level1->GetPixel(20, 20), 0.0f));
+    TEST_ASSERT(AlmostEqual(budgetPyramid.GetLevel(1)->GetPixel(20, 20), level1->GetPixel(20, 20), 0.0f));
+
+    // the levels can be requested by multiple threads.
+    ImagePyramid sharedPyramid(img);
+    std::vector<std::thread> threads;
+    std::atomic<int> numMismatches(0);
+    for (Types::U32 t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            for (Types::U32 level = 8 - t; level > 0; --level)
+            {
+                const auto mine = sharedPyramid.GetLevel(level);
+                const auto expect = pyramid.GetLevel(level);
+                if ( ! AlmostEqual(mine->GetPixel(0, 0), expect->GetPixel(0, 0), 0.0f))
+                {
+                    ++numMismatches;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    TEST_ASSERT(numMismatches == 0);
+
+    // throughput of a 1080p frame.
+    Image frame(1920, 1080);
+    for (const auto kernel : { ImagePyramid::BOX_KERNEL, ImagePyramid::TENT_KERNEL })
+    {
+        TestSuit::TimeCounter downsampleTime;
+        {
+            TestSuit::TimeGuard guard(downsampleTime);
+            ImagePyramid::Downsample(frame, kernel);
+        }
+        printf("downsample 1920x1080 by %s kernel: %lld %s\n", kernel == ImagePyramid::BOX_KERNEL ? "box" : "tent",
+            downsampleTime.m_sumDuration.count(), downsampleTime.DURATION_TYPE_NAME.c_str());
+    }
+
+    Image thumbnail = ImagePyramid::Downsample(*tentPyramid.GetLevel(2), ImagePyramid::TENT_KERNEL);
+    thumbnail.SaveTo(this->GetSafeStoragePath() + L"image_pyramid_tent_level3.png");
+}
@@ -23,8 +23,20 @@ DECLARE_CASE_IN_FILTER_FOR(GenerateLocMap, "the basic functionality of filter");
 
 DECLARE_CASE_IN_FILTER_FOR(Exercise, "the basic functionality of filter");
 
+DECLARE_CASE_IN_FILTER_FOR(ConvolutionKernel, "separable and multithreaded convolution with kernel weights");
+
+DECLARE_CASE_IN_FILTER_FOR(SummedAreaTable, "constant time box filters by summed-area table");
+
+DECLARE_CASE_IN_FILTER_FOR(FFTConvolution, "FFT convolution of large kernels and the crossover of the convolution paths");
+
+DECLARE_CASE_IN_FILTER_FOR(ImagePyramid, "lazy image pyramid with a memory budget");
+
 using SuitForFilter = SuitForPipline<
     CASE_NAME_IN_FILTER(Basic),
     CASE_NAME_IN_FILTER(GenerateLocMap),
-    CASE_NAME_IN_FILTER(Exercise)
+    CASE_NAME_IN_FILTER(Exercise),
+    CASE_NAME_IN_FILTER(ConvolutionKernel),
+    CASE_NAME_IN_FILTER(SummedAreaTable),
+    CASE_NAME_IN_FILTER(FFTConvolution),
+    CASE_NAME_IN_FILTER(ImagePyramid)
 >;
\ No newline at end of file
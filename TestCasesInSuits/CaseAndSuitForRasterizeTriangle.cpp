@@ -954,4 +954,853 @@ void CASE_NAME_IN_RASTER_TRI(ShadowMap)::Run()
 
     std::wstring shadowMapNameWithNoExt = L"shadowMap_shadowMap_" + pictureIndex + L"_" + geometryName;
     SaveAndShow(*shadowMap, shadowMapNameWithNoExt);
-}
\ No newline at end of file
+}
+
+void CASE_NAME_IN_RASTER_TRI(DepthOnlyShadowMap)::Run()
+{
+    using namespace Types;
+
+    CommonRenderingBuffer renderingBuffer;
+    renderingBuffer.cameraBuffer.m_lights[1].m_fadeoffEnd = 10.0f;
+    renderingBuffer.objInstances[2].m_scale = 2.0f * vector3::UNIT;
+    renderingBuffer.cameraBuffer.m_lights[0].m_position = vector3(-5.0f, 5.0f, 5.0f);
+    renderingBuffer.cameraBuffer.m_lights[0].m_fadeoffEnd = 10.0f;
+    renderingBuffer.UpdateConstantBuffer();
+
+    GraphicToolSet::ConstantBufferForInstance   instanceBufAgent;
+    const auto& mesh = renderingBuffer.prebuildMeshData[CommonRenderingBuffer::M_GEOSPHERE];
+
+    const U32 WIDTH  = graphicToolSet.COMMON_PIXEL_WIDTH;
+    const U32 HEIGHT = graphicToolSet.COMMON_PIXEL_HEIGHT;
+    auto pipline = graphicToolSet.GetCommonPipline();
+
+    // the color shadow map, the pixel shader output the ndc z, both pass use the fixed point rasterizer to cover the same pixels.
+    auto PSO_color = graphicToolSet.GetCommonPSO();
+    PSO_color->m_vertexLayout.vertexShaderInputSize = sizeof(SimplePoint);
+    PSO_color->m_vertexLayout.pixelShaderInputSize  = sizeof(GraphicToolSet::PSIn);
+    PSO_color->m_vertexShader   = graphicToolSet.GetVertexShaderWithVSOut(instanceBufAgent, renderingBuffer.lightCameraBuffer);
+    PSO_color->m_pixelShader    = [](const ScreenSpaceVertexTemplate* pVertex)->vector4 {
+        const F32 ndcZ = pVertex->m_posH.m_z;
+        return vector4(ndcZ, ndcZ, ndcZ, 1.0f);
+    };
+    PSO_color->m_primitiveType  = PrimitiveType::TRIANGLE_LIST;
+    PSO_color->m_cullFace       = CullFace::CLOCK_WISE;
+    PSO_color->m_rasterizeMode  = FIXED_POINT_SUBPIXEL;
+
+    // the depth only shadow map, no pixel shader.
+    auto PSO_depthOnly = graphicToolSet.GetCommonPSO();
+    PSO_depthOnly->m_vertexLayout   = PSO_color->m_vertexLayout;
+    PSO_depthOnly->m_vertexShader   = PSO_color->m_vertexShader;
+    PSO_depthOnly->m_primitiveType  = PrimitiveType::TRIANGLE_LIST;
+    PSO_depthOnly->m_cullFace       = CullFace::CLOCK_WISE;
+    PSO_depthOnly->m_isDepthOnly    = true;
+
+    auto colorShadowMap = std::make_shared<Image>(WIDTH, HEIGHT);
+    auto depthShadowMap = std::make_shared<DepthBuffer>(WIDTH, HEIGHT);
+
+    const unsigned int NUM_LOOPS = 10;
+    TestSuit::TimeCounter colorCounter, depthOnlyCounter;
+    for (unsigned int loop = 0; loop < NUM_LOOPS; ++loop)
+    {
+        {
+            TestSuit::TimeGuard guard(colorCounter);
+            pipline->SetPSO(PSO_color);
+            pipline->SetBackBuffer(colorShadowMap);
+            pipline->ClearBackBuffer(vector4::WHITE);
+            for (int i = 0; i < 3; ++i)
+            {
+                instanceBufAgent = renderingBuffer.instanceBuffers[i];
+                pipline->DrawInstance(mesh.indices, mesh.vertexBuffer.get());
+            }
+        }
+        {
+            TestSuit::TimeGuard guard(depthOnlyCounter);
+            pipline->SetPSO(PSO_depthOnly);
+            pipline->SetDepthTarget(depthShadowMap);
+            depthShadowMap->SetAll(1.0f);
+            for (int i = 0; i < 3; ++i)
+            {
+                instanceBufAgent = renderingBuffer.instanceBuffers[i];
+                pipline->DrawInstance(mesh.indices, mesh.vertexBuffer.get());
+            }
+        }
+    }
+
+    // the same pixels are covered with the same depth,
+    // a few pixels may differ where two triangles have almost the same depth.
+    unsigned int numCovered = 0, numDifferent = 0;
+    for (U32 y = 0; y < HEIGHT; ++y)
+    {
+        for (U32 x = 0; x < WIDTH; ++x)
+        {
+            const F32 colorDepth = colorShadowMap->GetPixel(x, y).m_x;
+            const F32 depth      = depthShadowMap->ValueAt(x, y);
+            numCovered   += depth < 1.0f ? 1 : 0;
+            numDifferent += std::abs(colorDepth - depth) > 1e-5f ? 1 : 0;
+        }
+    }
+    TEST_ASSERT(numCovered > 0);
+    TEST_ASSERT(numDifferent * 1000 <= numCovered);
+
+    // the shadow compare sampler.
+    const U32 cx = WIDTH / 2, cy = HEIGHT / 2;
+    const F32 centerDepth = depthShadowMap->ValueAt(cx, cy);
+    const F32 centerU = (cx + 0.5f) / WIDTH, centerV = (cy + 0.5f) / HEIGHT;
+    TEST_ASSERT(depthShadowMap->SampleCompare(centerU, centerV, centerDepth) == 1.0f);
+    TEST_ASSERT(depthShadowMap->SampleCompare(centerU, centerV, std::nextafter(centerDepth, 2.0f)) == 0.0f);
+    TEST_ASSERT(depthShadowMap->SampleCompare(-0.1f, centerV, 2.0f) == 1.0f);
+
+    printf("color      shadow map: %8.3f ms/frame\n", std::chrono::duration<double, std::milli>(colorCounter.m_sumDuration).count() / NUM_LOOPS);
+    printf("depth only shadow map: %8.3f ms/frame\n", std::chrono::duration<double, std::milli>(depthOnlyCounter.m_sumDuration).count() / NUM_LOOPS);
+    printf("covered pixels: %u, different pixels: %u\n", numCovered, numDifferent);
+
+    // rendering to back buffer with the shadow compare sampler.
+    auto PSO_backbuffer = graphicToolSet.GetCommonPSO();
+    PSO_backbuffer->m_vertexLayout  = PSO_color->m_vertexLayout;
+    PSO_backbuffer->m_vertexShader  = graphicToolSet.GetVertexShaderWithVSOut(instanceBufAgent, renderingBuffer.cameraBuffer);
+    PSO_backbuffer->m_pixelShader   = graphicToolSet.GetPixelShaderForShadowEffect(instanceBufAgent, renderingBuffer.cameraBuffer, renderingBuffer.lightCameraBuffer, depthShadowMap);
+    PSO_backbuffer->m_primitiveType = PrimitiveType::TRIANGLE_LIST;
+    PSO_backbuffer->m_cullFace      = CullFace::CLOCK_WISE;
+
+    auto backbuffer = std::make_shared<Image>(WIDTH, HEIGHT);
+    pipline->SetPSO(PSO_backbuffer);
+    pipline->SetBackBuffer(backbuffer);
+    pipline->ClearBackBuffer(vector4::WHITE * 0.5f);
+    for (int i = 0; i < 3; ++i)
+    {
+        instanceBufAgent = renderingBuffer.instanceBuffers[i];
+        COUNT_DETAIL_TIME;
+        pipline->DrawInstance(mesh.indices, mesh.vertexBuffer.get());
+    }
+
+    SaveAndShow(*backbuffer, L"shadowMap_backbuffer_depthOnly_geoSphere");
+    Image depthImage = ToImage(*depthShadowMap, 1.0f);
+    SaveAndShow(depthImage, L"shadowMap_depthOnly_geoSphere");
+}
+
+void CASE_NAME_IN_RASTER_TRI(CascadedShadowMap)::Run()
+{
+    using namespace Types;
+
+    // the PCF sampler, the left half of the map is a caster at 0.25, the right half is empty.
+    {
+        const U32 SIZE = 64;
+        DepthBuffer depthMap(SIZE, SIZE);
+        depthMap.SetAll(1.0f);
+        for (U32 y = 0; y < SIZE; ++y)
+        {
+            for (U32 x = 0; x < SIZE / 2; ++x)
+            {
+                depthMap.Value(x, y) = 0.25f;
+            }
+        }
+
+        // the brute force reference of the bilinear weighted box kernel.
+        auto referencePCF = [&](F32 u, F32 v, F32 compareValue, I32 radius)->F32
+        {
+            const F32 tx = u * SIZE - 0.5f, ty = v * SIZE - 0.5f;
+            const I32 x0 = static_cast<I32>(std::floor(tx)), y0 = static_cast<I32>(std::floor(ty));
+            const F32 fx = tx - std::floor(tx), fy = ty - std::floor(ty);
+            F32 sum = 0.0f;
+            for (I32 j = -radius; j <= radius + 1; ++j)
+            {
+                for (I32 i = -radius; i <= radius + 1; ++i)
+                {
+                    const F32 wx = i == -radius ? 1.0f - fx : (i == radius + 1 ? fx : 1.0f);
+                    const F32 wy = j == -radius ? 1.0f - fy : (j == radius + 1 ? fy : 1.0f);
+                    const U32 x = static_cast<U32>(std::min(std::max(x0 + i, 0), static_cast<I32>(SIZE) - 1));
+                    const U32 y = static_cast<U32>(std::min(std::max(y0 + j, 0), static_cast<I32>(SIZE) - 1));
+                    sum += compareValue <= depthMap.ValueAt(x, y) ? wx * wy : 0.0f;
+                }
+            }
+            return sum / ((2 * radius + 1) * (2 * radius + 1));
+        };
+
+        // both the pending tiles and the resolved ones.
+        for (int resolved = 0; resolved < 2; ++resolved)
+        {
+            if (resolved)
+            {
+                depthMap.ResolveClearedTiles();
+                TEST_ASSERT(depthMap.GetClearTiles().GetNumPendingTiles() == 0);
+            }
+            for (U32 radius = 0; radius <= DepthBuffer::PCF_MAX_RADIUS; ++radius)
+            {
+                for (int i = 0; i < 200; ++i)
+                {
+                    const F32 u = mtr.Random(), v = mtr.Random();
+                    const F32 compareValue = mtr.Random() < 0.5f ? 0.5f : 0.1f;
+                    TEST_ASSERT(std::abs(depthMap.SampleComparePCF(u, v, compareValue, radius) - referencePCF(u, v, compareValue, radius)) < 1e-4f);
+                }
+                // the shadow edge is filtered smoothly.
+                TEST_ASSERT(depthMap.SampleComparePCF(0.1f, 0.5f, 0.5f, radius) == 0.0f);
+                TEST_ASSERT(depthMap.SampleComparePCF(0.9f, 0.5f, 0.5f, radius) == 1.0f);
+                TEST_ASSERT(std::abs(depthMap.SampleComparePCF(0.5f, 0.5f, 0.5f, radius) - 0.5f) < 1e-4f);
+            }
+        }
+    }
+
+    // a large ground and a row of spheres far away from the camera.
+    CommonRenderingBuffer renderingBuffer;
+    const auto& groundMesh = renderingBuffer.prebuildMeshData[CommonRenderingBuffer::M_CUBE];
+    const auto& sphereMesh = renderingBuffer.prebuildMeshData[CommonRenderingBuffer::M_GEOSPHERE];
+    struct DrawItem
+    {
+        const CommonRenderingBuffer::SpecializedMeshData*   mesh;
+        GraphicToolSet::ConstantBufferForInstance           instance;
+    };
+    std::vector<DrawItem> drawItems;
+    {
+        GraphicToolSet::ObjectInstance ground;
+        ground.m_position = vector3(0.0f, -0.05f, -20.0f);
+        ground.m_rotation = vector3::ZERO;
+        ground.m_scale = vector3(30.0f, 0.05f, 30.0f);
+        ground.m_material.m_diffuse = RGB::WHITE;
+        ground.m_material.m_fresnelR0 = GraphicToolSet::FresnelR0_byReflectionIndex(1);
+        ground.m_material.m_shiness = 1.0f;
+        DrawItem item;
+        item.mesh = &groundMesh;
+        item.instance.m_toWorld = Transform::TRS(ground.m_position, ground.m_rotation, ground.m_scale);
+        item.instance.m_toWorldInverse = Transform::InverseTRS(ground.m_position, ground.m_rotation, ground.m_scale);
+        item.instance.m_material = ground.m_material;
+        drawItems.push_back(item);
+    }
+    const std::array<vector3, 4> spherePositions = { vector3(0.0f, 1.0f, 0.0f), vector3(3.0f, 1.0f, -8.0f), vector3(-4.0f, 1.5f, -20.0f), vector3(5.0f, 2.0f, -40.0f) };
+    for (const auto& position : spherePositions)
+    {
+        const vector3 scale = vector3::UNIT * (position.m_y / 0.8f);
+        DrawItem item;
+        item.mesh = &sphereMesh;
+        item.instance.m_toWorld = Transform::TRS(position, vector3::ZERO, scale);
+        item.instance.m_toWorldInverse = Transform::InverseTRS(position, vector3::ZERO, scale);
+        item.instance.m_material = renderingBuffer.objInstances[0].m_material;
+        drawItems.push_back(item);
+    }
+
+    const F32 FOV_Y = Types::Constant::PI_F / 3.0f, NEAR = 0.5f, FAR = 60.0f;
+    const vector3 lightDirection = Normalize(vector3(-1.0f, -2.0f, -0.5f));
+    CameraFrame camera(vector3(0.0f, 3.0f, 8.0f), vector3(0.0f, 0.0f, -10.0f));
+    auto shadowMap = std::make_shared<CascadedShadowMap>(4, 1024);
+    shadowMap->Update(camera, FOV_Y, 1.0f, NEAR, FAR, lightDirection);
+
+    // the slices are continuous, and each cascade contains the corners of its slice.
+    const U32 NUM_CASCADES = shadowMap->GetNumCascades();
+    TEST_ASSERT(NUM_CASCADES == 4);
+    TEST_ASSERT(shadowMap->GetCascade(0).m_splitNear == NEAR && shadowMap->GetCascade(NUM_CASCADES - 1).m_splitFar == FAR);
+    const F32 tanY = std::tan(FOV_Y * 0.5f);
+    for (U32 i = 0; i < NUM_CASCADES; ++i)
+    {
+        const auto& cascade = shadowMap->GetCascade(i);
+        if (i > 0)
+        {
+            TEST_ASSERT(cascade.m_splitNear == shadowMap->GetCascade(i - 1).m_splitFar);
+            TEST_ASSERT(cascade.m_texelWorldSize > shadowMap->GetCascade(i - 1).m_texelWorldSize);
+        }
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const F32 d = (corner & 4) ? cascade.m_splitFar : cascade.m_splitNear;
+            const vector4 cornerC(((corner & 1) ? 1.0f : -1.0f) * d * tanY, ((corner & 2) ? 1.0f : -1.0f) * d * tanY, -d, 1.0f);
+            const vector4 inShadowMap = cascade.m_toShadowMap * (camera.LocalToWorld() * cornerC);
+            TEST_ASSERT(std::abs(inShadowMap.m_x) <= 1.0f && std::abs(inShadowMap.m_y) <= 1.0f);
+            TEST_ASSERT(0.0f <= inShadowMap.m_z && inShadowMap.m_z <= 1.0f);
+        }
+    }
+
+    // moving the camera move the shadow maps by whole texels.
+    {
+        const vector4 fixedPoint(1.0f, 0.0f, -5.0f, 1.0f);
+        std::vector<vector4> before;
+        for (U32 i = 0; i < NUM_CASCADES; ++i)
+        {
+            before.push_back(shadowMap->GetCascade(i).m_toShadowMap * fixedPoint);
+        }
+        CameraFrame movedCamera(vector3(0.37f, 3.11f, 7.23f), vector3(0.5f, 0.2f, -10.0f));
+        shadowMap->Update(movedCamera, FOV_Y, 1.0f, NEAR, FAR, lightDirection);
+        for (U32 i = 0; i < NUM_CASCADES; ++i)
+        {
+            const vector4 after = shadowMap->GetCascade(i).m_toShadowMap * fixedPoint;
+            const F32 texelsX = (after.m_x - before[i].m_x) * 0.5f * shadowMap->GetResolution();
+            const F32 texelsY = (after.m_y - before[i].m_y) * 0.5f * shadowMap->GetResolution();
+            TEST_ASSERT(std::abs(texelsX - std::round(texelsX)) < 0.02f && std::abs(texelsY - std::round(texelsY)) < 0.02f);
+        }
+        shadowMap->Update(camera, FOV_Y, 1.0f, NEAR, FAR, lightDirection);
+    }
+
+    // render the cascades with the depth only pipelines.
+    auto drawCascade = [&](Pipline& pipline, const CascadedShadowMap::Cascade& cascade)
+    {
+        GraphicToolSet::ConstantBufferForInstance   instanceBuf;
+        GraphicToolSet::ConstantBufferForCamera     lightBuf;
+        lightBuf.m_toCamera = cascade.m_toLight;
+        lightBuf.m_project  = cascade.m_project;
+        auto pso = pipline.GetPSO();
+        pso->m_vertexLayout.vertexShaderInputSize   = sizeof(SimplePoint);
+        pso->m_vertexLayout.pixelShaderInputSize    = sizeof(GraphicToolSet::PSIn);
+        pso->m_batchVertexShader                    = graphicToolSet.GetBatchVertexShaderWithVSOut(instanceBuf, lightBuf);
+        for (const auto& item : drawItems)
+        {
+            instanceBuf = item.instance;
+            pipline.DrawInstance(item.mesh->indices, item.mesh->vertexBuffer.get());
+        }
+    };
+    const unsigned int NUM_LOOPS = 5;
+    TestSuit::TimeCounter serialCounter, parallelCounter;
+    for (unsigned int loop = 0; loop < NUM_LOOPS; ++loop)
+    {
+        {
+            TestSuit::TimeGuard guard(serialCounter);
+            shadowMap->Render(drawCascade, 1);
+        }
+        {
+            TestSuit::TimeGuard guard(parallelCounter);
+            shadowMap->Render(drawCascade);
+        }
+    }
+    printf("cascades on one thread: %8.3f ms/frame\n", std::chrono::duration<double, std::milli>(serialCounter.m_sumDuration).count() / NUM_LOOPS);
+    printf("cascades in parallel:   %8.3f ms/frame\n", std::chrono::duration<double, std::milli>(parallelCounter.m_sumDuration).count() / NUM_LOOPS);
+
+    // the ground under each sphere (along the light) is in shadow, the ground beside it is lit.
+    const Transform toCamera = camera.WorldToLocal();
+    for (const auto& position : spherePositions)
+    {
+        const vector3 shadowCenter = position + lightDirection * (position.m_y / -lightDirection.m_y);
+        const vector3 besideShadow = shadowCenter + vector3(0.0f, 0.0f, 3.0f * position.m_y);
+        const F32 shadowDepth = -(toCamera * shadowCenter.Tovector4()).m_z;
+        const F32 besideDepth = -(toCamera * besideShadow.Tovector4()).m_z;
+        TEST_ASSERT(shadowMap->SampleShadow(shadowCenter, vector3::AXIS_Y, shadowDepth) == 0.0f);
+        TEST_ASSERT(shadowMap->SampleShadow(besideShadow, vector3::AXIS_Y, besideDepth) == 1.0f);
+    }
+
+    // render the scene with the cascaded shadows.
+    GraphicToolSet::ConstantBufferForInstance   instanceBufAgent;
+    GraphicToolSet::ConstantBufferForCamera     cameraBuffer = renderingBuffer.cameraBuffer;
+    cameraBuffer.SetCameraMatrix(camera);
+    cameraBuffer.m_project = Transform::PerspectiveFOV(FOV_Y, 1.0f, NEAR, FAR);
+    cameraBuffer.m_lights[1].m_direction = lightDirection;
+    cameraBuffer.m_lights[1].m_color = RGB::WHITE;
+    cameraBuffer.m_ambientColor = RGB(0.2f, 0.2f, 0.2f);
+
+    auto pipline = graphicToolSet.GetCommonPipline();
+    auto pso = pipline->GetPSO();
+    pso->m_vertexLayout.vertexShaderInputSize   = sizeof(SimplePoint);
+    pso->m_vertexLayout.pixelShaderInputSize    = sizeof(GraphicToolSet::PSIn);
+    pso->m_vertexShader     = graphicToolSet.GetVertexShaderWithVSOut(instanceBufAgent, cameraBuffer);
+    pso->m_pixelShader      = graphicToolSet.GetPixelShaderWithCascadedShadow(instanceBufAgent, cameraBuffer, shadowMap);
+    pso->m_primitiveType    = PrimitiveType::TRIANGLE_LIST;
+    pso->m_cullFace         = CullFace::CLOCK_WISE;
+    pipline->ClearBackBuffer(vector4::WHITE * 0.5f);
+    for (const auto& item : drawItems)
+    {
+        instanceBufAgent = item.instance;
+        COUNT_DETAIL_TIME;
+        pipline->DrawInstance(item.mesh->indices, item.mesh->vertexBuffer.get());
+    }
+
+    SaveAndShowPiplineBackbuffer((*(pipline.get())), L"cascadedShadowMap");
+}
+
+void CASE_NAME_IN_RASTER_TRI(FrustumCulling)::Run()
+{
+    using namespace Types;
+
+    CommonRenderingBuffer renderingBuffer;
+    const auto& mesh = renderingBuffer.prebuildMeshData[CommonRenderingBuffer::M_GEOSPHERE];
+    const Transform toClip = renderingBuffer.cameraBuffer.m_project * renderingBuffer.cameraBuffer.m_toCamera;
+
+    // the camera is at (0, 0, 4) and looks at the origin.
+    auto isOutside = [&](const vector3& minPoint, const vector3& maxPoint)->bool
+    {
+        return Pipline::IsOutsideFrustum(AABB(minPoint, maxPoint), toClip);
+    };
+    TEST_ASSERT( ! isOutside(vector3(-1.0f, -1.0f, -1.0f), vector3(1.0f, 1.0f, 1.0f)));
+    TEST_ASSERT(   isOutside(vector3(-1.0f, -1.0f, 9.0f), vector3(1.0f, 1.0f, 11.0f)));     // behind the camera, w < 0.
+    TEST_ASSERT( ! isOutside(vector3(-1.0f, -1.0f, 3.0f), vector3(1.0f, 1.0f, 5.0f)));      // contain the camera.
+    TEST_ASSERT(   isOutside(vector3(-101.0f, -1.0f, -1.0f), vector3(-99.0f, 1.0f, 1.0f)));
+    TEST_ASSERT(   isOutside(vector3(-1.0f, -1.0f, -100.0f), vector3(1.0f, 1.0f, -90.0f))); // beyond the far plane.
+    TEST_ASSERT( ! isOutside(vector3(-100.0f, -1.0f, -1.0f), vector3(100.0f, 1.0f, 1.0f))); // cross the frustum.
+
+    // a lot of instances around the camera, most of them are out of the view.
+    const unsigned int NUM_INSTANCES = 300;
+    std::vector<MeshInstances> scene = { BuildRandomInstances(mesh, NUM_INSTANCES, renderingBuffer.objInstances[0].m_material,
+        [this](const unsigned int) { return vector3((mtr.Random() - 0.5f) * 40.0f, (mtr.Random() - 0.5f) * 40.0f, (mtr.Random() - 0.5f) * 40.0f); },
+        [this](const unsigned int) { return 0.3f + 0.4f * mtr.Random(); }) };
+
+    TestSuit::TimeCounter allCounter, culledCounter;
+    auto allPipline = DrawMeshInstances(renderingBuffer, scene, nullptr, allCounter);
+    scene[0].m_isBounded = true;
+    auto culledPipline = DrawMeshInstances(renderingBuffer, scene, nullptr, culledCounter);
+
+    // the culled draws have no visible pixel.
+    TEST_ASSERT(CountDifferentPixels(*allPipline->m_backBuffer, *culledPipline->m_backBuffer) == 0);
+
+    const auto& statistic = culledPipline->GetStatistic();
+    TEST_ASSERT(statistic.m_numDraws == NUM_INSTANCES);
+    TEST_ASSERT(statistic.m_numFrustumCulledDraws > NUM_INSTANCES / 2 && statistic.m_numFrustumCulledDraws < NUM_INSTANCES);
+    TEST_ASSERT(statistic.m_numCulledVertices == statistic.m_numFrustumCulledDraws * (mesh.vertexBuffer->GetSizeOfByte() / sizeof(SimplePoint)));
+    TEST_ASSERT(allPipline->GetStatistic().m_numFrustumCulledDraws == 0);
+
+    printf("draws: %u, culled draws: %u, culled vertices: %u\n", statistic.m_numDraws, statistic.m_numFrustumCulledDraws, statistic.m_numCulledVertices);
+    PrintDuration("without culling:", allCounter);
+    PrintDuration("with culling:", culledCounter);
+
+    SaveAndShowPiplineBackbuffer((*(culledPipline.get())), L"geosphere_frustumCulling");
+}
+
+void CASE_NAME_IN_RASTER_TRI(PreClipCulling)::Run()
+{
+    using namespace Types;
+
+    // hand made triangles in the clip space, the vertex shader only copy the position.
+    {
+        std::vector<vector4> clipPositions = {
+            // front face.
+            vector4(-0.8f, -0.8f, 0.5f, 1.0f),  vector4(-0.2f, -0.8f, 0.5f, 1.0f),  vector4(-0.5f, -0.2f, 0.5f, 1.0f),
+            // back face.
+            vector4( 0.2f, -0.8f, 0.5f, 1.0f),  vector4( 0.5f, -0.2f, 0.5f, 1.0f),  vector4( 0.8f, -0.8f, 0.5f, 1.0f),
+            // front face and back face crossing the camera plane, one vertex is behind the camera.
+            vector4(-0.5f,  0.2f, 0.5f, 1.0f),  vector4( 0.0f,  0.3f, 0.5f, 1.0f),  vector4(-0.2f,  0.8f, -0.5f, -0.5f),
+            vector4( 0.5f,  0.2f, 0.5f, 1.0f),  vector4( 0.3f,  0.8f, -0.5f, -0.5f), vector4( 0.9f,  0.3f, 0.5f, 1.0f),
+            // no area.
+            vector4(-0.9f,  0.0f, 0.5f, 1.0f),  vector4( 0.0f,  0.0f, 0.5f, 1.0f),  vector4( 0.9f,  0.0f, 0.5f, 1.0f),
+            // between the samples.
+            vector4(0.501f, 0.501f, 0.5f, 1.0f), vector4(0.5015f, 0.501f, 0.5f, 1.0f), vector4(0.5012f, 0.5015f, 0.5f, 1.0f)
+        };
+        std::vector<unsigned int> indices(clipPositions.size());
+        for (unsigned int i = 0; i < indices.size(); ++i)
+        {
+            indices[i] = i;
+        }
+        auto vertexBuffer = std::make_unique<F32Buffer>(clipPositions.size() * sizeof(vector4));
+        memcpy(vertexBuffer->GetBuffer(), clipPositions.data(), vertexBuffer->GetSizeOfByte());
+
+        auto drawTriangles = [&](const bool isCullingBeforeClipping)->std::unique_ptr<Pipline>
+        {
+            auto pipline = graphicToolSet.GetCommonPipline();
+            auto pso = pipline->GetPSO();
+            pso->m_vertexLayout.vertexShaderInputSize   = sizeof(vector4);
+            pso->m_vertexLayout.pixelShaderInputSize    = sizeof(vector4);
+            pso->m_vertexShader = [](const unsigned char * pSrcVertex, ScreenSpaceVertexTemplate * pDestV)->void
+            {
+                pDestV->m_posH = *reinterpret_cast<const vector4*>(pSrcVertex);
+            };
+            pso->m_pixelShader = [](const ScreenSpaceVertexTemplate*)->vector4
+            {
+                return vector4::WHITE;
+            };
+            pso->m_primitiveType            = PrimitiveType::TRIANGLE_LIST;
+            pso->m_fillMode                 = FillMode::SOLIDE;
+            pso->m_cullFace                 = CullFace::CLOCK_WISE;
+            pso->m_isCullingBeforeClipping  = isCullingBeforeClipping;
+            pipline->ClearBackBuffer(vector4::BLACK);
+            pipline->DrawInstance(indices, vertexBuffer.get());
+            return pipline;
+        };
+
+        auto culledPipline  = drawTriangles(true);
+        auto clippedPipline = drawTriangles(false);
+        const auto& statistic = culledPipline->GetStatistic();
+        TEST_ASSERT(statistic.m_numBackFaceTriangles == 2);
+        TEST_ASSERT(statistic.m_numDegeneratedTriangles == 2);
+        TEST_ASSERT(clippedPipline->GetStatistic().m_numBackFaceTriangles == 0);
+
+        const Image& culledImage = *culledPipline->m_backBuffer;
+        TEST_ASSERT(CountDifferentPixels(culledImage, *clippedPipline->m_backBuffer) == 0);
+        // the front faces are drawn.
+        Image emptyImage(culledImage.GetWidth(), culledImage.GetHeight());
+        emptyImage.ClearPixel(vector4::BLACK);
+        TEST_ASSERT(CountDifferentPixels(culledImage, emptyImage) > 0);
+    }
+
+    // a close geosphere and a lot of distant ones, which only cover a few pixels.
+    CommonRenderingBuffer renderingBuffer;
+    const auto& mesh = renderingBuffer.prebuildMeshData[CommonRenderingBuffer::M_GEOSPHERE];
+    const unsigned int NUM_INSTANCES = 200;
+    const std::vector<MeshInstances> scene = { BuildRandomInstances(mesh, NUM_INSTANCES, renderingBuffer.objInstances[0].m_material,
+        [this](const unsigned int i) { return i == 0 ? vector3::ZERO : vector3((mtr.Random() - 0.5f) * 30.0f, (mtr.Random() - 0.5f) * 30.0f, -40.0f - mtr.Random() * 40.0f); },
+        [this](const unsigned int i) { return i == 0 ? 1.0f : 0.1f + 0.2f * mtr.Random(); }) };
+    auto setCulling = [](const bool isCullingBeforeClipping)
+    {
+        return [isCullingBeforeClipping](Pipline& pipline) { pipline.GetPSO()->m_isCullingBeforeClipping = isCullingBeforeClipping; };
+    };
+
+    TestSuit::TimeCounter clippedCounter, culledCounter;
+    auto clippedPipline = DrawMeshInstances(renderingBuffer, scene, setCulling(false), clippedCounter);
+    auto culledPipline  = DrawMeshInstances(renderingBuffer, scene, setCulling(true),  culledCounter);
+
+    TEST_ASSERT(CountDifferentPixels(*clippedPipline->m_backBuffer, *culledPipline->m_backBuffer) == 0);
+
+    // about half of the triangles of a closed mesh are back faces.
+    const auto& statistic = culledPipline->GetStatistic();
+    const U32 numTriangles = static_cast<U32>(mesh.indices.size() / 3) * NUM_INSTANCES;
+    TEST_ASSERT(statistic.m_numBackFaceTriangles > numTriangles * 2 / 5 && statistic.m_numBackFaceTriangles < numTriangles * 3 / 5);
+    TEST_ASSERT(statistic.m_numDegeneratedTriangles > 0);
+
+    printf("triangles: %u, back faces: %u, degenerated: %u\n", numTriangles, statistic.m_numBackFaceTriangles, statistic.m_numDegeneratedTriangles);
+    PrintDuration("cull after clipping:", clippedCounter);
+    PrintDuration("cull before clipping:", culledCounter);
+
+    SaveAndShowPiplineBackbuffer((*(culledPipline.get())), L"geosphere_preClipCulling");
+}
+
+void CASE_NAME_IN_RASTER_TRI(OcclusionCulling)::Run()
+{
+    using namespace Types;
+
+    // the pixel centers inside the occluder are written with either winding, then the erosion remove the silhouettes.
+    {
+        bool isThrown = false;
+        try
+        {
+            CoarseDepthBuffer invalidBuffer(6, 8);
+        }
+        catch (const std::exception&)
+        {
+            isThrown = true;
+        }
+        TEST_ASSERT(isThrown);
+
+        CoarseDepthBuffer coarseBuffer(16, 16);
+        for (int winding = 0; winding < 2; ++winding)
+        {
+            coarseBuffer.Clear();
+            if (winding == 0)
+            {
+                coarseBuffer.RasterizeOccluder(0.0f, 0.0f, 16.0f, 0.0f, 0.0f, 16.0f, 0.5f);
+            }
+            else
+            {
+                coarseBuffer.RasterizeOccluder(0.0f, 0.0f, 0.0f, 16.0f, 16.0f, 0.0f, 0.5f);
+            }
+            TEST_ASSERT(coarseBuffer.ValueAt(0, 0)  == 0.5f);
+            TEST_ASSERT(coarseBuffer.ValueAt(7, 7)  == 0.5f);
+            TEST_ASSERT(coarseBuffer.ValueAt(15, 0) == 0.5f);
+            TEST_ASSERT(coarseBuffer.ValueAt(8, 8)  == 1.0f);
+
+            coarseBuffer.ErodeSilhouettes();
+            TEST_ASSERT(coarseBuffer.ValueAt(0, 0)  == 0.5f);
+            TEST_ASSERT(coarseBuffer.ValueAt(6, 6)  == 0.5f);
+            TEST_ASSERT(coarseBuffer.ValueAt(7, 7)  == 1.0f);
+            TEST_ASSERT(coarseBuffer.ValueAt(15, 0) == 1.0f);
+            TEST_ASSERT(  coarseBuffer.IsRectOccluded(0, 0, 3, 3, 0.6f));
+            TEST_ASSERT(! coarseBuffer.IsRectOccluded(0, 0, 3, 3, 0.4f));
+            TEST_ASSERT(! coarseBuffer.IsRectOccluded(5, 5, 9, 6, 0.6f));
+        }
+        // the nearer occluder is kept.
+        coarseBuffer.RasterizeOccluder(0.0f, 0.0f, 8.0f, 0.0f, 0.0f, 8.0f, 0.7f);
+        TEST_ASSERT(coarseBuffer.ValueAt(1, 1) == 0.5f);
+        coarseBuffer.RasterizeOccluder(0.0f, 0.0f, 8.0f, 0.0f, 0.0f, 8.0f, 0.2f);
+        TEST_ASSERT(coarseBuffer.ValueAt(1, 1) == 0.2f);
+    }
+
+    // a city block, a row of buildings in front of a lot of objects.
+    CommonRenderingBuffer renderingBuffer;
+    const auto& buildingMesh    = renderingBuffer.prebuildMeshData[CommonRenderingBuffer::M_CUBE];
+    const auto& objectMesh      = renderingBuffer.prebuildMeshData[CommonRenderingBuffer::M_GEOSPHERE];
+    const Transform toClip      = renderingBuffer.cameraBuffer.m_project * renderingBuffer.cameraBuffer.m_toCamera;
+
+    MeshInstances buildings;
+    buildings.m_pMesh = &buildingMesh;
+    for (int i = -2; i <= 2; ++i)
+    {
+        const vector3 position(2.0f * i, 0.0f, -2.0f);
+        const vector3 scale(0.9f, 3.0f, 0.5f);
+        GraphicToolSet::ConstantBufferForInstance building;
+        building.m_toWorld          = Transform::TRS(position, vector3::ZERO, scale);
+        building.m_toWorldInverse   = Transform::InverseTRS(position, vector3::ZERO, scale);
+        building.m_material         = renderingBuffer.objInstances[1].m_material;
+        buildings.m_instances.push_back(building);
+    }
+    const unsigned int NUM_OBJECTS = 300;
+    MeshInstances objects = BuildRandomInstances(objectMesh, NUM_OBJECTS, renderingBuffer.objInstances[0].m_material,
+        [this](const unsigned int i)
+        {
+            // most of them are behind the buildings, a few are in front.
+            const F32 z = i % 10 == 0 ? mtr.Random() * 2.0f : -5.0f - mtr.Random() * 20.0f;
+            return vector3((mtr.Random() - 0.5f) * 20.0f, (mtr.Random() - 0.5f) * 20.0f, z);
+        },
+        [this](const unsigned int) { return 0.3f + 0.4f * mtr.Random(); });
+    objects.m_isBounded = true;
+    const std::vector<MeshInstances> scene = { buildings, objects };
+    auto drawAll = [&](std::shared_ptr<OcclusionCuller> culler, TestSuit::TimeCounter& counter)
+    {
+        return DrawMeshInstances(renderingBuffer, scene, [culler](Pipline& pipline) { pipline.SetOcclusionCuller(culler); }, counter);
+    };
+
+    TestSuit::TimeCounter allCounter, occluderCounter, culledCounter;
+    auto allPipline = drawAll(nullptr, allCounter);
+
+    // the buildings are the occluders of this frame.
+    auto culler = std::make_shared<OcclusionCuller>(128, 128);
+    {
+        TestSuit::TimeGuard guard(occluderCounter);
+        culler->BeginFrame();
+        for (const auto& building : buildings.m_instances)
+        {
+            culler->RenderOccluder(buildingMesh.indices, buildingMesh.vertexBuffer.get(), sizeof(SimplePoint), toClip * building.m_toWorld);
+        }
+    }
+    auto culledPipline = drawAll(culler, culledCounter);
+
+    // the occluded draws have no visible pixel.
+    TEST_ASSERT(CountDifferentPixels(*allPipline->m_backBuffer, *culledPipline->m_backBuffer) == 0);
+    const auto& statistic = culledPipline->GetStatistic();
+    const auto& cullerStatistic = culler->GetStatistic();
+    TEST_ASSERT(statistic.m_numDraws == buildings.m_instances.size() + NUM_OBJECTS);
+    TEST_ASSERT(statistic.m_numOccludedDraws > NUM_OBJECTS / 10);
+    TEST_ASSERT(statistic.m_numOccludedDraws == cullerStatistic.m_numOccludedDraws);
+    TEST_ASSERT(cullerStatistic.m_numTestedDraws == NUM_OBJECTS - statistic.m_numFrustumCulledDraws);
+    TEST_ASSERT(allPipline->GetStatistic().m_numOccludedDraws == 0);
+
+    printf("draws: %u, frustum culled: %u, occluded: %u, occluder triangles: %u\n",
+        statistic.m_numDraws, statistic.m_numFrustumCulledDraws, statistic.m_numOccludedDraws, cullerStatistic.m_numOccluderTriangles);
+    PrintDuration("without occlusion culling:", allCounter);
+    PrintDuration("occluders:", occluderCounter);
+    PrintDuration("with occlusion culling:", culledCounter);
+
+    // reuse the depth of the previous frame, where the camera was a little to the left.
+    {
+        const F32 FOV_Y = Types::Constant::PI_F * 0.5f;
+        const vector4 pointC(0.3f, -0.2f, -5.0f, 1.0f);
+        TEST_ASSERT(AlmostEqual(Transform::InversePerspectiveFOV(FOV_Y, 1.0f, renderingBuffer.NEAR_F, renderingBuffer.FAR_F) * (renderingBuffer.perspect * pointC), pointC, 1e-4f));
+
+        CameraFrame previousCamera(vector3(-0.3f, 0.1f, 4.0f), vector3(-0.3f, 0.1f, 0.0f));
+        GraphicToolSet::ConstantBufferForCamera previousCameraBuffer = renderingBuffer.cameraBuffer;
+        previousCameraBuffer.SetCameraMatrix(previousCamera);
+
+        auto previousDepth = std::make_shared<DepthBuffer>(graphicToolSet.COMMON_PIXEL_WIDTH, graphicToolSet.COMMON_PIXEL_HEIGHT);
+        previousDepth->SetAll(1.0f);
+        auto depthPipline = graphicToolSet.GetCommonPipline();
+        auto depthPSO = depthPipline->GetPSO();
+        depthPSO->m_vertexLayout.vertexShaderInputSize  = sizeof(SimplePoint);
+        depthPSO->m_vertexLayout.pixelShaderInputSize   = sizeof(GraphicToolSet::PSIn);
+        depthPSO->m_vertexShader    = graphicToolSet.GetVertexShaderWithVSOut(instanceBufAgent, previousCameraBuffer);
+        depthPSO->m_primitiveType   = PrimitiveType::TRIANGLE_LIST;
+        depthPSO->m_cullFace        = CullFace::CLOCK_WISE;
+        depthPSO->m_isDepthOnly     = true;
+        depthPipline->SetDepthTarget(previousDepth);
+        for (const auto& building : buildings.m_instances)
+        {
+            instanceBufAgent = building;
+            depthPipline->DrawInstance(buildingMesh.indices, buildingMesh.vertexBuffer.get());
+        }
+
+        const Transform previousClipToCurrentClip = toClip * previousCamera.LocalToWorld()
+            * Transform::InversePerspectiveFOV(FOV_Y, 1.0f, renderingBuffer.NEAR_F, renderingBuffer.FAR_F);
+        auto reprojectedCuller = std::make_shared<OcclusionCuller>(128, 128);
+        TestSuit::TimeCounter reprojectCounter, reprojectedCounter;
+        {
+            TestSuit::TimeGuard guard(reprojectCounter);
+            reprojectedCuller->BeginFrame();
+            reprojectedCuller->ReprojectPreviousDepth(*previousDepth, previousClipToCurrentClip);
+        }
+        auto reprojectedPipline = drawAll(reprojectedCuller, reprojectedCounter);
+
+        // a gap between the buildings is hidden in the previous frame, and the objects seen through it may be culled.
+        const unsigned int numDifferentPixels = CountDifferentPixels(*allPipline->m_backBuffer, *reprojectedPipline->m_backBuffer);
+        TEST_ASSERT(numDifferentPixels < graphicToolSet.COMMON_PIXEL_WIDTH * graphicToolSet.COMMON_PIXEL_HEIGHT / 1000);
+        TEST_ASSERT(reprojectedPipline->GetStatistic().m_numOccludedDraws > NUM_OBJECTS / 10);
+
+        printf("occluded by the previous depth: %u, different pixels: %u\n", reprojectedPipline->GetStatistic().m_numOccludedDraws, numDifferentPixels);
+        PrintDuration("reproject the previous depth:", reprojectCounter);
+    }
+
+    Image coarseDepthImage = ToImage(culler->GetDepthBuffer(), 1.0f);
+    SaveAndShow(coarseDepthImage, L"occlusionCulling_coarseDepth");
+    SaveAndShowPiplineBackbuffer((*(culledPipline.get())), L"occlusionCulling");
+}
+
+void CASE_NAME_IN_RASTER_TRI(BatchVertexShader)::Run()
+{
+    using namespace Types;
+
+    CommonRenderingBuffer renderingBuffer;
+    GraphicToolSet::ConstantBufferForInstance   instanceBufAgent = renderingBuffer.instanceBuffers[1];
+
+    const auto& mesh = renderingBuffer.prebuildMeshData[CommonRenderingBuffer::M_GEOSPHERE];
+    const unsigned int srcStride    = sizeof(SimplePoint);
+    const unsigned int destStride   = sizeof(GraphicToolSet::VSOut);
+    const unsigned int numVertices  = mesh.vertexBuffer->GetSizeOfByte() / srcStride;
+    const unsigned char * pSrc      = mesh.vertexBuffer->GetBuffer();
+
+    auto vertexShader       = graphicToolSet.GetVertexShaderWithVSOut(instanceBufAgent, renderingBuffer.cameraBuffer);
+    auto batchVertexShader  = graphicToolSet.GetBatchVertexShaderWithVSOut(instanceBufAgent, renderingBuffer.cameraBuffer);
+
+    std::vector<GraphicToolSet::VSOut> vertexOut(numVertices);
+    std::vector<GraphicToolSet::VSOut> batchOut(numVertices);
+
+    // the batch shader must have the same output as the vertex by vertex shader.
+    const unsigned int NUM_LOOPS = 200;
+    TestSuit::TimeCounter vertexCounter, batchCounter;
+    for (unsigned int loop = 0; loop < NUM_LOOPS; ++loop)
+    {
+        {
+            TestSuit::TimeGuard guard(vertexCounter);
+            for (unsigned int i = 0; i < numVertices; ++i)
+            {
+                vertexShader(pSrc + i * srcStride, reinterpret_cast<ScreenSpaceVertexTemplate*>(&vertexOut[i]));
+            }
+        }
+        {
+            TestSuit::TimeGuard guard(batchCounter);
+            batchVertexShader(pSrc, srcStride, reinterpret_cast<ScreenSpaceVertexTemplate*>(batchOut.data()), destStride, numVertices);
+        }
+    }
+
+    for (unsigned int i = 0; i < numVertices; ++i)
+    {
+        TEST_ASSERT(AlmostEqual(vertexOut[i].m_posH,    batchOut[i].m_posH,     1e-4f));
+        TEST_ASSERT(AlmostEqual(vertexOut[i].m_posW,    batchOut[i].m_posW,     1e-4f));
+        TEST_ASSERT(AlmostEqual(vertexOut[i].m_normalW, batchOut[i].m_normalW,  1e-4f));
+        TEST_ASSERT(vertexOut[i].m_uv.m_x == batchOut[i].m_uv.m_x && vertexOut[i].m_uv.m_y == batchOut[i].m_uv.m_y);
+    }
+
+    const double vertexSeconds  = std::chrono::duration<double>(vertexCounter.m_sumDuration).count();
+    const double batchSeconds   = std::chrono::duration<double>(batchCounter.m_sumDuration).count();
+    printf("vertex shader: %8.2f M vertices/s\n", static_cast<double>(NUM_LOOPS) * numVertices / vertexSeconds * 1e-6);
+    printf("batch  shader: %8.2f M vertices/s\n", static_cast<double>(NUM_LOOPS) * numVertices / batchSeconds * 1e-6);
+
+    // draw with the batch shader, the picture should be same as the PixelShading case.
+    auto pipline = graphicToolSet.GetCommonPipline();
+    std::shared_ptr<CommonClass::PiplineStateObject> PSO = pipline->GetPSO();
+    PSO->m_vertexLayout.vertexShaderInputSize = sizeof(SimplePoint);
+    PSO->m_vertexLayout.pixelShaderInputSize = sizeof(GraphicToolSet::PSIn);
+    PSO->m_batchVertexShader = batchVertexShader;
+    PSO->m_pixelShader = graphicToolSet.GetPixelShaderWithPSIn(instanceBufAgent, renderingBuffer.cameraBuffer);
+    PSO->m_primitiveType = PrimitiveType::TRIANGLE_LIST;
+    PSO->m_cullFace = CullFace::CLOCK_WISE;
+    PSO->m_fillMode = FillMode::SOLIDE;
+    for (unsigned int i = 0; i < renderingBuffer.instanceBuffers.size(); ++i)
+    {
+        instanceBufAgent = renderingBuffer.instanceBuffers[i];
+        COUNT_DETAIL_TIME;
+        pipline->DrawInstance(mesh.indices, mesh.vertexBuffer.get());
+    }
+
+    SaveAndShowPiplineBackbuffer((*(pipline.get())), L"geosphere_batchVertexShader");
+}
+
+void CASE_NAME_IN_RASTER_TRI(FixedPointRasterizer)::Run()
+{
+    using namespace Types;
+
+    const I32 WIDTH  = graphicToolSet.COMMON_PIXEL_WIDTH;
+    const I32 HEIGHT = graphicToolSet.COMMON_PIXEL_HEIGHT;
+
+    // a jittered grid, the inner vertices have random locations on the quarter pixel grid,
+    // so a lot of pixel centers lie exactly on the shared edges. The border vertices are fixed.
+    const unsigned int  NUM_CELLS   = 24;
+    const F32           BORDER_MIN  = 16.25f;
+    const F32           BORDER_MAX  = 495.75f;
+    const F32           CELL_SIZE   = (BORDER_MAX - BORDER_MIN) / NUM_CELLS;
+    std::vector<vector4> gridPoints;
+    for (unsigned int row = 0; row <= NUM_CELLS; ++row)
+    {
+        for (unsigned int col = 0; col <= NUM_CELLS; ++col)
+        {
+            const bool isBorder = row == 0 || col == 0 || row == NUM_CELLS || col == NUM_CELLS;
+            const F32 jitterX = isBorder ? 0.0f : (mtr.Random() - 0.5f) * CELL_SIZE * 0.6f;
+            const F32 jitterY = isBorder ? 0.0f : (mtr.Random() - 0.5f) * CELL_SIZE * 0.6f;
+            gridPoints.push_back(vector4(
+                std::round((BORDER_MIN + col * CELL_SIZE + jitterX) * 4.0f) * 0.25f,
+                std::round((BORDER_MIN + row * CELL_SIZE + jitterY) * 4.0f) * 0.25f,
+                0.0f, 1.0f));
+        }
+    }
+
+    // two triangles for each cell, with random winding.
+    std::vector<std::array<vector4, 3>> triangles;
+    for (unsigned int row = 0; row < NUM_CELLS; ++row)
+    {
+        for (unsigned int col = 0; col < NUM_CELLS; ++col)
+        {
+            const vector4& p00 = gridPoints[row * (NUM_CELLS + 1) + col];
+            const vector4& p10 = gridPoints[row * (NUM_CELLS + 1) + col + 1];
+            const vector4& p01 = gridPoints[(row + 1) * (NUM_CELLS + 1) + col];
+            const vector4& p11 = gridPoints[(row + 1) * (NUM_CELLS + 1) + col + 1];
+            if (mtr.Random() < 0.5f)
+            {
+                triangles.push_back({ p00, p10, p11 });
+                triangles.push_back({ p00, p11, p01 });
+            }
+            else
+            {
+                triangles.push_back({ p00, p01, p11 });
+                triangles.push_back({ p00, p11, p10 });
+            }
+        }
+    }
+
+    // count how many times each pixel is shaded,
+    // the interpolated m_posH of the pixel shader input is the sample location.
+    std::vector<U32> coverage(WIDTH * HEIGHT);
+    vector4 triangleColor;
+    auto drawAllTriangles = [&](RasterizeMode mode, TestSuit::TimeCounter& counter)->std::unique_ptr<Pipline>
+    {
+        auto pipline = graphicToolSet.GetCommonPipline();
+        auto pso = pipline->GetPSO();
+        pso->m_rasterizeMode = mode;
+        pso->m_pixelShader = [&](const ScreenSpaceVertexTemplate* pVertex)->vector4 {
+            const I32 x = static_cast<I32>(std::lround(pVertex->m_posH.m_x));
+            const I32 y = static_cast<I32>(std::lround(pVertex->m_posH.m_y));
+            ++coverage[y * WIDTH + x];
+            return triangleColor;
+        };
+
+        Viewport viewport;
+        viewport.left   = 0;
+        viewport.right  = WIDTH - 1.0f;
+        viewport.bottom = 0;
+        viewport.top    = HEIGHT - 1.0f;
+        pso->SetViewport(viewport);
+
+        std::fill(coverage.begin(), coverage.end(), 0);
+        TestSuit::TimeGuard guard(counter);
+        for (size_t i = 0; i < triangles.size(); ++i)
+        {
+            // the later triangle is always closer (w store the 1/z), so every covered pixel pass the depth test.
+            std::array<vector4, 3> triv = triangles[i];
+            for (auto& v : triv)
+            {
+                v.m_w = 1.0f + i;
+            }
+            triangleColor = vector4(mtr.Random(), mtr.Random(), mtr.Random(), 1.0f);
+            pipline->DrawTriangle(
+                reinterpret_cast<ScreenSpaceVertexTemplate*>(&triv[0]),
+                reinterpret_cast<ScreenSpaceVertexTemplate*>(&triv[1]),
+                reinterpret_cast<ScreenSpaceVertexTemplate*>(&triv[2]),
+                sizeof(vector4));
+        }
+        return pipline;
+    };
+
+    // the pixels inside the grid should be shaded exactly once, the others should not be shaded.
+    auto countWrongPixels = [&]()->unsigned int
+    {
+        unsigned int numWrongPixels = 0;
+        for (I32 y = 0; y < HEIGHT; ++y)
+        {
+            for (I32 x = 0; x < WIDTH; ++x)
+            {
+                const bool isInside = BORDER_MIN < x && x < BORDER_MAX && BORDER_MIN < y && y < BORDER_MAX;
+                numWrongPixels += coverage[y * WIDTH + x] != (isInside ? 1u : 0u);
+            }
+        }
+        return numWrongPixels;
+    };
+
+    // the float rasterizer may shade the pixels on the shared edges twice, or miss them.
+    TestSuit::TimeCounter floatCounter, fixedCounter;
+    drawAllTriangles(FLOAT_POINT, floatCounter);
+    const unsigned int floatWrongPixels = countWrongPixels();
+
+    auto pipline = drawAllTriangles(FIXED_POINT_SUBPIXEL, fixedCounter);
+    const unsigned int fixedWrongPixels = countWrongPixels();
+    TEST_ASSERT(fixedWrongPixels == 0);
+
+    printf("float point: %u pixels shaded wrong times, %lld %s\n",
+        floatWrongPixels, floatCounter.m_sumDuration.count(), floatCounter.DURATION_TYPE_NAME.c_str());
+    printf("fixed point: %u pixels shaded wrong times, %lld %s\n",
+        fixedWrongPixels, fixedCounter.m_sumDuration.count(), fixedCounter.DURATION_TYPE_NAME.c_str());
+
+    SaveAndShowPiplineBackbuffer((*(pipline.get())), L"fixedPointRasterizer");
+}
@@ -43,6 +43,20 @@ DECLARE_CASE_IN_RASTER_TRI_FOR(NoiseBumpMap, "noise normal from a texture");
 
 DECLARE_CASE_IN_RASTER_TRI_FOR(ShadowMap, "noise normal from a texture");
 
+DECLARE_CASE_IN_RASTER_TRI_FOR(DepthOnlyShadowMap, "depth only pass for the shadow map");
+
+DECLARE_CASE_IN_RASTER_TRI_FOR(CascadedShadowMap, "cascaded shadow maps of a directional light with PCF");
+
+DECLARE_CASE_IN_RASTER_TRI_FOR(FrustumCulling, "cull the draws by the bounding boxes before the vertex shader");
+
+DECLARE_CASE_IN_RASTER_TRI_FOR(PreClipCulling, "cull the back faces and the degenerated triangles before clipping");
+
+DECLARE_CASE_IN_RASTER_TRI_FOR(OcclusionCulling, "cull the draws hidden by the occluders in a coarse depth buffer");
+
+DECLARE_CASE_IN_RASTER_TRI_FOR(BatchVertexShader, "batch vertex shader with concatenated matrices");
+
+DECLARE_CASE_IN_RASTER_TRI_FOR(FixedPointRasterizer, "fixed point subpixel rasterizer with top-left fill rule");
+
 using SuitForRasterizeTriangle = SuitForPipline<
     CASE_NAME_IN_RASTER_TRI(DrawTriInScreenSpace),
     CASE_NAME_IN_RASTER_TRI(SphereRayTriangle),
@@ -57,6 +71,13 @@ using SuitForRasterizeTriangle = SuitForPipline<
     CASE_NAME_IN_RASTER_TRI(PixelShading),
     CASE_NAME_IN_RASTER_TRI(TextureMapping),
     CASE_NAME_IN_RASTER_TRI(NoiseBumpMap),
-    CASE_NAME_IN_RASTER_TRI(ShadowMap)
+    CASE_NAME_IN_RASTER_TRI(ShadowMap),
+    CASE_NAME_IN_RASTER_TRI(DepthOnlyShadowMap),
+    CASE_NAME_IN_RASTER_TRI(CascadedShadowMap),
+    CASE_NAME_IN_RASTER_TRI(FrustumCulling),
+    CASE_NAME_IN_RASTER_TRI(PreClipCulling),
+    CASE_NAME_IN_RASTER_TRI(OcclusionCulling),
+    CASE_NAME_IN_RASTER_TRI(BatchVertexShader),
+    CASE_NAME_IN_RASTER_TRI(FixedPointRasterizer)
 >;
 
@@ -518,3 +518,310 @@ void CASE_NAME_IN_RAY_RENDER(TrasparentMat)::Run()
     ImageWindow imgWnd(camera.m_film.get(), pictureName);
     imgWnd.BlockShow();
 }
+
+void CASE_NAME_IN_RAY_RENDER(Wavefront)::Run()
+{
+    Scene scene;
+    BuildSimpleRayTraceScene(&scene);
+
+    vector3 camPosition = vector3(0.0f, 3.6f, 8.0f);
+    vector3 camTarget = vector3(0.0f, 2.145f, 0.0f);
+    vector3 camLookUp = vector3(0.0f, 1.0f, 0.0f);
+    Types::F32 focalLength = 1.0f;
+
+    PerspectiveCamera recursiveCamera(focalLength, camPosition, camTarget, camLookUp);
+    PerspectiveCamera wavefrontCamera(focalLength, camPosition, camTarget, camLookUp);
+
+    recursiveCamera.SetFilm(std::make_unique<Film>(
+        graphicToolSet.COMMON_PIXEL_WIDTH, graphicToolSet.COMMON_PIXEL_HEIGHT,
+        -0.5f, +0.5f,
+        -0.5f, +0.5f));
+    wavefrontCamera.SetFilm(std::make_unique<Film>(
+        graphicToolSet.COMMON_PIXEL_WIDTH, graphicToolSet.COMMON_PIXEL_HEIGHT,
+        -0.5f, +0.5f,
+        -0.5f, +0.5f));
+
+    const unsigned int PIXEL_WIDTH = recursiveCamera.m_film->GetWidth();
+    const unsigned int PIXEL_HEIGHT = recursiveCamera.m_film->GetHeight();
+
+    TestSuit::TimeCounter recursiveTime, wavefrontTime;
+    {
+        TestSuit::TimeGuard guard(recursiveTime);
+        for (unsigned int i = 0; i < PIXEL_WIDTH; ++i)
+        {
+            for (unsigned int j = 0; j < PIXEL_HEIGHT; ++j)
+            {
+                Ray viewRay = recursiveCamera.GetRay(static_cast<Types::F32>(i), static_cast<Types::F32>(j));
+                recursiveCamera.IncomeLight(i, j, scene.RayColor(viewRay, 0.0f, 1000.0f));
+            }
+        }
+    }
+
+    {
+        TestSuit::TimeGuard guard(wavefrontTime);
+        WavefrontRenderer renderer(scene);
+        renderer.Render(wavefrontCamera);
+    }
+
+    printf("recursive render: %lld %s, wavefront render: %lld %s\n",
+        recursiveTime.m_sumDuration.count(), recursiveTime.DURATION_TYPE_NAME.c_str(),
+        wavefrontTime.m_sumDuration.count(), wavefrontTime.DURATION_TYPE_NAME.c_str());
+
+    // the wavefront renderer should give the same image as the recursive one.
+    for (unsigned int i = 0; i < PIXEL_WIDTH; ++i)
+    {
+        for (unsigned int j = 0; j < PIXEL_HEIGHT; ++j)
+        {
+            TEST_ASSERT(AlmostEqual(recursiveCamera.m_film->GetPixel(i, j), wavefrontCamera.m_film->GetPixel(i, j), 1e-5f));
+        }
+    }
+
+    SaveAndShow(*wavefrontCamera.m_film, L"wavefront_001");
+}
+
+void CASE_NAME_IN_RAY_RENDER(AdaptiveSampling)::Run()
+{
+    Scene scene;
+    BuildSimpleRayTraceScene(&scene);
+
+    vector3 camPosition = vector3(0.0f, 3.6f, 8.0f);
+    vector3 camTarget = vector3(0.0f, 2.145f, 0.0f);
+    vector3 camLookUp = vector3(0.0f, 1.0f, 0.0f);
+    Types::F32 focalLength = 1.0f;
+
+    PerspectiveCamera fixedCamera(focalLength, camPosition, camTarget, camLookUp);
+    PerspectiveCamera adaptiveCamera(focalLength, camPosition, camTarget, camLookUp);
+
+    fixedCamera.SetFilm(std::make_unique<Film>(
+        graphicToolSet.COMMON_PIXEL_WIDTH, graphicToolSet.COMMON_PIXEL_HEIGHT,
+        -0.5f, +0.5f,
+        -0.5f, +0.5f));
+    adaptiveCamera.SetFilm(std::make_unique<Film>(
+        graphicToolSet.COMMON_PIXEL_WIDTH, graphicToolSet.COMMON_PIXEL_HEIGHT,
+        -0.5f, +0.5f,
+        -0.5f, +0.5f));
+
+    const unsigned int PIXEL_WIDTH = fixedCamera.m_film->GetWidth();
+    const unsigned int PIXEL_HEIGHT = fixedCamera.m_film->GetHeight();
+
+    // same fixed grid as the TrasparentMat case.
+    const int sampleSquareLen = 4;
+    const float recipoSSL = 1.0f / sampleSquareLen;
+    const float sqRecipoSSL = recipoSSL * recipoSSL;
+
+    TestSuit::TimeCounter fixedTime, adaptiveTime;
+    {
+        TestSuit::TimeGuard guard(fixedTime);
+        for (unsigned int i = 0; i < PIXEL_WIDTH; ++i)
+        {
+            for (unsigned int j = 0; j < PIXEL_HEIGHT; ++j)
+            {
+                vector3 color = vector3::ZERO;
+                for (int p = 0; p < sampleSquareLen; ++p)
+                {
+                    for (int q = 0; q < sampleSquareLen; ++q)
+                    {
+                        Ray viewRay = fixedCamera.GetRay(i + (p + mtr.Random()) * recipoSSL, j + (q + mtr.Random()) * recipoSSL);
+                        color = color + scene.RayColor(viewRay, 0.0f, 1000.0f, 5);
+                    }
+                }
+                fixedCamera.IncomeLight(i, j, color * sqRecipoSSL);
+            }
+        }
+    }
+
+    AdaptiveSampler sampler;
+    sampler.m_maxSamples = sampleSquareLen * sampleSquareLen;
+    {
+        TestSuit::TimeGuard guard(adaptiveTime);
+        sampler.Render(adaptiveCamera, [&scene](const Ray& ray)
+        {
+            return scene.RayColor(ray, 0.0f, 1000.0f, 5);
+        });
+    }
+
+    const unsigned int fixedSampleCount = PIXEL_WIDTH * PIXEL_HEIGHT * sampleSquareLen * sampleSquareLen;
+    printf("fixed grid: %u samples, %lld %s; adaptive: %u samples, %lld %s\n",
+        fixedSampleCount,                   fixedTime.m_sumDuration.count(),    fixedTime.DURATION_TYPE_NAME.c_str(),
+        sampler.GetTotalSampleCount(),      adaptiveTime.m_sumDuration.count(), adaptiveTime.DURATION_TYPE_NAME.c_str());
+
+    // the flat pixels should only take the initial samples.
+    TEST_ASSERT(sampler.GetTotalSampleCount() < fixedSampleCount);
+
+    // the average difference to the fixed grid should be small.
+    Types::F32 sumDiff = 0.0f;
+    for (unsigned int i = 0; i < PIXEL_WIDTH; ++i)
+    {
+        for (unsigned int j = 0; j < PIXEL_HEIGHT; ++j)
+        {
+            const vector4 diff = fixedCamera.m_film->GetPixel(i, j) - adaptiveCamera.m_film->GetPixel(i, j);
+            sumDiff += std::abs(diff.m_x) + std::abs(diff.m_y) + std::abs(diff.m_z);
+        }
+    }
+    TEST_ASSERT(sumDiff / (PIXEL_WIDTH * PIXEL_HEIGHT * 3) < 0.01f);
+
+    SaveAndShow(*adaptiveCamera.m_film, L"adaptive_sampling_001");
+}
+
+void CASE_NAME_IN_RAY_RENDER(ProgressiveRendering)::Run()
+{
+    Scene scene;
+    BuildSimpleRayTraceScene(&scene);
+
+    vector3 camPosition = vector3(0.0f, 3.6f, 8.0f);
+    vector3 camTarget = vector3(0.0f, 2.145f, 0.0f);
+    vector3 camLookUp = vector3(0.0f, 1.0f, 0.0f);
+
+    PerspectiveCamera camera(1.0f, camPosition, camTarget, camLookUp);
+    camera.SetFilm(std::make_unique<Film>(
+        graphicToolSet.COMMON_PIXEL_WIDTH, graphicToolSet.COMMON_PIXEL_HEIGHT,
+        -0.5f, +0.5f,
+        -0.5f, +0.5f));
+
+    auto radiance = [&scene](const Ray& ray)
+    {
+        return scene.RayColor(ray, 0.0f, 1000.0f, 5);
+    };
+
+    ProgressiveRenderer renderer;
+    renderer.m_maxSamples = 4;
+
+    // a very short budget, only part of the passes can be done.
+    const std::chrono::milliseconds budget(20);
+    ProgressiveRenderer::Statistic previewStat = renderer.Render(camera, radiance, budget);
+    printf("preview: %u passes, min %u samples, %f ms for budget %lld ms\n",
+        previewStat.m_completedPasses, previewStat.m_minSamples, previewStat.m_elapsedMs, static_cast<long long>(budget.count()));
+
+    // the preview either stop at the deadline with some samples left, or finish all of them before it.
+    TEST_ASSERT(previewStat.m_isFinished != previewStat.m_isDeadlineReached);
+    if (previewStat.m_isDeadlineReached)
+    {
+        TEST_ASSERT(previewStat.m_minSamples < renderer.m_maxSamples);
+    }
+    else
+    {
+        TEST_ASSERT(previewStat.m_minSamples == renderer.m_maxSamples);
+    }
+    SaveAndShow(*camera.m_film, L"progressive_preview");
+
+    // continue without deadline, all the pixels should reach the max samples.
+    ProgressiveRenderer::Statistic finalStat = renderer.Refine(camera, radiance, ProgressiveRenderer::Clock::time_point::max());
+    printf("final: %u passes, min %u samples, %f ms\n",
+        finalStat.m_completedPasses, finalStat.m_minSamples, finalStat.m_elapsedMs);
+
+    TEST_ASSERT(finalStat.m_isFinished && ! finalStat.m_isDeadlineReached);
+    TEST_ASSERT(finalStat.m_minSamples == renderer.m_maxSamples);
+    SaveAndShow(*camera.m_film, L"progressive_final");
+}
+
+void CASE_NAME_IN_RAY_RENDER(Instancing)::Run()
+{
+    auto material = std::make_shared<Material>(vector3(0.3f, 0.8f, 0.4f), 8, 4.0f);
+
+    // the shared object, a pyramid made of four triangles.
+    const std::array<vector3, 5> corners = {
+        vector3(-0.5f, 0.0f, -0.5f), vector3(+0.5f, 0.0f, -0.5f),
+        vector3(+0.5f, 0.0f, +0.5f), vector3(-0.5f, 0.0f, +0.5f),
+        vector3( 0.0f, 1.0f,  0.0f) };
+    std::vector<std::array<vector3, 3>> faces;
+    for (int i = 0; i < 4; ++i)
+    {
+        faces.push_back({ corners[i], corners[(i + 1) % 4], corners[4] });
+    }
+
+    std::vector<std::shared_ptr<Surface>> primitives;
+    for (auto & face : faces)
+    {
+        auto tri = std::make_shared<Triangle>(face[0], face[1], face[2]);
+        tri->m_material = material;
+        primitives.push_back(tri);
+    }
+    auto sharedObject = std::make_shared<BVH>(primitives);
+
+    // the same pyramids are placed in two scenes, by copies and by instances.
+    Scene copyScene, instanceScene;
+    std::vector<std::shared_ptr<Surface>> instances;
+    const int NUM_SIDE = 16;
+    for (int i = 0; i < NUM_SIDE; ++i)
+    {
+        for (int j = 0; j < NUM_SIDE; ++j)
+        {
+            const vector3 t((i - NUM_SIDE / 2) * 1.5f, 0.0f, -j * 1.5f);
+            const vector3 r(0.0f, mtr.Random() * Types::Constant::PI_F, 0.0f);
+            const vector3 s(1.0f, 0.5f + mtr.Random(), 1.0f);
+
+            const Transform objectToWorld = Transform::TRS(t, r, s);
+            for (auto & face : faces)
+            {
+                auto tri = std::make_unique<Triangle>(
+                    vector3(objectToWorld * face[0].Tovector4(1.0f)),
+                    vector3(objectToWorld * face[1].Tovector4(1.0f)),
+                    vector3(objectToWorld * face[2].Tovector4(1.0f)));
+                tri->m_material = material;
+                copyScene.Add(std::move(tri));
+            }
+
+            instances.push_back(std::make_shared<Instance>(sharedObject, t, r, s));
+        }
+    }
+    instanceScene.Add(std::make_unique<BVH>(instances));
+
+    for (Scene * pScene : { &copyScene, &instanceScene })
+    {
+        pScene->Add(std::make_unique<Light>(vector3(0.0f, 10.0f, 5.0f), vector3::WHITE * 0.8f));
+    }
+
+    vector3 camPosition = vector3(0.0f, 4.0f, 6.0f);
+    vector3 camTarget = vector3(0.0f, 0.0f, -8.0f);
+    vector3 camLookUp = vector3(0.0f, 1.0f, 0.0f);
+
+    PerspectiveCamera camera(1.0f, camPosition, camTarget, camLookUp);
+    camera.SetFilm(std::make_unique<Film>(
+        graphicToolSet.COMMON_PIXEL_WIDTH, graphicToolSet.COMMON_PIXEL_HEIGHT,
+        -0.5f, +0.5f,
+        -0.5f, +0.5f));
+
+    const unsigned int PIXEL_WIDTH = camera.m_film->GetWidth();
+    const unsigned int PIXEL_HEIGHT = camera.m_film->GetHeight();
+
+    // the closest hits of the two scenes should be the same.
+    TestSuit::TimeCounter copyTime, instanceTime;
+    for (unsigned int i = 0; i < PIXEL_WIDTH; ++i)
+    {
+        for (unsigned int j = 0; j < PIXEL_HEIGHT; ++j)
+        {
+            Ray viewRay = camera.GetRay(static_cast<Types::F32>(i), static_cast<Types::F32>(j));
+            HitRecord copyRec, instanceRec;
+            bool isCopyHit, isInstanceHit;
+            {
+                TestSuit::TimeGuard guard(copyTime);
+                isCopyHit = copyScene.Hit(viewRay, 0.0f, 1000.0f, &copyRec);
+            }
+            {
+                TestSuit::TimeGuard guard(instanceTime);
+                isInstanceHit = instanceScene.Hit(viewRay, 0.0f, 1000.0f, &instanceRec);
+            }
+
+            TEST_ASSERT(isCopyHit == isInstanceHit);
+            if (isCopyHit && isInstanceHit)
+            {
+                TEST_ASSERT(std::abs(copyRec.m_hitT - instanceRec.m_hitT) < 1e-3f);
+                TEST_ASSERT(Length(copyRec.m_normal - instanceRec.m_normal) < 1e-3f);
+            }
+        }
+    }
+    printf("%d pyramids, copies: %lld %s, instances: %lld %s\n", NUM_SIDE * NUM_SIDE,
+        copyTime.m_sumDuration.count(),     copyTime.DURATION_TYPE_NAME.c_str(),
+        instanceTime.m_sumDuration.count(), instanceTime.DURATION_TYPE_NAME.c_str());
+
+    for (unsigned int i = 0; i < PIXEL_WIDTH; ++i)
+    {
+        for (unsigned int j = 0; j < PIXEL_HEIGHT; ++j)
+        {
+            Ray viewRay = camera.GetRay(static_cast<Types::F32>(i), static_cast<Types::F32>(j));
+            camera.IncomeLight(i, j, instanceScene.RayColor(viewRay, 0.0f, 1000.0f));
+        }
+    }
+
+    SaveAndShow(*camera.m_film, L"instancing");
+}
@@ -18,7 +18,19 @@ DECLARE_CASE_IN_RAY_RENDER_FOR(InsideBoxesAndSphere, "render inside boxes and sp
 
 DECLARE_CASE_IN_RAY_RENDER_FOR(TrasparentMat, "transparent material");
 
+DECLARE_CASE_IN_RAY_RENDER_FOR(Wavefront, "wavefront ray tracing");
+
+DECLARE_CASE_IN_RAY_RENDER_FOR(AdaptiveSampling, "adaptive supersampling");
+
+DECLARE_CASE_IN_RAY_RENDER_FOR(ProgressiveRendering, "progressive rendering with deadline");
+
+DECLARE_CASE_IN_RAY_RENDER_FOR(Instancing, "two level instancing with BVH");
+
 using SuitForRayRender = SuitForPipline<
     //CASE_NAME_IN_RAY_RENDER(InsideBoxesAndSphere),
-    CASE_NAME_IN_RAY_RENDER(TrasparentMat)
+    CASE_NAME_IN_RAY_RENDER(TrasparentMat),
+    CASE_NAME_IN_RAY_RENDER(Wavefront),
+    CASE_NAME_IN_RAY_RENDER(AdaptiveSampling),
+    CASE_NAME_IN_RAY_RENDER(ProgressiveRendering),
+    CASE_NAME_IN_RAY_RENDER(Instancing)
 >;
\ No newline at end of file
@@ -1,5 +1,10 @@
 #include "CaseAndSuitForStbImage.h"
 
+extern "C"
+{
+#include "../CommonClasses/Utils/stb_image.h"
+}
+
 void CASE_NAME_IN_STB_IMG(TextureLoad)::Run()
 {
     Texture tex;
@@ -111,3 +116,94 @@ void CASE_NAME_IN_STB_IMG(NoiseVecTexture)::Run()
     this->BlockShowImg(&img, L"noise vector3 texture");
     img.SaveTo(GetSafeStoragePath() + L"noiseVector3_06.png");
 }
+
+void CASE_NAME_IN_STB_IMG(PngEncoder)::Run()
+{
+    using namespace Types;
+
+    // the known check values.
+    const U8 IEND[] = { 'I', 'E', 'N', 'D' };
+    TEST_ASSERT(PngEncoder::Crc32(IEND, 4) == 0xAE426082u);
+    const U8 WIKIPEDIA[] = { 'W', 'i', 'k', 'i', 'p', 'e', 'd', 'i', 'a' };
+    TEST_ASSERT(PngEncoder::Adler32(WIKIPEDIA, 9) == 0x11E60398u);
+
+    // a frame like image, smooth gradients, flat areas, some noise.
+    auto makeFrame = [this](const U32 width, const U32 height, const F32 noise)
+    {
+        Image img(width, height);
+        for (U32 y = 0; y < height; ++y)
+        {
+            for (U32 x = 0; x < width; ++x)
+            {
+                const F32 dx = x - width * 0.5f, dy = y - height * 0.4f;
+                const bool inCircle = dx * dx + dy * dy < height * height * 0.09f;
+                const vector4 background(x * 1.0f / width, y * 1.0f / height, 0.5f, 1.0f);
+                const vector4 color = inCircle ? vector4(0.9f, 0.3f, 0.2f, 1.0f) : background;
+                img.SetPixel(x, y, vector4(
+                    color.m_x + noise * (mtr.Random() - 0.5f),
+                    color.m_y + noise * (mtr.Random() - 0.5f),
+                    color.m_z + noise * (mtr.Random() - 0.5f),
+                    color.m_w));
+            }
+        }
+        img.FloatPixelToBytePixel();
+        return img;
+    };
+
+    // each mode is decoded to the same pixels.
+    auto roundTrip = [](const std::vector<U8>& png, const U8* rgba, const U32 width, const U32 height)
+    {
+        int decodedWidth = 0, decodedHeight = 0, numChannels = 0;
+        stbi_uc* decoded = stbi_load_from_memory(png.data(), static_cast<int>(png.size()), &decodedWidth, &decodedHeight, &numChannels, 4);
+        const bool isSame = decoded != nullptr
+            && decodedWidth == static_cast<int>(width) && decodedHeight == static_cast<int>(height)
+            && std::equal(rgba, rgba + width * height * 4, decoded);
+        stbi_image_free(decoded);
+        return isSame;
+    };
+
+    const PngEncoder::Compression MODES[] = { PngEncoder::STORE_COMPRESSION, PngEncoder::FAST_COMPRESSION, PngEncoder::SMALL_COMPRESSION };
+    const char* MODE_NAMES[] = { "store", "fast", "small" };
+    for (const F32 noise : { 0.0f, 0.02f, 1.0f })
+    {
+        Image img = makeFrame(301, 177, noise);
+        const U8* rgba = img.GetRawData();
+        std::size_t sizes[3];
+        for (U32 mode = 0; mode < 3; ++mode)
+        {
+            PngEncoder encoder(MODES[mode]);
+            // small chunks, so the image is split into several chunks.
+            encoder.m_chunkBytes = 16 * 1024;
+            const std::vector<U8> png = encoder.Encode(rgba, img.GetWidth(), img.GetHeight());
+            TEST_ASSERT(roundTrip(png, rgba, img.GetWidth(), img.GetHeight()));
+            sizes[mode] = png.size();
+
+            // the result does not depend on the thread count.
+            encoder.m_numThreads = 1;
+            TEST_ASSERT(encoder.Encode(rgba, img.GetWidth(), img.GetHeight()) == png);
+        }
+        // the noise cannot be compressed, it falls back to the stored blocks.
+        TEST_ASSERT(sizes[1] <= sizes[0] && sizes[2] <= sizes[1]);
+        printf("PNG of 301x177 with noise %.2f, store: %zu, fast: %zu, small: %zu bytes\n", noise, sizes[0], sizes[1], sizes[2]);
+    }
+
+    // the tiny images.
+    for (const U32 side : { 1u, 2u, 7u })
+    {
+        Image tiny = makeFrame(side, side, 0.5f);
+        TEST_ASSERT(roundTrip(PngEncoder().Encode(tiny.GetRawData(), side, side), tiny.GetRawData(), side, side));
+    }
+
+    // the throughput of a 1080p frame.
+    Image frame = makeFrame(1920, 1080, 0.02f);
+    for (U32 mode = 0; mode < 3; ++mode)
+    {
+        PngEncoder::Statistic statistic;
+        const std::vector<U8> png = PngEncoder(MODES[mode]).Encode(frame.GetRawData(), 1920, 1080, &statistic);
+        TEST_ASSERT(statistic.m_encodedBytes == png.size() && statistic.m_rawBytes == 1920 * 1080 * 4);
+        printf("PNG of 1920x1080 by %5s mode: %6.2f MB, %6.1f ms, %6.1f MB/s\n", MODE_NAMES[mode],
+            statistic.m_encodedBytes / 1e6, statistic.m_elapsedMs, statistic.MegabytesPerSecond());
+    }
+
+    frame.SaveTo(GetSafeStoragePath() + L"png_encoder_frame.png");
+}
@@ -28,9 +28,12 @@ DECLARE_CASE_IN_STB_IMG_FOR(PerlinNoiseTexture, "perlin noise texture");
 
 DECLARE_CASE_IN_STB_IMG_FOR(NoiseVecTexture, "perlin noise texture");
 
+DECLARE_CASE_IN_STB_IMG_FOR(PngEncoder, "compressed PNG encoder, decoded by stb_image");
+
 using SuitForStbImage = SuitForPipline<
     CASE_NAME_IN_STB_IMG(TextureLoad),
     CASE_NAME_IN_STB_IMG(TextureSample),
     CASE_NAME_IN_STB_IMG(PerlinNoiseTexture),
-    CASE_NAME_IN_STB_IMG(NoiseVecTexture)
+    CASE_NAME_IN_STB_IMG(NoiseVecTexture),
+    CASE_NAME_IN_STB_IMG(PngEncoder)
 >;
\ No newline at end of file
@@ -3,6 +3,10 @@
 
 #include "../CommonClasses/Utils/TestTool/Suit.h"
 #include "../CommonClasses/Utils/MTRandom.h"
+#include "../CommonClasses/Utils/CounterRandom.h"
+#include "../CommonClasses/Utils/SampleSequence.h"
+#include "../CommonClasses/Utils/ParallelTool.h"
+#include "../CommonClasses/Utils/FastMath.h"
 
 // tools about debugging
 #include "../CommonClasses/DebugHelpers.h"
@@ -29,13 +33,27 @@
 #include "../CommonClasses/ImageWindow.h"
 #include "../CommonClasses/FixPointNumber.h"
 #include "../CommonClasses/EFloat.h"
+#include "../CommonClasses/EFloat4.h"
 #include "../CommonClasses/Helpers.h"
 #include "../CommonClasses/EdgeEquation2D.h"
 #include "../CommonClasses/DepthBuffer.h"
 #include "../CommonClasses/GeomentryBuilder.h"
 #include "../CommonClasses/Filter.h"
+#include "../CommonClasses/ConvolutionKernel.h"
+#include "../CommonClasses/ImagePyramid.h"
+#include "../CommonClasses/PixelConverter.h"
+#include "../CommonClasses/PngEncoder.h"
+#include "../CommonClasses/AsyncImageWriter.h"
+#include "../CommonClasses/SummedAreaTable.h"
 #include "../CommonClasses/CameraFrame.h"
+#include "../CommonClasses/CascadedShadowMap.h"
+#include "../CommonClasses/OcclusionCuller.h"
 #include "../CommonClasses/Texture.h"
 #include "../CommonClasses/GraphicToolSet.h"
+#include "../CommonClasses/WavefrontRenderer.h"
+#include "../CommonClasses/AdaptiveSampler.h"
+#include "../CommonClasses/ProgressiveRenderer.h"
+#include "../CommonClasses/BVH.h"
+#include "../CommonClasses/Instance.h"
 
 #include "BaseToolForCaseAndSuit.h"
@@ -1080,12 +1080,33 @@ public:
             const Types::F32 correctResult = farr1[i] * farr2[i];
             const Types::F32 testResult = (fparr1[i] * fparr2[i]).ToFloat();
             TEST_ASSERT(MathTool::AlmostEqual(correctResult, testResult, 0.01f));
+
+            // the results of plus and minus are exact.
+            TEST_ASSERT((fparr1[i] + fparr2[i]).GetRaw() == fparr1[i].GetRaw() + fparr2[i].GetRaw());
+            TEST_ASSERT((fparr1[i] - fparr2[i]).GetRaw() == fparr1[i].GetRaw() - fparr2[i].GetRaw());
+            TEST_ASSERT((-fparr1[i]).ToFloat() == -fparr1[i].ToFloat());
+            TEST_ASSERT(MathTool::AlmostEqual(farr1[i] + farr2[i], (fparr1[i] + fparr2[i]).ToFloat(), 0.001f));
+
+            const Types::F32 correctQuotient = fparr1[i].ToFloat() / fparr2[i].ToFloat();
+            if (std::abs(correctQuotient) < 1000.0f)
+            {
+                TEST_ASSERT(MathTool::AlmostEqual(correctQuotient, (fparr1[i] / fparr2[i]).ToFloat(), 0.001f));
+            }
+
+            TEST_ASSERT((fparr1[i] < fparr2[i]) == (fparr1[i].ToFloat() < fparr2[i].ToFloat()));
+            TEST_ASSERT((fparr1[i] >= fparr2[i]) == (fparr1[i].ToFloat() >= fparr2[i].ToFloat()));
+            TEST_ASSERT(fparr1[i].Floor() == static_cast<Types::I32>(std::floor(fparr1[i].ToFloat())));
+            TEST_ASSERT(fparr1[i].Ceil()  == static_cast<Types::I32>(std::ceil(fparr1[i].ToFloat())));
         }
 
-        // the fixed point number is not completed, so this test will always failed, 
-        // until you fix all the bugs.
-        std::cout << "the fixed point number is not completed, so this test will always failed, until you fix all the bugs.\n";
-        CountOneError();
+        // 28.4 subpixel number, rounded to the nearest 1/16.
+        TEST_ASSERT(SubpixelNumber(1.03f).GetRaw() == 16);
+        TEST_ASSERT(SubpixelNumber(1.04f).GetRaw() == 17);
+        TEST_ASSERT(SubpixelNumber(-0.5f).GetRaw() == -8);
+        TEST_ASSERT(SubpixelNumber(-0.5f).Floor() == -1 && SubpixelNumber(-0.5f).Ceil() == 0);
+        TEST_ASSERT(SubpixelNumber(3).Floor() == 3 && SubpixelNumber(3).Ceil() == 3);
+        TEST_ASSERT((SubpixelNumber(2.5f) * SubpixelNumber(-2)).ToFloat() == -5.0f);
+        TEST_ASSERT((SubpixelNumber(5) / SubpixelNumber(2)).ToFloat() == 2.5f);
     }
 };
 
@@ -1398,6 +1419,110 @@ public:
     }
 };
 
+class CaseForEFloatBenchmark : public CaseForPipline
+{
+public:
+    CaseForEFloatBenchmark() : CaseForPipline("EFloat and EFloat4 operations against float") {}
+
+    virtual void Run() override
+    {
+        const unsigned int NUM_ELEMENTS = 1024;
+        const unsigned int NUM_LOOPS    = 1000;
+
+        std::vector<float> farr[2];
+        std::vector<EFloat> efarr[2];
+        std::vector<EFloat4> ef4arr[2];
+        for (unsigned int i = 0; i < NUM_ELEMENTS; ++i)
+        {
+            farr[0].push_back((mtr.Random() - 0.5f) * 4.0f);
+            farr[1].push_back(mtr.Random() + 0.5f);
+            // the divisors of some elements straddle zero.
+            const float err = (i % 16 == 0) ? 2.0f : 1e-3f;
+            efarr[0].push_back(EFloat(farr[0][i], 1e-3f));
+            efarr[1].push_back(EFloat(farr[1][i], err));
+        }
+        for (unsigned int i = 0; i < NUM_ELEMENTS; i += 4)
+        {
+            for (unsigned int k = 0; k < 2; ++k)
+            {
+                ef4arr[k].push_back(EFloat4(efarr[k][i], efarr[k][i + 1], efarr[k][i + 2], efarr[k][i + 3]));
+            }
+        }
+
+        // each lane of EFloat4 must have exactly the same value and bounds as EFloat.
+        // the square root of a bound straddling zero is nan in both of them.
+        auto sameFloat = [](const float a, const float b)
+        {
+            return a == b || (std::isnan(a) && std::isnan(b));
+        };
+        auto sameAsEFloat = [&sameFloat](const EFloat4& ef4, const EFloat& ef, const unsigned int lane)
+        {
+            const EFloat laneEF = ef4.Lane(lane);
+            return sameFloat(static_cast<Types::F32>(laneEF), static_cast<Types::F32>(ef))
+                && sameFloat(laneEF.LowerBound(), ef.LowerBound())
+                && sameFloat(laneEF.UpperBound(), ef.UpperBound());
+        };
+        for (unsigned int i = 0; i < NUM_ELEMENTS; ++i)
+        {
+            const EFloat4& a = ef4arr[0][i / 4];
+            const EFloat4& b = ef4arr[1][i / 4];
+            const EFloat& efa = efarr[0][i];
+            const EFloat& efb = efarr[1][i];
+            TEST_ASSERT(sameAsEFloat(a + b,     efa + efb,  i % 4));
+            TEST_ASSERT(sameAsEFloat(a - b,     efa - efb,  i % 4));
+            TEST_ASSERT(sameAsEFloat(a * b,     efa * efb,  i % 4));
+            TEST_ASSERT(sameAsEFloat(a / b,     efa / efb,  i % 4));
+            TEST_ASSERT(sameAsEFloat(-a,        -efa,       i % 4));
+            TEST_ASSERT(sameAsEFloat(abs(a),    abs(efa),   i % 4));
+            TEST_ASSERT(sameAsEFloat(sqrt(b),   sqrt(efb),  i % 4));
+            (a * b).Check();
+        }
+
+        // 'sink' keep the results alive, so the loops will not be removed by the compiler.
+        Types::F32 sink = 0.0f;
+        unsigned int loopSink = 0;
+        auto benchmark = [&](const char * name, const auto& arr0, const auto& arr1, auto && operation)
+        {
+            auto results = arr0;
+            TestSuit::TimeCounter counter;
+            {
+                TestSuit::TimeGuard guard(counter);
+                for (unsigned int loop = 0; loop < NUM_LOOPS; ++loop)
+                {
+                    for (unsigned int i = 0; i < arr0.size(); ++i)
+                    {
+                        results[i] = operation(arr0[i], arr1[i]);
+                    }
+                }
+            }
+            sink += *reinterpret_cast<const Types::F32 *>(&results[loopSink++ % results.size()]);
+            const double seconds = std::chrono::duration<double>(counter.m_sumDuration).count();
+            printf("%-14s %8.2f M numbers/s\n", name, static_cast<double>(NUM_LOOPS) * NUM_ELEMENTS / seconds * 1e-6);
+        };
+
+#ifdef EFLOAT_DEBUG
+        printf("EFLOAT_DEBUG is on, EFloat track the precise value.\n");
+#endif
+        benchmark("float +",        farr[0],    farr[1],    [](const float& a, const float& b)      { return a + b; });
+        benchmark("EFloat +",       efarr[0],   efarr[1],   [](const EFloat& a, const EFloat& b)    { return a + b; });
+        benchmark("EFloat4 +",      ef4arr[0],  ef4arr[1],  [](const EFloat4& a, const EFloat4& b)  { return a + b; });
+        benchmark("float -",        farr[0],    farr[1],    [](const float& a, const float& b)      { return a - b; });
+        benchmark("EFloat -",       efarr[0],   efarr[1],   [](const EFloat& a, const EFloat& b)    { return a - b; });
+        benchmark("EFloat4 -",      ef4arr[0],  ef4arr[1],  [](const EFloat4& a, const EFloat4& b)  { return a - b; });
+        benchmark("float *",        farr[0],    farr[1],    [](const float& a, const float& b)      { return a * b; });
+        benchmark("EFloat *",       efarr[0],   efarr[1],   [](const EFloat& a, const EFloat& b)    { return a * b; });
+        benchmark("EFloat4 *",      ef4arr[0],  ef4arr[1],  [](const EFloat4& a, const EFloat4& b)  { return a * b; });
+        benchmark("float /",        farr[0],    farr[1],    [](const float& a, const float& b)      { return a / b; });
+        benchmark("EFloat /",       efarr[0],   efarr[1],   [](const EFloat& a, const EFloat& b)    { return a / b; });
+        benchmark("EFloat4 /",      ef4arr[0],  ef4arr[1],  [](const EFloat4& a, const EFloat4& b)  { return a / b; });
+        benchmark("float sqrt",     farr[1],    farr[1],    [](const float& a, const float&)        { return std::sqrt(a); });
+        benchmark("EFloat sqrt",    efarr[1],   efarr[1],   [](const EFloat& a, const EFloat&)      { return sqrt(a); });
+        benchmark("EFloat4 sqrt",   ef4arr[1],  ef4arr[1],  [](const EFloat4& a, const EFloat4&)    { return sqrt(a); });
+
+        printf("sink %f\n", sink);
+    }
+};
+
 /*!
     \brief this struct is for unit test of DebugClient.
 */
@@ -1645,6 +1770,7 @@ BasicTypesTestSuit_BASE
     CaseForEFloat,
     CaseForEFloatConstructTest,
     CaseForEFloatOperatorTest,
+    CaseForEFloatBenchmark,
     CaseForDebugClientTest,
     CaseForTriangleRegionBoundary,
     CaseForEdgeEquation